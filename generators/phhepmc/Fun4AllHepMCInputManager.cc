@@ -1,5 +1,6 @@
 #include "Fun4AllHepMCInputManager.h"
 
+#include "HepMCBinaryCache.h"
 #include "PHHepMCGenEvent.h"
 #include "PHHepMCGenEventMap.h"
 
@@ -101,6 +102,10 @@ int Fun4AllHepMCInputManager::fileopen(const std::string &filenam)
   {
     theOscarFile.open(fname);
   }
+  else if (OpenBinaryCache(fname))
+  {
+    // events are decoded from the binary cache, the text file is not read
+  }
   else
   {
     TString tstr(fname);
@@ -144,6 +149,18 @@ int Fun4AllHepMCInputManager::fileopen(const std::string &filenam)
   events_thisfile = 0;
   IsOpen(1);
   AddToFileOpened(fname);  // add file to the list of files which were opened
+  if (!m_ReadOscarFlag)
+  {
+    unsigned int depth = m_PrefetchDepth;
+    if (depth == 0)
+    {
+      depth = Fun4AllServer::instance()->PipelineDepth();
+    }
+    if (depth > 0)
+    {
+      StartReader(depth);
+    }
+  }
   return 0;
 }
 
@@ -186,7 +203,7 @@ int Fun4AllHepMCInputManager::run(const int /*nevents*/)
       }
       else
       {
-        evt = ascii_in->read_next_event();
+        evt = NextEvent();
       }
     }
 
@@ -195,8 +212,7 @@ int Fun4AllHepMCInputManager::run(const int /*nevents*/)
       if (Verbosity() > 1)
       {
         std::cout << "Fun4AllHepMCInputManager::run::" << Name()
-                  << ": error type: " << ascii_in->error_type()
-                  << ", rdstate: " << ascii_in->rdstate() << std::endl;
+                  << ": " << ReadStatus() << std::endl;
       }
       fileclose();
     }
@@ -252,8 +268,14 @@ int Fun4AllHepMCInputManager::fileclose()
   }
   else
   {
+    StopReader();
     delete ascii_in;
     ascii_in = nullptr;
+    delete m_CacheReader;
+    m_CacheReader = nullptr;
+    // removes the partially written cache unless the whole file was read
+    delete m_CacheWriter;
+    m_CacheWriter = nullptr;
   }
   IsOpen(0);
   // if we have a file list, move next entry to top of the list
@@ -318,12 +340,11 @@ int Fun4AllHepMCInputManager::PushBackEvents(const int i)
   int errorflag = 0;
   while (nevents > 0 && !errorflag)
   {
-    evt = ascii_in->read_next_event();
+    evt = NextEvent();
     if (!evt)
     {
       std::cout << "Error after skipping " << i - nevents << std::endl;
-      std::cout << "error type: " << ascii_in->error_type()
-                << ", rdstate: " << ascii_in->rdstate() << std::endl;
+      std::cout << ReadStatus() << std::endl;
       errorflag = -1;
       fileclose();
     }
@@ -433,3 +454,141 @@ int Fun4AllHepMCInputManager::MyCurrentEvent(const unsigned int index) const
   }
   return m_MyEvent.at(index);
 }
+
+// returns true if there is a valid cache of fname, otherwise it gets created
+// while the text file is read
+bool Fun4AllHepMCInputManager::OpenBinaryCache(const std::string &fname)
+{
+  if (m_BinaryCacheDir.empty())
+  {
+    return false;
+  }
+  std::string cachefile = HepMCBinaryCache::CacheFileName(m_BinaryCacheDir, fname);
+  m_CacheReader = new HepMCBinaryCacheReader(cachefile, fname);
+  if (m_CacheReader->IsOpen())
+  {
+    if (Verbosity() > 0)
+    {
+      std::cout << Name() << ": reading binary cache " << cachefile << std::endl;
+    }
+    return true;
+  }
+  delete m_CacheReader;
+  m_CacheReader = nullptr;
+  m_CacheWriter = new HepMCBinaryCacheWriter(cachefile, fname);
+  return false;
+}
+
+void Fun4AllHepMCInputManager::StartReader(const unsigned int depth)
+{
+  m_ReadDepth = depth;
+  m_StopReader = false;
+  m_ReaderDone = false;
+  m_ReaderThread = std::thread(&Fun4AllHepMCInputManager::ReaderLoop, this);
+}
+
+// stops the reader and deletes all events it read ahead
+void Fun4AllHepMCInputManager::StopReader()
+{
+  if (!m_ReaderThread.joinable())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_ReadMutex);
+    m_StopReader = true;
+  }
+  m_ReadCondition.notify_all();
+  m_ReaderThread.join();
+  for (auto *queued : m_ReadQueue)
+  {
+    delete queued;
+  }
+  m_ReadQueue.clear();
+}
+
+// the reader thread is the only one using the input streams and the cache while it runs
+void Fun4AllHepMCInputManager::ReaderLoop()
+{
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_ReadMutex);
+      m_ReadCondition.wait(lock, [this]
+                           { return m_StopReader || m_ReadQueue.size() < m_ReadDepth; });
+      if (m_StopReader)
+      {
+        return;
+      }
+    }
+    HepMC::GenEvent *newevt = ReadEvent();
+    {
+      std::lock_guard<std::mutex> lock(m_ReadMutex);
+      m_ReadQueue.push_back(newevt);
+      m_ReaderDone = (newevt == nullptr);
+    }
+    m_ReadCondition.notify_all();
+    if (!newevt)
+    {
+      return;
+    }
+  }
+}
+
+HepMC::GenEvent *Fun4AllHepMCInputManager::ReadEvent()
+{
+  if (m_CacheReader)
+  {
+    return m_CacheReader->ReadNextEvent();
+  }
+  HepMC::GenEvent *newevt = ascii_in->read_next_event();
+  if (m_CacheWriter)
+  {
+    if (newevt)
+    {
+      m_CacheWriter->Write(newevt);
+    }
+    // the cache contains exactly the events the text file delivered
+    else if (m_CacheWriter->Commit() && Verbosity() > 0)
+    {
+      std::cout << Name() << ": created binary cache for " << filename << std::endl;
+    }
+  }
+  return newevt;
+}
+
+HepMC::GenEvent *Fun4AllHepMCInputManager::NextEvent()
+{
+  if (!m_ReaderThread.joinable())
+  {
+    return ReadEvent();
+  }
+  std::unique_lock<std::mutex> lock(m_ReadMutex);
+  m_ReadCondition.wait(lock, [this]
+                       { return !m_ReadQueue.empty() || m_ReaderDone; });
+  if (m_ReadQueue.empty())
+  {
+    return nullptr;
+  }
+  HepMC::GenEvent *newevt = m_ReadQueue.front();
+  m_ReadQueue.pop_front();
+  lock.unlock();
+  m_ReadCondition.notify_all();
+  return newevt;
+}
+
+std::string Fun4AllHepMCInputManager::ReadStatus() const
+{
+  if (m_CacheReader)
+  {
+    return "end of binary cache";
+  }
+  if (!ascii_in)
+  {
+    return "no input stream";
+  }
+  std::ostringstream status;
+  status << "error type: " << ascii_in->error_type()
+         << ", rdstate: " << ascii_in->rdstate();
+  return status.str();
+}
@@ -8,10 +8,16 @@
 
 #include <boost/iostreams/filtering_streambuf.hpp>
 
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
+class HepMCBinaryCacheReader;
+class HepMCBinaryCacheWriter;
 class PHCompositeNode;
 class SyncObject;
 
@@ -47,7 +53,18 @@ class Fun4AllHepMCInputManager : public Fun4AllInputManager, public PHHepMCGenHe
   int SkipForThisManager(const int nevents) override { return PushBackEvents(-nevents); }
   int MyCurrentEvent(const unsigned int index = 0) const;
 
+  //! number of events parsed ahead by a reader thread, 0 uses the pipeline depth of the Fun4AllServer
+  void PrefetchDepth(const unsigned int i) { m_PrefetchDepth = i; }
+  //! directory of binary copies of the input files, the first pass over a file
+  //! creates its copy which is read instead of the text file afterwards
+  void BinaryCacheDir(const std::string &dir) { m_BinaryCacheDir = dir; }
+
  protected:
+  //! next event of the open HepMC file, nullptr at its end
+  HepMC::GenEvent *NextEvent();
+  //! state of the input after NextEvent() returned nullptr
+  std::string ReadStatus() const;
+
   HepMC::GenEvent *evt = nullptr;
 
   int events_total = 0;
@@ -65,10 +82,31 @@ class Fun4AllHepMCInputManager : public Fun4AllInputManager, public PHHepMCGenHe
   std::ifstream *filestream = nullptr;  // holds compressed filestream
   std::istream *unzipstream = nullptr;  // feed into HepMc
 
+  bool OpenBinaryCache(const std::string &fname);
+  // prefetch mode: a reader thread keeps up to depth events ready
+  void StartReader(const unsigned int depth);
+  void StopReader();
+  void ReaderLoop();
+  HepMC::GenEvent *ReadEvent();
+
   int m_ReadOscarFlag = 0;
 
   std::vector<int> m_MyEvent;
 
+  std::string m_BinaryCacheDir;
+  HepMCBinaryCacheReader *m_CacheReader = nullptr;
+  HepMCBinaryCacheWriter *m_CacheWriter = nullptr;
+
+  unsigned int m_PrefetchDepth = 0;
+  std::thread m_ReaderThread;
+  std::mutex m_ReadMutex;
+  std::condition_variable m_ReadCondition;
+  // a nullptr entry marks the end of the file
+  std::deque<HepMC::GenEvent *> m_ReadQueue;
+  unsigned int m_ReadDepth = 0;
+  bool m_StopReader = false;
+  bool m_ReaderDone = false;
+
   boost::iostreams::filtering_streambuf<boost::iostreams::input> zinbuffer;
 
   std::ifstream theOscarFile;
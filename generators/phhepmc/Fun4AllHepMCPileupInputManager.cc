@@ -150,11 +150,11 @@ int Fun4AllHepMCPileupInputManager::run(const int /*nevents*/, const bool skip)
           }
           else
           {
-            evt = ascii_in->read_next_event();
+            evt = NextEvent();
             if (evt && m_SignalEventNumber == evt->event_number())
             {
               delete evt;
-              evt = ascii_in->read_next_event();
+              evt = NextEvent();
             }
           }
         }
@@ -163,8 +163,7 @@ int Fun4AllHepMCPileupInputManager::run(const int /*nevents*/, const bool skip)
         {
           if (Verbosity() > 1)
           {
-            std::cout << "error type: " << ascii_in->error_type()
-                      << ", rdstate: " << ascii_in->rdstate() << std::endl;
+            std::cout << ReadStatus() << std::endl;
           }
           fileclose();
         }
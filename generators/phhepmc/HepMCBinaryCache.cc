@@ -0,0 +1,741 @@
+#include "HepMCBinaryCache.h"
+
+#include <phool/phool.h>  // for PHWHERE
+
+#include <HepMC/Flow.h>
+#include <HepMC/GenCrossSection.h>
+#include <HepMC/GenEvent.h>
+#include <HepMC/GenParticle.h>
+#include <HepMC/GenVertex.h>
+#include <HepMC/HeavyIon.h>
+#include <HepMC/PdfInfo.h>
+#include <HepMC/Polarization.h>
+#include <HepMC/SimpleVector.h>  // for FourVector
+#include <HepMC/Units.h>
+#include <HepMC/WeightContainer.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>  // for rename, remove
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+  const char cache_magic[8] = {'P', 'H', 'H', 'E', 'P', 'M', 'C', 'B'};
+  const uint32_t cache_version = 1;
+
+  // the cache belongs to one version of the source file
+  bool source_stamp(const std::string &source, int64_t &size, int64_t &mtime)
+  {
+    struct stat st
+    {
+    };
+    if (stat(source.c_str(), &st) != 0)
+    {
+      return false;
+    }
+    size = st.st_size;
+    mtime = st.st_mtime;
+    return true;
+  }
+
+  template <class T>
+  void put(std::vector<char> &buffer, const T value)
+  {
+    const char *p = reinterpret_cast<const char *>(&value);
+    buffer.insert(buffer.end(), p, p + sizeof(T));
+  }
+
+  void put_string(std::vector<char> &buffer, const std::string &s)
+  {
+    put<uint32_t>(buffer, s.size());
+    buffer.insert(buffer.end(), s.begin(), s.end());
+  }
+
+  // bounds checked access to a block of the mapped file
+  class Cursor
+  {
+   public:
+    Cursor(const char *data, const std::size_t size)
+      : m_Data(data)
+      , m_Size(size)
+    {
+    }
+
+    template <class T>
+    bool get(T &value)
+    {
+      if (m_Size - m_Pos < sizeof(T))
+      {
+        return false;
+      }
+      std::memcpy(&value, m_Data + m_Pos, sizeof(T));
+      m_Pos += sizeof(T);
+      return true;
+    }
+
+    std::size_t position() const { return m_Pos; }
+
+   private:
+    const char *m_Data = nullptr;
+    std::size_t m_Size = 0;
+    std::size_t m_Pos = 0;
+  };
+
+  void put_header(std::vector<char> &buffer, const std::string &source, const int64_t size, const int64_t mtime)
+  {
+    buffer.insert(buffer.end(), cache_magic, cache_magic + sizeof(cache_magic));
+    put(buffer, cache_version);
+    put_string(buffer, source);
+    put(buffer, size);
+    put(buffer, mtime);
+  }
+
+  bool encode_event(const HepMC::GenEvent *evt, std::vector<char> &buffer)
+  {
+    // only weights without names can be restored exactly, which is
+    // what IO_GenEvent creates when the file does not name them
+    const HepMC::WeightContainer &weights = evt->weights();
+    for (std::size_t i = 0; i < weights.size(); ++i)
+    {
+      if (!weights.has_key(std::to_string(i)))
+      {
+        return false;
+      }
+    }
+
+    put<int32_t>(buffer, evt->momentum_unit());
+    put<int32_t>(buffer, evt->length_unit());
+    put<int32_t>(buffer, evt->event_number());
+    put<int32_t>(buffer, evt->signal_process_id());
+    put<int32_t>(buffer, evt->mpi());
+    put<double>(buffer, evt->event_scale());
+    put<double>(buffer, evt->alphaQCD());
+    put<double>(buffer, evt->alphaQED());
+
+    const std::vector<long> random_states = evt->random_states();
+    put<uint32_t>(buffer, random_states.size());
+    for (long state : random_states)
+    {
+      put<int64_t>(buffer, state);
+    }
+    put<uint32_t>(buffer, weights.size());
+    for (std::size_t i = 0; i < weights.size(); ++i)
+    {
+      put<double>(buffer, weights[i]);
+    }
+
+    const HepMC::HeavyIon *hi = evt->heavy_ion();
+    put<uint8_t>(buffer, hi != nullptr);
+    if (hi)
+    {
+      put<int32_t>(buffer, hi->Ncoll_hard());
+      put<int32_t>(buffer, hi->Npart_proj());
+      put<int32_t>(buffer, hi->Npart_targ());
+      put<int32_t>(buffer, hi->Ncoll());
+      put<int32_t>(buffer, hi->spectator_neutrons());
+      put<int32_t>(buffer, hi->spectator_protons());
+      put<int32_t>(buffer, hi->N_Nwounded_collisions());
+      put<int32_t>(buffer, hi->Nwounded_N_collisions());
+      put<int32_t>(buffer, hi->Nwounded_Nwounded_collisions());
+      put<float>(buffer, hi->impact_parameter());
+      put<float>(buffer, hi->event_plane_angle());
+      put<float>(buffer, hi->eccentricity());
+      put<float>(buffer, hi->sigma_inel_NN());
+    }
+    const HepMC::PdfInfo *pdf = evt->pdf_info();
+    put<uint8_t>(buffer, pdf != nullptr);
+    if (pdf)
+    {
+      put<int32_t>(buffer, pdf->id1());
+      put<int32_t>(buffer, pdf->id2());
+      put<double>(buffer, pdf->x1());
+      put<double>(buffer, pdf->x2());
+      put<double>(buffer, pdf->scalePDF());
+      put<double>(buffer, pdf->pdf1());
+      put<double>(buffer, pdf->pdf2());
+      put<int32_t>(buffer, pdf->pdf_id1());
+      put<int32_t>(buffer, pdf->pdf_id2());
+    }
+    const HepMC::GenCrossSection *xsec = evt->cross_section();
+    put<uint8_t>(buffer, xsec != nullptr);
+    if (xsec)
+    {
+      put<double>(buffer, xsec->cross_section());
+      put<double>(buffer, xsec->cross_section_error());
+    }
+
+    // particles are referenced by their position in this list
+    std::unordered_map<const HepMC::GenParticle *, uint32_t> particle_index;
+    put<uint32_t>(buffer, evt->particles_size());
+    for (HepMC::GenEvent::particle_const_iterator p = evt->particles_begin(); p != evt->particles_end(); ++p)
+    {
+      particle_index.emplace(*p, particle_index.size());
+      const HepMC::FourVector &mom = (*p)->momentum();
+      put<int32_t>(buffer, (*p)->barcode());
+      put<int32_t>(buffer, (*p)->pdg_id());
+      put<int32_t>(buffer, (*p)->status());
+      put<double>(buffer, mom.px());
+      put<double>(buffer, mom.py());
+      put<double>(buffer, mom.pz());
+      put<double>(buffer, mom.e());
+      put<double>(buffer, (*p)->generated_mass());
+      put<double>(buffer, (*p)->polarization().theta());
+      put<double>(buffer, (*p)->polarization().phi());
+      const HepMC::Flow &flow = (*p)->flow();
+      put<uint32_t>(buffer, flow.size());
+      for (const auto &code : flow)
+      {
+        put<int32_t>(buffer, code.first);
+        put<int32_t>(buffer, code.second);
+      }
+    }
+
+    std::unordered_map<const HepMC::GenVertex *, int32_t> vertex_index;
+    put<uint32_t>(buffer, evt->vertices_size());
+    for (HepMC::GenEvent::vertex_const_iterator v = evt->vertices_begin(); v != evt->vertices_end(); ++v)
+    {
+      vertex_index.emplace(*v, vertex_index.size());
+      const HepMC::FourVector &pos = (*v)->position();
+      put<int32_t>(buffer, (*v)->barcode());
+      put<int32_t>(buffer, (*v)->id());
+      put<double>(buffer, pos.x());
+      put<double>(buffer, pos.y());
+      put<double>(buffer, pos.z());
+      put<double>(buffer, pos.t());
+      const HepMC::WeightContainer &vweights = (*v)->weights();
+      put<uint32_t>(buffer, vweights.size());
+      for (std::size_t i = 0; i < vweights.size(); ++i)
+      {
+        put<double>(buffer, vweights[i]);
+      }
+      put<uint32_t>(buffer, (*v)->particles_in_size());
+      for (HepMC::GenVertex::particles_in_const_iterator p = (*v)->particles_in_const_begin(); p != (*v)->particles_in_const_end(); ++p)
+      {
+        put<uint32_t>(buffer, particle_index.at(*p));
+      }
+      put<uint32_t>(buffer, (*v)->particles_out_size());
+      for (HepMC::GenVertex::particles_out_const_iterator p = (*v)->particles_out_const_begin(); p != (*v)->particles_out_const_end(); ++p)
+      {
+        put<uint32_t>(buffer, particle_index.at(*p));
+      }
+    }
+
+    const HepMC::GenVertex *signal = evt->signal_process_vertex();
+    put<int32_t>(buffer, signal ? vertex_index.at(signal) : -1);
+    std::pair<HepMC::GenParticle *, HepMC::GenParticle *> beams = evt->beam_particles();
+    put<int32_t>(buffer, beams.first ? static_cast<int32_t>(particle_index.at(beams.first)) : -1);
+    put<int32_t>(buffer, beams.second ? static_cast<int32_t>(particle_index.at(beams.second)) : -1);
+    return true;
+  }
+
+  // fills evt, the caller deletes it if this fails
+  bool decode_event(Cursor &in, HepMC::GenEvent *evt)
+  {
+    int32_t ival = 0;
+    double dval = 0;
+    uint32_t n = 0;
+
+    if (!in.get(ival))
+    {
+      return false;
+    }
+    const int32_t momentum_unit = ival;
+    if (!in.get(ival))
+    {
+      return false;
+    }
+    evt->use_units(static_cast<HepMC::Units::MomentumUnit>(momentum_unit), static_cast<HepMC::Units::LengthUnit>(ival));
+    if (!in.get(ival))
+    {
+      return false;
+    }
+    evt->set_event_number(ival);
+    if (!in.get(ival))
+    {
+      return false;
+    }
+    evt->set_signal_process_id(ival);
+    if (!in.get(ival))
+    {
+      return false;
+    }
+    evt->set_mpi(ival);
+    if (!in.get(dval))
+    {
+      return false;
+    }
+    evt->set_event_scale(dval);
+    if (!in.get(dval))
+    {
+      return false;
+    }
+    evt->set_alphaQCD(dval);
+    if (!in.get(dval))
+    {
+      return false;
+    }
+    evt->set_alphaQED(dval);
+
+    if (!in.get(n))
+    {
+      return false;
+    }
+    std::vector<long> random_states(n);
+    for (long &state : random_states)
+    {
+      int64_t lval = 0;
+      if (!in.get(lval))
+      {
+        return false;
+      }
+      state = lval;
+    }
+    evt->set_random_states(random_states);
+    if (!in.get(n))
+    {
+      return false;
+    }
+    std::vector<double> weights(n);
+    for (double &w : weights)
+    {
+      if (!in.get(w))
+      {
+        return false;
+      }
+    }
+    evt->weights() = HepMC::WeightContainer(weights);
+
+    uint8_t present = 0;
+    if (!in.get(present))
+    {
+      return false;
+    }
+    if (present)
+    {
+      int32_t hint[9];
+      float hfloat[4];
+      for (int32_t &i : hint)
+      {
+        if (!in.get(i))
+        {
+          return false;
+        }
+      }
+      for (float &f : hfloat)
+      {
+        if (!in.get(f))
+        {
+          return false;
+        }
+      }
+      HepMC::HeavyIon hi;
+      hi.set_Ncoll_hard(hint[0]);
+      hi.set_Npart_proj(hint[1]);
+      hi.set_Npart_targ(hint[2]);
+      hi.set_Ncoll(hint[3]);
+      hi.set_spectator_neutrons(hint[4]);
+      hi.set_spectator_protons(hint[5]);
+      hi.set_N_Nwounded_collisions(hint[6]);
+      hi.set_Nwounded_N_collisions(hint[7]);
+      hi.set_Nwounded_Nwounded_collisions(hint[8]);
+      hi.set_impact_parameter(hfloat[0]);
+      hi.set_event_plane_angle(hfloat[1]);
+      hi.set_eccentricity(hfloat[2]);
+      hi.set_sigma_inel_NN(hfloat[3]);
+      evt->set_heavy_ion(hi);
+    }
+    if (!in.get(present))
+    {
+      return false;
+    }
+    if (present)
+    {
+      int32_t id1 = 0;
+      int32_t id2 = 0;
+      double pdouble[5];
+      int32_t pdf_id1 = 0;
+      int32_t pdf_id2 = 0;
+      if (!in.get(id1) || !in.get(id2))
+      {
+        return false;
+      }
+      for (double &d : pdouble)
+      {
+        if (!in.get(d))
+        {
+          return false;
+        }
+      }
+      if (!in.get(pdf_id1) || !in.get(pdf_id2))
+      {
+        return false;
+      }
+      HepMC::PdfInfo pdf;
+      pdf.set_id1(id1);
+      pdf.set_id2(id2);
+      pdf.set_x1(pdouble[0]);
+      pdf.set_x2(pdouble[1]);
+      pdf.set_scalePDF(pdouble[2]);
+      pdf.set_pdf1(pdouble[3]);
+      pdf.set_pdf2(pdouble[4]);
+      pdf.set_pdf_id1(pdf_id1);
+      pdf.set_pdf_id2(pdf_id2);
+      evt->set_pdf_info(pdf);
+    }
+    if (!in.get(present))
+    {
+      return false;
+    }
+    if (present)
+    {
+      double xs = 0;
+      double xs_err = 0;
+      if (!in.get(xs) || !in.get(xs_err))
+      {
+        return false;
+      }
+      HepMC::GenCrossSection xsec;
+      xsec.set_cross_section(xs, xs_err);
+      evt->set_cross_section(xsec);
+    }
+
+    if (!in.get(n))
+    {
+      return false;
+    }
+    // particles only belong to the event once they are attached to a vertex,
+    // the ones which never got attached have to be deleted here
+    std::vector<HepMC::GenParticle *> particles;
+    particles.reserve(n);
+    std::vector<char> attached(n, 0);
+    auto delete_unattached = [&particles, &attached]()
+    {
+      for (std::size_t i = 0; i < particles.size(); ++i)
+      {
+        if (!attached[i])
+        {
+          delete particles[i];
+        }
+      }
+    };
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      int32_t barcode = 0;
+      int32_t pdg = 0;
+      int32_t status = 0;
+      double mom[4];
+      double mass = 0;
+      double theta = 0;
+      double phi = 0;
+      uint32_t nflow = 0;
+      if (!in.get(barcode) || !in.get(pdg) || !in.get(status) ||
+          !in.get(mom[0]) || !in.get(mom[1]) || !in.get(mom[2]) || !in.get(mom[3]) ||
+          !in.get(mass) || !in.get(theta) || !in.get(phi) || !in.get(nflow))
+      {
+        delete_unattached();
+        return false;
+      }
+      HepMC::Flow flow;
+      for (uint32_t j = 0; j < nflow; ++j)
+      {
+        int32_t index = 0;
+        int32_t code = 0;
+        if (!in.get(index) || !in.get(code))
+        {
+          delete_unattached();
+          return false;
+        }
+        flow.set_icode(index, code);
+      }
+      HepMC::GenParticle *p = new HepMC::GenParticle(HepMC::FourVector(mom[0], mom[1], mom[2], mom[3]), pdg, status, flow, HepMC::Polarization(theta, phi));
+      p->setGeneratedMass(mass);
+      p->suggest_barcode(barcode);
+      particles.push_back(p);
+    }
+
+    if (!in.get(n))
+    {
+      delete_unattached();
+      return false;
+    }
+    std::vector<HepMC::GenVertex *> vertices;
+    vertices.reserve(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      int32_t barcode = 0;
+      int32_t id = 0;
+      double pos[4];
+      uint32_t nweights = 0;
+      if (!in.get(barcode) || !in.get(id) ||
+          !in.get(pos[0]) || !in.get(pos[1]) || !in.get(pos[2]) || !in.get(pos[3]) ||
+          !in.get(nweights))
+      {
+        delete_unattached();
+        return false;
+      }
+      std::vector<double> vweights(nweights);
+      for (double &w : vweights)
+      {
+        if (!in.get(w))
+        {
+          delete_unattached();
+          return false;
+        }
+      }
+      HepMC::GenVertex *v = new HepMC::GenVertex(HepMC::FourVector(pos[0], pos[1], pos[2], pos[3]), id, HepMC::WeightContainer(vweights));
+      v->suggest_barcode(barcode);
+      evt->add_vertex(v);
+      vertices.push_back(v);
+      // the barcodes are suggested before the particles are attached, so the
+      // event keeps them
+      for (int out = 0; out < 2; ++out)
+      {
+        uint32_t nattached = 0;
+        if (!in.get(nattached))
+        {
+          delete_unattached();
+          return false;
+        }
+        for (uint32_t j = 0; j < nattached; ++j)
+        {
+          uint32_t index = 0;
+          if (!in.get(index) || index >= particles.size())
+          {
+            delete_unattached();
+            return false;
+          }
+          if (out)
+          {
+            v->add_particle_out(particles[index]);
+          }
+          else
+          {
+            v->add_particle_in(particles[index]);
+          }
+          attached[index] = 1;
+        }
+      }
+    }
+    delete_unattached();
+
+    int32_t signal = -1;
+    int32_t beam1 = -1;
+    int32_t beam2 = -1;
+    if (!in.get(signal) || !in.get(beam1) || !in.get(beam2))
+    {
+      return false;
+    }
+    if (signal >= 0 && static_cast<std::size_t>(signal) < vertices.size())
+    {
+      evt->set_signal_process_vertex(vertices[signal]);
+    }
+    if (beam1 >= 0 && beam2 >= 0 && static_cast<std::size_t>(beam1) < particles.size() && static_cast<std::size_t>(beam2) < particles.size())
+    {
+      evt->set_beam_particles(particles[beam1], particles[beam2]);
+    }
+    return true;
+  }
+
+  // FNV-1a, stable across builds so cache names stay valid
+  uint64_t path_hash(const std::string &path)
+  {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const char c : path)
+    {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 0x100000001b3ULL;
+    }
+    return hash;
+  }
+}  // namespace
+
+std::string HepMCBinaryCache::CacheFileName(const std::string &cachedir, const std::string &source)
+{
+  // files with the same name in different directories get different caches
+  std::string basename = source.substr(source.find_last_of('/') + 1);
+  std::error_code ec;
+  std::string fullpath = std::filesystem::absolute(source, ec).lexically_normal().string();
+  if (ec)
+  {
+    fullpath = source;
+  }
+  return cachedir + "/" + basename + std::format(".{:016x}", path_hash(fullpath)) + ".hepmcbin";
+}
+
+HepMCBinaryCacheWriter::HepMCBinaryCacheWriter(const std::string &cachefile, const std::string &source)
+  : m_CacheFile(cachefile)
+  , m_TmpFile(cachefile + "." + std::to_string(getpid()) + ".tmp")
+{
+  int64_t size = 0;
+  int64_t mtime = 0;
+  if (!source_stamp(source, size, mtime))
+  {
+    return;
+  }
+  m_Out.open(m_TmpFile, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_Out.is_open())
+  {
+    std::cout << PHWHERE << " cannot create binary cache " << m_TmpFile << std::endl;
+    return;
+  }
+  put_header(m_Buffer, source, size, mtime);
+  m_Out.write(m_Buffer.data(), static_cast<std::streamsize>(m_Buffer.size()));
+  m_Good = m_Out.good();
+}
+
+HepMCBinaryCacheWriter::~HepMCBinaryCacheWriter()
+{
+  Discard();
+}
+
+bool HepMCBinaryCacheWriter::Write(const HepMC::GenEvent *evt)
+{
+  if (!m_Good)
+  {
+    return false;
+  }
+  m_Buffer.clear();
+  if (!encode_event(evt, m_Buffer))
+  {
+    std::cout << PHWHERE << " event " << evt->event_number()
+              << " has named weights which the binary cache cannot store, not creating "
+              << m_CacheFile << std::endl;
+    Discard();
+    return false;
+  }
+  uint64_t length = m_Buffer.size();
+  m_Out.write(reinterpret_cast<const char *>(&length), sizeof(length));
+  m_Out.write(m_Buffer.data(), static_cast<std::streamsize>(m_Buffer.size()));
+  if (!m_Out.good())
+  {
+    std::cout << PHWHERE << " writing " << m_TmpFile << " failed" << std::endl;
+    Discard();
+    return false;
+  }
+  return true;
+}
+
+bool HepMCBinaryCacheWriter::Commit()
+{
+  if (!m_Good)
+  {
+    return false;
+  }
+  m_Out.close();
+  if (m_Out.fail() || rename(m_TmpFile.c_str(), m_CacheFile.c_str()) != 0)
+  {
+    std::cout << PHWHERE << " could not create binary cache " << m_CacheFile << std::endl;
+    Discard();
+    return false;
+  }
+  m_Good = false;
+  return true;
+}
+
+void HepMCBinaryCacheWriter::Discard()
+{
+  // the temporary file exists unless it was committed or never opened
+  const bool created = m_Good || m_Out.is_open();
+  if (m_Out.is_open())
+  {
+    m_Out.close();
+  }
+  if (created)
+  {
+    // okay if the file does not exist
+    remove(m_TmpFile.c_str());
+  }
+  m_Good = false;
+}
+
+HepMCBinaryCacheReader::HepMCBinaryCacheReader(const std::string &cachefile, const std::string &source)
+{
+  int64_t size = 0;
+  int64_t mtime = 0;
+  if (!source_stamp(source, size, mtime))
+  {
+    return;
+  }
+  int fd = open(cachefile.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return;
+  }
+  struct stat st
+  {
+  };
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    close(fd);
+    return;
+  }
+  void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+  {
+    return;
+  }
+  madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+  // compare with the header a writer would create for the current source file
+  std::vector<char> expected;
+  put_header(expected, source, size, mtime);
+  if (static_cast<std::size_t>(st.st_size) < expected.size() ||
+      std::memcmp(data, expected.data(), expected.size()) != 0)
+  {
+    munmap(data, st.st_size);
+    return;
+  }
+  m_Data = static_cast<const char *>(data);
+  m_Size = st.st_size;
+  m_Offset = expected.size();
+}
+
+HepMCBinaryCacheReader::~HepMCBinaryCacheReader()
+{
+  if (m_Data)
+  {
+    munmap(const_cast<char *>(m_Data), m_Size);
+  }
+}
+
+HepMC::GenEvent *HepMCBinaryCacheReader::ReadNextEvent()
+{
+  if (!m_Data)
+  {
+    return nullptr;
+  }
+  uint64_t length = 0;
+  Cursor header(m_Data + m_Offset, m_Size - m_Offset);
+  if (!header.get(length))
+  {
+    return nullptr;
+  }
+  if (length > m_Size - m_Offset - sizeof(length))
+  {
+    std::cout << PHWHERE << " truncated event record in binary cache" << std::endl;
+    m_Offset = m_Size;
+    return nullptr;
+  }
+  Cursor record(m_Data + m_Offset + sizeof(length), length);
+  m_Offset += sizeof(length) + length;
+  HepMC::GenEvent *evt = new HepMC::GenEvent();
+  if (!decode_event(record, evt) || record.position() != length)
+  {
+    std::cout << PHWHERE << " corrupt event record in binary cache" << std::endl;
+    delete evt;
+    m_Offset = m_Size;
+    return nullptr;
+  }
+  return evt;
+}
@@ -0,0 +1,81 @@
+#ifndef PHHEPMC_HEPMCBINARYCACHE_H
+#define PHHEPMC_HEPMCBINARYCACHE_H
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace HepMC
+{
+  class GenEvent;
+}  // namespace HepMC
+
+//! binary copy of a HepMC2 ASCII file which is read back without parsing text
+/*!
+ * The cache starts with a header identifying the source file by name, size and
+ * modification time, followed by one length prefixed record per event. Each
+ * record stores the event header, the vertices and the particles with their
+ * barcodes and the order of the particles attached to each vertex, so the
+ * decoded GenEvent is identical to the one read from the text file.
+ * The data is written in the byte order of the machine, the cache is meant
+ * to be local scratch space and not to be shipped around.
+ */
+namespace HepMCBinaryCache
+{
+  //! name of the cache file for source inside the cache directory,
+  //! the source basename plus a hash of its full path
+  std::string CacheFileName(const std::string &cachedir, const std::string &source);
+}  // namespace HepMCBinaryCache
+
+//! writes the events of a source file into a new cache
+/*!
+ * Events go into a temporary file which is renamed to the cache file by
+ * Commit(), so readers never see a partial cache. If the writer is deleted
+ * without Commit() the temporary file is removed.
+ */
+class HepMCBinaryCacheWriter
+{
+ public:
+  HepMCBinaryCacheWriter(const std::string &cachefile, const std::string &source);
+  ~HepMCBinaryCacheWriter();
+
+  HepMCBinaryCacheWriter(const HepMCBinaryCacheWriter &) = delete;
+  HepMCBinaryCacheWriter &operator=(const HepMCBinaryCacheWriter &) = delete;
+
+  //! false once writing failed or an event cannot be stored exactly
+  bool IsGood() const { return m_Good; }
+  bool Write(const HepMC::GenEvent *evt);
+  bool Commit();
+  void Discard();
+
+ private:
+  std::string m_CacheFile;
+  std::string m_TmpFile;
+  std::ofstream m_Out;
+  std::vector<char> m_Buffer;
+  bool m_Good = false;
+};
+
+//! reads the events of a memory mapped cache
+class HepMCBinaryCacheReader
+{
+ public:
+  HepMCBinaryCacheReader(const std::string &cachefile, const std::string &source);
+  ~HepMCBinaryCacheReader();
+
+  HepMCBinaryCacheReader(const HepMCBinaryCacheReader &) = delete;
+  HepMCBinaryCacheReader &operator=(const HepMCBinaryCacheReader &) = delete;
+
+  //! false if the cache does not exist or does not belong to the source file
+  bool IsOpen() const { return m_Data != nullptr; }
+  //! returns nullptr at the end of the cache
+  HepMC::GenEvent *ReadNextEvent();
+
+ private:
+  const char *m_Data = nullptr;
+  std::size_t m_Size = 0;
+  std::size_t m_Offset = 0;
+};
+
+#endif /* PHHEPMC_HEPMCBINARYCACHE_H */
@@ -3,8 +3,12 @@
 
 #include "OfflinePacketv1.h"
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <span>
 
 class CaloPacket : public OfflinePacketv1
 {
@@ -72,6 +76,45 @@ class CaloPacket : public OfflinePacketv1
   virtual uint32_t getFemStatus(const int /*i*/) const { return 0; }
   virtual void setFemStatus(const int /*i*/, const uint32_t /*ival*/) { return; }
 
+  // copies the waveforms of channels [0, nchannels) in one call into a caller owned
+  // buffer laid out as buffer[channel * nsamples + sample]. For zero suppressed
+  // channels only pre and post are stored (first two samples) and the bit of the
+  // channel is set in suppressed (64 channels per word), the other bits are cleared.
+  // Returns the number of channels copied, limited by the sizes of buffer and suppressed
+  virtual int fillWaveforms(std::span<float> buffer, const int nchannels, const int nsamples, std::span<uint64_t> suppressed) const
+  {
+    int nfill = fillWaveformsLimit(buffer, nchannels, nsamples, suppressed);
+    for (int channel = 0; channel < nfill; channel++)
+    {
+      float *waveform = buffer.data() + static_cast<std::size_t>(channel) * nsamples;
+      if (getSuppressed(channel))
+      {
+        suppressed[channel / 64] |= uint64_t{1} << (channel % 64);
+        waveform[0] = getPre(channel);
+        waveform[1] = getPost(channel);
+        continue;
+      }
+      for (int samp = 0; samp < nsamples; samp++)
+      {
+        waveform[samp] = iValue(samp, channel);
+      }
+    }
+    return nfill;
+  }
+
+ protected:
+  // number of channels fillWaveforms() can copy, clears the used words of suppressed
+  static int fillWaveformsLimit(std::span<float> buffer, const int nchannels, const int nsamples, std::span<uint64_t> suppressed)
+  {
+    if (nchannels <= 0 || nsamples < 2)
+    {
+      return 0;
+    }
+    std::size_t nfill = std::min({static_cast<std::size_t>(nchannels), buffer.size() / nsamples, suppressed.size() * 64});
+    std::fill_n(suppressed.begin(), (nfill + 63) / 64, 0);
+    return static_cast<int>(nfill);
+  }
+
  private:
   ClassDefOverride(CaloPacket, 1)
 };
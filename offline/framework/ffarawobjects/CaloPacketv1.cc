@@ -6,6 +6,7 @@
 
 #include <TSystem.h>
 
+#include <algorithm>
 #include <iomanip>
 
 CaloPacketv1::CaloPacketv1()
@@ -245,6 +246,40 @@ int CaloPacketv1::iValue(const int sample, const int channel) const
   return samples.at(sample).at(channel);
 }
 
+// samples are stored sample major, the loops run over the channels of
+// one sample so the reads are contiguous
+int CaloPacketv1::fillWaveforms(std::span<float> buffer, const int nchannels, const int nsamples, std::span<uint64_t> suppressed) const
+{
+  int nfill = std::min(fillWaveformsLimit(buffer, nchannels, nsamples, suppressed), MAX_NUM_CHANNELS);
+  int nstored = std::min(nsamples, MAX_NUM_SAMPLES);
+  for (int samp = 0; samp < nstored; samp++)
+  {
+    const std::array<uint32_t, MAX_NUM_CHANNELS> &row = samples[samp];
+    for (int channel = 0; channel < nfill; channel++)
+    {
+      buffer[static_cast<size_t>(channel) * nsamples + samp] = row[channel];
+    }
+  }
+  for (int samp = nstored; samp < nsamples; samp++)
+  {
+    for (int channel = 0; channel < nfill; channel++)
+    {
+      buffer[static_cast<size_t>(channel) * nsamples + samp] = 0;
+    }
+  }
+  // zero suppressed channels carry pre and post instead of the samples
+  for (int channel = 0; channel < nfill; channel++)
+  {
+    if (isZeroSuppressed[channel])
+    {
+      suppressed[channel / 64] |= uint64_t{1} << (channel % 64);
+      buffer[static_cast<size_t>(channel) * nsamples] = pre[channel];
+      buffer[static_cast<size_t>(channel) * nsamples + 1] = post[channel];
+    }
+  }
+  return nfill;
+}
+
 void CaloPacketv1::identify(std::ostream &os) const
 {
   os << "CaloPacketv1: " << std::endl;
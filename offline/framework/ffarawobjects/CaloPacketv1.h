@@ -76,6 +76,8 @@ class CaloPacketv1 : public CaloPacket
   uint32_t getFemStatus(const int i) const override { return femstatus.at(i); }
   void setFemStatus(const int i, const uint32_t ival) override { femstatus.at(i) = ival; }
 
+  int fillWaveforms(std::span<float> buffer, const int nchannels, const int nsamples, std::span<uint64_t> suppressed) const override;
+
  protected:
   int PacketEvtSequence{0};
   int NrChannels{0};
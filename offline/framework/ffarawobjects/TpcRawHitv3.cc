@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <iostream>
+#include <utility>
 
 TpcRawHitv3::TpcRawHitv3(TpcRawHit *tpchit)
 {
@@ -104,18 +105,13 @@ void TpcRawHitv3::Clear(Option_t * /*unused*/)
   checksumerror = true;
   parityerror = true;
 
-  for (auto &waveform : m_adcData)
-  {
-    waveform.second.clear();
-    waveform.second.shrink_to_fit();
-  }
+  // keep the capacity, hits are recycled by the time frame builder
   m_adcData.clear();
-  m_adcData.shrink_to_fit();
 
   // std::cout << __PRETTY_FUNCTION__ << " - m_adcData.capacity = "<<m_adcData.capacity() << std::endl;
 }
 
 void TpcRawHitv3::move_adc_waveform(const uint16_t start_time, std::vector<uint16_t> &&adc)
 {
-  m_adcData.emplace_back(start_time, adc);
+  m_adcData.emplace_back(start_time, std::move(adc));
 }
@@ -125,6 +125,7 @@ int Fun4AllDstInputManager::fileopen(const std::string &filenam)
   // now open the dst node
   dstNode = se->getNode(InputNode(), TopNodeName());
   m_IManager = new PHNodeIOManager(fullfilename, PHReadOnly);
+  m_IManager->LazyRead(m_LazyRead);
   if (m_IManager->isFunctional())
   {
     IsOpen(1);
@@ -219,6 +220,14 @@ int Fun4AllDstInputManager::fileclose()
     std::cout << Name() << ": fileclose: No Input file open" << std::endl;
     return -1;
   }
+  if (m_LazyRead)
+  {
+    for (const auto &iter : m_IManager->LazyReadCounts())
+    {
+      m_LazyReadCounts[iter.first] += iter.second;
+    }
+    m_LazyReadEvents += m_IManager->LazyReadEvents();
+  }
   delete m_IManager;
   m_IManager = nullptr;
   IsOpen(0);
@@ -477,6 +486,8 @@ readnextsync:
     if (m_IManager->read(dstNode))
     {
       itest = 1;
+      // a lazily read sync object is only filled when it is accessed
+      syncobject = findNode::getClass<SyncObject>(dstNode, syncdefs::SYNCNODENAME);
     }
     else
     {
@@ -654,3 +665,43 @@ int Fun4AllDstInputManager::HasSyncObject() const
   }
   return 0;
 }
+
+int Fun4AllDstInputManager::End()
+{
+  if (!m_LazyRead)
+  {
+    return 0;
+  }
+  std::map<std::string, uint64_t> counts = m_LazyReadCounts;
+  uint64_t nevents = m_LazyReadEvents;
+  if (m_IManager)
+  {
+    for (const auto &iter : m_IManager->LazyReadCounts())
+    {
+      counts[iter.first] += iter.second;
+    }
+    nevents += m_IManager->LazyReadEvents();
+  }
+  std::cout << Name() << ": lazy reading of " << nevents << " events" << std::endl;
+  std::vector<std::string> unread;
+  for (const auto &iter : counts)
+  {
+    if (iter.second > 0)
+    {
+      std::cout << "  " << iter.first << " read in " << iter.second << " events" << std::endl;
+    }
+    else
+    {
+      unread.push_back(iter.first);
+    }
+  }
+  if (!unread.empty())
+  {
+    std::cout << Name() << ": branches which were never read (deselect them with BranchSelect):" << std::endl;
+    for (const auto &branch : unread)
+    {
+      std::cout << "  " << branch << std::endl;
+    }
+  }
+  return 0;
+}
@@ -7,6 +7,7 @@
 
 #include <phool/PHNodeIOManager.h>
 
+#include <cstdint>
 #include <map>
 #include <string>
 
@@ -31,6 +32,12 @@ class Fun4AllDstInputManager : public Fun4AllInputManager
   void Print(const std::string &what = "ALL") const override;
   int PushBackEvents(const int i) override;
   int HasSyncObject() const override;
+  int End() override;
+  // read only the branches whose nodes are accessed in an event, modules which keep
+  // pointers to input objects across events instead of using findNode::getClass
+  // every event will see stale data. The branches which were never read are
+  // listed in End()
+  void LazyRead(const bool b = true) { m_LazyRead = b; }
 
  protected:
   int ReadNextEventSyncObject();
@@ -58,6 +65,10 @@ class Fun4AllDstInputManager : public Fun4AllInputManager
   int events_thisfile{0};
   int events_skipped_during_sync{0};
   int m_HaveSyncObject{0};
+  bool m_LazyRead{false};
+  uint64_t m_LazyReadEvents{0};
+  // number of events each branch was read in, summed over closed files
+  std::map<std::string, uint64_t> m_LazyReadCounts;
   std::map<const std::string, int> branchread;
   std::string syncbranchname;
   std::string RunNode{"RUN"};
@@ -6,17 +6,56 @@
 #include <phool/PHNode.h>
 #include <phool/PHNodeIOManager.h>
 #include <phool/PHNodeIterator.h>
+#include <phool/PHPointerListIterator.h>
 #include <phool/phool.h>  // for PHWHERE, PHReadOnly, PHRunTree
 #include <phool/recoConsts.h>
 
+#include <TROOT.h>
 #include <TSystem.h>
 
 #include <cstdlib>
 #include <filesystem>
 #include <format>
 #include <iostream>
+#include <set>
 #include <string>
 
+namespace
+{
+  // copy the persistent data nodes below from into to, keeping the tree structure
+  // returns the name of the first node which cannot be copied or an empty string
+  std::string copy_persistent(PHCompositeNode *from, PHCompositeNode *to)
+  {
+    PHNodeIterator iter(from);
+    PHPointerListIterator<PHNode> nodeiter(iter.ls());
+    PHNode *thisNode;
+    while ((thisNode = nodeiter()))
+    {
+      if (thisNode->getType() == "PHCompositeNode")
+      {
+        PHCompositeNode *newcomp = new PHCompositeNode(thisNode->getName());
+        to->addNode(newcomp);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+        std::string failed = copy_persistent(static_cast<PHCompositeNode *>(thisNode), newcomp);
+        if (!failed.empty())
+        {
+          return failed;
+        }
+      }
+      else if (thisNode->getType() == "PHIODataNode" && thisNode->isPersistent())
+      {
+        PHNode *newnode = thisNode->copyForWrite();
+        if (!newnode)
+        {
+          return thisNode->getName();
+        }
+        to->addNode(newnode);
+      }
+    }
+    return "";
+  }
+}  // namespace
+
 Fun4AllDstOutputManager::Fun4AllDstOutputManager(const std::string &myname, const std::string &filename)
   : Fun4AllOutputManager(myname, filename)
 {
@@ -25,7 +64,8 @@ Fun4AllDstOutputManager::Fun4AllDstOutputManager(const std::string &myname, cons
 
 Fun4AllDstOutputManager::~Fun4AllDstOutputManager()
 {
-  delete dstOut;
+  StopWriter();
+  DeleteDstOut();
   return;
 }
 
@@ -92,6 +132,10 @@ void Fun4AllDstOutputManager::Print(const std::string &what) const
       }
     }
   }
+  if (what == "ALL" && m_CompressionThreads > 1)
+  {
+    std::cout << Name() << ": compressing with " << m_CompressionThreads << " threads" << std::endl;
+  }
   // base class print method
   Fun4AllOutputManager::Print(what);
 
@@ -171,7 +215,12 @@ int Fun4AllDstOutputManager::Write(PHCompositeNode *startNode)
       }
     }
   }
-  dstOut->write(startNode);
+  unsigned int depth = Fun4AllServer::instance()->PipelineDepth();
+  if (!depth || m_NoCopy || !QueueWrite(startNode, depth))
+  {
+    FlushWrites();
+    dstOut->write(startNode);
+  }
   // to save some cpu cycles we only make it globally transient if
   // all nodes have been written (savenodes set is empty)
   // else we only make the nodes transient which we have written (all
@@ -197,6 +246,8 @@ int Fun4AllDstOutputManager::Write(PHCompositeNode *startNode)
 
 int Fun4AllDstOutputManager::WriteNode(PHCompositeNode *thisNode)
 {
+  // all events have to be in the file before it is closed
+  FlushWrites();
   if (!m_SaveRunNodeFlag)
   {
     dstOut = nullptr;
@@ -227,7 +278,7 @@ int Fun4AllDstOutputManager::WriteNode(PHCompositeNode *thisNode)
       return 0;
     }
   }
-  delete dstOut;
+  DeleteDstOut();
 
   if (UsedOutFileName().empty())
   {
@@ -311,7 +362,9 @@ int Fun4AllDstOutputManager::WriteNode(PHCompositeNode *thisNode)
 
 int Fun4AllDstOutputManager::outfile_open_first_write()
 {
-  delete dstOut;
+  FlushWrites();
+  DeleteDstOut();
+  m_NoCopy = false;
   SetEventsWritten(1);  // this is the first event we write, need to set the number to 1
   std::filesystem::path p = OutFileName();
   if (m_FileNameStem.empty())
@@ -355,9 +408,124 @@ int Fun4AllDstOutputManager::outfile_open_first_write()
   }
 
   dstOut->SetCompressionSetting(m_CompressionSetting);
+  if (m_CompressionThreads > 1)
+  {
+    // the implicit MT pool is global, the first one to enable it sets its size
+    if (!ROOT::IsImplicitMTEnabled())
+    {
+      ROOT::EnableImplicitMT(m_CompressionThreads);
+    }
+    dstOut->ImplicitMT(true);
+  }
   return 0;
 }
 
+// copy the persistent nodes and hand the copy to the writer thread,
+// blocks if depth events are already waiting to be written.
+// Returns false if a node cannot be copied (its class does not implement
+// CloneMe()), then the caller has to write synchronously
+bool Fun4AllDstOutputManager::QueueWrite(PHCompositeNode *startNode, const unsigned int depth)
+{
+  PHCompositeNode *copy = new PHCompositeNode(startNode->getName());
+  std::string failed = copy_persistent(startNode, copy);
+  if (!failed.empty())
+  {
+    delete copy;
+    // do not try again for every event, the node tree does not change within a file
+    std::cout << PHWHERE << Name() << ": Node " << failed
+              << " cannot be copied, writing " << OutFileName()
+              << " without pipelining" << std::endl;
+    m_NoCopy = true;
+    return false;
+  }
+  if (!m_WriterThread.joinable())
+  {
+    ROOT::EnableThreadSafety();
+    m_StopWriter = false;
+    m_WriterThread = std::thread(&Fun4AllDstOutputManager::WriterLoop, this);
+  }
+  std::unique_lock<std::mutex> lock(m_WriteMutex);
+  m_WriteCondition.wait(lock, [this, depth]
+                        { return m_WriteQueue.size() < depth; });
+  m_WriteQueue.push_back(copy);
+  m_WriteCondition.notify_all();
+  return true;
+}
+
+// wait until the writer thread has written all queued events
+void Fun4AllDstOutputManager::FlushWrites()
+{
+  std::unique_lock<std::mutex> lock(m_WriteMutex);
+  m_WriteCondition.wait(lock, [this]
+                        { return m_WriteQueue.empty(); });
+}
+
+void Fun4AllDstOutputManager::StopWriter()
+{
+  if (!m_WriterThread.joinable())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_WriteMutex);
+    m_StopWriter = true;
+  }
+  m_WriteCondition.notify_all();
+  m_WriterThread.join();
+}
+
+// the queue entry is only removed after it was written, so an empty
+// queue means the writer is idle and dstOut can be touched again
+void Fun4AllDstOutputManager::WriterLoop()
+{
+  while (true)
+  {
+    PHCompositeNode *copy = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(m_WriteMutex);
+      m_WriteCondition.wait(lock, [this]
+                            { return m_StopWriter || !m_WriteQueue.empty(); });
+      if (m_WriteQueue.empty())
+      {
+        return;
+      }
+      copy = m_WriteQueue.front();
+    }
+    size_t evtno = dstOut->getEventNumber();
+    dstOut->write(copy);
+    m_WrittenCopies[evtno] = copy;
+    // branches of nodes which were missing in this event still point into
+    // the copy they were last written from, only those copies are kept
+    std::set<size_t> inuse = dstOut->EventsInUse();
+    for (auto iter = m_WrittenCopies.begin(); iter != m_WrittenCopies.end();)
+    {
+      if (inuse.contains(iter->first))
+      {
+        ++iter;
+        continue;
+      }
+      delete iter->second;
+      iter = m_WrittenCopies.erase(iter);
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_WriteMutex);
+      m_WriteQueue.pop_front();
+    }
+    m_WriteCondition.notify_all();
+  }
+}
+
+void Fun4AllDstOutputManager::DeleteDstOut()
+{
+  delete dstOut;
+  dstOut = nullptr;
+  for (auto &iter : m_WrittenCopies)
+  {
+    delete iter.second;
+  }
+  m_WrittenCopies.clear();
+}
+
 // this method figures out the last event number to be saved before rolling over
 // an integer div of the current event by the number of events gives the first event we can expect
 // in this process (this is not needed), then adding the number of events we want gives us the last event
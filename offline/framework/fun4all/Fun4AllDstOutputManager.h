@@ -5,8 +5,14 @@
 
 #include "Fun4AllOutputManager.h"
 
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 
 class PHNodeIOManager;
 class PHCompositeNode;
@@ -35,14 +41,34 @@ class Fun4AllDstOutputManager : public Fun4AllOutputManager
   int WriteNode(PHCompositeNode *thisNode) override;
   const std::string &UsedOutFileName() const { return m_UsedOutFileName; }
   void CompressionSetting(const int i) override { m_CompressionSetting = i; }
+  // compress the baskets with n threads (ROOT implicit MT), 0 or 1 compresses
+  // in the thread which writes the events
+  void CompressionThreads(const unsigned int n) { m_CompressionThreads = n; }
   void InitializeLastEvent(int eventnumber) override;
   
  private:
   int outfile_open_first_write();
+  // pipelined mode: the persistent nodes are copied and written by a separate thread
+  bool QueueWrite(PHCompositeNode *startNode, const unsigned int depth);
+  void FlushWrites();
+  void StopWriter();
+  void WriterLoop();
+  void DeleteDstOut();
   PHNodeIOManager *dstOut{nullptr};
+  // written copies by the event number of their write, kept as long as
+  // branches of the output tree point into them
+  std::map<size_t, PHCompositeNode *> m_WrittenCopies;
+  std::thread m_WriterThread;
+  std::mutex m_WriteMutex;
+  std::condition_variable m_WriteCondition;
+  std::deque<PHCompositeNode *> m_WriteQueue;
+  bool m_StopWriter{false};
+  // a node of the current output file cannot be copied, write it synchronously
+  bool m_NoCopy{false};
   int m_SaveRunNodeFlag{1};
   int m_SaveDstNodeFlag{1};
   int m_CompressionSetting{505};
+  unsigned int m_CompressionThreads{0};
   bool m_LastEventInitialized{false};
   std::string m_FileNameStem;
   std::string m_UsedOutFileName;
@@ -9,6 +9,7 @@
 #include "Fun4AllOutputManager.h"
 #include "Fun4AllReturnCodes.h"
 #include "Fun4AllSyncManager.h"
+#include "Fun4AllTaskScheduler.h"
 #include "SubsysReco.h"
 
 #include <phool/PHCompositeNode.h>
@@ -113,6 +114,7 @@ Fun4AllServer::~Fun4AllServer()
     delete TDirCollection.back();
     TDirCollection.pop_back();
   }
+  delete m_TaskScheduler;
   recoConsts *rc = recoConsts::instance();
   delete rc;
   delete ffamemtracker;
@@ -1158,6 +1160,13 @@ int Fun4AllServer::End()
     std::cout.copyfmt(m_saved_cout_state); // restore cout to default formatting
   }
   gROOT->cd(currdir.c_str());
+  for (auto &syncman : SyncManagers)
+  {
+    for (auto *inman : syncman->GetInputManagers())
+    {
+      i += inman->End();
+    }
+  }
   PHNodeIterator nodeiter(TopNode);
   PHCompositeNode *runNode = dynamic_cast<PHCompositeNode *>(nodeiter.findFirst("PHCompositeNode", "RUN"));
   if (!runNode)
@@ -1213,6 +1222,10 @@ int Fun4AllServer::End()
     std::cout << "*******************************************************************************" << std::endl;
     std::cout << "*******************************************************************************" << std::endl;
   }
+  if (m_TaskScheduler && Verbosity() > 0)
+  {
+    m_TaskScheduler->Print();
+  }
 
   return i;
 }
@@ -1243,6 +1256,17 @@ void Fun4AllServer::Print(const std::string &what) const
     std::cout << std::endl;
   }
 
+  if (what == "ALL" || what == "TASKSCHEDULER")
+  {
+    if (m_TaskScheduler)
+    {
+      std::cout << "--------------------------------------" << std::endl
+                << std::endl;
+      m_TaskScheduler->Print();
+      std::cout << std::endl;
+    }
+  }
+
   if (what == "ALL" || what == "INPUTMANAGER")
   {
     // the input managers are managed by the input singleton
@@ -1833,3 +1857,22 @@ int Fun4AllServer::UpdateRunNode()
   }
   return iret;
 }
+
+Fun4AllTaskScheduler *Fun4AllServer::TaskScheduler()
+{
+  if (!m_TaskScheduler)
+  {
+    m_TaskScheduler = new Fun4AllTaskScheduler("Fun4AllTaskScheduler", m_NumWorkerThreads);
+  }
+  return m_TaskScheduler;
+}
+
+void Fun4AllServer::NumWorkerThreads(const unsigned int n)
+{
+  m_NumWorkerThreads = n;
+  if (m_TaskScheduler)
+  {
+    m_TaskScheduler->NumWorkers(n);
+  }
+  return;
+}
@@ -20,6 +20,7 @@ class Fun4AllInputManager;
 class Fun4AllMemoryTracker;
 class Fun4AllSyncManager;
 class Fun4AllOutputManager;
+class Fun4AllTaskScheduler;
 class PHCompositeNode;
 class PHTimeStamp;
 class SubsysReco;
@@ -119,6 +120,15 @@ class Fun4AllServer : public Fun4AllBase
   int UpdateRunNode();
   void AddResetNodeName(const std::string &name) {ResetNodeList.emplace_back(name);}
 
+  //! shared worker pool for modules which process their data in parallel
+  Fun4AllTaskScheduler *TaskScheduler();
+  //! number of worker threads of the shared pool (0 = one per core)
+  void NumWorkerThreads(const unsigned int n);
+  //! overlap input reading and output writing with the processing of the current event.
+  //! depth is the number of events which may be buffered by the input/output threads (0 = off)
+  void Pipelined(const unsigned int depth) { m_PipelineDepth = depth; }
+  unsigned int PipelineDepth() const { return m_PipelineDepth; }
+
  protected:
   Fun4AllServer(const std::string &name = "Fun4AllServer");
   static int InitNodeTree(PHCompositeNode *topNode);
@@ -134,6 +144,7 @@ class Fun4AllServer : public Fun4AllBase
   PHTimeStamp *beginruntimestamp{nullptr};
   PHCompositeNode *TopNode{nullptr};
   Fun4AllSyncManager *defaultSyncManager{nullptr};
+  Fun4AllTaskScheduler *m_TaskScheduler{nullptr};
 
   int OutNodeCount{0};
   int bortime_override{0};
@@ -143,6 +154,8 @@ class Fun4AllServer : public Fun4AllBase
   int eventnumber{0};
   int eventcounter{0};
   int keep_db_connected{0};
+  unsigned int m_NumWorkerThreads{0};
+  unsigned int m_PipelineDepth{0};
   
   std::ios m_saved_cout_state{nullptr};
   std::vector<std::string> ComplaintList;
@@ -0,0 +1,268 @@
+#include "Fun4AllTaskScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+namespace
+{
+  // identifies the scheduler and queue index of the current worker thread,
+  // tasks submitted from a worker go to its own queue
+  thread_local const Fun4AllTaskScheduler *t_Scheduler = nullptr;
+  thread_local unsigned int t_QueueIndex = 0;
+
+  double elapsed_ms(const std::chrono::steady_clock::time_point &start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  // shared between the caller of parallel_for and the runner tasks
+  // runners which only start after the loop is done must not touch anything else
+  struct LoopState
+  {
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> done{0};
+    std::atomic<int64_t> busy_ns{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr exception;
+  };
+
+  void run_loop(LoopState &state, const std::size_t n, const std::function<void(std::size_t)> &func)
+  {
+    auto start = std::chrono::steady_clock::now();
+    std::size_t i;
+    while ((i = state.next.fetch_add(1)) < n)
+    {
+      try
+      {
+        func(i);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!state.exception)
+        {
+          state.exception = std::current_exception();
+        }
+      }
+      if (state.done.fetch_add(1) + 1 == n)
+      {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.finished.notify_all();
+      }
+    }
+    state.busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  }
+}  // namespace
+
+Fun4AllTaskScheduler::Fun4AllTaskScheduler(const std::string &name, const unsigned int nworkers)
+  : Fun4AllBase(name)
+{
+  StartWorkers(nworkers);
+}
+
+Fun4AllTaskScheduler::~Fun4AllTaskScheduler()
+{
+  StopWorkers();
+}
+
+void Fun4AllTaskScheduler::NumWorkers(const unsigned int n)
+{
+  StopWorkers();
+  StartWorkers(n);
+}
+
+void Fun4AllTaskScheduler::StartWorkers(const unsigned int n)
+{
+  unsigned int nworkers = n;
+  if (nworkers == 0)
+  {
+    nworkers = std::max(1U, std::thread::hardware_concurrency());
+  }
+  if (Verbosity() > 0)
+  {
+    std::cout << Name() << ": starting " << nworkers << " worker threads" << std::endl;
+  }
+  m_Stop = false;
+  m_Pending = 0;
+  for (unsigned int i = 0; i < nworkers; ++i)
+  {
+    m_Queues.emplace_back(std::make_unique<WorkerQueue>());
+  }
+  for (unsigned int i = 0; i < nworkers; ++i)
+  {
+    m_Workers.emplace_back(&Fun4AllTaskScheduler::WorkerLoop, this, i);
+  }
+}
+
+void Fun4AllTaskScheduler::StopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_WakeMutex);
+    m_Stop = true;
+  }
+  m_WakeCondition.notify_all();
+  // workers drain all queued tasks before they exit
+  for (auto &worker : m_Workers)
+  {
+    worker.join();
+  }
+  m_Workers.clear();
+  m_Queues.clear();
+}
+
+void Fun4AllTaskScheduler::WorkerLoop(const unsigned int index)
+{
+  t_Scheduler = this;
+  t_QueueIndex = index;
+  std::function<void()> task;
+  while (true)
+  {
+    if (Pop(index, task) || Steal(index, task))
+    {
+      --m_Pending;
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_WakeMutex);
+    m_WakeCondition.wait(lock, [this]
+                         { return m_Stop || m_Pending > 0; });
+    if (m_Stop && m_Pending == 0)
+    {
+      return;
+    }
+  }
+}
+
+void Fun4AllTaskScheduler::Push(std::function<void()> task)
+{
+  unsigned int index = (t_Scheduler == this) ? t_QueueIndex : (m_NextQueue++ % m_Queues.size());
+  {
+    std::lock_guard<std::mutex> lock(m_Queues[index]->mutex);
+    m_Queues[index]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_WakeMutex);
+    ++m_Pending;
+  }
+  m_WakeCondition.notify_one();
+}
+
+bool Fun4AllTaskScheduler::Pop(const unsigned int index, std::function<void()> &task)
+{
+  // own queue is worked on LIFO to keep the caches warm
+  WorkerQueue &queue = *m_Queues[index];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty())
+  {
+    return false;
+  }
+  task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  return true;
+}
+
+bool Fun4AllTaskScheduler::Steal(const unsigned int index, std::function<void()> &task)
+{
+  // others are robbed FIFO, the oldest task is the one least likely in their caches
+  for (unsigned int i = 1; i < m_Queues.size(); ++i)
+  {
+    WorkerQueue &queue = *m_Queues[(index + i) % m_Queues.size()];
+    std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+    if (!lock.owns_lock() || queue.tasks.empty())
+    {
+      continue;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+  }
+  return false;
+}
+
+std::future<void> Fun4AllTaskScheduler::submit(const std::string &client, std::function<void()> task)
+{
+  auto packaged = std::make_shared<std::packaged_task<void()>>(
+      [this, client, func = std::move(task)]()
+      {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        AddStats(client, 0, 1, 0, elapsed_ms(start));
+      });
+  std::future<void> result = packaged->get_future();
+  Push([packaged]()
+       { (*packaged)(); });
+  return result;
+}
+
+void Fun4AllTaskScheduler::parallel_for(const std::string &client, const std::size_t n, const std::function<void(std::size_t)> &func, const unsigned int maxconcurrency)
+{
+  if (n == 0)
+  {
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  // the caller is one of the threads working on the loop
+  std::size_t nthreads = std::min<std::size_t>(n, m_Workers.size() + 1);
+  if (maxconcurrency > 0)
+  {
+    nthreads = std::min<std::size_t>(nthreads, maxconcurrency);
+  }
+  auto state = std::make_shared<LoopState>();
+  for (std::size_t i = 1; i < nthreads; ++i)
+  {
+    Push([state, n, &func]()
+         { run_loop(*state, n, func); });
+  }
+  run_loop(*state, n, func);
+  {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state, n]
+                         { return state->done == n; });
+  }
+  AddStats(client, 1, n, elapsed_ms(start), state->busy_ns * 1e-6);
+  if (state->exception)
+  {
+    std::rethrow_exception(state->exception);
+  }
+}
+
+void Fun4AllTaskScheduler::AddStats(const std::string &client, const uint64_t loops, const uint64_t tasks, const double wall_ms, const double busy_ms)
+{
+  std::lock_guard<std::mutex> lock(m_StatsMutex);
+  ClientStats &stats = m_Stats[client];
+  stats.loops += loops;
+  stats.tasks += tasks;
+  stats.wall_ms += wall_ms;
+  stats.busy_ms += busy_ms;
+}
+
+void Fun4AllTaskScheduler::ResetStats()
+{
+  std::lock_guard<std::mutex> lock(m_StatsMutex);
+  m_Stats.clear();
+}
+
+void Fun4AllTaskScheduler::Print(const std::string & /*what*/) const
+{
+  std::lock_guard<std::mutex> lock(m_StatsMutex);
+  std::cout << Name() << ": " << m_Workers.size() << " worker threads" << std::endl;
+  for (const auto &[client, stats] : m_Stats)
+  {
+    std::cout << std::setw(30) << std::left << client << std::right
+              << " loops: " << stats.loops
+              << ", tasks: " << stats.tasks
+              << ", wall time: " << stats.wall_ms << " ms"
+              << ", cpu time: " << stats.busy_ms << " ms";
+    if (stats.wall_ms > 0)
+    {
+      std::cout << ", parallelism: " << stats.busy_ms / stats.wall_ms;
+    }
+    std::cout << std::endl;
+  }
+}
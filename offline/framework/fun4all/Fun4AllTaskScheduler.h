@@ -0,0 +1,91 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef FUN4ALL_FUN4ALLTASKSCHEDULER_H
+#define FUN4ALL_FUN4ALLTASKSCHEDULER_H
+
+#include "Fun4AllBase.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** Process wide pool of worker threads owned by the Fun4AllServer.
+ *
+ *  SubsysReco modules hand their parallel work to this scheduler
+ *  (Fun4AllServer::instance()->TaskScheduler()) instead of creating
+ *  their own threads, so all modules share one set of cores.
+ *  Every worker has its own task queue, idle workers steal from the
+ *  queues of busy ones. Statistics are kept per client (module) name.
+ */
+class Fun4AllTaskScheduler : public Fun4AllBase
+{
+ public:
+  //! nworkers = 0 uses std::thread::hardware_concurrency()
+  explicit Fun4AllTaskScheduler(const std::string &name = "Fun4AllTaskScheduler", const unsigned int nworkers = 0);
+  ~Fun4AllTaskScheduler() override;
+
+  //! (re)start the pool with n worker threads, 0 means one per core
+  void NumWorkers(const unsigned int n);
+  unsigned int NumWorkers() const { return m_Workers.size(); }
+
+  //! queue a single task, the returned future is ready once the task ran
+  std::future<void> submit(const std::string &client, std::function<void()> task);
+
+  /** call func(i) for i in [0, n), blocks until all calls are done.
+      The calling thread works on the loop as well, so this is safe to
+      call from within a task. maxconcurrency limits the number of threads
+      working on this loop (0 = no limit, 1 = run serially in the caller).
+      The first exception thrown by func is rethrown in the caller.
+  */
+  void parallel_for(const std::string &client, const std::size_t n, const std::function<void(std::size_t)> &func, const unsigned int maxconcurrency = 0);
+
+  void Print(const std::string &what = "ALL") const override;
+  void ResetStats();
+
+ private:
+  struct WorkerQueue
+  {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  struct ClientStats
+  {
+    uint64_t loops{0};
+    uint64_t tasks{0};
+    double wall_ms{0};
+    double busy_ms{0};
+  };
+
+  void StartWorkers(const unsigned int n);
+  void StopWorkers();
+  void WorkerLoop(const unsigned int index);
+  void Push(std::function<void()> task);
+  bool Pop(const unsigned int index, std::function<void()> &task);
+  bool Steal(const unsigned int index, std::function<void()> &task);
+  void AddStats(const std::string &client, const uint64_t loops, const uint64_t tasks, const double wall_ms, const double busy_ms);
+
+  std::vector<std::thread> m_Workers;
+  std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+
+  std::mutex m_WakeMutex;
+  std::condition_variable m_WakeCondition;
+  std::atomic<uint64_t> m_Pending{0};
+  std::atomic<unsigned int> m_NextQueue{0};
+  bool m_Stop{false};
+
+  mutable std::mutex m_StatsMutex;
+  std::map<std::string, ClientStats> m_Stats;
+};
+
+#endif
@@ -9,8 +9,35 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <vector>
 
+namespace
+{
+  // read the first nbytes of a local file and throw them away, this pulls
+  // them into the page cache. Remote urls (root://, dcap://,...) are skipped
+  void read_ahead(const std::string &filename, const uint64_t nbytes)
+  {
+    if (nbytes == 0 || filename.find("://") != std::string::npos)
+    {
+      return;
+    }
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(filename, ec))
+    {
+      return;
+    }
+    std::ifstream infile(filename, std::ios_base::in | std::ios_base::binary);
+    std::vector<char> buffer(4U * 1024U * 1024U);
+    uint64_t nread = 0;
+    while (infile && nread < nbytes)
+    {
+      infile.read(buffer.data(), static_cast<std::streamsize>(std::min<uint64_t>(buffer.size(), nbytes - nread)));
+      nread += static_cast<uint64_t>(infile.gcount());
+    }
+  }
+}  // namespace
+
 int InputFileHandler::AddFile(const std::string &filename)
 {
   if (GetVerbosity() > 0)
@@ -92,7 +119,14 @@ int InputFileHandler::OpenNextFile()
     {
       std::cout << PHWHERE << " opening next file: " << *iter << std::endl;
     }
-    if (!GetOpeningScript().empty())
+    if (m_PrefetchDepth > 0)
+    {
+      if (WaitForPrefetch(*iter))
+      {
+        std::cout << PHWHERE << " RunBeforeOpening() failed" << std::endl;
+      }
+    }
+    else if (!GetOpeningScript().empty())
     {
       std::vector<std::string> stringvec;
       stringvec.push_back(*iter);
@@ -112,6 +146,7 @@ int InputFileHandler::OpenNextFile()
     }
     else
     {
+      StartPrefetch();
       return InputFileHandlerReturnCodes::SUCCESS;
     }
   }
@@ -151,6 +186,7 @@ int InputFileHandler::ResetFileList()
     std::cout << "ResetFileList can only be used with filelists" << std::endl;
     return -1;
   }
+  ClearPrefetch();
   m_FileList.clear();
   m_FileList = m_FileListCopy;
   return 0;
@@ -198,3 +234,80 @@ int InputFileHandler::RunBeforeOpening(const std::vector<std::string> &stringvec
   }
   return static_cast<int> (iret);
 }
+
+// runs in a background thread, must not touch the file lists
+int InputFileHandler::Prefetch(const std::string &filename)
+{
+  int iret = 0;
+  if (!m_RunBeforeOpeningScript.empty())
+  {
+    iret = RunBeforeOpening({filename});
+  }
+  read_ahead(filename, m_PrefetchReadAhead);
+  return iret;
+}
+
+// the current file is the first one in the list, start the prefetch for
+// the following PrefetchDepth() files which are not prefetched yet
+void InputFileHandler::StartPrefetch()
+{
+  if (m_PrefetchDepth == 0 || m_FileList.empty())
+  {
+    return;
+  }
+  auto next = std::next(m_FileList.begin());
+  auto prefetched = m_Prefetches.begin();
+  for (unsigned int i = 0; i < m_PrefetchDepth && next != m_FileList.end(); ++i, ++next)
+  {
+    if (prefetched != m_Prefetches.end())
+    {
+      if (prefetched->first == *next)
+      {
+        ++prefetched;
+        continue;
+      }
+      // the file list changed underneath us, start over
+      ClearPrefetch();
+      prefetched = m_Prefetches.end();
+    }
+    if (GetVerbosity() > 1)
+    {
+      std::cout << PHWHERE << " prefetching " << *next << std::endl;
+    }
+    m_Prefetches.emplace_back(*next, std::async(std::launch::async, &InputFileHandler::Prefetch, this, *next));
+  }
+}
+
+// returns the return code of the opening script for filename, runs
+// it here if this file was not prefetched
+int InputFileHandler::WaitForPrefetch(const std::string &filename)
+{
+  if (!m_Prefetches.empty() && m_Prefetches.front().first == filename)
+  {
+    int iret = m_Prefetches.front().second.get();
+    m_Prefetches.pop_front();
+    return iret;
+  }
+  ClearPrefetch();
+  if (m_RunBeforeOpeningScript.empty())
+  {
+    return 0;
+  }
+  std::vector<std::string> stringvec;
+  stringvec.push_back(filename);
+  if (!m_FileName.empty())
+  {
+    stringvec.push_back(m_FileName);
+  }
+  return RunBeforeOpening(stringvec);
+}
+
+// waits for the running prefetches
+void InputFileHandler::ClearPrefetch()
+{
+  for (auto &prefetch : m_Prefetches)
+  {
+    prefetch.second.wait();
+  }
+  m_Prefetches.clear();
+}
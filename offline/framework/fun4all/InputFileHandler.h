@@ -2,8 +2,10 @@
 #define FUN4ALL_INPUTFILEHANDLER_H
 
 #include <cstdint>
+#include <future>
 #include <list>
 #include <string>
+#include <utility>
 #include <vector>
 
 class InputFileHandler
@@ -38,17 +40,35 @@ class InputFileHandler
   void SetOpeningScriptArgs(const std::string &args) { m_OpeningArgs = args; }
   const std::string &GetOpeningScriptArgs() const { return m_OpeningArgs; }
   int RunBeforeOpening(const std::vector<std::string> &stringvec);
+  // prefetch mode: while a file is processed the opening script is run for the
+  // next n files in the list in the background (with the file to be opened as
+  // only argument since the current file is still in use) and the first
+  // PrefetchReadAhead() bytes of these files are read into the page cache.
+  // The files are still opened in order by OpenNextFile()
+  void PrefetchDepth(const unsigned int n) { m_PrefetchDepth = n; }
+  unsigned int PrefetchDepth() const { return m_PrefetchDepth; }
+  void PrefetchReadAhead(const uint64_t nbytes) { m_PrefetchReadAhead = nbytes; }
+  uint64_t PrefetchReadAhead() const { return m_PrefetchReadAhead; }
 
  private:
+  int Prefetch(const std::string &filename);
+  void StartPrefetch();
+  int WaitForPrefetch(const std::string &filename);
+  void ClearPrefetch();
+
   int m_IsOpen{0};
   int m_Repeat{0};
   uint64_t m_Verbosity{0};
+  unsigned int m_PrefetchDepth{0};
+  uint64_t m_PrefetchReadAhead{0};
   std::string m_FileName;
   std::string m_RunBeforeOpeningScript;
   std::string m_OpeningArgs;
   std::list<std::string> m_FileList;
   std::list<std::string> m_FileListCopy;
   std::list<std::string> m_FileListOpened;  // all files which were opened during running
+  // running prefetches in the order of the file list, the result is the return code of the opening script
+  std::list<std::pair<std::string, std::future<int>>> m_Prefetches;
 };
 
 #endif
@@ -83,6 +83,11 @@ int Fun4AllPrdfInputManager::fileopen(const std::string &filenam)
   m_Segment = runseg.second;
   IsOpen(1);
   AddToFileOpened(fname);  // add file to the list of files which were opened
+  unsigned int depth = Fun4AllServer::instance()->PipelineDepth();
+  if (depth > 0)
+  {
+    StartReader(depth);
+  }
   return 0;
 }
 
@@ -123,7 +128,7 @@ readagain:
   }
   else
   {
-    m_Event = m_EventIterator->getNextEvent();
+    m_Event = NextEvent();
   }
   if (!m_Event || m_Event->getEvtType() == ENDRUNEVENT)
   {
@@ -164,6 +169,7 @@ int Fun4AllPrdfInputManager::fileclose()
     std::cout << Name() << ": fileclose: No Input file open" << std::endl;
     return -1;
   }
+  StopReader();
   delete m_EventIterator;
   m_EventIterator = nullptr;
   IsOpen(0);
@@ -222,7 +228,7 @@ int Fun4AllPrdfInputManager::PushBackEvents(const int i)
   int errorflag = 0;
   while (nevents > 0 && !errorflag)
   {
-    m_Event = m_EventIterator->getNextEvent();
+    m_Event = NextEvent();
     if (!m_Event)
     {
       std::cout << "Error after skipping " << i - nevents
@@ -286,6 +292,88 @@ int Fun4AllPrdfInputManager::SyncIt(const SyncObject *mastersync)
   return Fun4AllReturnCodes::SYNC_OK;
 }
 
+void Fun4AllPrdfInputManager::StartReader(const unsigned int depth)
+{
+  m_ReadDepth = depth;
+  m_StopReader = false;
+  m_ReaderDone = false;
+  m_ReaderThread = std::thread(&Fun4AllPrdfInputManager::ReaderLoop, this);
+}
+
+// stops the reader and deletes all events it read ahead
+void Fun4AllPrdfInputManager::StopReader()
+{
+  if (!m_ReaderThread.joinable())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_ReadMutex);
+    m_StopReader = true;
+  }
+  m_ReadCondition.notify_all();
+  m_ReaderThread.join();
+  for (auto *evt : m_ReadQueue)
+  {
+    delete evt;
+  }
+  m_ReadQueue.clear();
+}
+
+// the reader thread is the only one using the event iterator while it runs
+void Fun4AllPrdfInputManager::ReaderLoop()
+{
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_ReadMutex);
+      m_ReadCondition.wait(lock, [this]
+                           { return m_StopReader || m_ReadQueue.size() < m_ReadDepth; });
+      if (m_StopReader)
+      {
+        return;
+      }
+    }
+    Event *evt = m_EventIterator->getNextEvent();
+    if (evt)
+    {
+      // events can be views into the buffer of the iterator which is reused
+      // by the next getNextEvent(), give the queued event its own copy
+      evt->convert();
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_ReadMutex);
+      m_ReadQueue.push_back(evt);
+      m_ReaderDone = (evt == nullptr);
+    }
+    m_ReadCondition.notify_all();
+    if (!evt)
+    {
+      return;
+    }
+  }
+}
+
+Event *Fun4AllPrdfInputManager::NextEvent()
+{
+  if (!m_ReaderThread.joinable())
+  {
+    return m_EventIterator->getNextEvent();
+  }
+  std::unique_lock<std::mutex> lock(m_ReadMutex);
+  m_ReadCondition.wait(lock, [this]
+                       { return !m_ReadQueue.empty() || m_ReaderDone; });
+  if (m_ReadQueue.empty())
+  {
+    return nullptr;
+  }
+  Event *evt = m_ReadQueue.front();
+  m_ReadQueue.pop_front();
+  lock.unlock();
+  m_ReadCondition.notify_all();
+  return evt;
+}
+
 std::string Fun4AllPrdfInputManager::GetString(const std::string &what) const
 {
   if (what == "PRDFNODENAME")
@@ -5,7 +5,11 @@
 
 #include <fun4all/Fun4AllInputManager.h>
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
 
 class Event;
 class Eventiterator;
@@ -32,6 +36,12 @@ class Fun4AllPrdfInputManager : public Fun4AllInputManager
   std::string GetString(const std::string &what) const override;
 
  private:
+  // pipelined mode: a reader thread keeps up to depth events ready
+  void StartReader(const unsigned int depth);
+  void StopReader();
+  void ReaderLoop();
+  Event *NextEvent();
+
   int m_Segment = -999;
   int m_EventsTotal = 0;
   int m_EventsThisFile = 0;
@@ -41,6 +51,14 @@ class Fun4AllPrdfInputManager : public Fun4AllInputManager
   Eventiterator *m_EventIterator = nullptr;
   SyncObject *m_SyncObject = nullptr;
   std::string m_PrdfNodeName;
+  std::thread m_ReaderThread;
+  std::mutex m_ReadMutex;
+  std::condition_variable m_ReadCondition;
+  // a nullptr entry marks the end of the file
+  std::deque<Event *> m_ReadQueue;
+  unsigned int m_ReadDepth = 0;
+  bool m_StopReader = false;
+  bool m_ReaderDone = false;
 };
 
 #endif /* FUN4ALL_FUN4ALLPRDFINPUTMANAGER_H */
@@ -23,6 +23,7 @@
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <fun4all/Fun4AllServer.h>
 #include <fun4all/Fun4AllSyncManager.h>
+#include <fun4all/Fun4AllTaskScheduler.h>
 
 #include <ffaobjects/SyncObject.h>  // for SyncObject
 #include <ffaobjects/SyncObjectv1.h>
@@ -41,12 +42,39 @@
 
 #include <algorithm>  // for max
 #include <cassert>
+#include <chrono>
 #include <cstdint>  // for uint64_t, uint16_t
 #include <cstdlib>
 #include <format>
 #include <iostream>  // for operator<<, basic_ostream, endl
 #include <sstream>
 #include <utility>   // for pair
+#include <vector>
+
+namespace
+{
+  //! hits of one input decoded on a worker thread, added to the pools once all inputs are done
+  struct StagedHits
+  {
+    struct MvtxFeeId
+    {
+      uint64_t bclk{0};
+      uint16_t feeid{0};
+      uint32_t detField{0};
+    };
+
+    std::vector<std::pair<uint64_t, Gl1Packet *>> gl1;
+    std::vector<std::pair<uint64_t, InttRawHit *>> intt;
+    std::vector<std::pair<uint64_t, MicromegasRawHit *>> micromegas;
+    std::vector<std::pair<uint64_t, MvtxRawHit *>> mvtx;
+    std::vector<MvtxFeeId> mvtx_feeid;
+    std::vector<std::pair<uint64_t, uint64_t>> mvtx_l1trg;
+    std::vector<std::pair<uint64_t, TpcRawHit *>> tpc;
+  };
+
+  //! staging area of the input decoding in this thread, hits go directly to the pools if not set
+  thread_local StagedHits *t_staged_hits{nullptr};
+}  // namespace
 
 Fun4AllStreamingInputManager::Fun4AllStreamingInputManager(const std::string &name, const std::string &dstnodename, const std::string &topnodename)
   : Fun4AllInputManager(name, dstnodename, topnodename)
@@ -309,6 +337,19 @@ void Fun4AllStreamingInputManager::Print(const std::string &what) const
                 << std::endl;
     }
   }
+  if (what == "ALL" || what == "DECODE")
+  {
+    std::cout << "-----------------------------" << std::endl;
+    std::cout << "Decoding time per input (stall: time waiting for the slowest input of the same subsystem)" << std::endl;
+    for (const auto &[name, stats] : m_DecodeStats)
+    {
+      std::cout << name << ": fills: " << stats.fills
+                << ", decode: " << stats.decode_ms << " ms"
+                << ", stall: " << stats.stall_ms << " ms"
+                << ", slowest in " << stats.slowest << " fills"
+                << std::endl;
+    }
+  }
   Fun4AllInputManager::Print(what);
   return;
 }
@@ -485,6 +526,11 @@ void Fun4AllStreamingInputManager::registerStreamingInput(SingleStreamingInput *
 
 void Fun4AllStreamingInputManager::AddGl1RawHit(uint64_t bclk, Gl1Packet *hit)
 {
+  if (t_staged_hits)
+  {
+    t_staged_hits->gl1.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding gl1 hit to bclk 0x"
@@ -495,6 +541,11 @@ void Fun4AllStreamingInputManager::AddGl1RawHit(uint64_t bclk, Gl1Packet *hit)
 
 void Fun4AllStreamingInputManager::AddMvtxRawHit(uint64_t bclk, MvtxRawHit *hit)
 {
+  if (t_staged_hits)
+  {
+    t_staged_hits->mvtx.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding mvtx hit to bclk 0x"
@@ -505,6 +556,11 @@ void Fun4AllStreamingInputManager::AddMvtxRawHit(uint64_t bclk, MvtxRawHit *hit)
 
 void Fun4AllStreamingInputManager::AddMvtxFeeIdInfo(uint64_t bclk, uint16_t feeid, uint32_t detField)
 {
+  if (t_staged_hits)
+  {
+    t_staged_hits->mvtx_feeid.push_back({bclk, feeid, detField});
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding mvtx feeid info to bclk 0x"
@@ -519,6 +575,11 @@ void Fun4AllStreamingInputManager::AddMvtxFeeIdInfo(uint64_t bclk, uint16_t feei
 
 void Fun4AllStreamingInputManager::AddMvtxL1TrgBco(uint64_t bclk, uint64_t lv1Bco)
 {
+  if (t_staged_hits)
+  {
+    t_staged_hits->mvtx_l1trg.emplace_back(bclk, lv1Bco);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding mvtx L1Trg to bclk 0x"
@@ -529,6 +590,11 @@ void Fun4AllStreamingInputManager::AddMvtxL1TrgBco(uint64_t bclk, uint64_t lv1Bc
 
 void Fun4AllStreamingInputManager::AddInttRawHit(uint64_t bclk, InttRawHit *hit)
 {
+  if (t_staged_hits)
+  {
+    t_staged_hits->intt.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding intt hit to bclk 0x"
@@ -540,6 +606,11 @@ void Fun4AllStreamingInputManager::AddInttRawHit(uint64_t bclk, InttRawHit *hit)
 
 void Fun4AllStreamingInputManager::AddMicromegasRawHit(uint64_t bclk, MicromegasRawHit *hit)
 {
+  if (t_staged_hits)
+  {
+    t_staged_hits->micromegas.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding micromegas hit to bclk 0x"
@@ -550,6 +621,11 @@ void Fun4AllStreamingInputManager::AddMicromegasRawHit(uint64_t bclk, Micromegas
 
 void Fun4AllStreamingInputManager::AddTpcRawHit(uint64_t bclk, TpcRawHit *hit)
 {
+  if (t_staged_hits)
+  {
+    t_staged_hits->tpc.emplace_back(bclk, hit);
+    return;
+  }
   if (Verbosity() > 1)
   {
     std::cout << "Adding tpc hit to bclk 0x"
@@ -1416,8 +1492,10 @@ int Fun4AllStreamingInputManager::FillInttPool()
     {
       std::cout << "Fun4AllStreamingInputManager::FillInttPool - fill pool for " << iter->Name() << std::endl;
     }
-    iter->FillPool(ref_bco_minus_range);
-    // iter->FillPool();
+  }
+  FillPools(m_InttInputVector, ref_bco_minus_range);
+  for (auto *iter : m_InttInputVector)
+  {
     if (m_RunNumber == 0)
     {
       m_RunNumber = iter->RunNumber();
@@ -1453,13 +1531,16 @@ int Fun4AllStreamingInputManager::FillTpcPool()
     ref_bco_minus_range = m_RefBCO - m_tpc_negative_bco;
   }
 
-  for (auto *iter : m_TpcInputVector)
+  if (Verbosity() > 0)
   {
-    if (Verbosity() > 0)
+    for (auto *iter : m_TpcInputVector)
     {
       std::cout << "Fun4AllStreamingInputManager::FillTpcPool - fill pool for " << iter->Name() << std::endl;
     }
-    iter->FillPool(ref_bco_minus_range);
+  }
+  FillPools(m_TpcInputVector, ref_bco_minus_range);
+  for (auto *iter : m_TpcInputVector)
+  {
     const int fill_pool_status = iter->FillPoolStatus();
     if (fill_pool_status < 0)
     {
@@ -1501,13 +1582,16 @@ int Fun4AllStreamingInputManager::FillMicromegasPool()
     ref_bco_minus_range = m_RefBCO - m_micromegas_negative_bco;
   }
 
-  for (auto *iter : m_MicromegasInputVector)
+  if (Verbosity() > 0)
   {
-    if (Verbosity() > 0)
+    for (auto *iter : m_MicromegasInputVector)
     {
       std::cout << "Fun4AllStreamingInputManager::FillMicromegasPool - fill pool for " << iter->Name() << std::endl;
     }
-    iter->FillPool(ref_bco_minus_range);
+  }
+  FillPools(m_MicromegasInputVector, ref_bco_minus_range);
+  for (auto *iter : m_MicromegasInputVector)
+  {
     if (m_RunNumber == 0)
     {
       m_RunNumber = iter->RunNumber();
@@ -1538,13 +1622,16 @@ int Fun4AllStreamingInputManager::FillMicromegasPool()
 int Fun4AllStreamingInputManager::FillMvtxPool()
 {
   uint64_t ref_bco_minus_range = m_RefBCO < m_mvtx_negative_bco ? m_mvtx_negative_bco : m_RefBCO - m_mvtx_negative_bco;
-  for (auto *iter : m_MvtxInputVector)
+  if (Verbosity() > 3)
   {
-    if (Verbosity() > 3)
+    for (auto *iter : m_MvtxInputVector)
     {
       std::cout << "Fun4AllStreamingInputManager::FillMvtxPool - fill pool for " << iter->Name() << std::endl;
     }
-    iter->FillPool(ref_bco_minus_range);
+  }
+  FillPools(m_MvtxInputVector, ref_bco_minus_range);
+  for (auto *iter : m_MvtxInputVector)
+  {
     if (m_RunNumber == 0)
     {
       m_RunNumber = iter->RunNumber();
@@ -1571,6 +1658,94 @@ int Fun4AllStreamingInputManager::FillMvtxPool()
   }
   return 0;
 }
+void Fun4AllStreamingInputManager::FillPools(const std::vector<SingleStreamingInput *> &inputs, const uint64_t minbco)
+{
+  // every input decodes its own file on the shared worker pool, its hits are staged
+  // and added to the pools afterwards in input order, so the pools do not depend on thread scheduling
+  std::vector<StagedHits> staged(inputs.size());
+  std::vector<double> decode_ms(inputs.size(), 0);
+
+  // ROOT objects (e.g. the histograms of new TPC time frame builders) are not created
+  // on the workers, the inputs postpone that setup and are filled again below
+  for (auto *input : inputs)
+  {
+    input->DeferSetup(true);
+  }
+  Fun4AllServer::instance()->TaskScheduler()->parallel_for(
+      Name(), inputs.size(), [&](std::size_t i)
+      {
+        const auto start = std::chrono::steady_clock::now();
+        t_staged_hits = &staged[i];
+        inputs[i]->FillPool(minbco);
+        t_staged_hits = nullptr;
+        decode_ms[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); },
+      (Verbosity() > 0) ? 1 : m_DecodeConcurrency);
+
+  for (std::size_t i = 0; i < inputs.size(); ++i)
+  {
+    inputs[i]->DeferSetup(false);
+    if (inputs[i]->HasPendingSetup())
+    {
+      const auto start = std::chrono::steady_clock::now();
+      inputs[i]->CompletePendingSetup();
+      t_staged_hits = &staged[i];
+      inputs[i]->FillPool(minbco);
+      t_staged_hits = nullptr;
+      decode_ms[i] += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+  }
+
+  for (const auto &hits : staged)
+  {
+    for (const auto &[bclk, hit] : hits.gl1)
+    {
+      AddGl1RawHit(bclk, hit);
+    }
+    for (const auto &[bclk, hit] : hits.intt)
+    {
+      AddInttRawHit(bclk, hit);
+    }
+    for (const auto &[bclk, hit] : hits.micromegas)
+    {
+      AddMicromegasRawHit(bclk, hit);
+    }
+    for (const auto &[bclk, hit] : hits.mvtx)
+    {
+      AddMvtxRawHit(bclk, hit);
+    }
+    for (const auto &info : hits.mvtx_feeid)
+    {
+      AddMvtxFeeIdInfo(info.bclk, info.feeid, info.detField);
+    }
+    for (const auto &[bclk, lv1Bco] : hits.mvtx_l1trg)
+    {
+      AddMvtxL1TrgBco(bclk, lv1Bco);
+    }
+    for (const auto &[bclk, hit] : hits.tpc)
+    {
+      AddTpcRawHit(bclk, hit);
+    }
+  }
+
+  // stall accounting: the merge waits for the slowest input
+  if (inputs.empty())
+  {
+    return;
+  }
+  const auto slowest = std::max_element(decode_ms.begin(), decode_ms.end()) - decode_ms.begin();
+  for (std::size_t i = 0; i < inputs.size(); ++i)
+  {
+    auto &stats = m_DecodeStats[inputs[i]->Name()];
+    ++stats.fills;
+    stats.decode_ms += decode_ms[i];
+    stats.stall_ms += decode_ms[slowest] - decode_ms[i];
+    if (i == static_cast<std::size_t>(slowest) && inputs.size() > 1)
+    {
+      ++stats.slowest;
+    }
+  }
+}
+
 void Fun4AllStreamingInputManager::createQAHistos()
 {
   auto *hm = QAHistManagerDef::getHistoManager();
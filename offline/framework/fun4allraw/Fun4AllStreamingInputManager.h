@@ -69,6 +69,9 @@ class Fun4AllStreamingInputManager : public Fun4AllInputManager
   int FillTpcPool();
   void Streaming(bool b = true) { m_StreamingFlag = b; }
 
+  //! maximum number of inputs of a subsystem decoded concurrently (0 = no limit, 1 = serial in the calling thread)
+  void SetDecodeConcurrency(const unsigned int n) { m_DecodeConcurrency = n; }
+
   void runMvtxTriggered(bool b = true) { m_mvtx_is_triggered = b; }
 
   // configuration for INTT hit carry-over issue mitigation (hit duplication)
@@ -115,8 +118,20 @@ class Fun4AllStreamingInputManager : public Fun4AllInputManager
     unsigned int EventFoundCounter{0};
   };
 
+  //! per input decoding statistics
+  struct DecodeStats
+  {
+    uint64_t fills{0};
+    uint64_t slowest{0};
+    double decode_ms{0};
+    double stall_ms{0};
+  };
+
   void createQAHistos();
 
+  //! fill the pools of all inputs of one subsystem on the shared worker pool
+  void FillPools(const std::vector<SingleStreamingInput *> &inputs, const uint64_t minbco);
+
   SyncObject *m_SyncObject{nullptr};
   PHCompositeNode *m_topNode{nullptr};
 
@@ -131,6 +146,7 @@ class Fun4AllStreamingInputManager : public Fun4AllInputManager
   unsigned int m_mvtx_negative_bco{0};
   unsigned int m_tpc_bco_range{0};
   unsigned int m_tpc_negative_bco{0};
+  unsigned int m_DecodeConcurrency{0};
 
   bool m_gl1_registered_flag{false};
   bool m_intt_registered_flag{false};
@@ -151,6 +167,7 @@ class Fun4AllStreamingInputManager : public Fun4AllInputManager
   std::map<uint64_t, MvtxRawHitInfo> m_MvtxRawHitMap;
   std::map<uint64_t, TpcRawHitInfo> m_TpcRawHitMap;
   std::map<int, std::map<int, uint64_t>> m_InttPacketFeeBcoMap;
+  std::map<std::string, DecodeStats> m_DecodeStats;
 
   // QA histos
   TH1 *h_refbco_mvtx[12]{nullptr};
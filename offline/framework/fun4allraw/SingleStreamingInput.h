@@ -52,6 +52,17 @@ class SingleStreamingInput : public Fun4AllBase, public InputFileHandler
   virtual void ConfigureStreamingInputManager() { return; }
   virtual void SubsystemEnum(const int id) { m_SubsystemEnum = id; }
   virtual int SubsystemEnum() const { return m_SubsystemEnum; }
+
+  //! when set, FillPool runs on a worker thread and must not create ROOT objects
+  /** setup that needs them is postponed until CompletePendingSetup() is called from the calling thread */
+  void DeferSetup(const bool b) { m_DeferSetup = b; }
+  bool DeferSetup() const { return m_DeferSetup; }
+
+  //! true if FillPool stopped early because some setup was postponed
+  virtual bool HasPendingSetup() const { return false; }
+
+  //! do the postponed setup, FillPool has to be called again afterwards
+  virtual void CompletePendingSetup() {}
   void MaxBclkDiff(uint64_t ui) { m_MaxBclkSpread = ui; }
   uint64_t MaxBclkDiff() const { return m_MaxBclkSpread; }
   virtual const std::map<int, std::set<uint64_t>> &BclkStackMap() const { return m_BclkStackPacketMap; }
@@ -124,6 +135,7 @@ class SingleStreamingInput : public Fun4AllBase, public InputFileHandler
   int m_EventsThisFile{0};
   int m_AllDone{0};
   int m_SubsystemEnum{0};
+  bool m_DeferSetup{false};
   std::map<uint64_t, std::set<int>> m_BeamClockFEE;
   std::map<int, uint64_t> m_FEEBclkMap;
   std::set<uint64_t> m_BclkStack;
@@ -32,6 +32,7 @@
 #include <Event/Eventiterator.h>
 #include <Event/fileEventiterator.h>
 
+#include <atomic>
 #include <memory>
 #include <set>
 
@@ -114,14 +115,65 @@ SingleTpcTimeFrameInput::TimeTracker::~TimeTracker()
   }
 }
 
+TpcTimeFrameBuilderBase *SingleTpcTimeFrameInput::CreateBuilder(const int packet_id, const int hit_format)
+{
+  TpcTimeFrameBuilderBase *builder = nullptr;
+  if (hit_format == IDTPCFEEV4)
+  {
+    if (Verbosity() >= 1)
+    {
+      std::cout << __PRETTY_FUNCTION__ << ": Creating TpcTimeFrameBuilder for packet id: " << packet_id
+                << " hit format " << hit_format << std::endl;
+    }
+    builder = new TpcTimeFrameBuilder(packet_id);
+  }
+  else if (hit_format == IDTPCFEEV5 || hit_format == IDTPCFEEV6)
+  {
+    if (Verbosity() >= 1)
+    {
+      std::cout << __PRETTY_FUNCTION__ << ": Creating TpcTimeFrameBuilderRun3 for packet id: " << packet_id
+                << " hit format " << hit_format << std::endl;
+    }
+    builder = new TpcTimeFrameBuilderRun3(packet_id);
+  }
+  else
+  {
+    return nullptr;
+  }
+
+  m_TpcTimeFrameBuilderMap[packet_id] = builder;
+  m_TpcTimeFrameBuilderHitFormatMap[packet_id] = hit_format;
+  builder->setVerbosity(Verbosity());
+  builder->fillBadFeeMap();
+  if (!m_digitalCurrentDebugTTreeName.empty())
+  {
+    builder->SaveDigitalCurrentDebugTTree(m_digitalCurrentDebugTTreeName);
+  }
+  if (!m_bxCounterSyncCDBTTreeName.empty())
+  {
+    builder->SaveBXCounterSyncCDBTTree(m_bxCounterSyncCDBTTreeName);
+  }
+  return builder;
+}
+
+void SingleTpcTimeFrameInput::CompletePendingSetup()
+{
+  // unsupported hit formats are reported when the event is processed
+  for (const auto &[packet_id, hit_format] : m_PendingBuilders)
+  {
+    CreateBuilder(packet_id, hit_format);
+  }
+  m_PendingBuilders.clear();
+}
+
 void SingleTpcTimeFrameInput::FillPool(const uint64_t targetBCO)
 {
   m_FillPoolStatus = Fun4AllReturnCodes::EVENT_OK;
   {
-    static bool first = true;
-    if (first)
+    // inputs can be filled concurrently, only the first one prints
+    static std::atomic<bool> first = true;
+    if (first.exchange(false))
     {
-      first = false;
 
       if (!m_SelectedPacketIDs.empty())
       {
@@ -220,7 +272,13 @@ void SingleTpcTimeFrameInput::FillPool(const uint64_t targetBCO)
     }
 
     TimeTracker getNextEventTimer(m_getNextEventTimer, "getNextEvent", m_hNorm);
-    std::unique_ptr<Event> evt(GetEventiterator()->getNextEvent());
+
+    // an event put aside for postponed builder creation is processed first
+    std::unique_ptr<Event> evt = std::move(m_PendingEvent);
+    if (!evt)
+    {
+      evt.reset(GetEventiterator()->getNextEvent());
+    }
     while (!evt)
     {
       fileclose();
@@ -269,6 +327,31 @@ void SingleTpcTimeFrameInput::FillPool(const uint64_t targetBCO)
     }
     getNextEventTimer.stop();
 
+    // new packet ids need a time frame builder, which creates histograms.
+    // When running on a worker thread this is left to CompletePendingSetup,
+    // and the event is put aside until the next call
+    if (DeferSetup())
+    {
+      for (int i = 0; i < npackets; i++)
+      {
+        const int packet_id = plist[i]->getIdentifier();
+        if ((m_SelectedPacketIDs.empty() || m_SelectedPacketIDs.contains(packet_id)) && !m_TpcTimeFrameBuilderMap.contains(packet_id))
+        {
+          m_PendingBuilders[packet_id] = plist[i]->getHitFormat();
+        }
+      }
+      if (!m_PendingBuilders.empty())
+      {
+        for (int i = 0; i < npackets; i++)
+        {
+          delete plist[i];
+          plist[i] = nullptr;
+        }
+        m_PendingEvent = std::move(evt);
+        return;
+      }
+    }
+
     TimeTracker ProcessPacketTimer(m_ProcessPacketTimer, "ProcessPacket", m_hNorm);
     for (int i = 0; i < npackets; i++)
     {
@@ -316,49 +399,14 @@ void SingleTpcTimeFrameInput::FillPool(const uint64_t targetBCO)
         return;
       }
 
-      if (!m_TpcTimeFrameBuilderMap.contains(packet_id))
+      if (!m_TpcTimeFrameBuilderMap.contains(packet_id) && !CreateBuilder(packet_id, hit_format))
       {
-        TpcTimeFrameBuilderBase *builder = nullptr;
-        if (hit_format == IDTPCFEEV4)
-        {
-          if (Verbosity() >= 1)
-          {
-            std::cout << __PRETTY_FUNCTION__ << ": Creating TpcTimeFrameBuilder for packet id: " << packet_id
-                      << " hit format " << hit_format << std::endl;
-          }
-          builder = new TpcTimeFrameBuilder(packet_id);
-        }
-        else if (hit_format == IDTPCFEEV5 || hit_format == IDTPCFEEV6)
-        {
-          if (Verbosity() >= 1)
-          {
-            std::cout << __PRETTY_FUNCTION__ << ": Creating TpcTimeFrameBuilderRun3 for packet id: " << packet_id
-                      << " hit format " << hit_format << std::endl;
-          }
-          builder = new TpcTimeFrameBuilderRun3(packet_id);
-        }
-        else
-        {
-          std::cout << __PRETTY_FUNCTION__ << ": Error : unsupported TPC hit format " << hit_format
-                    << " for packet id " << packet_id << ". Aborting run." << std::endl;
-          packet->identify();
-          m_FillPoolStatus = Fun4AllReturnCodes::ABORTRUN;
-          cleanup_remaining_packets(i);
-          return;
-        }
-
-        m_TpcTimeFrameBuilderMap[packet_id] = builder;
-        m_TpcTimeFrameBuilderHitFormatMap[packet_id] = hit_format;
-        m_TpcTimeFrameBuilderMap[packet_id]->setVerbosity(Verbosity());
-        m_TpcTimeFrameBuilderMap[packet_id]->fillBadFeeMap();
-        if (!m_digitalCurrentDebugTTreeName.empty())
-        {
-          m_TpcTimeFrameBuilderMap[packet_id]->SaveDigitalCurrentDebugTTree(m_digitalCurrentDebugTTreeName);
-        }
-        if (!m_bxCounterSyncCDBTTreeName.empty())
-        {
-          m_TpcTimeFrameBuilderMap[packet_id]->SaveBXCounterSyncCDBTTree(m_bxCounterSyncCDBTTreeName);
-        }
+        std::cout << __PRETTY_FUNCTION__ << ": Error : unsupported TPC hit format " << hit_format
+                  << " for packet id " << packet_id << ". Aborting run." << std::endl;
+        packet->identify();
+        m_FillPoolStatus = Fun4AllReturnCodes::ABORTRUN;
+        cleanup_remaining_packets(i);
+        return;
       }
 
       if (Verbosity() > 1)
@@ -6,10 +6,12 @@
 #include <array>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+class Event;
 class TpcRawHit;
 class Packet;
 class TpcTimeFrameBuilderBase;
@@ -26,6 +28,8 @@ class SingleTpcTimeFrameInput : public SingleStreamingInput
   ~SingleTpcTimeFrameInput() override;
   void FillPool(const uint64_t targetBCO) override;
   int FillPoolStatus() const override { return m_FillPoolStatus; }
+  bool HasPendingSetup() const override { return !m_PendingBuilders.empty(); }
+  void CompletePendingSetup() override;
   void CleanupUsedPackets(const uint64_t bclk) override;
   // bool CheckPoolDepth(const uint64_t bclk) override;
   void ClearCurrentEvent() override;
@@ -49,6 +53,9 @@ class SingleTpcTimeFrameInput : public SingleStreamingInput
   }
 
  private:
+  //! create and configure the builder of a new packet id, nullptr if the hit format is not supported
+  TpcTimeFrameBuilderBase *CreateBuilder(const int packet_id, const int hit_format);
+
   const int NTPCPACKETS = 3;
 
   // in BCO, limit caching to a quarter of FEE clock rollover or 7ms, to avoid memory over usage when trigger jumped by a long time
@@ -64,6 +71,10 @@ class SingleTpcTimeFrameInput : public SingleStreamingInput
   std::map<int, int> m_TpcTimeFrameBuilderHitFormatMap;
   std::set<int> m_SelectedPacketIDs;
 
+  //! packet ID -> hit format of builders postponed by DeferSetup, and the event that needs them
+  std::map<int, int> m_PendingBuilders;
+  std::unique_ptr<Event> m_PendingEvent;
+
   TH1 *m_hNorm = nullptr;
 
   PHTimer *m_FillPoolTimer = nullptr;
@@ -0,0 +1,101 @@
+#ifndef FUN4ALLRAW_TPCFEEDATABUFFER_H
+#define FUN4ALLRAW_TPCFEEDATABUFFER_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace TpcFeeCrc16
+{
+  //! byte-wise lookup table of the reflected CRC-16 (polynomial 0xa001) used by the FEEs
+  inline constexpr std::array<uint16_t, 256> table = []()
+  {
+    std::array<uint16_t, 256> crctable{};
+    for (uint16_t byte = 0; byte < 256U; ++byte)
+    {
+      uint16_t crc = byte;
+      for (int k = 0; k < 8; ++k)
+      {
+        crc = crc & 1U ? static_cast<uint16_t>(crc >> 1U) ^ 0xa001U : crc >> 1U;
+      }
+      crctable[byte] = crc;
+    }
+    return crctable;
+  }();
+
+  //! add one bit reversed 16-bit word to the crc
+  /*! two table steps, low byte first, are equivalent to 16 single bit shifts */
+  inline uint16_t update(uint16_t crc, const uint16_t reversed)
+  {
+    crc = static_cast<uint16_t>(crc >> 8U) ^ table[(crc ^ reversed) & 0xffU];
+    crc = static_cast<uint16_t>(crc >> 8U) ^ table[(crc ^ static_cast<uint16_t>(reversed >> 8U)) & 0xffU];
+    return crc;
+  }
+}  // namespace TpcFeeCrc16
+
+//! FIFO of the 16-bit words received from a single TPC FEE
+/*!
+ * The DMA words of all FEEs are interleaved in a packet, so the stream of each
+ * FEE is reassembled here before decoding. Words are appended at the back and
+ * consumed from the front by advancing a read offset. The consumed head is only
+ * compacted away once it is larger than the unread data, which keeps the cost
+ * per word constant while the unread data is always one contiguous span.
+ */
+class TpcFeeDataBuffer
+{
+ public:
+  //! number of unread words
+  size_t size() const { return m_data.size() - m_head; }
+  bool empty() const { return m_head == m_data.size(); }
+
+  const uint16_t &operator[](const size_t i) const
+  {
+    assert(i < size());
+    return m_data[m_head + i];
+  }
+
+  //! unread words, valid until the next append
+  std::span<const uint16_t> view() const { return {m_data.data() + m_head, size()}; }
+
+  void append(std::span<const uint16_t> words)
+  {
+    if (m_head > 0 && m_head >= size())
+    {
+      compact();
+    }
+    m_data.insert(m_data.end(), words.begin(), words.end());
+  }
+
+  void pop_front() { consume(1); }
+
+  void consume(const size_t n)
+  {
+    assert(n <= size());
+    m_head += n;
+    if (m_head == m_data.size())
+    {
+      clear();
+    }
+  }
+
+  void clear()
+  {
+    m_data.clear();
+    m_head = 0;
+  }
+
+ private:
+  void compact()
+  {
+    m_data.erase(m_data.begin(), m_data.begin() + static_cast<std::ptrdiff_t>(m_head));
+    m_head = 0;
+  }
+
+  std::vector<uint16_t> m_data;
+  size_t m_head = 0;
+};
+
+#endif
@@ -24,6 +24,7 @@
 #include <TTree.h>
 #include <TVector3.h>
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <limits>
@@ -181,6 +182,11 @@ TpcTimeFrameBuilder::~TpcTimeFrameBuilder()
     }
   }
 
+  for (TpcRawHitv3* hit : m_rawHitPool)
+  {
+    delete hit;
+  }
+
   delete m_packetTimer;
 
   delete m_digitalCurrentDebugTTree;
@@ -269,7 +275,7 @@ std::vector<TpcRawHit*>& TpcTimeFrameBuilder::getTimeFrame(const uint64_t& gtm_b
       h_GTMClockDiff_Dropped->Fill(int64_t(it->first) - int64_t(bclk_rollover_corrected));
       for (const auto& hit : it->second)
       {
-        delete hit;
+        recycle_raw_hit(hit);
       }
       it = m_timeFrameMap.erase(it);
     }
@@ -368,7 +374,7 @@ void TpcTimeFrameBuilder::CleanupUsedPackets(const uint64_t& bclk)
     {
       while (!it->second.empty())
       {
-        delete it->second.back();
+        recycle_raw_hit(it->second.back());
         it->second.pop_back();
       }
       m_timeFrameMap.erase(it);
@@ -387,7 +393,7 @@ void TpcTimeFrameBuilder::CleanupUsedPackets(const uint64_t& bclk)
       while (!it->second.empty())
       {
         m_hFEEDataStream->Fill(it->second.back()->get_fee(), "HitUnusedBeforeCleanup", 1);
-        delete it->second.back();
+        recycle_raw_hit(it->second.back());
         it->second.pop_back();
         ++count;
       }
@@ -411,10 +417,38 @@ void TpcTimeFrameBuilder::CleanupUsedPackets(const uint64_t& bclk)
   }  //   for (auto it = m_timeFrameMap.begin(); it != m_timeFrameMap.end();)
 }
 
+TpcRawHitv3* TpcTimeFrameBuilder::new_raw_hit()
+{
+  if (m_rawHitPool.empty())
+  {
+    return new TpcRawHitv3();
+  }
+
+  TpcRawHitv3* hit = m_rawHitPool.back();
+  m_rawHitPool.pop_back();
+  return hit;
+}
+
+void TpcTimeFrameBuilder::recycle_raw_hit(TpcRawHit* hit)
+{
+  // all hits in the time frame map are created by new_raw_hit()
+  TpcRawHitv3* hitv3 = static_cast<TpcRawHitv3*>(hit);
+
+  // keep at most one time frame worth of hits for reuse
+  if (m_rawHitPool.size() >= kMaxRawHitLimit)
+  {
+    delete hitv3;
+    return;
+  }
+
+  hitv3->Clear(nullptr);
+  m_rawHitPool.push_back(hitv3);
+}
+
 int TpcTimeFrameBuilder::ProcessPacket(Packet* packet)
 {
-  static size_t call_count = 0;
-  ++call_count;
+  static std::atomic<size_t> packet_count = 0;
+  const size_t call_count = ++packet_count;
 
   if (m_verbosity > 1)
   {
@@ -527,7 +561,11 @@ int TpcTimeFrameBuilder::ProcessPacket(Packet* packet)
   }
 
   size_t dma_words_buffer = static_cast<size_t>(data_length) * 2 / DAM_DMA_WORD_LENGTH + 1;
-  std::vector<dma_word> buffer(dma_words_buffer);
+  std::vector<dma_word>& buffer = m_dmaBuffer;
+  if (buffer.size() < dma_words_buffer)
+  {
+    buffer.resize(dma_words_buffer);
+  }
 
   int l2 = 0;
   packet->fillIntArray(reinterpret_cast<int*>(buffer.data()), data_length + DAM_DMA_WORD_LENGTH / 2, &l2, "DATA");
@@ -607,10 +645,7 @@ int TpcTimeFrameBuilder::ProcessPacket(Packet* packet)
 
       if (fee_id < MAX_FEECOUNT)
       {
-        for (const uint16_t& i : dma_word_data.data)
-        {
-          m_feeData[fee_id].push_back(i);
-        }
+        m_feeData[fee_id].append(dma_word_data.data);
         m_hNorm->Fill("DMA_WORD_FEE", 1);
 
         // immediate fee buffer processing to reduce memory consuption
@@ -651,7 +686,7 @@ int TpcTimeFrameBuilder::ProcessPacket(Packet* packet)
 
       while (!timeframe.second.empty())
       {
-        delete timeframe.second.back();
+        recycle_raw_hit(timeframe.second.back());
         timeframe.second.pop_back();
       }
     }
@@ -674,7 +709,7 @@ int TpcTimeFrameBuilder::process_fee_data(unsigned int fee)
   }
 
   assert(fee < m_feeData.size());
-  std::deque<uint16_t>& data_buffer = m_feeData[fee];
+  TpcFeeDataBuffer& data_buffer = m_feeData[fee];
 
   while (HEADER_LENGTH <= data_buffer.size())
   {
@@ -749,13 +784,13 @@ int TpcTimeFrameBuilder::process_fee_data(unsigned int fee)
 
     if (is_digital_current)
     {
-      process_fee_data_digital_current(fee, data_buffer);
+      process_fee_data_digital_current(fee, data_buffer.view());
     }
     else
     {
-      process_fee_data_waveform(fee, data_buffer);
+      process_fee_data_waveform(fee, data_buffer.view());
     }
-    data_buffer.erase(data_buffer.begin(), data_buffer.begin() + pkt_length + 1);
+    data_buffer.consume(pkt_length + 1);
     m_hFEEDataStream->Fill(fee, "WordValid", pkt_length + 1);
 
   }  //     while (HEADER_LENGTH < data_buffer.size())
@@ -763,7 +798,7 @@ int TpcTimeFrameBuilder::process_fee_data(unsigned int fee)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
-void TpcTimeFrameBuilder::process_fee_data_waveform(const unsigned int& fee, std::deque<uint16_t>& data_buffer)
+void TpcTimeFrameBuilder::process_fee_data_waveform(const unsigned int& fee, std::span<const uint16_t> data_buffer)
 {
   const uint16_t& pkt_length = data_buffer[0];
 
@@ -924,16 +959,10 @@ void TpcTimeFrameBuilder::process_fee_data_waveform(const unsigned int& fee, std
 
     // Format is (N sample) (start time), (1st sample)... (Nth sample)
     size_t pos = HEADER_LENGTH;
-    std::deque<uint16_t>::const_iterator data_buffer_iterator = data_buffer.cbegin();
-    std::advance(data_buffer_iterator, pos);
     while (pos + 2 < pkt_length)
     {
-      const uint16_t& nsamp = *data_buffer_iterator;
-      ++pos;
-      ++data_buffer_iterator;
-      const uint16_t& start_t = *data_buffer_iterator;
-      ++pos;
-      ++data_buffer_iterator;
+      const uint16_t& nsamp = data_buffer[pos++];
+      const uint16_t& start_t = data_buffer[pos++];
       if (m_verbosity > 3)
       {
         std::cout << __PRETTY_FUNCTION__ << ": nsamp: " << nsamp
@@ -961,18 +990,13 @@ void TpcTimeFrameBuilder::process_fee_data_waveform(const unsigned int& fee, std
       }
 
       const unsigned int fee_sampa_address = fee * MAX_SAMPA + payload.sampa_address;
-      std::vector<uint16_t> adc(nsamp);
+      const auto samples = data_buffer.subspan(pos, nsamp);
       for (int j = 0; j < nsamp; j++)
       {
-        const uint16_t& adc_value = *data_buffer_iterator;
-
-        adc[j] = adc_value;
-        m_hFEESAMPAADC->Fill(start_t + j, fee_sampa_address, adc_value);
-
-        ++pos;
-        ++data_buffer_iterator;  // data_buffer[pos++];
+        m_hFEESAMPAADC->Fill(start_t + j, fee_sampa_address, samples[j]);
       }
-      payload.waveforms.emplace_back(start_t, std::move(adc));
+      pos += nsamp;
+      payload.waveforms.emplace_back(start_t, std::vector<uint16_t>(samples.begin(), samples.end()));
 
       //   // an exception to deal with the last sample that is missing in the current hit format
       //   if (pos + 1 == pkt_length) break;
@@ -992,7 +1016,7 @@ void TpcTimeFrameBuilder::process_fee_data_waveform(const unsigned int& fee, std
     // valid packet in the buffer, create a new hit
     if (payload.type != TpcTimeFrameBuilder::BcoMatchingInformation::HEARTBEAT_T)
     {
-      TpcRawHitv3* hit = new TpcRawHitv3();
+      TpcRawHitv3* hit = new_raw_hit();
       m_timeFrameMap[payload.gtm_bco].push_back(hit);
 
       hit->set_bco(payload.bx_timestamp);
@@ -1015,7 +1039,7 @@ void TpcTimeFrameBuilder::process_fee_data_waveform(const unsigned int& fee, std
   return;
 }
 
-void TpcTimeFrameBuilder::process_fee_data_digital_current(const unsigned int& fee, std::deque<uint16_t>& data_buffer)
+void TpcTimeFrameBuilder::process_fee_data_digital_current(const unsigned int& fee, std::span<const uint16_t> data_buffer)
 {
   if (m_verbosity > 2)
   {
@@ -1271,23 +1295,17 @@ uint16_t TpcTimeFrameBuilder::reverseBits(const uint16_t x) const
 
 std::pair<uint16_t, uint16_t> TpcTimeFrameBuilder::crc16_parity(const uint32_t fee, const uint16_t l) const
 {
-  const std::deque<uint16_t>& data_buffer = m_feeData[fee];
+  const std::span<const uint16_t> data_buffer = m_feeData[fee].view();
   assert(l < data_buffer.size());
 
-  std::deque<uint16_t>::const_iterator it = data_buffer.begin();
-
   uint16_t crc = 0xffffU;
   uint16_t data_parity = 0U;
 
-  for (int i = 0; i < l; ++i, ++it)
+  for (int i = 0; i < l; ++i)
   {
-    const uint16_t& x = *it;
+    const uint16_t& x = data_buffer[i];
 
-    crc ^= reverseBits(x);
-    for (uint16_t k = 0; k < 16U; k++)
-    {
-      crc = crc & 1U ? static_cast<uint16_t>(crc >> 1U) ^ 0xa001U : crc >> 1U;
-    }
+    crc = TpcFeeCrc16::update(crc, reverseBits(x));
 
     // parity on data payload only
     if (i >= HEADER_LENGTH)
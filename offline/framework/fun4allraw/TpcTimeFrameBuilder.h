@@ -1,11 +1,11 @@
 #ifndef Fun4All_TpcTimeFrameBuilder_H
 #define Fun4All_TpcTimeFrameBuilder_H
 
+#include "TpcFeeDataBuffer.h"
 #include "TpcTimeFrameBuilderBase.h"
 
 #include <algorithm>
 #include <cstdint>
-#include <deque>
 #include <functional>
 #include <iostream>
 #include <limits>
@@ -14,12 +14,14 @@
 #include <optional>
 #include <queue>
 #include <set>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
 
 class Packet;
 class TpcRawHit;
+class TpcRawHitv3;
 class PHTimer;
 class TH1;
 class TH2;
@@ -86,8 +88,13 @@ class TpcTimeFrameBuilder : public TpcTimeFrameBuilderBase
 
   int decode_gtm_data(const dma_word &gtm_word);
   int process_fee_data(unsigned int fee_id);
-  void process_fee_data_waveform(const unsigned int &fee_id, std::deque<uint16_t> &data_buffer);
-  void process_fee_data_digital_current(const unsigned int &fee_id, std::deque<uint16_t> &data_buffer);
+  void process_fee_data_waveform(const unsigned int &fee_id, std::span<const uint16_t> data_buffer);
+  void process_fee_data_digital_current(const unsigned int &fee_id, std::span<const uint16_t> data_buffer);
+
+  //! get a raw hit from the recycled pool, or allocate a new one
+  TpcRawHitv3 *new_raw_hit();
+  //! return a used raw hit to the pool
+  void recycle_raw_hit(TpcRawHit *hit);
 
   struct gtm_payload
   {
@@ -374,7 +381,13 @@ class TpcTimeFrameBuilder : public TpcTimeFrameBuilderBase
   };  //   class BcoMatchingInformation
 
  private:
-  std::vector<std::deque<uint16_t>> m_feeData;
+  std::vector<TpcFeeDataBuffer> m_feeData;
+
+  //! DMA words of the current packet, reused across packets
+  std::vector<dma_word> m_dmaBuffer;
+
+  //! used raw hits, cleared and ready to be reused by the decoder
+  std::vector<TpcRawHitv3 *> m_rawHitPool;
 
   std::map<int, std::set<int>> m_maskedFEEs;
 
@@ -24,6 +24,8 @@
 #include <TTree.h>
 #include <TVector3.h>
 
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <limits>
@@ -1260,8 +1262,8 @@ void TpcTimeFrameBuilderRun3::CleanupUsedPackets(const uint64_t& bclk)
 
 int TpcTimeFrameBuilderRun3::ProcessPacket(Packet* packet)
 {
-  static size_t call_count = 0;
-  ++call_count;
+  static std::atomic<size_t> packet_count = 0;
+  const size_t call_count = ++packet_count;
 
   if (m_verbosity > 1)
   {
@@ -1335,9 +1337,9 @@ int TpcTimeFrameBuilderRun3::ProcessPacket(Packet* packet)
       }
     }
     size_t total_fee_data = 0;
-    for (const auto& fee_data_deque : m_feeData)
+    for (const auto& fee_data_buffer : m_feeData)
     {
-      total_fee_data += fee_data_deque.size();
+      total_fee_data += fee_data_buffer.size();
     }
     size_t total_gtm_bco_trig = 0;
     size_t total_bco_heartbeat = 0;
@@ -1388,7 +1390,11 @@ int TpcTimeFrameBuilderRun3::ProcessPacket(Packet* packet)
   }
 
   size_t dma_words_buffer = static_cast<size_t>(data_length) * 2 / DAM_DMA_WORD_LENGTH + 1;
-  std::vector<dma_word> buffer(dma_words_buffer);
+  std::vector<dma_word>& buffer = m_dmaBuffer;
+  if (buffer.size() < dma_words_buffer)
+  {
+    buffer.resize(dma_words_buffer);
+  }
 
   int l2 = 0;
   packet->fillIntArray(reinterpret_cast<int*>(buffer.data()), data_length + DAM_DMA_WORD_LENGTH / 2, &l2, "DATA");
@@ -1468,10 +1474,7 @@ int TpcTimeFrameBuilderRun3::ProcessPacket(Packet* packet)
 
       if (fee_id < MAX_FEECOUNT)
       {
-        for (const uint16_t& i : dma_word_data.data)
-        {
-          m_feeData[fee_id].push_back(i);
-        }
+        m_feeData[fee_id].append(dma_word_data.data);
         m_hNorm->Fill("DMA_WORD_FEE", 1);
 
         // immediate fee buffer processing to reduce memory consuption
@@ -1513,9 +1516,9 @@ int TpcTimeFrameBuilderRun3::ProcessPacket(Packet* packet)
       }
     }
     size_t total_fee_data_post = 0;
-    for (const auto& fee_data_deque : m_feeData)
+    for (const auto& fee_data_buffer : m_feeData)
     {
-      total_fee_data_post += fee_data_deque.size();
+      total_fee_data_post += fee_data_buffer.size();
     }
     size_t total_gtm_bco_trig_post = 0;
     size_t total_bco_heartbeat_post = 0;
@@ -1580,9 +1583,9 @@ int TpcTimeFrameBuilderRun3::ProcessPacket(Packet* packet)
       }
     }
     size_t total_fee_data_final = 0;
-    for (const auto& fee_data_deque : m_feeData)
+    for (const auto& fee_data_buffer : m_feeData)
     {
-      total_fee_data_final += fee_data_deque.size();
+      total_fee_data_final += fee_data_buffer.size();
     }
     size_t total_gtm_bco_trig_final = 0;
     size_t total_bco_heartbeat_final = 0;
@@ -1620,7 +1623,7 @@ int TpcTimeFrameBuilderRun3::process_fee_data(unsigned int fee)
   }
 
   assert(fee < m_feeData.size());
-  std::deque<uint16_t>& data_buffer = m_feeData[fee];
+  TpcFeeDataBuffer& data_buffer = m_feeData[fee];
 
   while (HEADER_LENGTH <= data_buffer.size())
   {
@@ -1695,13 +1698,13 @@ int TpcTimeFrameBuilderRun3::process_fee_data(unsigned int fee)
 
     if (is_digital_current)
     {
-      process_fee_data_digital_current(fee, data_buffer);
+      process_fee_data_digital_current(fee, data_buffer.view());
     }
     else
     {
-      process_fee_data_waveform(fee, data_buffer);
+      process_fee_data_waveform(fee, data_buffer.view());
     }
-    data_buffer.erase(data_buffer.begin(), data_buffer.begin() + pkt_length + 1);
+    data_buffer.consume(pkt_length + 1);
     m_hFEEDataStream->Fill(fee, "WordValid", pkt_length + 1);
 
   }  //     while (HEADER_LENGTH < data_buffer.size())
@@ -1709,7 +1712,7 @@ int TpcTimeFrameBuilderRun3::process_fee_data(unsigned int fee)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
-void TpcTimeFrameBuilderRun3::process_fee_data_waveform(const unsigned int& fee, std::deque<uint16_t>& data_buffer)
+void TpcTimeFrameBuilderRun3::process_fee_data_waveform(const unsigned int& fee, std::span<const uint16_t> data_buffer)
 {
   const uint16_t& pkt_length = data_buffer[0];
 
@@ -1854,16 +1857,10 @@ void TpcTimeFrameBuilderRun3::process_fee_data_waveform(const unsigned int& fee,
 
     // Format is (N sample) (start time), (1st sample)... (Nth sample)
     size_t pos = HEADER_LENGTH;
-    std::deque<uint16_t>::const_iterator data_buffer_iterator = data_buffer.cbegin();
-    std::advance(data_buffer_iterator, pos);
     while (pos + 2 < pkt_length)
     {
-      const uint16_t& nsamp = *data_buffer_iterator;
-      ++pos;
-      ++data_buffer_iterator;
-      const uint16_t& start_t = *data_buffer_iterator;
-      ++pos;
-      ++data_buffer_iterator;
+      const uint16_t& nsamp = data_buffer[pos++];
+      const uint16_t& start_t = data_buffer[pos++];
       if (m_verbosity > 3)
       {
         std::cout << __PRETTY_FUNCTION__ << ": nsamp: " << nsamp
@@ -1891,18 +1888,13 @@ void TpcTimeFrameBuilderRun3::process_fee_data_waveform(const unsigned int& fee,
       }
 
       const unsigned int fee_sampa_address = fee * MAX_SAMPA + payload.sampa_address;
-      std::vector<uint16_t> adc(nsamp);
+      const auto samples = data_buffer.subspan(pos, nsamp);
       for (int j = 0; j < nsamp; j++)
       {
-        const uint16_t& adc_value = *data_buffer_iterator;
-
-        adc[j] = adc_value;
-        m_hFEESAMPAADC->Fill(start_t + j, fee_sampa_address, adc_value);
-
-        ++pos;
-        ++data_buffer_iterator;  // data_buffer[pos++];
+        m_hFEESAMPAADC->Fill(start_t + j, fee_sampa_address, samples[j]);
       }
-      payload.waveforms.emplace_back(start_t, std::move(adc));
+      pos += nsamp;
+      payload.waveforms.emplace_back(start_t, std::vector<uint16_t>(samples.begin(), samples.end()));
 
       //   // an exception to deal with the last sample that is missing in the current hit format
       //   if (pos + 1 == pkt_length) break;
@@ -1953,7 +1945,7 @@ void TpcTimeFrameBuilderRun3::process_fee_data_waveform(const unsigned int& fee,
   return;
 }
 
-void TpcTimeFrameBuilderRun3::process_fee_data_digital_current(const unsigned int& fee, std::deque<uint16_t>& data_buffer)
+void TpcTimeFrameBuilderRun3::process_fee_data_digital_current(const unsigned int& fee, std::span<const uint16_t> data_buffer)
 {
   if (m_verbosity > 2)
   {
@@ -2215,23 +2207,17 @@ uint16_t TpcTimeFrameBuilderRun3::reverseBits(const uint16_t x) const
 
 std::pair<uint16_t, uint16_t> TpcTimeFrameBuilderRun3::crc16_parity(const uint32_t fee, const uint16_t l) const
 {
-  const std::deque<uint16_t>& data_buffer = m_feeData[fee];
+  const std::span<const uint16_t> data_buffer = m_feeData[fee].view();
   assert(l < data_buffer.size());
 
-  std::deque<uint16_t>::const_iterator it = data_buffer.begin();
-
   uint16_t crc = 0xffffU;
   uint16_t data_parity = 0U;
 
-  for (int i = 0; i < l; ++i, ++it)
+  for (int i = 0; i < l; ++i)
   {
-    const uint16_t& x = *it;
+    const uint16_t& x = data_buffer[i];
 
-    crc ^= reverseBits(x);
-    for (uint16_t k = 0; k < 16U; k++)
-    {
-      crc = crc & 1U ? static_cast<uint16_t>(crc >> 1U) ^ 0xa001U : crc >> 1U;
-    }
+    crc = TpcFeeCrc16::update(crc, reverseBits(x));
 
     // parity on data payload only
     if (i >= HEADER_LENGTH)
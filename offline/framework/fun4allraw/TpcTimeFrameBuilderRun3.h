@@ -1,13 +1,13 @@
 #ifndef Fun4All_TpcTimeFrameBuilderRun3_H
 #define Fun4All_TpcTimeFrameBuilderRun3_H
 
+#include "TpcFeeDataBuffer.h"
 #include "TpcTimeFrameBuilderBase.h"
 
 #include <algorithm>
 #include <array>
 #include <bitset>
 #include <cstdint>
-#include <deque>
 #include <functional>
 #include <iostream>
 #include <limits>
@@ -16,6 +16,7 @@
 #include <optional>
 #include <queue>
 #include <set>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -96,8 +97,8 @@ class TpcTimeFrameBuilderRun3 : public TpcTimeFrameBuilderBase
 
   int decode_gtm_data(const dma_word &gtm_word);
   int process_fee_data(unsigned int fee_id);
-  void process_fee_data_waveform(const unsigned int &fee_id, std::deque<uint16_t> &data_buffer);
-  void process_fee_data_digital_current(const unsigned int &fee_id, std::deque<uint16_t> &data_buffer);
+  void process_fee_data_waveform(const unsigned int &fee_id, std::span<const uint16_t> data_buffer);
+  void process_fee_data_digital_current(const unsigned int &fee_id, std::span<const uint16_t> data_buffer);
 
   struct gtm_payload
   {
@@ -429,7 +430,10 @@ class TpcTimeFrameBuilderRun3 : public TpcTimeFrameBuilderBase
   };  //   class BcoMatchingInformation
 
  private:
-  std::vector<std::deque<uint16_t>> m_feeData;
+  std::vector<TpcFeeDataBuffer> m_feeData;
+
+  //! DMA words of the current packet, reused across packets
+  std::vector<dma_word> m_dmaBuffer;
 
   std::map<int, std::set<int>> m_maskedFEEs;
 
@@ -11,8 +11,16 @@
 #include "phool.h"
 #include "phooldefs.h"
 
+#include <atomic>
 #include <iostream>
 
+namespace
+{
+  // global so a subtree attached to another tree never reports
+  // a version number which was already seen for the new root
+  std::atomic<unsigned long> lastTreeVersion{0};
+}  // namespace
+
 PHCompositeNode::PHCompositeNode(const std::string& n)
   : PHNode(n, "PHCompositeNode")
 {
@@ -36,22 +44,56 @@ bool PHCompositeNode::addNode(PHNode* newNode)
   //
   // Check all existing subNodes for name-conflict.
   //
-  PHPointerListIterator<PHNode> nodeIter(subNodes);
-  PHNode* thisNode;
-  while ((thisNode = nodeIter()))
+  if (nodeIndex.find(newNode->getName()) != nodeIndex.end())
   {
-    if (thisNode->getName() == newNode->getName())
-    {
-      std::cout << PHWHERE << "Node " << newNode->getName()
-                << " already exists" << std::endl;
-      return false;
-    }
+    std::cout << PHWHERE << "Node " << newNode->getName()
+              << " already exists" << std::endl;
+    return false;
   }
   //
   // No conflict, so we can append the new node.
   //
   newNode->setParent(this);
-  return (subNodes.append(newNode));
+  if (!subNodes.append(newNode))
+  {
+    return false;
+  }
+  nodeIndex[newNode->getName()] = newNode;
+  treeChanged();
+  return true;
+}
+
+PHNode* PHCompositeNode::findChild(const std::string& childname) const
+{
+  auto iter = nodeIndex.find(childname);
+  if (iter == nodeIndex.end())
+  {
+    return nullptr;
+  }
+  return iter->second;
+}
+
+unsigned long PHCompositeNode::treeVersion() const
+{
+  const PHNode* root = this;
+  while (root->getParent())
+  {
+    root = root->getParent();
+  }
+  // parents are always PHCompositeNodes
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+  return static_cast<const PHCompositeNode*>(root)->m_TreeVersion;
+}
+
+void PHCompositeNode::treeChanged()
+{
+  PHNode* root = this;
+  while (root->getParent())
+  {
+    root = root->getParent();
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+  static_cast<PHCompositeNode*>(root)->m_TreeVersion = ++lastTreeVersion;
 }
 
 void PHCompositeNode::prune()
@@ -64,6 +106,8 @@ void PHCompositeNode::prune()
     {
       subNodes.removeAt(nodeIter.pos());
       --nodeIter;
+      nodeIndex.erase(thisNode->getName());
+      treeChanged();
       delete thisNode;
     }
     else
@@ -90,6 +134,8 @@ void PHCompositeNode::forgetMe(PHNode* child)
     if (thisNode == child)
     {
       subNodes.removeAt(nodeIter.pos());
+      nodeIndex.erase(child->getName());
+      treeChanged();
       child = nullptr;
     }
   }
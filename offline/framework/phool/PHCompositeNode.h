@@ -8,6 +8,7 @@
 #include "PHPointerList.h"
 
 #include <string>
+#include <unordered_map>
 
 class PHIOManager;
 
@@ -24,6 +25,17 @@ class PHCompositeNode : public PHNode
   //
   bool addNode(PHNode *);
 
+  //
+  // Direct subnode with this name (no recursion), nullptr if none.
+  //
+  PHNode *findChild(const std::string &) const;
+
+  //
+  // Changes whenever a node is added to or removed from the tree
+  // this node belongs to. Used to invalidate cached node lookups.
+  //
+  unsigned long treeVersion() const;
+
   //
   // This recursively calls the prune function of all the subnodes.
   // If a subnode is found to be marked as transient (non persistent)
@@ -39,7 +51,10 @@ class PHCompositeNode : public PHNode
 
  protected:
   void forgetMe(PHNode *) override;
+  void treeChanged();
   PHPointerList<PHNode> subNodes;
+  std::unordered_map<std::string, PHNode *> nodeIndex;
+  unsigned long m_TreeVersion = 0;
   int deleteMe = 0;
 
  private:
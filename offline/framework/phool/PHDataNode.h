@@ -18,8 +18,17 @@ class PHDataNode : public PHNode
   ~PHDataNode() override;
 
  public:
-  T* getData() { return data.data; }
+  T* getData()
+  {
+    if (m_LoadPending)
+    {
+      loadData();
+    }
+    return data.data;
+  }
   void setData(T* d) { data.data = d; }
+  // true if the data of this event was not read in yet (lazy reading of input files)
+  bool isLoadPending() const { return m_LoadPending; }
   void prune() override {}
   void forgetMe(PHNode*) override {}
   void print(const std::string&) override;
@@ -35,6 +44,9 @@ class PHDataNode : public PHNode
     TObject* tobj;
   };
   tobjcast data;
+  // reads the data of this event, used by nodes which are filled on demand
+  virtual void loadData() { m_LoadPending = false; }
+  bool m_LoadPending{false};
   PHDataNode() = delete;
 };
 
@@ -0,0 +1,261 @@
+#include "PHGridFile.h"
+
+#include "phool.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>  // for mkstemp
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+  constexpr char kMagic[8] = {'P', 'H', 'G', 'R', 'I', 'D', '\n', '\0'};
+  constexpr size_t kAlignment = 64;
+
+  struct Header
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t type;
+    uint64_t narrays;
+    uint64_t checksum;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t header_checksum;
+    uint64_t reserved;
+  };
+  static_assert(sizeof(Header) == kAlignment);
+
+  size_t aligned(size_t size)
+  {
+    return (size + kAlignment - 1) / kAlignment * kAlignment;
+  }
+
+  // FNV-1a on 8 byte words, the length is always a multiple of 8
+  uint64_t checksum(const char *data, size_t length, uint64_t hash = 14695981039346656037ULL)
+  {
+    for (size_t i = 0; i < length; i += sizeof(uint64_t))
+    {
+      uint64_t word;
+      std::memcpy(&word, data + i, sizeof(uint64_t));
+      hash ^= word;
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  // checksum of the header, with its own checksum field cleared, and of the array size table
+  uint64_t header_checksum(Header header, const char *table, size_t table_length)
+  {
+    header.header_checksum = 0;
+    return checksum(table, table_length, checksum(reinterpret_cast<const char *>(&header), sizeof(Header)));
+  }
+}  // namespace
+
+//____________________________________________________________________________
+std::unique_ptr<PHGridFile> PHGridFile::openCache(const std::string &source, uint32_t type, bool verify_checksum)
+{
+  const std::string filename = cacheName(source);
+  struct stat cache_stat{};
+  if (stat(filename.c_str(), &cache_stat) != 0)
+  {
+    return nullptr;
+  }
+
+  auto grid = open(filename, type, verify_checksum);
+  if (!grid)
+  {
+    return nullptr;
+  }
+
+  // the cache is also used when the source is not accessible
+  struct stat source_stat{};
+  if (stat(source.c_str(), &source_stat) == 0 &&
+      (grid->m_source_size != static_cast<uint64_t>(source_stat.st_size) || grid->m_source_mtime != static_cast<int64_t>(source_stat.st_mtime)))
+  {
+    std::cout << "PHGridFile::openCache - " << filename << " was not written for the current " << source << ", ignored" << std::endl;
+    return nullptr;
+  }
+  return grid;
+}
+
+//____________________________________________________________________________
+std::unique_ptr<PHGridFile> PHGridFile::open(const std::string &filename, uint32_t type, bool verify_checksum)
+{
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    std::cout << PHWHERE << " cannot open " << filename << std::endl;
+    return nullptr;
+  }
+
+  struct stat file_stat{};
+  if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(Header))
+  {
+    std::cout << PHWHERE << " invalid file " << filename << std::endl;
+    ::close(fd);
+    return nullptr;
+  }
+
+  // the mapping stays valid after closing the descriptor
+  std::unique_ptr<PHGridFile> grid(new PHGridFile);
+  grid->m_length = file_stat.st_size;
+  grid->m_address = mmap(nullptr, grid->m_length, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (grid->m_address == MAP_FAILED)
+  {
+    std::cout << PHWHERE << " cannot map " << filename << std::endl;
+    grid->m_address = nullptr;
+    return nullptr;
+  }
+
+  const char *base = static_cast<const char *>(grid->m_address);
+  Header header{};
+  std::memcpy(&header, base, sizeof(Header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion || header.type != type)
+  {
+    std::cout << PHWHERE << " " << filename << " has wrong format, version or type, ignored" << std::endl;
+    return nullptr;
+  }
+
+  // array sizes
+  const size_t table_length = aligned(header.narrays * sizeof(uint64_t));
+  if (header.narrays > grid->m_length || sizeof(Header) + table_length > grid->m_length)
+  {
+    std::cout << PHWHERE << " " << filename << " is truncated, ignored" << std::endl;
+    return nullptr;
+  }
+  if (header_checksum(header, base + sizeof(Header), table_length) != header.header_checksum)
+  {
+    std::cout << PHWHERE << " " << filename << " header checksum mismatch, ignored" << std::endl;
+    return nullptr;
+  }
+  std::vector<uint64_t> sizes(header.narrays);
+  std::memcpy(sizes.data(), base + sizeof(Header), header.narrays * sizeof(uint64_t));
+
+  size_t offset = sizeof(Header) + table_length;
+  for (const auto &size : sizes)
+  {
+    const size_t length = aligned(size * sizeof(float));
+    if (size > grid->m_length || offset + length > grid->m_length)
+    {
+      std::cout << PHWHERE << " " << filename << " is truncated, ignored" << std::endl;
+      return nullptr;
+    }
+    grid->m_arrays.emplace_back(reinterpret_cast<const float *>(base + offset), size);
+    offset += length;
+  }
+
+  if (offset != grid->m_length)
+  {
+    std::cout << PHWHERE << " " << filename << " has inconsistent size, ignored" << std::endl;
+    return nullptr;
+  }
+
+  if (verify_checksum && checksum(base + sizeof(Header), grid->m_length - sizeof(Header)) != header.checksum)
+  {
+    std::cout << PHWHERE << " " << filename << " checksum mismatch, ignored" << std::endl;
+    return nullptr;
+  }
+  grid->m_source_size = header.source_size;
+  grid->m_source_mtime = header.source_mtime;
+
+  // tell the kernel the pages will be needed
+  madvise(grid->m_address, grid->m_length, MADV_WILLNEED);
+  return grid;
+}
+
+//____________________________________________________________________________
+bool PHGridFile::writeCache(const std::string &source, uint32_t type, const std::vector<std::span<const float>> &arrays)
+{
+  struct stat source_stat{};
+  if (stat(source.c_str(), &source_stat) != 0)
+  {
+    std::cout << PHWHERE << " cannot stat " << source << ", no cache written" << std::endl;
+    return false;
+  }
+  return write(cacheName(source), type, arrays, source_stat.st_size, source_stat.st_mtime);
+}
+
+//____________________________________________________________________________
+bool PHGridFile::write(const std::string &filename, uint32_t type, const std::vector<std::span<const float>> &arrays,
+                       uint64_t source_size, int64_t source_mtime)
+{
+  // build the content after the header in memory, needed for the checksum
+  const size_t table_length = aligned(arrays.size() * sizeof(uint64_t));
+  size_t length = table_length;
+  for (const auto &array : arrays)
+  {
+    length += aligned(array.size_bytes());
+  }
+
+  std::vector<char> content(length, 0);
+  size_t offset = table_length;
+  for (size_t i = 0; i < arrays.size(); ++i)
+  {
+    const uint64_t size = arrays[i].size();
+    std::memcpy(content.data() + i * sizeof(uint64_t), &size, sizeof(uint64_t));
+    if (!arrays[i].empty())
+    {
+      std::memcpy(content.data() + offset, arrays[i].data(), arrays[i].size_bytes());
+    }
+    offset += aligned(arrays[i].size_bytes());
+  }
+
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.type = type;
+  header.narrays = arrays.size();
+  header.checksum = checksum(content.data(), content.size());
+  header.source_size = source_size;
+  header.source_mtime = source_mtime;
+  header.header_checksum = header_checksum(header, content.data(), table_length);
+
+  // unique temporary name, also between hosts sharing the file system
+  std::string tmpname = filename + ".tmpXXXXXX";
+  const int fd = mkstemp(tmpname.data());
+  if (fd < 0)
+  {
+    std::cout << PHWHERE << " cannot create " << tmpname << std::endl;
+    return false;
+  }
+  // mkstemp creates the file readable by the owner only
+  fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  ::close(fd);
+  {
+    std::ofstream out(tmpname, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+    out.write(content.data(), content.size());
+    if (!out)
+    {
+      std::cout << PHWHERE << " cannot write " << tmpname << std::endl;
+      out.close();
+      std::remove(tmpname.c_str());
+      return false;
+    }
+  }
+
+  if (std::rename(tmpname.c_str(), filename.c_str()) != 0)
+  {
+    std::cout << PHWHERE << " cannot rename " << tmpname << " to " << filename << std::endl;
+    std::remove(tmpname.c_str());
+    return false;
+  }
+  return true;
+}
+
+//____________________________________________________________________________
+PHGridFile::~PHGridFile()
+{
+  if (m_address)
+  {
+    munmap(m_address, m_length);
+  }
+}
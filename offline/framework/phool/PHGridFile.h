@@ -0,0 +1,90 @@
+#ifndef PHOOL_PHGRIDFILE_H
+#define PHOOL_PHGRIDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * Read-only, memory mapped binary file holding a list of float arrays.
+ * It is used to cache field maps and distortion maps converted from their
+ * ROOT sources, so that jobs do not need to loop over ntuples or histograms
+ * at startup. All processes mapping the same file share its pages.
+ *
+ * Layout: 64 byte header (magic, format version, content type, number of arrays,
+ * checksums, size and modification time of the source), the size of each array,
+ * then the arrays, each one aligned to 64 bytes.
+ * Checksums are 64 bit FNV-1a on 8 byte words. The header checksum covers the
+ * header and the array size table and is always verified, together with the file size.
+ * The full checksum covers everything after the header. It is always written,
+ * but only verified on request since it means reading the whole file, which
+ * defeats the point of mapping it.
+ *
+ * The cache of a source file lives next to it (see cacheName) and is ignored
+ * when the size or modification time of the source changed.
+ */
+class PHGridFile
+{
+ public:
+  //! format version, files with a different version are ignored
+  static constexpr uint32_t kVersion = 3;
+
+  //! content type from four characters, e.g. typeId("B3DC")
+  static constexpr uint32_t typeId(const char (&name)[5])
+  {
+    return static_cast<uint32_t>(name[0]) |
+           (static_cast<uint32_t>(name[1]) << 8U) |
+           (static_cast<uint32_t>(name[2]) << 16U) |
+           (static_cast<uint32_t>(name[3]) << 24U);
+  }
+
+  //! cache file name for a given source file
+  static std::string cacheName(const std::string &source) { return source + ".phgrid"; }
+
+  //! map the cache of the source file
+  /**
+   * returns nullptr if there is no cache, if it was written for a source file with a different
+   * size or modification time, or if it cannot be validated (type, version, size, header checksum, full checksum if requested)
+   */
+  static std::unique_ptr<PHGridFile> openCache(const std::string &source, uint32_t type, bool verify_checksum = false);
+
+  //! map a grid file, returns nullptr if it cannot be validated
+  static std::unique_ptr<PHGridFile> open(const std::string &filename, uint32_t type, bool verify_checksum = false);
+
+  //! write the arrays to the cache of the source file, together with the source size and modification time
+  static bool writeCache(const std::string &source, uint32_t type, const std::vector<std::span<const float>> &arrays);
+
+  //! write the arrays to a grid file
+  /** the file is written under a temporary name and renamed, so that concurrent readers never see a partial file */
+  static bool write(const std::string &filename, uint32_t type, const std::vector<std::span<const float>> &arrays,
+                    uint64_t source_size = 0, int64_t source_mtime = 0);
+
+  ~PHGridFile();
+
+  PHGridFile(const PHGridFile &) = delete;
+  PHGridFile &operator=(const PHGridFile &) = delete;
+
+  //! number of arrays
+  size_t size() const { return m_arrays.size(); }
+
+  //! read-only view on a given array, valid as long as this object lives
+  std::span<const float> array(size_t i) const { return m_arrays[i]; }
+
+ private:
+  PHGridFile() = default;
+
+  //! mapped region
+  void *m_address = nullptr;
+  size_t m_length = 0;
+
+  //! size and modification time of the source file, from the header
+  uint64_t m_source_size = 0;
+  int64_t m_source_mtime = 0;
+
+  std::vector<std::span<const float>> m_arrays;
+};
+
+#endif
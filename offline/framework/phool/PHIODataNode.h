@@ -7,11 +7,13 @@
 #include "PHDataNode.h"
 #include "PHIOManager.h"
 #include "PHNodeIOManager.h"
+#include "PHObject.h"
 #include "PHTypedNodeIterator.h"
 #include "phooldefs.h"
 
 #include <TObject.h>
 
+#include <cstddef>
 #include <string>
 
 template <typename T>
@@ -24,16 +26,21 @@ class PHIODataNode : public PHDataNode<T>
   PHIODataNode(T *, const std::string &);
   PHIODataNode(T *, const std::string &, const std::string &);
   PHIODataNode(T *, const int, const std::string &);
-  virtual ~PHIODataNode() = default;
+  ~PHIODataNode() override;
   typedef PHTypedNodeIterator<T> iterator;
   void BufferSize(int size) { buffersize = size; }
   void SplitLevel(int split) { splitlevel = split; }
+  PHNode *copyForWrite() const override;
 
  protected:
   bool write(PHIOManager *, const std::string & = "") override;
+  void loadData() override;
   PHIODataNode() = delete;
   int buffersize{32000};
   int splitlevel{0};
+  // set if the branch of this node is read on demand by the io manager
+  PHNodeIOManager *m_LazyIOManager{nullptr};
+  size_t m_LazyIndex{0};
 };
 
 template <class T>
@@ -65,11 +72,34 @@ PHIODataNode<T>::PHIODataNode(T *d, const int id,
   this->objectclass = TO->GetName();
 }
 
+template <class T>
+PHIODataNode<T>::~PHIODataNode()
+{
+  if (m_LazyIOManager)
+  {
+    m_LazyIOManager->forgetLazyNode(m_LazyIndex);
+  }
+}
+
+template <class T>
+void PHIODataNode<T>::loadData()
+{
+  if (m_LazyIOManager)
+  {
+    m_LazyIOManager->readLazyNode(m_LazyIndex);
+  }
+  this->m_LoadPending = false;
+}
+
 template <class T>
 bool PHIODataNode<T>::write(PHIOManager *IOManager, const std::string &path)
 {
   if (this->persistent)
   {
+    if (this->m_LoadPending)
+    {
+      loadData();
+    }
     PHNodeIOManager *np = dynamic_cast<PHNodeIOManager *>(IOManager);
     if (np)
     {
@@ -85,4 +115,28 @@ bool PHIODataNode<T>::write(PHIOManager *IOManager, const std::string &path)
   return true;
 }
 
+template <class T>
+PHNode *PHIODataNode<T>::copyForWrite() const
+{
+  if (this->m_LoadPending)
+  {
+    // the copy needs the data of the current event
+    const_cast<PHIODataNode<T> *>(this)->loadData();
+  }
+  const PHObject *obj = dynamic_cast<const PHObject *>(this->data.tobj);
+  if (!obj)
+  {
+    return nullptr;
+  }
+  T *copy = dynamic_cast<T *>(obj->CloneMe());
+  if (!copy)
+  {
+    return nullptr;
+  }
+  PHIODataNode<T> *newnode = new PHIODataNode<T>(copy, this->name, this->objecttype);
+  newnode->buffersize = buffersize;
+  newnode->splitlevel = splitlevel;
+  return newnode;
+}
+
 #endif /* PHOOL_PHIODATANODE_H */
@@ -22,6 +22,10 @@ class PHNode
   virtual void forgetMe(PHNode *) = 0;
   virtual bool write(PHIOManager *, const std::string & = "") = 0;
 
+  // deep copy of a data node which can be written out independently of
+  // this one (e.g. by an output thread), nullptr if it cannot be copied
+  virtual PHNode *copyForWrite() const { return nullptr; }
+
   virtual void setResetFlag(const bool b) { reset_able = b; }
   virtual bool getResetFlag() const { return reset_able; }
   PHNode *getParent() const { return parent; }
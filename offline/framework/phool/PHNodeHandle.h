@@ -0,0 +1,132 @@
+#ifndef PHOOL_PHNODEHANDLE_H
+#define PHOOL_PHNODEHANDLE_H
+
+//  Declaration of class PHNodeHandle
+//  Purpose: cached typed lookup of a data node by name. The node tree is
+//  only searched again after nodes were added to or removed from it, so
+//  modules can keep a handle as member and use it in every event instead
+//  of calling findNode::getClass
+
+#include "PHCompositeNode.h"
+#include "PHDataNode.h"
+#include "PHIODataNode.h"
+#include "PHNode.h"
+#include "PHNodeIterator.h"
+
+#include <TObject.h>
+
+#include <string>
+
+template <class T>
+class PHNodeHandle
+{
+ public:
+  PHNodeHandle() = default;
+  explicit PHNodeHandle(const std::string &nodename)
+    : m_Name(nodename)
+  {
+  }
+  explicit PHNodeHandle(const int packetid)
+    : m_Name(std::to_string(packetid))
+  {
+  }
+
+  const std::string &name() const { return m_Name; }
+  void name(const std::string &nodename)
+  {
+    m_Name = nodename;
+    reset();
+  }
+
+  //! object in the node below top (same result as findNode::getClass<T>(top, name()))
+  T *get(PHCompositeNode *top);
+
+  //! forget the cached node, the next get() searches the tree again
+  void reset()
+  {
+    m_TopNode = nullptr;
+    m_Node = nullptr;
+    m_Object = nullptr;
+  }
+
+ private:
+  void resolve(PHCompositeNode *top);
+  void extract();
+  // the data pointer the cached object was taken from. PHDataNodes
+  // (e.g. PRDF) get new content by setData() without changing the tree
+  void *rawData() const;
+
+  std::string m_Name;
+  PHCompositeNode *m_TopNode = nullptr;
+  PHNode *m_Node = nullptr;
+  T *m_Object = nullptr;
+  void *m_RawData = nullptr;
+  bool m_IsIONode = false;
+  unsigned long m_TreeVersion = 0;
+};
+
+template <class T>
+T *PHNodeHandle<T>::get(PHCompositeNode *top)
+{
+  if (top != m_TopNode || top->treeVersion() != m_TreeVersion)
+  {
+    resolve(top);
+  }
+  else if (m_Node && rawData() != m_RawData)
+  {
+    extract();
+  }
+  return m_Object;
+}
+
+template <class T>
+void PHNodeHandle<T>::resolve(PHCompositeNode *top)
+{
+  m_TopNode = top;
+  m_TreeVersion = top->treeVersion();
+  m_Node = nullptr;
+  m_Object = nullptr;
+  m_RawData = nullptr;
+  PHNodeIterator iter(top);
+  m_Node = iter.findFirst(m_Name);
+  if (m_Node)
+  {
+    extract();
+  }
+}
+
+// same logic as findNode::getClass
+template <class T>
+void PHNodeHandle<T>::extract()
+{
+  // first test if it is a PHDataNode
+  PHDataNode<T> *DNode = dynamic_cast<PHDataNode<T> *>(m_Node);
+  if (DNode && DNode->getData())
+  {
+    m_IsIONode = false;
+    m_RawData = rawData();
+    m_Object = DNode->getData();
+    return;
+  }
+  // all PHIODataNodes contain a TObject (see getClass.h), the data
+  // pointer of an empty PHDataNode is read the same way until it is set
+  m_IsIONode = true;
+  m_RawData = rawData();
+  m_Object = nullptr;
+  if (m_RawData && m_Node->getType() == "PHIODataNode")
+  {
+    m_Object = dynamic_cast<T *>(static_cast<TObject *>(m_RawData));
+  }
+}
+
+template <class T>
+void *PHNodeHandle<T>::rawData() const
+{
+  if (m_IsIONode)
+  {
+    return static_cast<PHIODataNode<TObject> *>(m_Node)->getData();
+  }
+  return static_cast<PHDataNode<T> *>(m_Node)->getData();
+}
+
+#endif /* PHOOL_PHNODEHANDLE_H */
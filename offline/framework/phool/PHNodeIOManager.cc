@@ -63,6 +63,8 @@ PHNodeIOManager::~PHNodeIOManager()
 
 void PHNodeIOManager::closeFile()
 {
+  // nodes must not read from a closed file
+  clearLazyNodes();
   if (file)
   {
     if (accessMode == PHWrite || accessMode == PHUpdate)
@@ -78,6 +80,7 @@ bool PHNodeIOManager::setFile(const std::string& f, const std::string& title,
 {
   filename = f;
   accessMode = a;
+  m_WriteBranches.clear();
   if (file)
   {
     if (file->IsOpen())
@@ -99,6 +102,7 @@ bool PHNodeIOManager::setFile(const std::string& f, const std::string& title,
     }
     file->SetCompressionSettings(m_CompressionSetting);
     tree = new TTree(TreeName.c_str(), title.c_str());
+    tree->SetImplicitMT(m_ImplicitMT);
     TTree::SetMaxTreeSize(900000000000LL);  // set max size to ~900 GB
 
     gROOT->cd(currdir.c_str());
@@ -123,6 +127,7 @@ bool PHNodeIOManager::setFile(const std::string& f, const std::string& title,
     }
     file->SetCompressionSettings(m_CompressionSetting);
     tree = new TTree(TreeName.c_str(), title.c_str());
+    tree->SetImplicitMT(m_ImplicitMT);
     gROOT->cd(currdir.c_str());
     return true;
     break;
@@ -159,7 +164,15 @@ bool PHNodeIOManager::write(TObject** data, const std::string& path, int nodebuf
 {
   if (file && tree)
   {
-    TBranch* thisBranch = tree->GetBranch(path.c_str());
+    // the string lookup in the tree is slow with many branches, keep
+    // the branch pointers for the following events
+    WriteBranch& writebranch = m_WriteBranches[path];
+    writebranch.lastwrite = eventNumber;
+    TBranch*& thisBranch = writebranch.branch;
+    if (!thisBranch)
+    {
+      thisBranch = tree->GetBranch(path.c_str());
+    }
     if (!thisBranch)
     {
       int use_splitlevel = splitlevel;
@@ -175,8 +188,8 @@ bool PHNodeIOManager::write(TObject** data, const std::string& path, int nodebuf
       {
         use_buffersize = nodebuffersize;
       }
-      tree->Branch(path.c_str(), (*data)->ClassName(),
-                   data, use_buffersize, use_splitlevel);
+      thisBranch = tree->Branch(path.c_str(), (*data)->ClassName(),
+                                data, use_buffersize, use_splitlevel);
     }
     else
     {
@@ -188,6 +201,25 @@ bool PHNodeIOManager::write(TObject** data, const std::string& path, int nodebuf
   return false;
 }
 
+std::set<size_t> PHNodeIOManager::EventsInUse() const
+{
+  std::set<size_t> events;
+  for (const auto& iter : m_WriteBranches)
+  {
+    events.insert(iter.second.lastwrite);
+  }
+  return events;
+}
+
+void PHNodeIOManager::ImplicitMT(const bool b)
+{
+  m_ImplicitMT = b;
+  if (tree && (accessMode == PHWrite || accessMode == PHUpdate))
+  {
+    tree->SetImplicitMT(b);
+  }
+}
+
 bool PHNodeIOManager::read(size_t requestedEvent)
 {
   return readEventFromFile(requestedEvent);
@@ -299,7 +331,34 @@ bool PHNodeIOManager::readEventFromFile(size_t requestedEvent)
     tree->SetCacheSize(m_cacheSize);
   }
 
-  if (requestedEvent)
+  if (m_LazyRead)
+  {
+    // only select the entry, the branches are read by readLazyNode()
+    size_t entry = requestedEvent;
+    if (!requestedEvent)
+    {
+      entry = eventNumber++;
+    }
+    bytesRead = 0;
+    if (entry < static_cast<size_t>(tree->GetEntries()))
+    {
+      bytesRead = 1;
+      if (requestedEvent)
+      {
+        eventNumber = requestedEvent + 1;
+      }
+      m_LazyEntry = entry;
+      m_LazyReadEvents++;
+    }
+    for (auto& lazy : m_LazyBranches)
+    {
+      if (lazy.node)
+      {
+        lazy.node->m_LoadPending = (bytesRead != 0);
+      }
+    }
+  }
+  else if (requestedEvent)
   {
     bytesRead = tree->GetEvent(requestedEvent);
     if (bytesRead)
@@ -339,6 +398,14 @@ int PHNodeIOManager::readSpecific(size_t requestedEvent, const std::string& obje
     TBranch* branch = p->second;
     if (branch)
     {
+      // the node now holds this entry, it must not be overwritten by a lazy read
+      for (auto& lazy : m_LazyBranches)
+      {
+        if (lazy.branch == branch && lazy.node)
+        {
+          lazy.node->m_LoadPending = false;
+        }
+      }
       return branch->GetEvent(requestedEvent);
     }
   }
@@ -498,6 +565,17 @@ PHNodeIOManager::reconstructNodeTree(PHCompositeNode* topNode)
       newIODataNode->setObjectType("PHObject");
     }
     thisBranch->SetAddress(&(newIODataNode->data));
+    if (m_LazyRead)
+    {
+      // a node which is shared with another input file is read on demand from this file only
+      if (newIODataNode->m_LazyIOManager)
+      {
+        newIODataNode->m_LazyIOManager->forgetLazyNode(newIODataNode->m_LazyIndex);
+      }
+      newIODataNode->m_LazyIOManager = this;
+      newIODataNode->m_LazyIndex = m_LazyBranches.size();
+      m_LazyBranches.push_back({branchName, thisBranch, newIODataNode, 0});
+    }
     for (j = 1; j < splitvec.size() - 1; j++)
     {
       nodeIter.cd("..");
@@ -626,3 +704,51 @@ void PHNodeIOManager::DisableReadCache()
   }
   return;
 }
+
+std::map<std::string, uint64_t> PHNodeIOManager::LazyReadCounts() const
+{
+  std::map<std::string, uint64_t> counts;
+  for (const auto& lazy : m_LazyBranches)
+  {
+    counts[lazy.name] += lazy.nread;
+  }
+  return counts;
+}
+
+void PHNodeIOManager::readLazyNode(const size_t index)
+{
+  LazyBranch& lazy = m_LazyBranches[index];
+  lazy.node->m_LoadPending = false;
+  // same directory handling as in readEventFromFile()
+  std::string currdir = gDirectory->GetPath();
+  TFile* file_ptr = gFile;  // save current gFile
+  file->cd();
+  int bytesRead = lazy.branch->GetEntry(m_LazyEntry);
+  gFile = file_ptr;  // recover gFile
+  gROOT->cd(currdir.c_str());
+  if (bytesRead == -1)
+  {
+    std::cout << PHWHERE << "Error: Input TTree corrupt, exiting now" << std::endl;
+    exit(1);
+  }
+  lazy.nread++;
+}
+
+void PHNodeIOManager::forgetLazyNode(const size_t index)
+{
+  LazyBranch& lazy = m_LazyBranches[index];
+  if (lazy.node)
+  {
+    lazy.node->m_LazyIOManager = nullptr;
+    lazy.node->m_LoadPending = false;
+    lazy.node = nullptr;
+  }
+}
+
+void PHNodeIOManager::clearLazyNodes()
+{
+  for (size_t i = 0; i < m_LazyBranches.size(); ++i)
+  {
+    forgetLazyNode(i);
+  }
+}
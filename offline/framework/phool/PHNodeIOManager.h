@@ -13,9 +13,14 @@
 #include <cstdint>
 #include <limits>
 #include <map>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 class PHCompositeNode;
+template <typename T>
+class PHIODataNode;
 class TBranch;
 class TFile;
 class TObject;
@@ -23,6 +28,9 @@ class TTree;
 
 class PHNodeIOManager : public PHIOManager
 {
+  template <typename T>
+  friend class PHIODataNode;
+
  public:
   PHNodeIOManager() = default;
   PHNodeIOManager(const std::string &, const PHAccessType = PHReadOnly);
@@ -59,7 +67,37 @@ class PHNodeIOManager : public PHIOManager
   
   void DisableReadCache();
 
+  // compress and flush the baskets of the output tree in parallel with
+  // ROOT's implicit multithreading, needs ROOT::EnableImplicitMT()
+  void ImplicitMT(const bool b);
+  bool ImplicitMT() const { return m_ImplicitMT; }
+
+  // event numbers (getEventNumber() at the time of the write) whose objects
+  // the output branches still point to. Objects of other events written
+  // before can be deleted
+  std::set<size_t> EventsInUse() const;
+
+  // lazy reading: the branches of the event tree are only read for the nodes
+  // which are accessed (getData(), findNode::getClass) during an event.
+  // Needs to be set before the first event is read
+  void LazyRead(const bool b) { m_LazyRead = b; }
+  bool LazyRead() const { return m_LazyRead; }
+  uint64_t LazyReadEvents() const { return m_LazyReadEvents; }
+  // number of events in which each branch was read
+  std::map<std::string, uint64_t> LazyReadCounts() const;
+
 private:
+  struct LazyBranch
+  {
+    std::string name;
+    TBranch *branch{nullptr};
+    PHIODataNode<TObject> *node{nullptr};
+    uint64_t nread{0};
+  };
+
+  void readLazyNode(const size_t index);
+  void forgetLazyNode(const size_t index);
+  void clearLazyNodes();
   int FillBranchMap();
   PHCompositeNode *reconstructNodeTree(PHCompositeNode *);
   bool readEventFromFile(size_t requestedEvent);
@@ -76,6 +114,18 @@ private:
   int splitlevel{std::numeric_limits<int>::min()};
   std::map<std::string, TBranch *> fBranches;
   std::map<std::string, bool> objectToRead;
+  struct WriteBranch
+  {
+    TBranch *branch{nullptr};
+    size_t lastwrite{0};  // event number of the last address set
+  };
+  // output branches by node path, resolved on the first write
+  std::unordered_map<std::string, WriteBranch> m_WriteBranches;
+  bool m_ImplicitMT{false};
+  bool m_LazyRead{false};
+  size_t m_LazyEntry{0};
+  uint64_t m_LazyReadEvents{0};
+  std::vector<LazyBranch> m_LazyBranches;
 };
 
 #endif
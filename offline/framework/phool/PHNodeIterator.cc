@@ -123,15 +123,13 @@ bool PHNodeIterator::cd(const std::string& pathString)
       }
       else
       {
-        PHPointerListIterator<PHNode> subNodeIter(currentNode->subNodes);
+        // node names are unique within a PHCompositeNode
+        subNode = currentNode->findChild(iter);
         pathFound = false;
-        while ((subNode = subNodeIter()))
+        if (subNode && subNode->getType() == "PHCompositeNode")
         {
-          if (subNode->getType() == "PHCompositeNode" && subNode->getName() == iter)
-          {
-            currentNode = dynamic_cast<PHCompositeNode*>(subNode);
-            pathFound = true;
-          }
+          currentNode = dynamic_cast<PHCompositeNode*>(subNode);
+          pathFound = true;
         }
         if (!pathFound)
         {
@@ -25,7 +25,12 @@ void PHNodeReset::perform(PHNode* node)
     if (node->getObjectType() == "PHObject")
     {
       // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
-      (static_cast<PHDataNode<PHObject>*>(node))->getData()->Reset();
+      PHDataNode<PHObject>* datanode = static_cast<PHDataNode<PHObject>*>(node);
+      // data which was not read in during this event does not need a reset
+      if (!datanode->isLoadPending())
+      {
+        datanode->getData()->Reset();
+      }
     }
   }
 }
@@ -1,5 +1,6 @@
 #include "onnxlib.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace onnxlib
@@ -33,119 +34,97 @@ Ort::Session *onnxSession(std::string &modelfile, int verbosity)
 
 std::vector<float> onnxInference(Ort::Session *session, std::vector<float> &input, int N, int Nsamp, int Nreturn)
 {
-  Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-
-  Ort::AllocatorWithDefaultOptions allocator;
-
-  std::vector<Ort::Value> inputTensors;
-  std::vector<Ort::Value> outputTensors;
-
-  std::vector<int64_t> inputDimsN = {N, Nsamp};
-  std::vector<int64_t> outputDimsN = {N, Nreturn};
-  int inputlen = N * Nsamp;
-  int outputlen = N * Nreturn;
-
-  std::vector<float> outputTensorValuesN(outputlen);
+  onnxlib::InferenceContext context(session);
+  return context.run(input, N, {Nsamp}, Nreturn);
+}
 
-  inputTensors.push_back(Ort::Value::CreateTensor<float>(memoryInfo, input.data(), inputlen, inputDimsN.data(), inputDimsN.size()));
-  outputTensors.push_back(Ort::Value::CreateTensor<float>(memoryInfo, outputTensorValuesN.data(), outputlen, outputDimsN.data(), outputDimsN.size()));
+std::vector<float> onnxInference(Ort::Session *session, std::vector<float> &input, int N, int Nx, int Ny, int Nz, int Nreturn)
+{
+  onnxlib::InferenceContext context(session);
+  return context.run(input, N, {Nx, Ny, Nz}, Nreturn);
+}
 
+onnxlib::InferenceContext::InferenceContext(Ort::Session *session)
+  : m_session(session)
+  , m_memoryInfo(Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault))
+  , m_binding(*session)
+{
 #if ORT_API_VERSION == 12
-  std::vector<const char *> inputNames{session->GetInputName(0, allocator)};
-  std::vector<const char *> outputNames{session->GetOutputName(0, allocator)};
+  Ort::AllocatorWithDefaultOptions allocator;
+  char *name = m_session->GetInputName(0, allocator);
+  m_inputName = name;
+  allocator.Free(name);
+  name = m_session->GetOutputName(0, allocator);
+  m_outputName = name;
+  allocator.Free(name);
 #elif ORT_API_VERSION == 22
-  std::vector<const char *> inputNames;
-  std::vector<const char *> outputNames;
-
-  char *name{nullptr};
-  for (const std::string &s : session->GetInputNames())
-  {
-    name = new char[s.size() + 1];
-    sprintf(name, "%s", s.c_str()); //NOLINT(hicpp-vararg)
-    inputNames.push_back(name);
-  }
-  for (const std::string &s : session->GetOutputNames())
-  {
-    name = new char[s.size() + 1];
-    sprintf(name, "%s", s.c_str()); //NOLINT(hicpp-vararg)
-    outputNames.push_back(name);
-  }
+  m_inputName = m_session->GetInputNames().at(0);
+  m_outputName = m_session->GetOutputNames().at(0);
 #else
 #define XSTR(x) STR(x)
 #define STR(x) #x
 #pragma message "ORT_API_VERSION " XSTR(ORT_API_VERSION) " not implemented"
 #endif
-  session->Run(Ort::RunOptions{nullptr}, inputNames.data(), inputTensors.data(), 1, outputNames.data(), outputTensors.data(), 1);
 
-#if ORT_API_VERSION == 22
-  for (const auto *iter : inputNames)
-  {
-    delete[] iter;
-  }
-  for (const auto *iter : outputNames)
+  const auto input_dims = m_session->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+  const auto output_dims = m_session->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+  m_n_input = input_dims.size() > 1 ? input_dims[1] : -1;
+  m_n_output = output_dims.size() > 1 ? output_dims[1] : -1;
+
+  // dynamic batch dimensions are negative
+  if (!input_dims.empty() && input_dims[0] > 0)
   {
-    delete[] iter;
+    m_batchsize = input_dims[0];
   }
-#endif
-  return outputTensorValuesN;
 }
 
-std::vector<float> onnxInference(Ort::Session *session, std::vector<float> &input, int N, int Nx, int Ny, int Nz, int Nreturn)
+const std::vector<float> &onnxlib::InferenceContext::run(std::span<const float> input, int N, const std::vector<int64_t> &dims, int Nreturn)
 {
-  // Define the memory information for ONNX Runtime
-  Ort::MemoryInfo memoryInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-
-  Ort::AllocatorWithDefaultOptions allocator;
-
-  std::vector<int64_t> inputDims = {N, Nx, Ny, Nz};
-  std::vector<int64_t> outputDimsN = {N, Nreturn};
-  int inputlen = N * Nx * Ny * Nz;
-  int outputlen = N * Nreturn;
-
-  std::vector<float> outputTensorValues(outputlen);
-
-  std::vector<Ort::Value> inputTensors;
-  std::vector<Ort::Value> outputTensors;
-
-  inputTensors.push_back(Ort::Value::CreateTensor<float>(memoryInfo, input.data(), inputlen, inputDims.data(), inputDims.size()));
-
-  outputTensors.push_back(Ort::Value::CreateTensor<float>(memoryInfo, outputTensorValues.data(), outputlen, outputDimsN.data(), outputDimsN.size()));
-
-#if ORT_API_VERSION == 12
-  std::vector<const char *> inputNames{session->GetInputName(0, allocator)};
-  std::vector<const char *> outputNames{session->GetOutputName(0, allocator)};
-#elif ORT_API_VERSION == 22
-  std::vector<const char *> inputNames;
-  std::vector<const char *> outputNames;
-  char *name{nullptr};
-  for (const std::string &s : session->GetInputNames())
+  int64_t entrysize = 1;
+  for (const auto &dim : dims)
   {
-    name = new char[s.size() + 1];
-    sprintf(name, "%s", s.c_str()); //NOLINT(hicpp-vararg)
-    inputNames.push_back(name);
+    entrysize *= dim;
   }
-  for (const std::string &s : session->GetOutputNames())
+  if (static_cast<int64_t>(input.size()) < N * entrysize)
   {
-    name = new char[s.size() + 1];
-    sprintf(name, "%s", s.c_str()); //NOLINT(hicpp-vararg)
-    outputNames.push_back(name);
+    std::cout << "onnxlib::InferenceContext::run - input size " << input.size() << " too small for " << N << " entries of size " << entrysize << std::endl;
+    m_output.clear();
+    return m_output;
   }
-#else
-#define XSTR(x) STR(x)
-#define STR(x) #x
-#pragma message "ORT_API_VERSION " XSTR(ORT_API_VERSION) " not implemented"
-#endif
-  session->Run(Ort::RunOptions{nullptr}, inputNames.data(), inputTensors.data(), 1, outputNames.data(), outputTensors.data(), 1);
-#if ORT_API_VERSION == 22
-  for (const auto *iter : inputNames)
-  {
-    delete[] iter;
-  }
-  for (const auto *iter : outputNames)
+
+  m_output.resize(N * Nreturn);
+  const int64_t batchsize = m_batchsize > 0 ? m_batchsize : N;
+  for (int64_t first = 0; first < N; first += batchsize)
   {
-    delete[] iter;
+    const int64_t count = std::min<int64_t>(batchsize, N - first);
+
+    // onnxruntime does not modify inputs, but only provides non-const tensor creation
+    float *input_data = const_cast<float *>(input.data()) + first * entrysize;  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    float *output_data = m_output.data() + first * Nreturn;
+    if (count < batchsize)
+    {
+      // fixed batch size, pad the last batch with zeros
+      m_paddedInput.assign(batchsize * entrysize, 0);
+      std::copy(input_data, input_data + count * entrysize, m_paddedInput.begin());
+      m_paddedOutput.resize(batchsize * Nreturn);
+      input_data = m_paddedInput.data();
+      output_data = m_paddedOutput.data();
+    }
+
+    m_inputDims.assign(1, batchsize);
+    m_inputDims.insert(m_inputDims.end(), dims.begin(), dims.end());
+    m_outputDims = {batchsize, Nreturn};
+
+    m_binding.ClearBoundInputs();
+    m_binding.ClearBoundOutputs();
+    m_binding.BindInput(m_inputName.c_str(), Ort::Value::CreateTensor<float>(m_memoryInfo, input_data, batchsize * entrysize, m_inputDims.data(), m_inputDims.size()));
+    m_binding.BindOutput(m_outputName.c_str(), Ort::Value::CreateTensor<float>(m_memoryInfo, output_data, batchsize * Nreturn, m_outputDims.data(), m_outputDims.size()));
+    m_session->Run(Ort::RunOptions{nullptr}, m_binding);
+
+    if (count < batchsize)
+    {
+      std::copy(m_paddedOutput.begin(), m_paddedOutput.begin() + count * Nreturn, m_output.begin() + first * Nreturn);
+    }
   }
-#endif
-
-  return outputTensorValues;
+  return m_output;
 }
@@ -3,6 +3,12 @@
 
 #include <onnxruntime_c_api.h>
 #include <onnxruntime_cxx_api.h>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
 // This is a stub for some ONNX code refactoring
 
 Ort::Session *onnxSession(std::string &modelfile, int verbosity = 0);
@@ -15,6 +21,53 @@ namespace onnxlib
 {
   extern int n_input;
   extern int n_output;
+
+  /**
+   * Reusable inference context for a given session.
+   * Input/output names, memory info and the IO binding are set up once,
+   * and a full batch of N entries is evaluated in a single call.
+   * The session is not owned and must outlive the context.
+   * A context is not thread safe, use one per thread.
+   */
+  class InferenceContext
+  {
+   public:
+    explicit InferenceContext(Ort::Session *session);
+
+    //! input size per entry (second input dimension of the model)
+    int n_input() const { return m_n_input; }
+
+    //! output size per entry (second output dimension of the model)
+    int n_output() const { return m_n_output; }
+
+    //! run inference on N entries of shape dims (batch dimension excluded), stored contiguously in input
+    /**
+     * returns N x Nreturn values, valid until the next call.
+     * If the model has a fixed batch size, entries are evaluated in batches of that size
+     */
+    const std::vector<float> &run(std::span<const float> input, int N, const std::vector<int64_t> &dims, int Nreturn);
+
+   private:
+    Ort::Session *m_session{nullptr};
+    Ort::MemoryInfo m_memoryInfo{nullptr};
+    Ort::IoBinding m_binding{nullptr};
+
+    std::string m_inputName;
+    std::string m_outputName;
+
+    //! batch size fixed by the model, 0 if dynamic
+    int64_t m_batchsize{0};
+    int m_n_input{-1};
+    int m_n_output{-1};
+
+    std::vector<int64_t> m_inputDims;
+    std::vector<int64_t> m_outputDims;
+    std::vector<float> m_output;
+
+    //! padding buffers for incomplete fixed size batches
+    std::vector<float> m_paddedInput;
+    std::vector<float> m_paddedOutput;
+  };
 }  // namespace onnxlib
 
 #endif
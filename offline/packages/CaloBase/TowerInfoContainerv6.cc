@@ -0,0 +1,76 @@
+#include "TowerInfoContainerv6.h"
+
+#include <algorithm>
+
+TowerInfoContainerv6::TowerInfoContainerv6(DETECTOR detec)
+  : _detector(detec)
+{
+  // as tower numbers are fixed per event
+  // size the arrays once per run
+  size_t nchannels = get_channels(detec);
+  m_energy.resize(nchannels, 0);
+  m_time.resize(nchannels, 0);
+  m_chi2.resize(nchannels, 0);
+  m_pedestal.resize(nchannels, 0);
+  m_status.resize(nchannels, 0);
+}
+
+// the tower views point to their container, they are not copied
+TowerInfoContainerv6::TowerInfoContainerv6(const TowerInfoContainerv6& source)
+  : TowerInfoContainer(source)
+  , _detector(source.get_detectorid())
+  , m_energy(source.m_energy)
+  , m_time(source.m_time)
+  , m_chi2(source.m_chi2)
+  , m_pedestal(source.m_pedestal)
+  , m_status(source.m_status)
+{
+}
+
+void TowerInfoContainerv6::identify(std::ostream& os) const
+{
+  os << "TowerInfoContainerv6 of size " << size() << std::endl;
+}
+
+void TowerInfoContainerv6::Reset()
+{
+  // clear content of towers in the container for the next event
+  std::fill(m_energy.begin(), m_energy.end(), 0);
+  std::fill(m_time.begin(), m_time.end(), 0);
+  std::fill(m_chi2.begin(), m_chi2.end(), 0);
+  std::fill(m_pedestal.begin(), m_pedestal.end(), 0);
+  std::fill(m_status.begin(), m_status.end(), 0);
+}
+
+TowerInfoRef* TowerInfoContainerv6::get_tower_at_channel(int pos)
+{
+  if (pos < 0 || static_cast<size_t>(pos) >= size())
+  {
+    return nullptr;
+  }
+  if (m_towers.size() != size())
+  {
+    m_towers.clear();
+    m_towers.reserve(size());
+    for (unsigned int i = 0; i < size(); ++i)
+    {
+      m_towers.emplace_back(this, i);
+    }
+  }
+  return &m_towers[pos];
+}
+
+TowerInfoRef* TowerInfoContainerv6::get_tower_at_key(int pos)
+{
+  int index = decode_key(pos);
+  return get_tower_at_channel(index);
+}
+
+void TowerInfoContainerv6::copy_towers(const TowerInfoContainerv6& source)
+{
+  std::copy(source.m_energy.begin(), source.m_energy.end(), m_energy.begin());
+  std::copy(source.m_time.begin(), source.m_time.end(), m_time.begin());
+  std::copy(source.m_chi2.begin(), source.m_chi2.end(), m_chi2.begin());
+  std::copy(source.m_pedestal.begin(), source.m_pedestal.end(), m_pedestal.begin());
+  std::copy(source.m_status.begin(), source.m_status.end(), m_status.begin());
+}
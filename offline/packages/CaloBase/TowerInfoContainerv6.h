@@ -0,0 +1,81 @@
+#ifndef TOWERINFOCONTAINERV6_H
+#define TOWERINFOCONTAINERV6_H
+
+#include "TowerInfoContainer.h"
+#include "TowerInfoRef.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <vector>
+
+class PHObject;
+
+// same quantities as TowerInfoContainerv2 but stored as one array per quantity
+// indexed by channel. Unlike v1/v2, which quantize the time to short(t * 1000),
+// the time is kept as a float. Loops over all towers can use the spans directly,
+// get_tower_at_channel() returns a TowerInfo view of the arrays for
+// code written against the TowerInfoContainer interface
+class TowerInfoContainerv6 : public TowerInfoContainer
+{
+ public:
+  // status bits, same layout as TowerInfov2
+  static constexpr uint8_t kHot = 1U << 0U;
+  static constexpr uint8_t kFitStatus = 1U << 1U;
+  static constexpr uint8_t kBadChi2 = 1U << 2U;
+  static constexpr uint8_t kNotInstr = 1U << 3U;
+  static constexpr uint8_t kNoCalib = 1U << 4U;
+  static constexpr uint8_t kZS = 1U << 5U;
+  static constexpr uint8_t kRecovered = 1U << 6U;
+  static constexpr uint8_t kSaturated = 1U << 7U;
+
+  TowerInfoContainerv6(DETECTOR detec);
+
+  // default constructor for ROOT IO
+  TowerInfoContainerv6() = default;
+  PHObject *CloneMe() const override { return new TowerInfoContainerv6(*this); }
+  TowerInfoContainerv6(const TowerInfoContainerv6 &);
+  TowerInfoContainerv6 &operator=(const TowerInfoContainerv6 &) = delete;
+
+  ~TowerInfoContainerv6() override = default;
+
+  void identify(std::ostream &os = std::cout) const override;
+
+  void Reset() override;
+  TowerInfoRef *get_tower_at_channel(int pos) override;
+  TowerInfoRef *get_tower_at_key(int pos) override;
+
+  size_t size() const override { return m_energy.size(); }
+  DETECTOR get_detectorid() const override { return _detector; }
+
+  std::span<float> get_energies() { return m_energy; }
+  std::span<const float> get_energies() const { return m_energy; }
+  std::span<float> get_times() { return m_time; }
+  std::span<const float> get_times() const { return m_time; }
+  std::span<float> get_chi2s() { return m_chi2; }
+  std::span<const float> get_chi2s() const { return m_chi2; }
+  std::span<float> get_pedestals() { return m_pedestal; }
+  std::span<const float> get_pedestals() const { return m_pedestal; }
+  std::span<uint8_t> get_statuses() { return m_status; }
+  std::span<const uint8_t> get_statuses() const { return m_status; }
+
+  // copies all channels of source which must have the same size
+  void copy_towers(const TowerInfoContainerv6 &source);
+
+ protected:
+  DETECTOR _detector{DETECTOR_INVALID};
+
+ private:
+  std::vector<float> m_energy;
+  std::vector<float> m_time;
+  std::vector<float> m_chi2;
+  std::vector<float> m_pedestal;
+  std::vector<uint8_t> m_status;
+  // views handed out by get_tower_at_channel(), created on first use
+  std::vector<TowerInfoRef> m_towers;  //!
+
+  ClassDefOverride(TowerInfoContainerv6, 1);
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "TowerInfoRef.h"
+
+#include "TowerInfoContainerv6.h"
+
+void TowerInfoRef::Reset()
+{
+  set_energy(0);
+  set_time(0);
+  set_chi2(0);
+  set_pedestal(0);
+  set_status(0);
+}
+
+void TowerInfoRef::set_time(float t)
+{
+  m_container->get_times()[m_channel] = t;
+}
+
+float TowerInfoRef::get_time()
+{
+  return m_container->get_times()[m_channel];
+}
+
+void TowerInfoRef::set_energy(float energy)
+{
+  m_container->get_energies()[m_channel] = energy;
+}
+
+float TowerInfoRef::get_energy()
+{
+  return m_container->get_energies()[m_channel];
+}
+
+void TowerInfoRef::set_chi2(float chi2)
+{
+  m_container->get_chi2s()[m_channel] = chi2;
+}
+
+float TowerInfoRef::get_chi2()
+{
+  return m_container->get_chi2s()[m_channel];
+}
+
+void TowerInfoRef::set_pedestal(float pedestal)
+{
+  m_container->get_pedestals()[m_channel] = pedestal;
+}
+
+float TowerInfoRef::get_pedestal()
+{
+  return m_container->get_pedestals()[m_channel];
+}
+
+uint8_t TowerInfoRef::get_status() const
+{
+  return m_container->get_statuses()[m_channel];
+}
+
+void TowerInfoRef::set_status(uint8_t status)
+{
+  m_container->get_statuses()[m_channel] = status;
+}
+
+void TowerInfoRef::copy_tower(TowerInfo* tower)
+{
+  set_time(tower->get_time());
+  set_energy(tower->get_energy());
+  set_chi2(tower->get_chi2());
+  set_pedestal(tower->get_pedestal());
+  set_status(tower->get_status());
+}
+
+void TowerInfoRef::set_status_bit(int bit, bool value)
+{
+  if (bit < 0 || bit > 7)
+  {
+    return;
+  }
+  uint8_t &status = m_container->get_statuses()[m_channel];
+  status &= ~((uint8_t) 1 << bit);
+  status |= (uint8_t) value << bit;
+}
+
+bool TowerInfoRef::get_status_bit(int bit) const
+{
+  if (bit < 0 || bit > 7)
+  {
+    return false;  // default behavior
+  }
+  return (get_status() & ((uint8_t) 1 << bit)) != 0;
+}
@@ -0,0 +1,67 @@
+#ifndef TOWERINFOREF_H
+#define TOWERINFOREF_H
+
+#include "TowerInfo.h"
+
+#include <cstdint>
+
+class TowerInfoContainerv6;
+
+// transient view of one channel of a TowerInfoContainerv6, the data
+// live in the arrays of the container. Status bits as in TowerInfov2
+class TowerInfoRef : public TowerInfo
+{
+ public:
+  TowerInfoRef(TowerInfoContainerv6 *container, unsigned int channel)
+    : m_container(container)
+    , m_channel(channel)
+  {
+  }
+  ~TowerInfoRef() override = default;
+
+  void Reset() override;
+
+  void set_time(float t) override;
+  float get_time() override;
+  void set_time_short(short t) override { set_time(t); }
+  short get_time_short() override { return static_cast<short>(get_time()); }
+  void set_energy(float energy) override;
+  float get_energy() override;
+  void set_chi2(float chi2) override;
+  float get_chi2() override;
+  void set_pedestal(float pedestal) override;
+  float get_pedestal() override;
+
+  void set_isHot(bool isHot) override { set_status_bit(0, isHot); }
+  bool get_isHot() const override { return get_status_bit(0); }
+  void set_FitStatus(bool fitstatus) override { set_status_bit(1, fitstatus); }
+  bool get_FitStatus() const override { return get_status_bit(1); }
+  void set_isBadChi2(bool isBadChi2) override { set_status_bit(2, isBadChi2); }
+  bool get_isBadChi2() const override { return get_status_bit(2); }
+  void set_isNotInstr(bool isNotInstr) override { set_status_bit(3, isNotInstr); }
+  bool get_isNotInstr() const override { return get_status_bit(3); }
+  void set_isNoCalib(bool isNoCalib) override { set_status_bit(4, isNoCalib); }
+  bool get_isNoCalib() const override { return get_status_bit(4); }
+  void set_isZS(bool isZS) override { set_status_bit(5, isZS); }
+  bool get_isZS() const override { return get_status_bit(5); }
+  void set_isRecovered(bool isRecovered) override { set_status_bit(6, isRecovered); }
+  bool get_isRecovered() const override { return get_status_bit(6); }
+  void set_isSaturated(bool isSaturated) override { set_status_bit(7, isSaturated); }
+  bool get_isSaturated() const override { return get_status_bit(7); }
+
+  bool get_isGood() const override { return !(get_isHot() || get_isBadChi2() || get_isNoCalib() || get_isNotInstr()); }
+
+  uint8_t get_status() const override;
+  void set_status(uint8_t status) override;
+
+  void copy_tower(TowerInfo *tower) override;
+
+ private:
+  void set_status_bit(int bit, bool value);
+  bool get_status_bit(int bit) const;
+
+  TowerInfoContainerv6 *m_container{nullptr};
+  unsigned int m_channel{0};
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "CaloTowerBuilder.h"
 #include "CaloTowerDefs.h"
+#include "CaloWaveformFitting.h"
 
 #include <calobase/TowerInfo.h>
 #include <calobase/TowerInfoContainer.h>
@@ -9,6 +10,7 @@
 #include <calobase/TowerInfoContainerv2.h>
 #include <calobase/TowerInfoContainerv3.h>
 #include <calobase/TowerInfoContainerv4.h>
+#include <calobase/TowerInfoContainerv6.h>
 
 #include <ffarawobjects/CaloPacket.h>
 #include <ffarawobjects/CaloPacketContainer.h>
@@ -34,9 +36,13 @@
 
 #include <TSystem.h>
 
+#include <algorithm>
 #include <climits>
+#include <cstdint>
 #include <iostream>  // for operator<<, endl, basic...
 #include <memory>    // for allocator_traits<>::val...
+#include <span>
+#include <utility>  // for move
 #include <variant>
 #include <vector>  // for vector
 
@@ -46,6 +52,41 @@ static const std::map<CaloTowerDefs::DetectorSystem, std::string> nodemap{
     {CaloTowerDefs::HCALOUT, "HCALPackets"},
     {CaloTowerDefs::ZDC, "ZDCPackets"},
     {CaloTowerDefs::SEPD, "SEPDPackets"}};
+namespace
+{
+  int fill_waveforms(CaloPacket *packet, std::span<float> buffer, const int nchannels, const int nsamples, std::span<uint64_t> suppressed)
+  {
+    return packet->fillWaveforms(buffer, nchannels, nsamples, suppressed);
+  }
+
+  // same layout as CaloPacket::fillWaveforms() for the packets of the raw event
+  int fill_waveforms(Packet *packet, std::span<float> buffer, const int nchannels, const int nsamples, std::span<uint64_t> suppressed)
+  {
+    if (nchannels <= 0 || nsamples < 2)
+    {
+      return 0;
+    }
+    int nfill = std::min({nchannels, static_cast<int>(buffer.size() / nsamples), static_cast<int>(suppressed.size() * 64)});
+    std::fill(suppressed.begin(), suppressed.end(), 0);
+    for (int channel = 0; channel < nfill; channel++)
+    {
+      float *waveform = buffer.data() + static_cast<size_t>(channel) * nsamples;
+      if (packet->iValue(channel, "SUPPRESSED"))
+      {
+        suppressed[channel / 64] |= uint64_t{1} << (channel % 64);
+        waveform[0] = packet->iValue(channel, "PRE");
+        waveform[1] = packet->iValue(channel, "POST");
+        continue;
+      }
+      for (int samp = 0; samp < nsamples; samp++)
+      {
+        waveform[samp] = packet->iValue(samp, channel);
+      }
+    }
+    return nfill;
+  }
+}  // namespace
+
 //____________________________________________________________________________..
 CaloTowerBuilder::CaloTowerBuilder(const std::string &name)
   : SubsysReco(name)
@@ -178,6 +219,17 @@ int CaloTowerBuilder::InitRun(PHCompositeNode *topNode)
     cdbttree_tbt_zs = new CDBTTree(m_zsURL);
   }
 
+  auto packetnode = nodemap.find(m_dettype);
+  if (packetnode != nodemap.end())
+  {
+    m_PacketContainerHandle.name(packetnode->second);
+  }
+  m_PacketHandles.clear();
+  for (int pid = m_packet_low; pid <= m_packet_high; pid++)
+  {
+    m_PacketHandles.emplace_back(pid);
+  }
+
   CreateNodeTree(topNode);
   return Fun4AllReturnCodes::EVENT_OK;
 }
@@ -266,12 +318,12 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
   std::variant<CaloPacketContainer *, Event *> event;
   if (m_UseOfflinePacketFlag)
   {
-    CaloPacketContainer *calopacketcontainer = findNode::getClass<CaloPacketContainer>(topNode, nodemap.find(m_dettype)->second);
+    CaloPacketContainer *calopacketcontainer = m_PacketContainerHandle.get(topNode);
     if (!calopacketcontainer)
     {
-      for (int pid = m_packet_low; pid <= m_packet_high; pid++)
+      for (auto &packethandle : m_PacketHandles)
       {
-        if (findNode::getClass<CaloPacket>(topNode, pid))
+        if (packethandle.get(topNode))
         {
           m_PacketNodesFlag = true;
           break;
@@ -279,6 +331,7 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
       }
       if (!m_PacketNodesFlag)
       {
+        release_waveforms(waveforms, 0);
         return Fun4AllReturnCodes::EVENT_OK;
       }
     }
@@ -289,7 +342,7 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
   }
   else
   {
-    Event *_event = findNode::getClass<Event>(topNode, "PRDF");
+    Event *_event = m_EventHandle.get(topNode);
     if (_event == nullptr)
     {
       std::cout << PHWHERE << " Event not found" << std::endl;
@@ -301,6 +354,31 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
     }
     event = _event;
   }
+  // the waveform vectors of the caller are reused, they are only
+  // allocated when the number of channels grows
+  size_t nwaveforms = 0;
+  auto next_waveform = [this, &waveforms, &nwaveforms]() -> std::vector<float> &
+  {
+    if (nwaveforms == waveforms.size())
+    {
+      if (m_SpareWaveforms.empty())
+      {
+        waveforms.emplace_back();
+      }
+      else
+      {
+        waveforms.push_back(std::move(m_SpareWaveforms.back()));
+        m_SpareWaveforms.pop_back();
+      }
+    }
+    std::vector<float> &waveform = waveforms[nwaveforms++];
+    waveform.clear();
+    return waveform;
+  };
+  auto add_constant_waveform = [this, &next_waveform](const float value)
+  {
+    next_waveform().assign(m_nzerosuppsamples, value);
+  };
   // since the function call on Packet and CaloPacket is the same, maybe we can use lambda?
   auto process_packet = [&](auto *packet, int pid)
   {
@@ -317,13 +395,7 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
           {
             continue;
           }
-          std::vector<float> waveform;
-          waveform.reserve(m_nzerosuppsamples);
-          for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-          {
-            waveform.push_back(-1);
-          }
-          waveforms.push_back(waveform);
+          add_constant_waveform(-1);
         }
         return Fun4AllReturnCodes::EVENT_OK;
       }
@@ -341,6 +413,11 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
         return Fun4AllReturnCodes::ABORTEVENT;
       }
 
+      // all waveforms of the packet in one call: [channel][m_nsamples]
+      m_PacketWaveforms.resize(static_cast<size_t>(nchannels) * m_nsamples);
+      m_PacketSuppressed.resize((nchannels + 63) / 64);
+      int nfilled = fill_waveforms(packet, m_PacketWaveforms, nchannels, m_nsamples, m_PacketSuppressed);
+
       int n_pad_skip_mask = 0;
       for (int channel = 0; channel < nchannels; channel++)
       {
@@ -358,36 +435,28 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
               for (int iskip = 0; iskip < 64; iskip++)
               {
                 n_pad_skip_mask++;
-                std::vector<float> waveform;
-                waveform.reserve(m_nsamples);
-
-                for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-                {
-                  waveform.push_back(0);
-                }
-                waveforms.push_back(waveform);
-                waveform.clear();
+                add_constant_waveform(0);
               }
             }
           }
         }
 
-        std::vector<float> waveform;
-        waveform.reserve(m_nsamples);
-        if (packet->iValue(channel, "SUPPRESSED"))
+        std::vector<float> &waveform = next_waveform();
+        if (channel >= nfilled)
         {
-          waveform.push_back(packet->iValue(channel, "PRE"));
-          waveform.push_back(packet->iValue(channel, "POST"));
+          waveform.assign(m_nsamples, 0);
+          continue;
+        }
+        const float *samples = m_PacketWaveforms.data() + static_cast<size_t>(channel) * m_nsamples;
+        if ((m_PacketSuppressed[channel / 64] >> (channel % 64)) & 0x1U)
+        {
+          // pre and post
+          waveform.assign(samples, samples + 2);
         }
         else
         {
-          for (int samp = 0; samp < m_nsamples; samp++)
-          {
-            waveform.push_back(packet->iValue(samp, channel));
-          }
+          waveform.assign(samples, samples + m_nsamples);
         }
-        waveforms.push_back(waveform);
-        waveform.clear();
       }
 
       int nch_padded = nchannels;
@@ -403,15 +472,7 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
           {
             continue;
           }
-          std::vector<float> waveform;
-          waveform.reserve(m_nsamples);
-
-          for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-          {
-            waveform.push_back(0);
-          }
-          waveforms.push_back(waveform);
-          waveform.clear();
+          add_constant_waveform(0);
         }
       }
     }
@@ -423,14 +484,7 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
         {
           continue;
         }
-        std::vector<float> waveform;
-        waveform.reserve(2);
-        for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-        {
-          waveform.push_back(-1);  // push back -1 for missing packets
-        }
-        waveforms.push_back(waveform);
-        waveform.clear();
+        add_constant_waveform(-1);  // -1 for missing packets
       }
     }
     return Fun4AllReturnCodes::EVENT_OK;
@@ -462,13 +516,25 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
     }
     else
     {
-      CaloPacket *calopacket = findNode::getClass<CaloPacket>(topNode, pid);
+      CaloPacket *calopacket = m_PacketHandles[pid - m_packet_low].get(topNode);
       process_packet(calopacket, pid);
     }
   }
+  release_waveforms(waveforms, nwaveforms);
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
+
+//____________________________________________________________________________..
+void CaloTowerBuilder::release_waveforms(std::vector<std::vector<float>> &waveforms, const size_t nwaveforms)
+{
+  // the unused vectors keep their memory for the next events
+  while (waveforms.size() > nwaveforms)
+  {
+    m_SpareWaveforms.push_back(std::move(waveforms.back()));
+    waveforms.pop_back();
+  }
+}
 //____________________________________________________________________________..
 int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
 {
@@ -476,7 +542,7 @@ int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
   {
     return process_sim();
   }
-  std::vector<std::vector<float>> waveforms;
+  std::vector<std::vector<float>> &waveforms = m_Waveforms;
   if (process_data(topNode, waveforms) == Fun4AllReturnCodes::ABORTEVENT)
   {
     return Fun4AllReturnCodes::ABORTEVENT;
@@ -487,9 +553,10 @@ int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
   }
   // waveform vector is filled here, now fill our output. methods from the base class make sure
   // we only fill what the chosen container version supports
-  std::vector<std::vector<float>> processed_waveforms = WaveformProcessing->process_waveform(waveforms);
+  // the fit results are written to a buffer kept across events, nfitresults values per channel
+  WaveformProcessing->process_waveform(waveforms, m_FitResults);
 
-  int n_channels = processed_waveforms.size();
+  int n_channels = waveforms.size();
   for (int i = 0; i < n_channels; i++)
   {
     int idx = i;
@@ -498,15 +565,16 @@ int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
     {
       idx = cdbttree_sepd_map->GetIntValue(i, m_fieldname);
     }
+    const std::span<const float> fitresult(m_FitResults.data() + static_cast<size_t>(idx) * CaloWaveformFitting::nfitresults, CaloWaveformFitting::nfitresults);
     TowerInfo *towerinfo = m_CaloInfoContainer->get_tower_at_channel(i);
-    towerinfo->set_time(processed_waveforms.at(idx).at(1));
-    towerinfo->set_energy(processed_waveforms.at(idx).at(0));
-    towerinfo->set_time(processed_waveforms.at(idx).at(1));
-    towerinfo->set_pedestal(processed_waveforms.at(idx).at(2));
-    towerinfo->set_chi2(processed_waveforms.at(idx).at(3));
-    bool SZS = isSZS(processed_waveforms.at(idx).at(1), processed_waveforms.at(idx).at(3));
-
-    if (processed_waveforms.at(idx).at(4) == 0)
+    towerinfo->set_time(fitresult[1]);
+    towerinfo->set_energy(fitresult[0]);
+    towerinfo->set_time(fitresult[1]);
+    towerinfo->set_pedestal(fitresult[2]);
+    towerinfo->set_chi2(fitresult[3]);
+    bool SZS = isSZS(fitresult[1], fitresult[3]);
+
+    if (fitresult[4] == 0)
     {
       towerinfo->set_isRecovered(false);
     }
@@ -514,7 +582,7 @@ int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
     {
       towerinfo->set_isRecovered(true);
     }
-    towerinfo->set_FitStatus(static_cast<bool>(processed_waveforms.at(idx).at(5)));
+    towerinfo->set_FitStatus(static_cast<bool>(fitresult[5]));
     int n_samples = waveforms.at(idx).size();
     if (n_samples == m_nzerosuppsamples || SZS)
     {
@@ -537,8 +605,6 @@ int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
       towerinfo->set_waveform_value(j, waveforms.at(idx).at(j));
     }
   }
-  waveforms.clear();
-
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
@@ -669,6 +735,10 @@ void CaloTowerBuilder::CreateNodeTree(PHCompositeNode *topNode)
   {
     m_CaloInfoContainer = new TowerInfoContainerSimv1(DetectorEnum);
   }
+  else if (m_buildertype == CaloTowerDefs::kWaveformTowerv6)
+  {
+    m_CaloInfoContainer = new TowerInfoContainerv6(DetectorEnum);
+  }
   else
   {
     std::cout << PHWHERE << "invalid builder type " << m_buildertype << std::endl;
@@ -10,10 +10,17 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <phool/PHNodeHandle.h>
+
+#include <cstdint>
 #include <limits>
 #include <string>
+#include <vector>
 
+class CaloPacket;
+class CaloPacketContainer;
 class CaloWaveformProcessing;
+class Event;
 class PHCompositeNode;
 class TowerInfoContainer;
 class TowerInfoContainerv3;
@@ -130,12 +137,27 @@ public:
   CaloWaveformProcessing *get_WaveformProcessing() { return WaveformProcessing; }
 
 private:
+  //! keep the first nwaveforms waveforms, move the other vectors to the spare ones
+  void release_waveforms(std::vector<std::vector<float>> &waveforms, const size_t nwaveforms);
   int process_sim();
   bool skipChannel(int ich, int pid);
   static bool isSZS(float time, float chi2);
   CaloWaveformProcessing *WaveformProcessing{nullptr};
   TowerInfoContainer *m_CaloInfoContainer{nullptr};      //! Calo info
   TowerInfoContainer *m_CalowaveformContainer{nullptr};  // waveform from simulation
+  // input nodes, looked up once per run instead of every event
+  PHNodeHandle<CaloPacketContainer> m_PacketContainerHandle;
+  PHNodeHandle<Event> m_EventHandle{"PRDF"};
+  std::vector<PHNodeHandle<CaloPacket>> m_PacketHandles;  // index is pid - m_packet_low
+  // waveforms of one packet, [channel][m_nsamples], and the zero suppression bits of its channels
+  std::vector<float> m_PacketWaveforms;
+  std::vector<uint64_t> m_PacketSuppressed;
+  // waveforms of all channels of the event, kept to reuse their memory
+  std::vector<std::vector<float>> m_Waveforms;
+  // waveform vectors not used in the current event
+  std::vector<std::vector<float>> m_SpareWaveforms;
+  // fit results of all channels of the event, [channel][CaloWaveformFitting::nfitresults]
+  std::vector<float> m_FitResults;
   CDBTTree *cdbttree = nullptr;
   CDBTTree *cdbttree_sepd_map = nullptr;
   CDBTTree *cdbttree_tbt_zs = nullptr;
@@ -5,6 +5,7 @@
 #include <calobase/TowerInfoContainer.h>
 #include <calobase/TowerInfoContainerv1.h>
 #include <calobase/TowerInfoContainerv2.h>
+#include <calobase/TowerInfoContainerv6.h>
 #include <calobase/TowerInfov1.h>
 #include <calobase/TowerInfov2.h>
 
@@ -28,9 +29,12 @@
 
 #include <TSystem.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>    // for exit
 #include <exception>  // for exception
 #include <iostream>   // for operator<<, basic_ostream
+#include <span>
 #include <stdexcept>  // for runtime_error
 
 //____________________________________________________________________________..
@@ -242,22 +246,28 @@ void CaloTowerCalib::LoadCalib(PHCompositeNode *topNode)
 {
   TowerInfoContainer *_raw_towers = findNode::getClass<TowerInfoContainer>(topNode, RawTowerNodeName);
   unsigned int ntowers = _raw_towers->size();
-  m_cdbInfo_vec.resize(ntowers);
+  m_calibconst.assign(ntowers, 0);
+  m_crosscalibconst.assign(ntowers, 1);
+  m_meantime.assign(ntowers, 0);
 
   for (unsigned int channel = 0; channel < ntowers; channel++)
   {
     unsigned int key = _raw_towers->encode_key(channel);
 
-    m_cdbInfo_vec[channel].calibconst = cdbttree->GetFloatValue(key, m_fieldname);
+    m_calibconst[channel] = cdbttree->GetFloatValue(key, m_fieldname);
 
     if (m_doZScrosscalib)
     {
-      m_cdbInfo_vec[channel].crosscalibconst = cdbttree_ZScrosscalib->GetFloatValue(key, m_fieldname_ZScrosscalib);
+      float crosscalibconst = cdbttree_ZScrosscalib->GetFloatValue(key, m_fieldname_ZScrosscalib);
+      if (crosscalibconst != 0)
+      {
+        m_crosscalibconst[channel] = crosscalibconst;
+      }
     }
 
     if(m_dotimecalib)
     {
-      m_cdbInfo_vec[channel].meantime = cdbttree_time->GetFloatValue(key, m_fieldname_time);
+      m_meantime[channel] = cdbttree_time->GetFloatValue(key, m_fieldname_time);
     }
   }
 }
@@ -267,6 +277,13 @@ int CaloTowerCalib::process_event(PHCompositeNode *topNode)
 {
   TowerInfoContainer *_raw_towers = findNode::getClass<TowerInfoContainer>(topNode, RawTowerNodeName);
   TowerInfoContainer *_calib_towers = findNode::getClass<TowerInfoContainer>(topNode, CalibTowerNodeName);
+  const TowerInfoContainerv6 *raw_arrays = dynamic_cast<TowerInfoContainerv6 *>(_raw_towers);
+  TowerInfoContainerv6 *calib_arrays = dynamic_cast<TowerInfoContainerv6 *>(_calib_towers);
+  if (raw_arrays && calib_arrays)
+  {
+    CalibrateArrays(*raw_arrays, *calib_arrays);
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
   unsigned int ntowers = _raw_towers->size();
 
   for (unsigned int channel = 0; channel < ntowers; channel++)
@@ -274,16 +291,12 @@ int CaloTowerCalib::process_event(PHCompositeNode *topNode)
     TowerInfo *caloinfo_raw = _raw_towers->get_tower_at_channel(channel);
     _calib_towers->get_tower_at_channel(channel)->copy_tower(caloinfo_raw);
     float raw_amplitude = caloinfo_raw->get_energy();
-    float calibconst = m_cdbInfo_vec[channel].calibconst;
+    float calibconst = m_calibconst[channel];
     bool isZS = caloinfo_raw->get_isZS();
 
     if (isZS && m_doZScrosscalib)
     {
-      float crosscalibconst = m_cdbInfo_vec[channel].crosscalibconst;
-      if (crosscalibconst == 0) 
-      { 
-        crosscalibconst = 1; 
-      }
+      float crosscalibconst = m_crosscalibconst[channel];
       _calib_towers->get_tower_at_channel(channel)->set_energy(raw_amplitude * calibconst * crosscalibconst);
     }
     else
@@ -302,7 +315,7 @@ int CaloTowerCalib::process_event(PHCompositeNode *topNode)
       {
       //I realized that there is no point to do timing calibration for the towerinfov1 object since the resolution is not enough...
       float raw_time = caloinfo_raw->get_time();
-      float meantime = m_cdbInfo_vec[channel].meantime;
+      float meantime = m_meantime[channel];
       _calib_towers->get_tower_at_channel(channel)->set_time(raw_time - meantime);
       }
     }
@@ -310,6 +323,39 @@ int CaloTowerCalib::process_event(PHCompositeNode *topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+// same as the tower loop in process_event, written as plain loops over the
+// arrays without branches so the compiler can vectorize them
+void CaloTowerCalib::CalibrateArrays(const TowerInfoContainerv6 &raw_towers, TowerInfoContainerv6 &calib_towers) const
+{
+  calib_towers.copy_towers(raw_towers);
+  std::span<const float> raw_energy = raw_towers.get_energies();
+  std::span<float> energy = calib_towers.get_energies();
+  std::span<float> time = calib_towers.get_times();
+  std::span<uint8_t> status = calib_towers.get_statuses();
+  const float *calibconst = m_calibconst.data();
+  const float *crosscalibconst = m_crosscalibconst.data();
+  const float *meantime = m_meantime.data();
+  const size_t ntowers = std::min(raw_energy.size(), m_calibconst.size());
+  const bool doZScrosscalib = m_doZScrosscalib;
+
+  for (size_t channel = 0; channel < ntowers; channel++)
+  {
+    const bool isZS = (status[channel] & TowerInfoContainerv6::kZS) != 0;
+    const float crosscalib = (isZS && doZScrosscalib) ? crosscalibconst[channel] : 1.F;
+    energy[channel] = raw_energy[channel] * calibconst[channel] * crosscalib;
+    status[channel] |= (calibconst[channel] == 0) ? TowerInfoContainerv6::kNoCalib : 0;
+  }
+  if (m_dotimecalib)
+  {
+    // timing is not useful for ZS towers
+    for (size_t channel = 0; channel < ntowers; channel++)
+    {
+      const bool isZS = (status[channel] & TowerInfoContainerv6::kZS) != 0;
+      time[channel] -= isZS ? 0.F : meantime[channel];
+    }
+  }
+}
+
 void CaloTowerCalib::CreateNodeTree(PHCompositeNode *topNode)
 {
   PHNodeIterator iter(topNode);
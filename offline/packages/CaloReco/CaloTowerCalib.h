@@ -11,10 +11,12 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 class CDBTTree;
 class PHCompositeNode;
 class TowerInfoContainer;
+class TowerInfoContainerv6;
 
 class CaloTowerCalib : public SubsysReco
 {
@@ -160,15 +162,14 @@ class CaloTowerCalib : public SubsysReco
   CDBTTree *cdbttree_ZScrosscalib = nullptr;
 
   void LoadCalib(PHCompositeNode *topNode);
-
-  struct CDBInfo
-  {
-    float calibconst{0};
-    float crosscalibconst{0};
-    float meantime{0};
-  };
-
-  std::vector<CDBInfo> m_cdbInfo_vec;
+  // calibration of all channels in one pass over the arrays
+  void CalibrateArrays(const TowerInfoContainerv6 &raw_towers, TowerInfoContainerv6 &calib_towers) const;
+
+  // calibration constants by channel, the ZS cross calibration is 1 if
+  // it is missing in the CDB
+  std::vector<float> m_calibconst;
+  std::vector<float> m_crosscalibconst;
+  std::vector<float> m_meantime;
 };
 
 #endif  // CALOTOWERBUILDER_H
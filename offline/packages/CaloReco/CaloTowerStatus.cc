@@ -3,6 +3,7 @@
 
 #include <calobase/TowerInfo.h>  // for TowerInfo
 #include <calobase/TowerInfoContainer.h>
+#include <calobase/TowerInfoContainerv6.h>
 
 #include <cdbobjects/CDBTTree.h>  // for CDBTTree
 
@@ -18,7 +19,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <iostream>  // for operator<<, basic_ostream
+#include <span>
 
 //____________________________________________________________________________..
 CaloTowerStatus::CaloTowerStatus(const std::string &name)
@@ -178,6 +181,12 @@ void CaloTowerStatus::LoadCalib(CDBTTree *cdbttree_chi2, CDBTTree *cdbttree_hotM
 //____________________________________________________________________________..
 int CaloTowerStatus::process_event(PHCompositeNode * /*topNode*/)
 {
+  TowerInfoContainerv6 *raw_arrays = dynamic_cast<TowerInfoContainerv6 *>(m_raw_towers);
+  if (raw_arrays)
+  {
+    StatusArrays(*raw_arrays);
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
   unsigned int ntowers = m_raw_towers->size();
   float fraction_badChi2 = 0;
   int hotMap_val = 0;
@@ -237,6 +246,46 @@ int CaloTowerStatus::process_event(PHCompositeNode * /*topNode*/)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void CaloTowerStatus::StatusArrays(TowerInfoContainerv6 &towers) const
+{
+  std::span<const float> energy = towers.get_energies();
+  std::span<const float> chi2 = towers.get_chi2s();
+  std::span<uint8_t> status = towers.get_statuses();
+  const size_t ntowers = std::min(status.size(), m_cdbInfo_vec.size());
+  const bool default_zscore = (z_score_threshold == z_score_threshold_default);
+
+  for (size_t channel = 0; channel < ntowers; channel++)
+  {
+    // only reset what we will set
+    uint8_t towerstatus = status[channel] & ~(TowerInfoContainerv6::kHot | TowerInfoContainerv6::kBadChi2);
+    const CDBInfo &info = m_cdbInfo_vec[channel];
+
+    if (m_doHotChi2 && info.fraction_badChi2 > fraction_badChi2_threshold)
+    {
+      towerstatus |= TowerInfoContainerv6::kHot;
+    }
+    if (m_doHotMap)
+    {
+      // same hot and cold tower definitions as in process_event
+      const bool is_hot_tower = default_zscore
+                                    ? (info.hotMap_val > 0)
+                                    : (info.hotMap_val == 1 ||
+                                       std::abs(info.z_score) > z_score_threshold ||
+                                       (info.hotMap_val == 3 && info.z_score >= -1 * z_score_threshold_default));
+      if (is_hot_tower)
+      {
+        towerstatus |= TowerInfoContainerv6::kHot;
+      }
+    }
+    const float adc = energy[channel];
+    if (chi2[channel] > std::min(std::max(badChi2_treshold_const, adc * adc * badChi2_treshold_quadratic), badChi2_treshold_max))
+    {
+      towerstatus |= TowerInfoContainerv6::kBadChi2;
+    }
+    status[channel] = towerstatus;
+  }
+}
+
 void CaloTowerStatus::CreateNodeTree(PHCompositeNode *topNode)
 {
   std::string RawTowerNodeName = m_inputNodePrefix + m_detector;
@@ -13,6 +13,7 @@
 class CDBTTree;
 class PHCompositeNode;
 class TowerInfoContainer;
+class TowerInfoContainerv6;
 
 class CaloTowerStatus : public SubsysReco
 {
@@ -123,6 +124,9 @@ class CaloTowerStatus : public SubsysReco
 
   void LoadCalib(CDBTTree *cdbttree_chi2, CDBTTree *cdbttree_hotMap);
 
+  // same as process_event, directly on the arrays of a TowerInfoContainerv6
+  void StatusArrays(TowerInfoContainerv6 &towers) const;
+
   struct CDBInfo
   {
     float fraction_badChi2{0};
@@ -1,4 +1,8 @@
 #include "CaloWaveformFitting.h"
+#include "CaloWaveformTemplateFit.h"
+
+#include <fun4all/Fun4AllServer.h>
+#include <fun4all/Fun4AllTaskScheduler.h>
 
 #include <TF1.h>
 #include <TFile.h>
@@ -7,28 +11,14 @@
 #include <TSpline.h>
 #include <TFitResult.h>
 
-#include <Fit/BinData.h>
-#include <Fit/Chi2FCN.h>
-#include <Fit/Fitter.h>
-#include <Fit/UnBinData.h>
-#include <HFitInterface.h>
-#include <Math/WrappedMultiTF1.h>
-#include <Math/WrappedTF1.h>
-#include <ROOT/TThreadExecutor.hxx>
-#include <ROOT/TThreadedObject.hxx>
-
-#include <pthread.h>
 #include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <limits>
+#include <span>
 #include <string>
 
-static ROOT::TThreadExecutor *t = new ROOT::TThreadExecutor(1);  // NOLINT(misc-use-anonymous-namespace)
-double CaloWaveformFitting::template_function(double *x, double *par)
-{
-  Double_t v1 = (par[0] * h_template->Interpolate(x[0] - par[1])) + par[2];
-  return v1;
-}
+CaloWaveformFitting::CaloWaveformFitting() = default;
 
 CaloWaveformFitting::~CaloWaveformFitting()
 {
@@ -45,7 +35,16 @@ void CaloWaveformFitting::initialize_processing(const std::string &templatefile)
   fin->Close();
   delete fin;
   m_peakTimeTemp = h_template->GetBinCenter(h_template->GetMaximumBin());
-  t = new ROOT::TThreadExecutor(_nthreads);
+
+  // tabulate the template for the fits
+  std::vector<double> centers;
+  std::vector<double> values;
+  for (int i = 1; i <= h_template->GetNbinsX(); ++i)
+  {
+    centers.push_back(h_template->GetBinCenter(i));
+    values.push_back(h_template->GetBinContent(i));
+  }
+  m_TemplateFit = std::make_unique<CaloWaveformTemplateFit>(centers, values);
 }
 
 std::vector<std::vector<float>> CaloWaveformFitting::process_waveform(std::vector<std::vector<float>> waveformvector)
@@ -60,26 +59,47 @@ std::vector<std::vector<float>> CaloWaveformFitting::process_waveform(std::vecto
   return fitresults;
 }
 
-std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit(std::vector<std::vector<float>> chnlvector)
+std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit(const std::vector<std::vector<float>> &chnlvector, bool with_index)
 {
-  auto func = [&](std::vector<float> &v)
+  std::vector<float> flat_params;
+  calo_processing_templatefit(chnlvector, flat_params, with_index);
+  std::vector<std::vector<float>> fit_params(chnlvector.size());
+  for (size_t i = 0; i < fit_params.size(); ++i)
   {
-    int size1 = v.size() - 1;
+    fit_params[i].assign(flat_params.begin() + i * nfitresults, flat_params.begin() + (i + 1) * nfitresults);
+  }
+  return fit_params;
+}
+
+void CaloWaveformFitting::calo_processing_templatefit(const std::vector<std::vector<float>> &chnlvector, std::vector<float> &fit_params, bool with_index)
+{
+  // results are written directly to their final location, nfitresults values per channel
+  fit_params.resize(chnlvector.size() * nfitresults);
+
+  auto func = [&](const std::vector<float> &v, float *result)
+  {
+    unsigned int nresult = 0;
+    auto push_result = [result, &nresult](const float value)
+    { result[nresult++] = value; };
+
+    // the last element is the channel index, if any
+    const int size1 = with_index ? v.size() - 1 : v.size();
+    const std::span<const float> samples(v.data(), size1);
     if (size1 == _nzerosuppresssamples)
     {
-      v.push_back(v.at(1) - v.at(0));                        // returns peak sample - pedestal sample
-      v.push_back(std::numeric_limits<float>::quiet_NaN());  // set time to qnan for ZS
-      v.push_back(v.at(0));
+      push_result(v.at(1) - v.at(0));                        // returns peak sample - pedestal sample
+      push_result(std::numeric_limits<float>::quiet_NaN());  // set time to qnan for ZS
+      push_result(v.at(0));
       if (v.at(0) != 0 && v.at(1) == 0)  // check if post-sample is 0, if so set high chi2
       {
-        v.push_back(1000000);
+        push_result(1000000);
       }
       else
       {
-        v.push_back(std::numeric_limits<float>::quiet_NaN());
+        push_result(std::numeric_limits<float>::quiet_NaN());
       }
-      v.push_back(0);
-      v.push_back(0);
+      push_result(0);
+      push_result(0);
     }
     else
     {
@@ -109,89 +129,38 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
 
       if ((_bdosoftwarezerosuppression && v.at(6) - v.at(0) < _nsoftwarezerosuppression) || (_maxsoftwarezerosuppression && maxheight - pedestal < _nsoftwarezerosuppression))
       {
-        v.push_back(v.at(6) - v.at(0));
-        v.push_back(std::numeric_limits<float>::quiet_NaN());
-        v.push_back(v.at(0));
+        push_result(v.at(6) - v.at(0));
+        push_result(std::numeric_limits<float>::quiet_NaN());
+        push_result(v.at(0));
         if (v.at(0) != 0 && v.at(1) == 0)  // check if post-sample is 0, if so set high chi2
         {
-          v.push_back(1000000);
+          push_result(1000000);
         }
         else
         {
-          v.push_back(std::numeric_limits<float>::quiet_NaN());
+          push_result(std::numeric_limits<float>::quiet_NaN());
         }
-        v.push_back(0);
-        v.push_back(0);
+        push_result(0);
+        push_result(0);
       }
       else
       {
-        auto *h = new TH1F(std::string("h_" + std::to_string((int) round(v.at(size1)))).c_str(), "", size1, -0.5, size1 - 0.5);
-
-        int ndata = 0;
-        for (int i = 0; i < size1; ++i)
-        {
-          if ((v.at(i) == 16383) && _handleSaturation)
-          {
-            continue;
-          }
-
-          h->SetBinContent(i + 1, v.at(i));
-          h->SetBinError(i + 1, 1);
-          ndata++;
-        }
-        // if too many are saturated don't do the saturation recovery need enough ndf
-        if (ndata < (size1 - 4))
-        {
-          ndata = size1;
-          for (int i = 0; i < size1; ++i)
-          {
-            h->SetBinContent(i + 1, v.at(i));
-            h->SetBinError(i + 1, 1);
-          }
-        }
-
-        auto *f = new TF1(std::string("f_" + std::to_string((int) round(v.at(size1)))).c_str(), this, &CaloWaveformFitting::template_function, 0, 31, 3, "CaloWaveformFitting", "template_function");
-        ROOT::Math::WrappedMultiTF1 *fitFunction = new ROOT::Math::WrappedMultiTF1(*f, 3);
-        ROOT::Fit::BinData data(v.size() - 1, 1);
-        ROOT::Fit::FillData(data, h);
-        ROOT::Fit::Chi2Function *EPChi2 = new ROOT::Fit::Chi2Function(data, *fitFunction);
-        ROOT::Fit::Fitter *fitter = new ROOT::Fit::Fitter();
-        fitter->Config().MinimizerOptions().SetMinimizerType("GSLMultiFit");
-        fitter->Config().MinimizerOptions().SetPrintLevel(-1);
-        double params[] = {static_cast<double>(maxheight - pedestal), static_cast<double>(maxbin - m_peakTimeTemp), static_cast<double>(pedestal)};
-        // double params[] = {static_cast<double>(maxheight - pedestal), 0, static_cast<double>(pedestal)};
-        fitter->Config().SetParamsSettings(3, params);
-        fitter->Config().ParSettings(1).SetLimits(-1 * m_peakTimeTemp, size1 - m_peakTimeTemp);  // set lim on time par
+        // amplitude and pedestal are solved for, only the time is minimized
+        double tmin = -1 * m_peakTimeTemp;
+        double tmax = size1 - m_peakTimeTemp;
         if (m_setTimeLim)
         {
-          fitter->Config().ParSettings(1).SetLimits(m_timeLim_low, m_timeLim_high);
+          tmin = m_timeLim_low;
+          tmax = m_timeLim_high;
         }
-        fitter->FitFCN(*EPChi2, nullptr, data.Size(), true);
-        ROOT::Fit::FitResult fitres = fitter->Result();
-        // get the fit status code (0 means successful fit)
-        int validfit = fitres.Status();
-        /*
-        if(validfit != 0)
-        {
-          std::cout<<"invalid fit status in waveform fitting: " << validfit <<std::endl;
-          for (int i = 0; i < size1; ++i)
-        {
-          std::cout<<v.at(i) << " ";
-        }
-        std::cout<<std::endl;
-        }
-        */
-        double chi2min = fitres.MinFcnValue();
-        // chi2min /= size1 - 3;  // divide by the number of dof
-        chi2min /= ndata - 3;  // divide by the number of dof
-        if (chi2min > _chi2threshold && (f->GetParameter(2) < _bfr_highpedestalthreshold || pedestal < _bfr_highpedestalthreshold) && (f->GetParameter(2) > _bfr_lowpedestalthreshold || pedestal > _bfr_lowpedestalthreshold) && _dobitfliprecovery)
+        const auto fitres = m_TemplateFit->fit(samples, _handleSaturation, maxbin - m_peakTimeTemp, tmin, tmax);
+        const double chi2min = fitres.chi2 / (fitres.ndata - 3);  // divide by the number of dof
+
+        if (chi2min > _chi2threshold && (fitres.pedestal < _bfr_highpedestalthreshold || pedestal < _bfr_highpedestalthreshold) && (fitres.pedestal > _bfr_lowpedestalthreshold || pedestal > _bfr_lowpedestalthreshold) && _dobitfliprecovery)
         {
-          std::vector<float> rv;  // temporary recovered waveform
-          rv.reserve(size1);
-          for (int i = 0; i < size1; i++)
-          {
-            rv.push_back(v.at(i));
-          }
+          // temporary recovered waveform, in per-thread scratch
+          thread_local std::vector<float> rv;
+          rv.assign(samples.begin(), samples.end());
           unsigned int bits[3] = {8192, 4096, 2048};
           for (auto bit : bits)
           {
@@ -203,115 +172,46 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
               }
             }
           }
-          for (int i = 0; i < size1; i++)
-          {
-            h->SetBinContent(i + 1, rv.at(i));
-            h->SetBinError(i + 1, 1);
-          }
-
-          maxheight = 0;
-          maxbin = 0;
-          for (int i = 0; i < size1; i++)
-          {
-            if (rv.at(i) > maxheight)
-            {
-              maxheight = rv.at(i);
-              maxbin = i;
-            }
-          }
-          if (maxbin > 4)
-          {
-            pedestal = 0.5 * (rv.at(maxbin - 4) + rv.at(maxbin - 5));
-          }
-          else if (maxbin > 3)
-          {
-            pedestal = (rv.at(maxbin - 4));
-          }
-          else
-          {
-            pedestal = 0.5 * (rv.at(size1 - 3) + rv.at(size1 - 2));
-          }
 
-          auto *recover_f = new TF1(std::string("recover_f_" + std::to_string((int) round(v.at(size1)))).c_str(), this, &CaloWaveformFitting::template_function, 0, 31, 3, "CaloWaveformFitting", "template_function");
-          ROOT::Math::WrappedMultiTF1 *recoverFitFunction = new ROOT::Math::WrappedMultiTF1(*recover_f, 3);
-          ROOT::Fit::BinData recoverData(rv.size() - 1, 1);
-          ROOT::Fit::FillData(recoverData, h);
-          ROOT::Fit::Chi2Function *recoverEPChi2 = new ROOT::Fit::Chi2Function(recoverData, *recoverFitFunction);
-          ROOT::Fit::Fitter *recoverFitter = new ROOT::Fit::Fitter();
-          recoverFitter->Config().MinimizerOptions().SetMinimizerType("GSLMultiFit");
-          double recover_params[] = {static_cast<double>(maxheight - pedestal), 0, static_cast<double>(pedestal)};
-          recoverFitter->Config().SetParamsSettings(3, recover_params);
-          recoverFitter->Config().ParSettings(1).SetLimits(-1 * m_peakTimeTemp, size1 - m_peakTimeTemp);  // set lim on time par
-          recoverFitter->FitFCN(*recoverEPChi2, nullptr, recoverData.Size(), true);
-          ROOT::Fit::FitResult recover_fitres = recoverFitter->Result();
-          int recover_validfit = recover_fitres.Status();
-          double recover_chi2min = recover_fitres.MinFcnValue();
-          recover_chi2min /= size1 - 3;  // divide by the number of dof
-          if (recover_chi2min < _chi2lowthreshold && recover_f->GetParameter(2) < _bfr_highpedestalthreshold && recover_f->GetParameter(2) > _bfr_lowpedestalthreshold)
+          const auto recover_fitres = m_TemplateFit->fit(rv, false, 0, -1 * m_peakTimeTemp, size1 - m_peakTimeTemp);
+          const double recover_chi2min = recover_fitres.chi2 / (size1 - 3);  // divide by the number of dof
+          if (recover_chi2min < _chi2lowthreshold && recover_fitres.pedestal < _bfr_highpedestalthreshold && recover_fitres.pedestal > _bfr_lowpedestalthreshold)
           {
-            for (int i = 0; i < size1; i++)
-            {
-              v.at(i) = rv.at(i);
-            }
-            for (int i = 0; i < 3; i++)
-            {
-              v.push_back(recover_f->GetParameter(i));
-            }
-            v.push_back(recover_chi2min);
-            v.push_back(1);
-            v.push_back(recover_validfit);
+            push_result(recover_fitres.amplitude);
+            push_result(recover_fitres.time);
+            push_result(recover_fitres.pedestal);
+            push_result(recover_chi2min);
+            push_result(1);
+            push_result(recover_fitres.status);
           }
           else
           {
-            for (int i = 0; i < 3; i++)
-            {
-              v.push_back(f->GetParameter(i));
-            }
-            v.push_back(chi2min);
-            v.push_back(0);
-            v.push_back(validfit);
+            push_result(fitres.amplitude);
+            push_result(fitres.time);
+            push_result(fitres.pedestal);
+            push_result(chi2min);
+            push_result(0);
+            push_result(fitres.status);
           }
-          recover_f->Delete();
-          delete recoverFitFunction;
-          delete recoverFitter;
-          delete recoverEPChi2;
         }
         else
         {
-          for (int i = 0; i < 3; i++)
-          {
-            v.push_back(f->GetParameter(i));
-          }
-          v.push_back(chi2min);
-          v.push_back(0);
-          v.push_back(validfit);
+          push_result(fitres.amplitude);
+          push_result(fitres.time);
+          push_result(fitres.pedestal);
+          push_result(chi2min);
+          push_result(0);
+          push_result(fitres.status);
         }
-        h->Delete();
-        f->Delete();
-        delete fitFunction;
-        delete fitter;
-        delete EPChi2;
       }
     }
   };
 
-  t->Foreach(func, chnlvector);
-  int size3 = chnlvector.size();
-  std::vector<std::vector<float>> fit_params;
-  std::vector<float> fit_params_tmp;
-  for (int i = 0; i < size3; i++)
-  {
-    const std::vector<float> &tv = chnlvector.at(i);
-    int size2 = tv.size();
-    for (int q = 6; q > 0; q--)
-    {
-      fit_params_tmp.push_back(tv.at(size2 - q));
-    }
-    fit_params.push_back(fit_params_tmp);
-    fit_params_tmp.clear();
-  }
-  chnlvector.clear();
-  return fit_params;
+  // _nthreads limits the number of shared worker threads fitting these channels, 1 fits them in this thread
+  Fun4AllServer::instance()->TaskScheduler()->parallel_for(
+      "CaloWaveformFitting", chnlvector.size(), [&func, &chnlvector, &fit_params](std::size_t i)
+      { func(chnlvector[i], fit_params.data() + i * nfitresults); },
+      static_cast<unsigned int>(std::max(_nthreads, 1)));
 }
 
 void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float y1, float y2, float &xmax, float &ymax)
@@ -388,7 +288,19 @@ void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float
 }
 std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_fast(const std::vector<std::vector<float>> &chnlvector)
 {
-  std::vector<std::vector<float>> fit_values;
+  std::vector<float> flat_values;
+  calo_processing_fast(chnlvector, flat_values);
+  std::vector<std::vector<float>> fit_values(chnlvector.size());
+  for (size_t i = 0; i < fit_values.size(); ++i)
+  {
+    fit_values[i].assign(flat_values.begin() + i * nfitresults, flat_values.begin() + (i + 1) * nfitresults);
+  }
+  return fit_values;
+}
+
+void CaloWaveformFitting::calo_processing_fast(const std::vector<std::vector<float>> &chnlvector, std::vector<float> &fit_values)
+{
+  fit_values.clear();
   int nchnls = chnlvector.size();
   for (int m = 0; m < nchnls; m++)
   {
@@ -442,11 +354,8 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_fast(const
       }
     }
     amp -= ped;
-    std::vector<float> val = {amp, time, ped, chi2, 0, 0};
-    fit_values.push_back(val);
-    val.clear();
+    fit_values.insert(fit_values.end(), {amp, time, ped, chi2, 0, 0});
   }
-  return fit_values;
 }
 
 std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_nyquist(const std::vector<std::vector<float>> &chnlvector)
@@ -536,8 +445,7 @@ std::vector<float> CaloWaveformFitting::NyquistInterpolation(std::vector<float>
   double par[3] = {max - pedestal, maxpos - m_peakTimeTemp, pedestal};
   for (int i = 0; i < (int) vec_signal_samples.size(); i++)
   {
-    double xval[1] = {(double) i};
-    float diff = vec_signal_samples[i] - template_function(xval, par);
+    float diff = vec_signal_samples[i] - ((par[0] * m_TemplateFit->evaluate(i - par[1])) + par[2]);
     chi2 += diff * diff;
   }
   std::vector<float> val = {max - pedestal, maxpos, pedestal, chi2, 0, 0};
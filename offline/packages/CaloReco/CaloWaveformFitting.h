@@ -1,9 +1,11 @@
 #ifndef CALORECO_CALOWAVEFORMFITTING_H
 #define CALORECO_CALOWAVEFORMFITTING_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
+class CaloWaveformTemplateFit;
 class TProfile;
 
 class CaloWaveformFitting
@@ -16,7 +18,10 @@ class CaloWaveformFitting
     FERMIEXP = 2,
   };
 
-  CaloWaveformFitting() = default;
+  //! number of values per channel returned by the processing methods
+  static constexpr unsigned int nfitresults = 6;
+
+  CaloWaveformFitting();
   ~CaloWaveformFitting();
 
   void set_template_file(const std::string &template_input_file)
@@ -65,8 +70,14 @@ class CaloWaveformFitting
   }
 
   std::vector<std::vector<float>> process_waveform(std::vector<std::vector<float>> waveformvector);
-  std::vector<std::vector<float>> calo_processing_templatefit(std::vector<std::vector<float>> chnlvector);
+  //! template fit of each waveform, returns amplitude, time, pedestal, chi2/ndf, bit flip recovery flag and fit status
+  /** if with_index is true, the last element of each waveform is its channel index and is not fitted */
+  std::vector<std::vector<float>> calo_processing_templatefit(const std::vector<std::vector<float>> &chnlvector, bool with_index = true);
+  //! same, the results of channel i are fit_params[i * nfitresults] to fit_params[(i + 1) * nfitresults - 1]
+  /** fit_params is resized, its memory is reused from one call to the next */
+  void calo_processing_templatefit(const std::vector<std::vector<float>> &chnlvector, std::vector<float> &fit_params, bool with_index = true);
   static std::vector<std::vector<float>> calo_processing_fast(const std::vector<std::vector<float>> &chnlvector);
+  static void calo_processing_fast(const std::vector<std::vector<float>> &chnlvector, std::vector<float> &fit_values);
   std::vector<std::vector<float>> calo_processing_nyquist(const std::vector<std::vector<float>> &chnlvector);
   std::vector<std::vector<float>> calo_processing_funcfit(const std::vector<std::vector<float>> &chnlvector);
 
@@ -106,9 +117,9 @@ class CaloWaveformFitting
   static float stablepsinc(float t, std::vector<float> &vec_signal_samples);
 
   static float psinc(float t, std::vector<float> &vec_signal_samples);
-  double template_function(double *x, double *par);
 
   TProfile *h_template{nullptr};
+  std::unique_ptr<CaloWaveformTemplateFit> m_TemplateFit;
   double m_peakTimeTemp{0};
   int _nthreads{1};
   int _nzerosuppresssamples{2};
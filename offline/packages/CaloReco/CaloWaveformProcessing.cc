@@ -5,7 +5,7 @@
 
 #include <phool/onnxlib.h>
 
-#include <algorithm>  // for max
+#include <algorithm>  // for copy, max, min
 #include <cassert>
 #include <cstdlib>  // for getenv
 #include <iostream>
@@ -18,6 +18,8 @@ namespace
   Ort::Session *onnxmodule;
 }
 
+CaloWaveformProcessing::CaloWaveformProcessing() = default;
+
 CaloWaveformProcessing::~CaloWaveformProcessing()
 {
   delete m_Fitter;
@@ -57,6 +59,7 @@ void CaloWaveformProcessing::initialize_processing()
     // std::string calibrations_repo_model = m_model_name;
     // url_onnx = CDBInterface::instance()->getUrl("CEMC_ONNX", m_model_name);
     onnxmodule = onnxSession(m_model_name, Verbosity());
+    m_onnxcontext = std::make_unique<onnxlib::InferenceContext>(onnxmodule);
   }
   else if (m_processingtype == CaloWaveformProcessing::NYQUIST)
   {
@@ -80,17 +83,13 @@ void CaloWaveformProcessing::initialize_processing()
   }
 }
 
-std::vector<std::vector<float>> CaloWaveformProcessing::process_waveform(std::vector<std::vector<float>> waveformvector)
+std::vector<std::vector<float>> CaloWaveformProcessing::process_waveform(const std::vector<std::vector<float>> &waveformvector)
 {
-  unsigned int size1 = waveformvector.size();
   std::vector<std::vector<float>> fitresults;
   if (m_processingtype == CaloWaveformProcessing::TEMPLATE || m_processingtype == CaloWaveformProcessing::TEMPLATE_NOSAT)
   {
-    for (unsigned int i = 0; i < size1; i++)
-    {
-      waveformvector.at(i).push_back((float) i);
-    }
-    fitresults = m_Fitter->calo_processing_templatefit(waveformvector);
+    // waveforms are fitted in place, without appending the channel index
+    fitresults = m_Fitter->calo_processing_templatefit(waveformvector, false);
   }
   if (m_processingtype == CaloWaveformProcessing::ONNX)
   {
@@ -111,11 +110,41 @@ std::vector<std::vector<float>> CaloWaveformProcessing::process_waveform(std::ve
   return fitresults;
 }
 
+void CaloWaveformProcessing::process_waveform(const std::vector<std::vector<float>> &waveformvector, std::vector<float> &fitresults)
+{
+  if (m_processingtype == CaloWaveformProcessing::TEMPLATE || m_processingtype == CaloWaveformProcessing::TEMPLATE_NOSAT)
+  {
+    m_Fitter->calo_processing_templatefit(waveformvector, fitresults, false);
+    return;
+  }
+  if (m_processingtype == CaloWaveformProcessing::FAST)
+  {
+    CaloWaveformFitting::calo_processing_fast(waveformvector, fitresults);
+    return;
+  }
+
+  // the other methods return one vector per channel, copied to the flat output
+  const std::vector<std::vector<float>> results = process_waveform(waveformvector);
+  fitresults.assign(results.size() * CaloWaveformFitting::nfitresults, 0);
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const size_t n = std::min<size_t>(results[i].size(), CaloWaveformFitting::nfitresults);
+    std::copy(results[i].begin(), results[i].begin() + n, fitresults.begin() + i * CaloWaveformFitting::nfitresults);
+  }
+}
+
 std::vector<std::vector<float>> CaloWaveformProcessing::calo_processing_ONNX(const std::vector<std::vector<float>> &chnlvector)
 {
   std::vector<std::vector<float>> fit_values;
   std::vector<float> val;  // single row to return
   unsigned int nchnls = chnlvector.size();
+  fit_values.reserve(nchnls);
+
+  // waveforms passed to the network are collected and evaluated in a single batch
+  const int n_input = m_onnxcontext->n_input();
+  const int n_output = m_onnxcontext->n_output();
+  std::vector<unsigned int> onnx_channels;
+  m_onnxinput.clear();
   for (unsigned int m = 0; m < nchnls; m++)
   {
     val.clear();
@@ -186,19 +215,10 @@ std::vector<std::vector<float>> CaloWaveformProcessing::calo_processing_ONNX(con
         unsigned int nsamples = v.size();
         if (nsamples == 12)
         {
-          // downstream onnx does not have a static input vector API,
-          // so we need to make a copy
-          std::vector<float> vtmp(v);  // NOLINT(performance-unnecessary-copy-initialization)
-          val = onnxInference(onnxmodule, vtmp, 1, onnxlib::n_input, onnxlib::n_output);
-          unsigned int nvals = val.size();
-          for (unsigned int i = 0; i < nvals; i++)
-          {
-            val.at(i) = val.at(i) * m_Onnx_factor.at(i) + m_Onnx_offset.at(i);
-          }
-          val.push_back(2000);
-          val.push_back(0);
-          val.push_back(0);
-          fit_values.push_back(val);
+          // filled once the batch is evaluated
+          onnx_channels.push_back(m);
+          m_onnxinput.insert(m_onnxinput.end(), v.begin(), v.end());
+          fit_values.emplace_back();
         }
         else
         {
@@ -209,6 +229,28 @@ std::vector<std::vector<float>> CaloWaveformProcessing::calo_processing_ONNX(con
       }
     }
   }
+
+  if (!onnx_channels.empty())
+  {
+    const auto &result = m_onnxcontext->run(m_onnxinput, onnx_channels.size(), {n_input}, n_output);
+    if (result.size() != onnx_channels.size() * n_output)
+    {
+      std::cout << "CaloWaveformProcessing::calo_processing_ONNX - inference failed, model input size: " << n_input << std::endl;
+      exit(1);
+    }
+    for (unsigned int ich = 0; ich < onnx_channels.size(); ++ich)
+    {
+      auto &channel_val = fit_values[onnx_channels[ich]];
+      channel_val.assign(result.begin() + ich * n_output, result.begin() + (ich + 1) * n_output);
+      for (int i = 0; i < n_output; i++)
+      {
+        channel_val.at(i) = channel_val.at(i) * m_Onnx_factor.at(i) + m_Onnx_offset.at(i);
+      }
+      channel_val.push_back(2000);
+      channel_val.push_back(0);
+      channel_val.push_back(0);
+    }
+  }
   return fit_values;
 }
 
@@ -4,11 +4,17 @@
 #include <fun4all/SubsysReco.h>
 
 #include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
 class CaloWaveformFitting;
 
+namespace onnxlib
+{
+  class InferenceContext;
+}
+
 class CaloWaveformProcessing : public SubsysReco
 {
  public:
@@ -23,7 +29,7 @@ class CaloWaveformProcessing : public SubsysReco
     FUNCFIT = 6,
   };
 
-  CaloWaveformProcessing() = default;
+  CaloWaveformProcessing();
   ~CaloWaveformProcessing() override;
 
   void set_processing_type(CaloWaveformProcessing::process modelno)
@@ -96,7 +102,10 @@ class CaloWaveformProcessing : public SubsysReco
     _doubleexp_ratio = ratio;
   }
 
-  std::vector<std::vector<float>> process_waveform(std::vector<std::vector<float>> waveformvector);
+  std::vector<std::vector<float>> process_waveform(const std::vector<std::vector<float>> &waveformvector);
+  //! same, the results of channel i are fitresults[i * CaloWaveformFitting::nfitresults] and the next ones
+  /** fitresults is resized, its memory is reused from one call to the next. The template and fast methods write it directly */
+  void process_waveform(const std::vector<std::vector<float>> &waveformvector, std::vector<float> &fitresults);
   std::vector<std::vector<float>> calo_processing_ONNX(const std::vector<std::vector<float>> &chnlvector);
 
   void initialize_processing();
@@ -127,6 +136,10 @@ class CaloWaveformProcessing : public SubsysReco
 
   std::string url_onnx;
   std::string m_model_name{"CEMC_ONNX"};
+  std::unique_ptr<onnxlib::InferenceContext> m_onnxcontext;
+
+  //! batched network input, reused across events
+  std::vector<float> m_onnxinput;
   std::array<double, 4> m_Onnx_factor{std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()};
   std::array<double, 4> m_Onnx_offset{std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN()};
 
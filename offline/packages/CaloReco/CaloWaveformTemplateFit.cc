@@ -0,0 +1,284 @@
+#include "CaloWaveformTemplateFit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+  // initial step of the downhill search, in samples
+  constexpr double kStep = 0.25;
+
+  // tolerance on the fitted time, in samples
+  constexpr double kTolerance = 1e-5;
+
+  constexpr int kMaxIterations = 100;
+}  // namespace
+
+//____________________________________________________________________________
+CaloWaveformTemplateFit::CaloWaveformTemplateFit(const std::vector<double>& centers, const std::vector<double>& values)
+  : m_centers(centers)
+  , m_values(values)
+{
+  if (m_centers.size() != m_values.size() || m_centers.empty())
+  {
+    std::cout << "CaloWaveformTemplateFit::CaloWaveformTemplateFit - invalid template, " << m_centers.size() << " centers, " << m_values.size() << " values" << std::endl;
+    m_centers.assign(1, 0);
+    m_values.assign(1, 0);
+  }
+
+  // same arithmetic as TH1::Interpolate, so that values are identical
+  m_slopes.assign(m_centers.size(), 0);
+  for (size_t i = 0; i + 1 < m_centers.size(); ++i)
+  {
+    m_slopes[i] = (m_values[i + 1] - m_values[i]) / (m_centers[i + 1] - m_centers[i]);
+  }
+
+  if (m_centers.size() > 1)
+  {
+    m_width = (m_centers.back() - m_centers.front()) / (m_centers.size() - 1);
+    m_uniform = true;
+    for (size_t i = 0; i + 1 < m_centers.size() && m_uniform; ++i)
+    {
+      m_uniform = std::abs(m_centers[i + 1] - m_centers[i] - m_width) < 1e-9 * m_width;
+    }
+  }
+}
+
+//____________________________________________________________________________
+double CaloWaveformTemplateFit::evaluate(double x) const
+{
+  if (x <= m_centers.front())
+  {
+    return m_values.front();
+  }
+  if (x >= m_centers.back())
+  {
+    return m_values.back();
+  }
+
+  // find bin such that m_centers[bin] < x <= m_centers[bin+1]
+  size_t bin = 0;
+  if (m_uniform)
+  {
+    bin = std::min(static_cast<size_t>((x - m_centers.front()) / m_width), m_centers.size() - 2);
+    while (bin > 0 && m_centers[bin] >= x)
+    {
+      --bin;
+    }
+    while (bin + 2 < m_centers.size() && m_centers[bin + 1] < x)
+    {
+      ++bin;
+    }
+  }
+  else
+  {
+    bin = std::lower_bound(m_centers.begin(), m_centers.end(), x) - m_centers.begin() - 1;
+  }
+  return m_values[bin] + (x - m_centers[bin]) * m_slopes[bin];
+}
+
+//____________________________________________________________________________
+double CaloWaveformTemplateFit::chi2(std::span<const double> x, std::span<const double> y, double time, Result* result) const
+{
+  // sums needed for the 2x2 linear system in amplitude and pedestal
+  const double n = x.size();
+  double st = 0;
+  double stt = 0;
+  double sy = 0;
+  double sty = 0;
+  double syy = 0;
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    const double t = evaluate(x[i] - time);
+    st += t;
+    stt += t * t;
+    sy += y[i];
+    sty += t * y[i];
+    syy += y[i] * y[i];
+  }
+
+  double amplitude = 0;
+  double pedestal = sy / n;
+  const double det = n * stt - st * st;
+  if (det > 1e-12 * n * stt)
+  {
+    amplitude = (n * sty - st * sy) / det;
+    pedestal = (sy - amplitude * st) / n;
+  }
+
+  // residual sum of squares at the least squares solution
+  const double value = std::max(0., syy - amplitude * sty - pedestal * sy);
+  if (result)
+  {
+    result->amplitude = amplitude;
+    result->pedestal = pedestal;
+    result->time = time;
+    result->chi2 = value;
+  }
+  return value;
+}
+
+//____________________________________________________________________________
+CaloWaveformTemplateFit::Result CaloWaveformTemplateFit::fit(std::span<const float> samples, bool skip_saturated, double t0, double tmin, double tmax) const
+{
+  // per-thread scratch buffers for the fitted points
+  thread_local std::vector<double> xs;
+  thread_local std::vector<double> ys;
+  xs.clear();
+  ys.clear();
+
+  const int nsamples = samples.size();
+  for (int i = 0; i < nsamples; ++i)
+  {
+    if (skip_saturated && samples[i] == kSaturation)
+    {
+      continue;
+    }
+    xs.push_back(i);
+    ys.push_back(samples[i]);
+  }
+
+  // if too many are saturated don't do the saturation recovery, need enough ndf
+  if (static_cast<int>(xs.size()) < nsamples - 4)
+  {
+    xs.clear();
+    ys.clear();
+    for (int i = 0; i < nsamples; ++i)
+    {
+      xs.push_back(i);
+      ys.push_back(samples[i]);
+    }
+  }
+
+  Result result;
+  result.ndata = xs.size();
+  if (xs.empty())
+  {
+    result.status = 1;
+    return result;
+  }
+
+  const std::span<const double> x(xs);
+  const std::span<const double> y(ys);
+  auto f = [&](double time)
+  { return chi2(x, y, time); };
+
+  // downhill search from the starting point, until the minimum is bracketed or a limit is reached
+  double b = std::clamp(t0, tmin, tmax);
+  double fb = f(b);
+  double a = std::max(tmin, b - kStep);
+  double c = std::min(tmax, b + kStep);
+  const double fa = f(a);
+  const double fc = f(c);
+  if (fa < fb || fc < fb)
+  {
+    const double direction = fa < fc ? -1 : 1;
+    double next = direction < 0 ? a : c;
+    double fnext = direction < 0 ? fa : fc;
+    double step = kStep;
+    while (fnext < fb)
+    {
+      b = next;
+      fb = fnext;
+      if (b <= tmin || b >= tmax)
+      {
+        break;
+      }
+      step *= 1.6;
+      next = std::clamp(b + direction * step, tmin, tmax);
+      fnext = f(next);
+    }
+    a = std::max(tmin, std::min(b - step, next));
+    c = std::min(tmax, std::max(b + step, next));
+  }
+
+  // Brent minimization in [a, c], starting from b
+  constexpr double golden = 0.3819660112501051;
+  double xmin = b;
+  double w = b;
+  double v = b;
+  double fx = fb;
+  double fw = fb;
+  double fv = fb;
+  double d = 0;
+  double e = 0;
+  result.status = 1;
+  for (int iter = 0; iter < kMaxIterations; ++iter)
+  {
+    const double middle = 0.5 * (a + c);
+    const double tol1 = kTolerance * std::abs(xmin) + kTolerance;
+    const double tol2 = 2 * tol1;
+    if (std::abs(xmin - middle) <= tol2 - 0.5 * (c - a))
+    {
+      result.status = 0;
+      break;
+    }
+
+    bool golden_step = true;
+    if (std::abs(e) > tol1)
+    {
+      // try a parabolic fit through x, v, w
+      const double r = (xmin - w) * (fx - fv);
+      double q = (xmin - v) * (fx - fw);
+      double p = (xmin - v) * q - (xmin - w) * r;
+      q = 2 * (q - r);
+      if (q > 0)
+      {
+        p = -p;
+      }
+      q = std::abs(q);
+      const double etemp = e;
+      e = d;
+      if (std::abs(p) < std::abs(0.5 * q * etemp) && p > q * (a - xmin) && p < q * (c - xmin))
+      {
+        d = p / q;
+        const double u = xmin + d;
+        if (u - a < tol2 || c - u < tol2)
+        {
+          d = middle > xmin ? tol1 : -tol1;
+        }
+        golden_step = false;
+      }
+    }
+    if (golden_step)
+    {
+      e = (xmin >= middle) ? a - xmin : c - xmin;
+      d = golden * e;
+    }
+
+    const double u = std::abs(d) >= tol1 ? xmin + d : xmin + (d > 0 ? tol1 : -tol1);
+    const double fu = f(u);
+    if (fu <= fx)
+    {
+      (u >= xmin ? a : c) = xmin;
+      v = w;
+      fv = fw;
+      w = xmin;
+      fw = fx;
+      xmin = u;
+      fx = fu;
+    }
+    else
+    {
+      (u < xmin ? a : c) = u;
+      if (fu <= fw || w == xmin)
+      {
+        v = w;
+        fv = fw;
+        w = u;
+        fw = fu;
+      }
+      else if (fu <= fv || v == xmin || v == w)
+      {
+        v = u;
+        fv = fu;
+      }
+    }
+  }
+
+  const int status = result.status;
+  chi2(x, y, xmin, &result);
+  result.status = status;
+  return result;
+}
@@ -0,0 +1,65 @@
+#ifndef CALORECO_CALOWAVEFORMTEMPLATEFIT_H
+#define CALORECO_CALOWAVEFORMTEMPLATEFIT_H
+
+#include <span>
+#include <vector>
+
+/**
+ * Template fit of calorimeter waveforms: samples are fitted to
+ * amplitude * template(x - time) + pedestal, x being the sample index.
+ * For a given time, amplitude and pedestal are the linear least squares
+ * solution, so the only numerical minimization is a 1D search over time.
+ * The template is tabulated once and evaluated exactly as TH1::Interpolate.
+ * Fits only use per-thread scratch buffers, so that a single instance can be
+ * shared between worker threads.
+ */
+class CaloWaveformTemplateFit
+{
+ public:
+  //! ADC value of saturated samples
+  static constexpr float kSaturation = 16383;
+
+  struct Result
+  {
+    double amplitude{0};
+    double time{0};
+    double pedestal{0};
+
+    //! chi2 (not normalized)
+    double chi2{0};
+
+    //! number of fitted samples
+    int ndata{0};
+
+    //! 0 if the minimization converged
+    int status{0};
+  };
+
+  //! template from bin centers and bin contents
+  CaloWaveformTemplateFit(const std::vector<double>& centers, const std::vector<double>& values);
+
+  //! template value at x, linearly interpolated between bin centers
+  double evaluate(double x) const;
+
+  //! fit samples, starting from time t0, with time limited to [tmin, tmax]
+  /**
+   * if skip_saturated is true, saturated samples are excluded from the fit,
+   * unless fewer than nsamples - 4 samples would remain
+   */
+  Result fit(std::span<const float> samples, bool skip_saturated, double t0, double tmin, double tmax) const;
+
+ private:
+  //! chi2 of the (x, y) points at a given time, with amplitude and pedestal solved for
+  double chi2(std::span<const double> x, std::span<const double> y, double time, Result* result = nullptr) const;
+
+  //! bin centers, values and slopes to the next bin
+  std::vector<double> m_centers;
+  std::vector<double> m_values;
+  std::vector<double> m_slopes;
+
+  //! uniform bin centers allow direct bin lookup
+  bool m_uniform{false};
+  double m_width{0};
+};
+
+#endif
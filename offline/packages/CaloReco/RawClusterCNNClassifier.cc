@@ -29,6 +29,7 @@ I trained a crappy CNN to classify EMCal clusters as photon or not photon. S.Li
 #include <phool/phool.h>
 
 #include <iostream>
+#include <memory>
 #include <vector>
 
 RawClusterCNNClassifier::RawClusterCNNClassifier(const std::string &name)
@@ -38,6 +39,8 @@ RawClusterCNNClassifier::RawClusterCNNClassifier(const std::string &name)
 
 RawClusterCNNClassifier::~RawClusterCNNClassifier()
 {
+  // the context refers to the session
+  m_onnxcontext.reset();
   delete onnxmodule;
 }
 
@@ -45,6 +48,7 @@ int RawClusterCNNClassifier::Init(PHCompositeNode *topNode)
 {
   // init the onnx model
   onnxmodule = onnxSession(m_modelPath,Verbosity());
+  m_onnxcontext = std::make_unique<onnxlib::InferenceContext>(onnxmodule);
 
   if (m_inputNodeName == m_outputNodeName)
   {
@@ -98,6 +102,11 @@ int RawClusterCNNClassifier::process_event(PHCompositeNode *topNode)
     return Fun4AllReturnCodes::ABORTEVENT;
   }
 
+  // cluster images are collected and classified in a single batch
+  const int vectorSize = inputDimx * inputDimy;
+  std::vector<RawCluster *> classified_clusters;
+  m_input.clear();
+
   RawClusterContainer::Map clusterMap = _clusters->getClustersMap();
   for (auto &clusterPair : clusterMap)
   {
@@ -152,7 +161,6 @@ int RawClusterCNNClassifier::process_event(PHCompositeNode *topNode)
     // find the N by N tower around the max tower
     std::vector<float> input;
     // resize to inputDimx * inputDimy
-    int vectorSize = inputDimx * inputDimy;
     input.resize(vectorSize, 0);
 
     if (maxtowerE > 0)
@@ -191,10 +199,18 @@ int RawClusterCNNClassifier::process_event(PHCompositeNode *topNode)
         }
       }
     }
-    std::vector<float> prob = onnxInference(onnxmodule, input, 1, inputDimx, inputDimy, inputDimz, outputDim);
-    // std::cout << "new prob: " << prob[0] << "ET: " << ET << " original prob: " << recoCluster->get_prob() << std::endl;
-    // inplace change for the prob for now
-    recoCluster->set_prob(prob[0]);
+    classified_clusters.push_back(recoCluster);
+    m_input.insert(m_input.end(), input.begin(), input.end());
+  }
+
+  if (!classified_clusters.empty())
+  {
+    const std::vector<float> &prob = m_onnxcontext->run(m_input, classified_clusters.size(), {inputDimx, inputDimy, inputDimz}, outputDim);
+    for (size_t i = 0; i < classified_clusters.size(); ++i)
+    {
+      // inplace change for the prob for now
+      classified_clusters[i]->set_prob(prob.at(i * outputDim));
+    }
   }
 
   return Fun4AllReturnCodes::EVENT_OK;
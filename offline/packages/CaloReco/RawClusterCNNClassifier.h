@@ -5,6 +5,9 @@
 
 #include <phool/onnxlib.h>
 
+#include <memory>
+#include <vector>
+
 class PHCompositeNode;
 class RawClusterContainer;
 
@@ -33,6 +36,11 @@ class RawClusterCNNClassifier : public SubsysReco
   void CreateNodes(PHCompositeNode* topNode);
 
   Ort::Session *onnxmodule{nullptr};
+  std::unique_ptr<onnxlib::InferenceContext> m_onnxcontext;
+
+  //! batched network input, reused across events
+  std::vector<float> m_input;
+
   const int inputDimx{5};
   const int inputDimy{5};
   const int inputDimz{1};
@@ -3,6 +3,8 @@
 
 // units of this class. To convert internal value to Geant4/CLHEP units for fast access
 
+#include <cstddef>
+
 //! \brief transient object for field storage and access
 class PHField
 {
@@ -30,6 +32,21 @@ class PHField
       double *Bfield) const
   { return GetFieldValue( Point, Bfield ); }
 
+  //! access field values for many points at once
+  /* thread safe as long as GetFieldValue_nocache is. By default, loops over GetFieldValue_nocache */
+  //! @param[in]  Points  npoints space time coordinates. x, y, z, t in Geant4/CLHEP units
+  //! @param[out] Bfields npoints field values. Bx, By, Bz in Geant4/CLHEP units
+  virtual void GetFieldValues(
+      const double Points[][4],
+      double Bfields[][3],
+      const std::size_t npoints) const
+  {
+    for (std::size_t i = 0; i < npoints; ++i)
+    {
+      GetFieldValue_nocache(Points[i], Bfields[i]);
+    }
+  }
+
   //! verbosity
   void Verbosity(const int i) { m_Verbosity = i; }
 
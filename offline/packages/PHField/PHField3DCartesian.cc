@@ -1,5 +1,6 @@
 #include "PHField3DCartesian.h"
 
+#include <phool/PHGridFile.h>
 #include <phool/phool.h>
 
 #include <TDirectory.h>  // for TDirectory, gDirectory
@@ -11,6 +12,8 @@
 
 #include <boost/stacktrace.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
@@ -19,29 +22,123 @@
 #include <set>
 #include <utility>
 
-PHField3DCartesian::PHField3DCartesian(const std::string &fname, const float magfield_rescale, const float innerradius, const float outerradius, const float size_z)
-  : filename(fname)
+namespace
 {
-  std::cout << "PHField3DCartesian::PHField3DCartesian" << std::endl;
-
-  for (int i = 0; i < 2; i++) // NOLINT (modernize-loop-convert)
+  // same as std::lower_bound on the sorted grid coordinates
+  // the search starts from the index expected for uniform spacing, so it is O(1) for regular grids
+  inline std::size_t find_upper_index(std::span<const float> vals, const double stepsize, const double value)
   {
-    for (int j = 0; j < 2; j++)
+    // compare in float, like the lookup in std::set<float> which was used before
+    const float key = value;
+    const double guess = std::ceil((value - vals.front()) / stepsize);
+    std::size_t index = guess > 0 ? std::min<std::size_t>(guess, vals.size() - 1) : 0;
+    while (index > 0 && !(vals[index - 1] < key))
     {
-      for (int k = 0; k < 2; k++)
-      {
-        for (int l = 0; l < 3; l++)
-        {
-          bf[i][j][k][l] = {std::numeric_limits<double>::quiet_NaN()};
-        }
-      }
+      --index;
     }
+    while (index < vals.size() - 1 && vals[index] < key)
+    {
+      ++index;
+    }
+    return index;
   }
+}  // namespace
+
+PHField3DCartesian::PHField3DCartesian(const std::string &fname, const float magfield_rescale, const float innerradius, const float outerradius, const float size_z)
+  : filename(fname)
+  , m_parameters{{magfield_rescale, innerradius, outerradius, size_z}}
+{
+  std::cout << "PHField3DCartesian::PHField3DCartesian" << std::endl;
+
   std::cout << "\n================ Begin Construct Mag Field =====================" << std::endl;
   std::cout << "\n-----------------------------------------------------------"
             << "\n      Magnetic field Module - Verbosity:"
             << "\n-----------------------------------------------------------";
 
+  // use the binary cache next to the source file if any
+  if (!load_cache())
+  {
+    load_root_file();
+  }
+
+  ystride = xvals.size();
+  zstride = xvals.size() * yvals.size();
+
+  xmin = xvals.front();
+  xmax = xvals.back();
+
+  ymin = yvals.front();
+  ymax = yvals.back();
+  if (ymin != xmin || ymax != xmax)
+  {
+    std::cout << "PHField3DCartesian: Compiler bug!!!!!!!! Do not use inlining!!!!!!" << std::endl;
+    std::cout << "exiting now - recompile with -fno-inline" << std::endl;
+    exit(1);
+  }
+
+  zmin = zvals.front();
+  zmax = zvals.back();
+
+  xstepsize = (xmax - xmin) / (xvals.size() - 1);
+  ystepsize = (ymax - ymin) / (yvals.size() - 1);
+  zstepsize = (zmax - zmin) / (zvals.size() - 1);
+
+  std::cout << "\n================= End Construct Mag Field ======================\n"
+            << std::endl;
+}
+
+//_____________________________________________________________
+bool PHField3DCartesian::WriteCache() const
+{
+  std::cout << "PHField3DCartesian::WriteCache - writing " << PHGridFile::cacheName(filename) << std::endl;
+  return PHGridFile::writeCache(filename, kCacheType, {m_parameters, xvals, yvals, zvals, fieldmap});
+}
+
+//_____________________________________________________________
+bool PHField3DCartesian::load_cache()
+{
+  auto cache = PHGridFile::openCache(filename, kCacheType, Verbosity() > 0);
+  if (!cache)
+  {
+    return false;
+  }
+
+  // the cache must have been produced with the same rescaling and radius cuts
+  if (cache->size() != 5 || !std::equal(m_parameters.begin(), m_parameters.end(), cache->array(0).begin(), cache->array(0).end()))
+  {
+    std::cout << "\n ---> cache " << PHGridFile::cacheName(filename) << " does not match field parameters, ignored" << std::endl;
+    return false;
+  }
+
+  xvals = cache->array(1);
+  yvals = cache->array(2);
+  zvals = cache->array(3);
+  fieldmap = cache->array(4);
+  if (xvals.empty() || yvals.empty() || zvals.empty() || fieldmap.size() != 3 * xvals.size() * yvals.size() * zvals.size())
+  {
+    std::cout << "\n ---> cache " << PHGridFile::cacheName(filename) << " has inconsistent sizes, ignored" << std::endl;
+    xvals = {};
+    yvals = {};
+    zvals = {};
+    fieldmap = {};
+    return false;
+  }
+
+  std::cout << "\n ---> "
+               "Reading the field grid from "
+            << PHGridFile::cacheName(filename) << " ... " << std::endl;
+  m_cache = std::move(cache);
+  return true;
+}
+
+//_____________________________________________________________
+void PHField3DCartesian::load_root_file()
+{
+  const float magfield_rescale = m_parameters[0];
+  const float innerradius = m_parameters[1];
+  const float outerradius = m_parameters[2];
+  const float size_z = m_parameters[3];
+
   // open file
   TFile *rootinput = TFile::Open(filename.c_str());
   if (!rootinput)
@@ -76,53 +173,52 @@ PHField3DCartesian::PHField3DCartesian(const std::string &fname, const float mag
   field_map->SetBranchAddress("bx", &ROOT_BX);
   field_map->SetBranchAddress("by", &ROOT_BY);
   field_map->SetBranchAddress("bz", &ROOT_BZ);
+
+  // the grid can only be filled once all coordinates are known
+  // keep x, y, z, bx, by, bz of the selected entries
+  std::set<float> xset;
+  std::set<float> yset;
+  std::set<float> zset;
+  std::vector<std::array<float, 6>> entries;
+  entries.reserve(field_map->GetEntries());
   for (int i = 0; i < field_map->GetEntries(); i++)
   {
     field_map->GetEntry(i);
-    trio coord_key(ROOT_X * cm, ROOT_Y * cm, ROOT_Z * cm);
-    trio field_val(ROOT_BX * tesla * magfield_rescale, ROOT_BY * tesla * magfield_rescale, ROOT_BZ * tesla * magfield_rescale);
-    xvals.insert(ROOT_X * cm);
-    yvals.insert(ROOT_Y * cm);
-    zvals.insert(ROOT_Z * cm);
+    xset.insert(ROOT_X * cm);
+    yset.insert(ROOT_Y * cm);
+    zset.insert(ROOT_Z * cm);
     if ((std::sqrt(ROOT_X * cm * ROOT_X * cm + ROOT_Y * cm * ROOT_Y * cm) >= innerradius &&
          std::sqrt(ROOT_X * cm * ROOT_X * cm + ROOT_Y * cm * ROOT_Y * cm) <= outerradius) ||
         std::abs(ROOT_Z * cm) > size_z)
     {
-      fieldmap[coord_key] = field_val;
+      entries.push_back({static_cast<float>(ROOT_X * cm), static_cast<float>(ROOT_Y * cm), static_cast<float>(ROOT_Z * cm),
+                         static_cast<float>(ROOT_BX * tesla * magfield_rescale), static_cast<float>(ROOT_BY * tesla * magfield_rescale), static_cast<float>(ROOT_BZ * tesla * magfield_rescale)});
     }
   }
-  xmin = *(xvals.begin());
-  xmax = *(xvals.rbegin());
-
-  ymin = *(yvals.begin());
-  ymax = *(yvals.rbegin());
-  if (ymin != xmin || ymax != xmax)
-  {
-    std::cout << "PHField3DCartesian: Compiler bug!!!!!!!! Do not use inlining!!!!!!" << std::endl;
-    std::cout << "exiting now - recompile with -fno-inline" << std::endl;
-    exit(1);
-  }
-
-  zmin = *(zvals.begin());
-  zmax = *(zvals.rbegin());
-
-  xstepsize = (xmax - xmin) / (xvals.size() - 1);
-  ystepsize = (ymax - ymin) / (yvals.size() - 1);
-  zstepsize = (zmax - zmin) / (zvals.size() - 1);
-
   delete field_map;
   delete rootinput;
-  std::cout << "\n================= End Construct Mag Field ======================\n"
-            << std::endl;
-}
 
-PHField3DCartesian::~PHField3DCartesian()
-{
-  if (Verbosity() > 0)
+  // storage is x, y and z grid coordinates followed by the dense grid, NaN for points which were not selected
+  const std::size_t nx = xset.size();
+  const std::size_t ny = yset.size();
+  const std::size_t nz = zset.size();
+  m_storage.assign(nx + ny + nz + 3 * nx * ny * nz, std::numeric_limits<float>::quiet_NaN());
+  auto storage_end = std::copy(xset.begin(), xset.end(), m_storage.begin());
+  storage_end = std::copy(yset.begin(), yset.end(), storage_end);
+  std::copy(zset.begin(), zset.end(), storage_end);
+
+  xvals = std::span<const float>(m_storage.data(), nx);
+  yvals = std::span<const float>(m_storage.data() + nx, ny);
+  zvals = std::span<const float>(m_storage.data() + nx + ny, nz);
+  float *grid = m_storage.data() + nx + ny + nz;
+  fieldmap = std::span<const float>(grid, 3 * nx * ny * nz);
+
+  for (const auto &entry : entries)
   {
-    std::cout << "PHField3DCartesian: cache hits: " << cache_hits
-              << " cache misses: " << cache_misses
-              << std::endl;
+    const std::size_t ix = std::lower_bound(xvals.begin(), xvals.end(), entry[0]) - xvals.begin();
+    const std::size_t iy = std::lower_bound(yvals.begin(), yvals.end(), entry[1]) - yvals.begin();
+    const std::size_t iz = std::lower_bound(zvals.begin(), zvals.end(), entry[2]) - zvals.begin();
+    std::copy(entry.begin() + 3, entry.end(), grid + 3 * (ix + nx * iy + nx * ny * iz));
   }
 }
 
@@ -176,151 +272,7 @@ void PHField3DCartesian::GetFieldValue(const double point[4], double *Bfield) co
     return;
   }
 
-  double xkey[2];
-  std::set<float>::const_iterator it = xvals.lower_bound(x);
-  xkey[0] = *it;
-  if (it == xvals.begin())
-  {
-    xkey[1] = *it;
-    if (x < xkey[0])
-    {
-      std::cout << PHWHERE << ": This should not happen! x too small - outside range: " << x / cm << std::endl;
-      return;
-    }
-  }
-  else
-  {
-    --it;
-    xkey[1] = *it;
-  }
-
-  double ykey[2];
-  it = yvals.lower_bound(y);
-  ykey[0] = *it;
-  if (it == yvals.begin())
-  {
-    ykey[1] = *it;
-    if (y < ykey[0])
-    {
-      std::cout << PHWHERE << ": This should not happen! y too small - outside range: " << y / cm << std::endl;
-      return;
-    }
-  }
-  else
-  {
-    --it;
-    ykey[1] = *it;
-  }
-  double zkey[2];
-  it = zvals.lower_bound(z);
-  zkey[0] = *it;
-  if (it == zvals.begin())
-  {
-    zkey[1] = *it;
-    if (z < zkey[0])
-    {
-      std::cout << PHWHERE << ": This should not happen! z too small - outside range: " << z / cm << std::endl;
-      return;
-    }
-  }
-  else
-  {
-    --it;
-    zkey[1] = *it;
-  }
-
-  if (xkey_save != xkey[0] ||
-      ykey_save != ykey[0] ||
-      zkey_save != zkey[0])
-  {
-    cache_misses++;
-    xkey_save = xkey[0];
-    ykey_save = ykey[0];
-    zkey_save = zkey[0];
-
-    std::map<std::tuple<float, float, float>, std::tuple<float, float, float> >::const_iterator magval;
-    trio key;
-    for (int i = 0; i < 2; i++)
-    {
-      for (int j = 0; j < 2; j++)
-      {
-        for (int k = 0; k < 2; k++)
-        {
-          key = std::make_tuple(xkey[i], ykey[j], zkey[k]);
-          magval = fieldmap.find(key);
-          if (magval == fieldmap.end())
-          {
-            std::cout << PHWHERE << " could not locate key in " << filename
-                      << " value: x: " << xkey[i] / cm
-                      << ", y: " << ykey[j] / cm
-                      << ", z: " << zkey[k] / cm << std::endl;
-            return;
-          }
-          bf[i][j][k][0] = std::get<0>(magval->second);
-          bf[i][j][k][1] = std::get<1>(magval->second);
-          bf[i][j][k][2] = std::get<2>(magval->second);
-          if (Verbosity() > 0)
-          {
-            const double x_loc = std::get<0>(magval->first);
-            const double y_loc = std::get<1>(magval->first);
-            const double z_loc = std::get<2>(magval->first);
-
-            std::cout << "read x/y/z: " << x_loc / cm << "/"
-              << y_loc / cm << "/"
-              << z_loc / cm << " bx/by/bz: "
-              << bf[i][j][k][0] / tesla << "/"
-              << bf[i][j][k][1] / tesla << "/"
-              << bf[i][j][k][2] / tesla << std::endl;
-          }
-        }
-      }
-    }
-  }
-  else
-  {
-    cache_hits++;
-  }
-
-  // how far are we away from the reference point
-  double xinblock = point[0] - xkey[1];
-  double yinblock = point[1] - ykey[1];
-  double zinblock = point[2] - zkey[1];
-  // normalize distance to step size
-  double fractionx = xinblock / xstepsize;
-  double fractiony = yinblock / ystepsize;
-  double fractionz = zinblock / zstepsize;
-  if (Verbosity() > 0)
-  {
-    std::cout << "x/y/z stepsize: " << xstepsize / cm << "/" << ystepsize / cm << "/" << zstepsize / cm << std::endl;
-    std::cout << "x/y/z inblock: " << xinblock / cm << "/" << yinblock / cm << "/" << zinblock / cm << std::endl;
-    std::cout << "x/y/z fraction: " << fractionx << "/" << fractiony << "/" << fractionz << std::endl;
-  }
-
-  // linear extrapolation in cube:
-
-  // Vxyz =
-  // V000 * x * y * z +
-  // V100 * (1 - x) * y * z +
-  // V010 * x * (1 - y) * z +
-  // V001 * x y * (1 - z) +
-  // V101 * (1 - x) * y * (1 - z) +
-  // V011 * x * (1 - y) * (1 - z) +
-  // V110 * (1 - x) * (1 - y) * z +
-  // V111 * (1 - x) * (1 - y) * (1 - z)
-
-  for (int i = 0; i < 3; i++)
-  {
-    Bfield[i] = bf[0][0][0][i] * fractionx * fractiony * fractionz +
-                bf[1][0][0][i] * (1. - fractionx) * fractiony * fractionz +
-                bf[0][1][0][i] * fractionx * (1. - fractiony) * fractionz +
-                bf[0][0][1][i] * fractionx * fractiony * (1. - fractionz) +
-                bf[1][0][1][i] * (1. - fractionx) * fractiony * (1. - fractionz) +
-                bf[0][1][1][i] * fractionx * (1. - fractiony) * (1. - fractionz) +
-                bf[1][1][0][i] * (1. - fractionx) * (1. - fractiony) * fractionz +
-                bf[1][1][1][i] * (1. - fractionx) * (1. - fractiony) * (1. - fractionz);
-  }
-
-  return;
+  interpolate(point, Bfield);
 }
 
 //_____________________________________________________________
@@ -342,94 +294,55 @@ void PHField3DCartesian::GetFieldValue_nocache(const double point[4], double *Bf
       point[2] < zmin || point[2] > zmax)
   { return; }
 
-  double xkey[2];
-  std::set<float>::const_iterator it = xvals.lower_bound(x);
-  xkey[0] = *it;
-  if (it == xvals.begin())
-  {
-    xkey[1] = *it;
-    if (x < xkey[0])
-    {
-      std::cout << PHWHERE << ": This should not happen! x too small - outside range: " << x / cm << std::endl;
-      return;
-    }
-  }
-  else
-  {
-    --it;
-    xkey[1] = *it;
-  }
+  interpolate(point, Bfield);
+}
 
-  double ykey[2];
-  it = yvals.lower_bound(y);
-  ykey[0] = *it;
-  if (it == yvals.begin())
-  {
-    ykey[1] = *it;
-    if (y < ykey[0])
-    {
-      std::cout << PHWHERE << ": This should not happen! y too small - outside range: " << y / cm << std::endl;
-      return;
-    }
-  }
-  else
-  {
-    --it;
-    ykey[1] = *it;
-  }
-  double zkey[2];
-  it = zvals.lower_bound(z);
-  zkey[0] = *it;
-  if (it == zvals.begin())
-  {
-    zkey[1] = *it;
-    if (z < zkey[0])
-    {
-      std::cout << PHWHERE << ": This should not happen! z too small - outside range: " << z / cm << std::endl;
-      return;
-    }
-  }
-  else
+//_____________________________________________________________
+void PHField3DCartesian::GetFieldValues(const double points[][4], double bfields[][3], const std::size_t npoints) const
+{
+  for (std::size_t i = 0; i < npoints; ++i)
   {
-    --it;
-    zkey[1] = *it;
+    GetFieldValue_nocache(points[i], bfields[i]);
   }
+}
 
-  // local xyz and field
+//_____________________________________________________________
+void PHField3DCartesian::interpolate(const double point[4], double *Bfield) const
+{
+  // upper ([0]) and lower ([1]) grid points around the point, same convention as the former key lookup
+  const std::size_t xindex1 = find_upper_index(xvals, xstepsize, point[0]);
+  const std::size_t yindex1 = find_upper_index(yvals, ystepsize, point[1]);
+  const std::size_t zindex1 = find_upper_index(zvals, zstepsize, point[2]);
+  const std::size_t xindex[2] = {xindex1, xindex1 > 0 ? xindex1 - 1 : xindex1};
+  const std::size_t yindex[2] = {yindex1, yindex1 > 0 ? yindex1 - 1 : yindex1};
+  const std::size_t zindex[2] = {zindex1, zindex1 > 0 ? zindex1 - 1 : zindex1};
+
+  // local field at the corners of the cube
   double bf_loc[2][2][2][3]{};
-
-  std::map<std::tuple<float, float, float>, std::tuple<float, float, float> >::const_iterator magval;
-  trio key;
   for (int i = 0; i < 2; i++)
   {
     for (int j = 0; j < 2; j++)
     {
       for (int k = 0; k < 2; k++)
       {
-        key = std::make_tuple(xkey[i], ykey[j], zkey[k]);
-        magval = fieldmap.find(key);
-        if (magval == fieldmap.end())
+        const float *magval = &fieldmap[3 * (xindex[i] + ystride * yindex[j] + zstride * zindex[k])];
+        if (std::isnan(magval[0]))
         {
           std::cout << PHWHERE << " could not locate key in " << filename
-            << " value: x: " << xkey[i] / cm
-            << ", y: " << ykey[j] / cm
-            << ", z: " << zkey[k] / cm << std::endl;
+            << " value: x: " << xvals[xindex[i]] / cm
+            << ", y: " << yvals[yindex[j]] / cm
+            << ", z: " << zvals[zindex[k]] / cm << std::endl;
           return;
         }
 
-        bf_loc[i][j][k][0] = std::get<0>(magval->second);
-        bf_loc[i][j][k][1] = std::get<1>(magval->second);
-        bf_loc[i][j][k][2] = std::get<2>(magval->second);
+        bf_loc[i][j][k][0] = magval[0];
+        bf_loc[i][j][k][1] = magval[1];
+        bf_loc[i][j][k][2] = magval[2];
         if (Verbosity() > 0)
         {
-
-          const double x_loc = std::get<0>(magval->first);
-          const double y_loc = std::get<1>(magval->first);
-          const double z_loc = std::get<2>(magval->first);
-
-          std::cout << "read x/y/z: " << x_loc / cm << "/"
-            << y_loc / cm << "/"
-            << z_loc / cm << " bx/by/bz: "
+          std::cout << "read x/y/z: " << xvals[xindex[i]] / cm << "/"
+            << yvals[yindex[j]] / cm << "/"
+            << zvals[zindex[k]] / cm << " bx/by/bz: "
             << bf_loc[i][j][k][0] / tesla << "/"
             << bf_loc[i][j][k][1] / tesla << "/"
             << bf_loc[i][j][k][2] / tesla << std::endl;
@@ -439,9 +352,9 @@ void PHField3DCartesian::GetFieldValue_nocache(const double point[4], double *Bf
   }
 
   // how far are we away from the reference point
-  double xinblock = point[0] - xkey[1];
-  double yinblock = point[1] - ykey[1];
-  double zinblock = point[2] - zkey[1];
+  double xinblock = point[0] - xvals[xindex[1]];
+  double yinblock = point[1] - yvals[yindex[1]];
+  double zinblock = point[2] - zvals[zindex[1]];
   // normalize distance to step size
   double fractionx = xinblock / xstepsize;
   double fractiony = yinblock / ystepsize;
@@ -3,11 +3,15 @@
 
 #include "PHField.h"
 
+#include <phool/PHGridFile.h>
+
+#include <array>
+#include <cstddef>
 #include <limits>
-#include <map>
-#include <set>
+#include <memory>
+#include <span>
 #include <string>
-#include <tuple>
+#include <vector>
 
 class PHField3DCartesian : public PHField
 {
@@ -17,7 +21,7 @@ class PHField3DCartesian : public PHField
   explicit PHField3DCartesian(const std::string &fname, const float magfield_rescale = 1.0, const float innerradius = 0, const float outerradius = 1.e10, const float size_z = 1.e10);
 
   //! destructor
-  ~PHField3DCartesian() override;
+  ~PHField3DCartesian() override = default;
 
   //! access field value
   //! Follow the convention of G4ElectroMagneticField
@@ -27,7 +31,32 @@ class PHField3DCartesian : public PHField
 
   void GetFieldValue_nocache(const double Point[4], double *Bfield) const override;
 
+  //! access field values for many points at once, see PHField::GetFieldValues
+  void GetFieldValues(const double Points[][4], double Bfields[][3], const std::size_t npoints) const override;
+
+  //! write the field grid to the binary cache next to the source file (see PHGridFile)
+  /**
+   * the cache is used instead of the ROOT file by later jobs with the same rescaling and radius cuts.
+   * Written by PHFieldUtility::BuildFieldMap when enabled with PHFieldUtility::set_write_cache
+   */
+  bool WriteCache() const;
+
+  //! true if the field grid was mapped from the binary cache
+  bool CacheUsed() const { return m_cache != nullptr; }
+
   private:
+  //! content type of the binary cache
+  static constexpr uint32_t kCacheType = PHGridFile::typeId("B3DC");
+
+  //! map the grid from the binary cache, returns false if there is no valid cache
+  bool load_cache();
+
+  //! read the grid from the ROOT ntuple
+  void load_root_file();
+
+  //! trilinear interpolation in the field grid, input coordinates must be finite and inside the grid
+  void interpolate(const double point[4], double *Bfield) const;
+
   std::string filename;
   double xmin {1000000};
   double xmax {-1000000};
@@ -39,20 +68,25 @@ class PHField3DCartesian : public PHField
   double ystepsize {std::numeric_limits<double>::quiet_NaN()};
   double zstepsize {std::numeric_limits<double>::quiet_NaN()};
 
-  // these are updated in a const method
-  // to cache previous values
-  mutable double bf[2][2][2][3]{};
-  mutable double xkey_save {std::numeric_limits<double>::quiet_NaN()};
-  mutable double ykey_save {std::numeric_limits<double>::quiet_NaN()};
-  mutable double zkey_save {std::numeric_limits<double>::quiet_NaN()};
-  mutable int cache_hits {0};
-  mutable int cache_misses {0};
-
-  typedef std::tuple<float, float, float> trio;
-  std::map<std::tuple<float, float, float>, std::tuple<float, float, float> > fieldmap;
-  std::set<float> xvals;
-  std::set<float> yvals;
-  std::set<float> zvals;
+  //! magfield_rescale, innerradius, outerradius, size_z, stored with the cache
+  std::array<float, 4> m_parameters{};
+
+  //! grid coordinates and field when read from the ROOT file
+  std::vector<float> m_storage;
+
+  //! binary cache, when used
+  std::unique_ptr<PHGridFile> m_cache;
+
+  //! grid coordinates along each axis, sorted. Views on m_storage or m_cache
+  std::span<const float> xvals;
+  std::span<const float> yvals;
+  std::span<const float> zvals;
+
+  //! field map, Bx, By, Bz for each grid point, x index running fastest
+  /** points not loaded from the map (see radius cuts in constructor) are set to NaN */
+  std::span<const float> fieldmap;
+  std::size_t ystride {0};
+  std::size_t zstride {0};
 };
 
 #endif
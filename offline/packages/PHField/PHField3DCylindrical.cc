@@ -1,5 +1,7 @@
 #include "PHField3DCylindrical.h"
 
+#include <phool/PHGridFile.h>
+
 #include <TDirectory.h>  // for TDirectory, gDirectory
 #include <TFile.h>
 #include <TNtuple.h>
@@ -15,14 +17,104 @@
 #include <set>
 #include <utility>
 
+namespace
+{
+  // same as std::upper_bound(...) - 1 on the sorted grid coordinates
+  // the search starts from the index expected for uniform spacing, so it is O(1) for regular grids
+  inline int find_lower_index(std::span<const float> vals, const float key)
+  {
+    const int size = vals.size();
+    const double guess = size > 1 ? std::floor((key - vals.front()) * (size - 1) / (vals.back() - vals.front())) : 0;
+    int index = guess > 0 ? static_cast<int>(std::min<double>(guess, size - 1)) : 0;
+    while (index >= 0 && key < vals[index])
+    {
+      --index;
+    }
+    while (index + 1 < size && !(key < vals[index + 1]))
+    {
+      ++index;
+    }
+    return index;
+  }
+}  // namespace
+
 PHField3DCylindrical::PHField3DCylindrical(const std::string &filename, const int verb, const float magfield_rescale)
   : PHField(verb)
+  , m_filename(filename)
+  , m_magfield_rescale(magfield_rescale)
 {
   std::cout << "\n================ Begin Construct Mag Field =====================" << std::endl;
   std::cout << "\n-----------------------------------------------------------"
             << "\n      Magnetic field Module - Verbosity:" << Verbosity()
             << "\n-----------------------------------------------------------";
 
+  // use the binary cache next to the source file if any
+  if (!load_cache())
+  {
+    load_root_file();
+  }
+
+  std::cout << "\n ---> ... read file successfully "
+            << "\n ---> Z Boundaries ~ zlow, zhigh: "
+            << minz_ / cm << "," << maxz_ / cm << " cm " << std::endl;
+
+  std::cout << "\n================= End Construct Mag Field ======================\n"
+            << std::endl;
+}
+
+//_____________________________________________________________
+bool PHField3DCylindrical::WriteCache() const
+{
+  std::cout << "PHField3DCylindrical::WriteCache - writing " << PHGridFile::cacheName(m_filename) << std::endl;
+  const float parameters[1] = {m_magfield_rescale};
+  return PHGridFile::writeCache(m_filename, kCacheType, {parameters, z_map_, r_map_, phi_map_, BField_});
+}
+
+//_____________________________________________________________
+bool PHField3DCylindrical::load_cache()
+{
+  auto cache = PHGridFile::openCache(m_filename, kCacheType, Verbosity() > 0);
+  if (!cache)
+  {
+    return false;
+  }
+
+  // the cache must have been produced with the same rescaling
+  if (cache->size() != 5 || cache->array(0).size() != 1 || cache->array(0)[0] != m_magfield_rescale)
+  {
+    std::cout << "\n ---> cache " << PHGridFile::cacheName(m_filename) << " does not match field parameters, ignored" << std::endl;
+    return false;
+  }
+
+  z_map_ = cache->array(1);
+  r_map_ = cache->array(2);
+  phi_map_ = cache->array(3);
+  BField_ = cache->array(4);
+  if (z_map_.empty() || r_map_.empty() || phi_map_.empty() || BField_.size() != 3 * z_map_.size() * r_map_.size() * phi_map_.size())
+  {
+    std::cout << "\n ---> cache " << PHGridFile::cacheName(m_filename) << " has inconsistent sizes, ignored" << std::endl;
+    z_map_ = {};
+    r_map_ = {};
+    phi_map_ = {};
+    BField_ = {};
+    return false;
+  }
+
+  std::cout << "\n ---> "
+               "Reading the field grid from "
+            << PHGridFile::cacheName(m_filename) << " ... " << std::endl;
+  minz_ = z_map_.front();
+  maxz_ = z_map_.back();
+  m_cache = std::move(cache);
+  return true;
+}
+
+//_____________________________________________________________
+void PHField3DCylindrical::load_root_file()
+{
+  const std::string &filename = m_filename;
+  const float magfield_rescale = m_magfield_rescale;
+
   // open file
   TFile *rootinput = TFile::Open(filename.c_str());
   if (!rootinput)
@@ -134,18 +226,17 @@ PHField3DCylindrical::PHField3DCylindrical(const std::string &filename, const in
   nz = z_set.size();
   nr = r_set.size();
   nphi = phi_set.size();
-  r_map_.resize(nr, 0);
-  z_map_.resize(nz, 0);
-  phi_map_.resize(nphi, 0);
-
-  std::copy(z_set.begin(), z_set.end(), z_map_.begin());
-  std::copy(phi_set.begin(), phi_set.end(), phi_map_.begin());
-  std::copy(r_set.begin(), r_set.end(), r_map_.begin());
 
-  // initialize the field map vectors to the correct sizes
-  BFieldR_.resize(nz, std::vector<std::vector<float> >(nr, std::vector<float>(nphi, 0)));
-  BFieldPHI_.resize(nz, std::vector<std::vector<float> >(nr, std::vector<float>(nphi, 0)));
-  BFieldZ_.resize(nz, std::vector<std::vector<float> >(nr, std::vector<float>(nphi, 0)));
+  // storage is z, r and phi grid coordinates followed by the field map
+  m_storage.assign(nz + nr + nphi + 3 * nz * nr * nphi, 0);
+  std::copy(z_set.begin(), z_set.end(), m_storage.begin());
+  std::copy(r_set.begin(), r_set.end(), m_storage.begin() + nz);
+  std::copy(phi_set.begin(), phi_set.end(), m_storage.begin() + nz + nr);
+  z_map_ = std::span<const float>(m_storage.data(), nz);
+  r_map_ = std::span<const float>(m_storage.data() + nz, nr);
+  phi_map_ = std::span<const float>(m_storage.data() + nz + nr, nphi);
+  float *field_storage = m_storage.data() + nz + nr + nphi;
+  BField_ = std::span<const float>(field_storage, 3 * nz * nr * nphi);
 
   // all of this assumes that  z_prev < z , i.e. the table is ordered (as of right now)
   unsigned int ir = 0;
@@ -188,9 +279,10 @@ PHField3DCylindrical::PHField3DCylindrical(const std::string &filename, const in
       std::cout << "!!!!!!!!! Your map isn't ordered.... z: " << z << " zprev: " << z_map_[iz - 1] << std::endl;
     }
 
-    BFieldR_[iz][ir][iphi] = Br * magfield_rescale;
-    BFieldPHI_[iz][ir][iphi] = Bphi * magfield_rescale;
-    BFieldZ_[iz][ir][iphi] = Bz * magfield_rescale;
+    float *bfield = field_storage + field_index(iz, ir, iphi);
+    bfield[0] = Bz * magfield_rescale;
+    bfield[1] = Br * magfield_rescale;
+    bfield[2] = Bphi * magfield_rescale;
 
     // you can change this to check table values for correctness
     // print_map prints the values in the root table, and the
@@ -203,21 +295,14 @@ PHField3DCylindrical::PHField3DCylindrical(const std::string &filename, const in
                 << r_map_[ir] << ", "
                 << phi_map_[iphi] << ", "
                 << z_map_[iz] << "):  ("
-                << BFieldR_[iz][ir][iphi] << ", "
-                << BFieldPHI_[iz][ir][iphi] << ", "
-                << BFieldZ_[iz][ir][iphi] << ")" << std::endl;
+                << bfield[1] << ", "
+                << bfield[2] << ", "
+                << bfield[0] << ")" << std::endl;
     }
 
   }  // end loop over root field map file
 
   rootinput->Close();
-
-  std::cout << "\n ---> ... read file successfully "
-            << "\n ---> Z Boundaries ~ zlow, zhigh: "
-            << minz_ / cm << "," << maxz_ / cm << " cm " << std::endl;
-
-  std::cout << "\n================= End Construct Mag Field ======================\n"
-            << std::endl;
 }
 
 void PHField3DCylindrical::GetFieldValue(const double point[4], double *Bfield) const
@@ -325,8 +410,7 @@ void PHField3DCylindrical::GetFieldCyl(const double CylPoint[4], double *BfieldC
     return;
   }
 
-  std::vector<float>::const_iterator ziter = upper_bound(z_map_.begin(), z_map_.end(), z);
-  int z_index0 = distance(z_map_.begin(), ziter) - 1;
+  int z_index0 = find_lower_index(z_map_, z);
   int z_index1 = z_index0 + 1;
 
   assert(z_index0 >= 0);
@@ -334,8 +418,7 @@ void PHField3DCylindrical::GetFieldCyl(const double CylPoint[4], double *BfieldC
   assert(z_index0 < (int) z_map_.size());
   assert(z_index1 < (int) z_map_.size());
 
-  std::vector<float>::const_iterator riter = upper_bound(r_map_.begin(), r_map_.end(), r);
-  int r_index0 = distance(r_map_.begin(), riter) - 1;
+  int r_index0 = find_lower_index(r_map_, r);
   if (r_index0 >= (int) r_map_.size())
   {
     if (Verbosity() > 2)
@@ -358,8 +441,7 @@ void PHField3DCylindrical::GetFieldCyl(const double CylPoint[4], double *BfieldC
   assert(r_index0 >= 0);
   assert(r_index1 >= 0);
 
-  std::vector<float>::const_iterator phiiter = upper_bound(phi_map_.begin(), phi_map_.end(), phi);
-  int phi_index0 = distance(phi_map_.begin(), phiiter) - 1;
+  int phi_index0 = find_lower_index(phi_map_, phi);
   int phi_index1 = phi_index0 + 1;
   if (phi_index1 >= (int) phi_map_.size())
   {
@@ -370,32 +452,15 @@ void PHField3DCylindrical::GetFieldCyl(const double CylPoint[4], double *BfieldC
   assert(phi_index0 < (int) phi_map_.size());
   assert(phi_index1 >= 0);
 
-  double Br000 = BFieldR_[z_index0][r_index0][phi_index0];
-  double Br001 = BFieldR_[z_index0][r_index0][phi_index1];
-  double Br010 = BFieldR_[z_index0][r_index1][phi_index0];
-  double Br011 = BFieldR_[z_index0][r_index1][phi_index1];
-  double Br100 = BFieldR_[z_index1][r_index0][phi_index0];
-  double Br101 = BFieldR_[z_index1][r_index0][phi_index1];
-  double Br110 = BFieldR_[z_index1][r_index1][phi_index0];
-  double Br111 = BFieldR_[z_index1][r_index1][phi_index1];
-
-  double Bphi000 = BFieldPHI_[z_index0][r_index0][phi_index0];
-  double Bphi001 = BFieldPHI_[z_index0][r_index0][phi_index1];
-  double Bphi010 = BFieldPHI_[z_index0][r_index1][phi_index0];
-  double Bphi011 = BFieldPHI_[z_index0][r_index1][phi_index1];
-  double Bphi100 = BFieldPHI_[z_index1][r_index0][phi_index0];
-  double Bphi101 = BFieldPHI_[z_index1][r_index0][phi_index1];
-  double Bphi110 = BFieldPHI_[z_index1][r_index1][phi_index0];
-  double Bphi111 = BFieldPHI_[z_index1][r_index1][phi_index1];
-
-  double Bz000 = BFieldZ_[z_index0][r_index0][phi_index0];
-  double Bz001 = BFieldZ_[z_index0][r_index0][phi_index1];
-  double Bz100 = BFieldZ_[z_index1][r_index0][phi_index0];
-  double Bz101 = BFieldZ_[z_index1][r_index0][phi_index1];
-  double Bz010 = BFieldZ_[z_index0][r_index1][phi_index0];
-  double Bz110 = BFieldZ_[z_index1][r_index1][phi_index0];
-  double Bz011 = BFieldZ_[z_index0][r_index1][phi_index1];
-  double Bz111 = BFieldZ_[z_index1][r_index1][phi_index1];
+  // the eight corners, <Bz, Br, Bphi> each
+  const float *b000 = &BField_[field_index(z_index0, r_index0, phi_index0)];
+  const float *b001 = &BField_[field_index(z_index0, r_index0, phi_index1)];
+  const float *b010 = &BField_[field_index(z_index0, r_index1, phi_index0)];
+  const float *b011 = &BField_[field_index(z_index0, r_index1, phi_index1)];
+  const float *b100 = &BField_[field_index(z_index1, r_index0, phi_index0)];
+  const float *b101 = &BField_[field_index(z_index1, r_index0, phi_index1)];
+  const float *b110 = &BField_[field_index(z_index1, r_index1, phi_index0)];
+  const float *b111 = &BField_[field_index(z_index1, r_index1, phi_index1)];
 
   double zweight = z - z_map_[z_index0];
   double zspacing = z_map_[z_index1] - z_map_[z_index0];
@@ -413,37 +478,15 @@ void PHField3DCylindrical::GetFieldCyl(const double CylPoint[4], double *BfieldC
   }
   phiweight /= phispacing;
 
-  // Z direction of B-field
-  BfieldCyl[0] =
-      (1 - zweight) * ((1 - rweight) * ((1 - phiweight) * Bz000 + phiweight * Bz001) +
-                       rweight * ((1 - phiweight) * Bz010 + phiweight * Bz011)) +
-      zweight * ((1 - rweight) * ((1 - phiweight) * Bz100 + phiweight * Bz101) +
-                 rweight * ((1 - phiweight) * Bz110 + phiweight * Bz111));
-
-  // R direction of B-field
-  BfieldCyl[1] =
-      (1 - zweight) * ((1 - rweight) * ((1 - phiweight) * Br000 + phiweight * Br001) +
-                       rweight * ((1 - phiweight) * Br010 + phiweight * Br011)) +
-      zweight * ((1 - rweight) * ((1 - phiweight) * Br100 + phiweight * Br101) +
-                 rweight * ((1 - phiweight) * Br110 + phiweight * Br111));
-
-  // PHI Direction of B-field
-  BfieldCyl[2] =
-      (1 - zweight) * ((1 - rweight) * ((1 - phiweight) * Bphi000 + phiweight * Bphi001) +
-                       rweight * ((1 - phiweight) * Bphi010 + phiweight * Bphi011)) +
-      zweight * ((1 - rweight) * ((1 - phiweight) * Bphi100 + phiweight * Bphi101) +
-                 rweight * ((1 - phiweight) * Bphi110 + phiweight * Bphi111));
-
-  //     std::cout << "wr: " << rweight << " wz: " << zweight << " wphi: " << phiweight << std::endl;
-  //     std::cout << "Bz000: " << Bz000 << std::endl
-  //          << "Bz001: " << Bz001 << std::endl
-  //          << "Bz010: " << Bz010 << std::endl
-  //          << "Bz011: " << Bz011 << std::endl
-  //          << "Bz100: " << Bz100 << std::endl
-  //          << "Bz101: " << Bz101 << std::endl
-  //          << "Bz110: " << Bz110 << std::endl
-  //          << "Bz111: " << Bz111 << std::endl
-  //          << "Bz:    " << BfieldCyl[0] << std::endl << std::endl;
+  // Z, R and PHI direction of B-field
+  for (int i = 0; i < 3; ++i)
+  {
+    BfieldCyl[i] =
+        (1 - zweight) * ((1 - rweight) * ((1 - phiweight) * b000[i] + phiweight * b001[i]) +
+                         rweight * ((1 - phiweight) * b010[i] + phiweight * b011[i])) +
+        zweight * ((1 - rweight) * ((1 - phiweight) * b100[i] + phiweight * b101[i]) +
+                   rweight * ((1 - phiweight) * b110[i] + phiweight * b111[i]));
+  }
 
   if (Verbosity() > 2)
   {
@@ -22,7 +22,12 @@
 
 #include "PHField.h"
 
+#include <phool/PHGridFile.h>
+
+#include <cstddef>
 #include <map>
+#include <memory>
+#include <span>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -37,21 +42,55 @@ class PHField3DCylindrical : public PHField
   void GetFieldValue(const double Point[4], double* Bfield) const override;
   void GetFieldCyl(const double CylPoint[4], double* Bfield) const;
 
+  //! write the field grid to the binary cache next to the source file (see PHGridFile)
+  /**
+   * the cache is used instead of the ROOT file by later jobs with the same rescaling.
+   * Written by PHFieldUtility::BuildFieldMap when enabled with PHFieldUtility::set_write_cache
+   */
+  bool WriteCache() const;
+
+  //! true if the field grid was mapped from the binary cache
+  bool CacheUsed() const { return m_cache != nullptr; }
+
  protected:
-  // < i, j, k > , this allows i and i+1 to be neighbors ( <i,j,k>=<z,r,phi> )
-  std::vector<std::vector<std::vector<float> > > BFieldZ_;
-  std::vector<std::vector<std::vector<float> > > BFieldR_;
-  std::vector<std::vector<std::vector<float> > > BFieldPHI_;
+  //! source file and rescaling, needed to match the cache
+  std::string m_filename;
+  float m_magfield_rescale = 1.0;
+
+  //! grid coordinates and field when read from the ROOT file
+  std::vector<float> m_storage;
+
+  //! binary cache, when used
+  std::unique_ptr<PHGridFile> m_cache;
+
+  // <Bz, Br, Bphi> for each < i, j, k > grid point ( <i,j,k>=<z,r,phi> ), k running fastest
+  // this and the maps below are views on m_storage or m_cache
+  std::span<const float> BField_;
 
   // maps indices to values z_map[i] = z_value that corresponds to ith index
-  std::vector<float> z_map_;    // < i >
-  std::vector<float> r_map_;    // < j >
-  std::vector<float> phi_map_;  // < k >
+  std::span<const float> z_map_;    // < i >
+  std::span<const float> r_map_;    // < j >
+  std::span<const float> phi_map_;  // < k >
 
   float maxz_, minz_;  // boundaries of magnetic field map cyl
 
  private:
+  //! content type of the binary cache
+  static constexpr uint32_t kCacheType = PHGridFile::typeId("B3DY");
+
+  //! map the grid from the binary cache, returns false if there is no valid cache
+  bool load_cache();
+
+  //! read the grid from the ROOT ntuple
+  void load_root_file();
+
   bool bin_search(const std::vector<float>& vec, unsigned start, unsigned end, const float& key, unsigned& index) const;
+
+  // position of <Bz, Br, Bphi> for a given grid point in BField_
+  std::size_t field_index(unsigned iz, unsigned ir, unsigned iphi) const
+  {
+    return 3 * ((iz * r_map_.size() + ir) * phi_map_.size() + iphi);
+  }
   void print_map(std::map<trio, trio>::iterator& it) const;
 };
 
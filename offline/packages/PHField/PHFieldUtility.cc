@@ -59,21 +59,35 @@ PHFieldUtility::BuildFieldMap(const PHFieldConfig *field_config, float inner_rad
 
   case PHFieldConfig::kField3DCylindrical:
     //    return "3D field map expressed in cylindrical coordinates";
-    field = new PHField3DCylindrical(
+  {
+    auto *cylfield = new PHField3DCylindrical(
         field_config->get_filename(),
         verbosity,
         field_config->get_magfield_rescale());
+    if (s_write_cache && !cylfield->CacheUsed())
+    {
+      cylfield->WriteCache();
+    }
+    field = cylfield;
     break;
+  }
 
   case PHFieldConfig::Field3DCartesian:
     //    return "3D field map expressed in Cartesian coordinates";
-    field = new PHField3DCartesian(
+  {
+    auto *cartfield = new PHField3DCartesian(
         field_config->get_filename(),
         field_config->get_magfield_rescale(),
         inner_radius,
         outer_radius,
         size_z);
+    if (s_write_cache && !cartfield->CacheUsed())
+    {
+      cartfield->WriteCache();
+    }
+    field = cartfield;
     break;
+  }
   case PHFieldConfig::FieldInterpolated:
 	//    return "3d interpolated fieldmap"
     field = new PHFieldInterpolated;
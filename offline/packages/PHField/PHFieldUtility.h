@@ -33,6 +33,10 @@ class PHFieldUtility
   static PHField *
   BuildFieldMap(const PHFieldConfig *field_config, float inner_radius = 0., float outer_radius = 1.e10, float size_z = 1.e10, const int verbosity = 0);
 
+  //! write the binary cache (see PHGridFile) next to 3D field maps read from ROOT files
+  /** later jobs use the cache automatically. Off by default, field maps often live in read-only areas */
+  static void set_write_cache(bool flag) { s_write_cache = flag; }
+
   //! DST node name for RunTime field map object
   static std::string
   GetDSTFieldMapNodeName()
@@ -48,6 +52,8 @@ class PHFieldUtility
   }
 
  private:
+  static inline bool s_write_cache = false;
+
   // static tool sets only
   PHFieldUtility() = delete;
   ~PHFieldUtility() = delete;
@@ -2,7 +2,8 @@
 #include "CylinderGeomIntt.h"
 
 #include <trackbase/InttDefs.h>
-#include <trackbase/TrkrClusterContainerv4.h>
+#include <trackbase/PixelClusterLabeler.h>
+#include <trackbase/TrkrClusterContainerv5.h>
 #include <trackbase/TrkrClusterCrossingAssocv1.h>
 #include <trackbase/TrkrClusterHitAssocv3.h>
 #include <trackbase/TrkrClusterv5.h>
@@ -19,6 +20,8 @@
 #include <g4detectors/PHG4CylinderGeomContainer.h>
 
 #include <fun4all/Fun4AllReturnCodes.h>
+#include <fun4all/Fun4AllServer.h>
+#include <fun4all/Fun4AllTaskScheduler.h>
 #include <fun4all/SubsysReco.h>
 
 #include <phool/PHCompositeNode.h>
@@ -29,9 +32,6 @@
 #include <phool/getClass.h>
 #include <phool/phool.h>
 
-#include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/connected_components.hpp>
-
 #include <algorithm>
 #include <array>
 #include <cmath>
@@ -39,6 +39,7 @@
 #include <limits>
 #include <memory>  // for unique_ptr, make_...
 #include <set>
+#include <utility>
 #include <vector>  // for vector
 
 namespace
@@ -52,52 +53,6 @@ namespace
   }
 }  // namespace
 
-bool InttClusterizer::ladder_are_adjacent(const std::pair<TrkrDefs::hitkey, TrkrHit*>& lhs, const std::pair<TrkrDefs::hitkey, TrkrHit*>& rhs, const int layer) const
-{
-  if (get_z_clustering(layer))
-  {
-    if (std::abs(InttDefs::getCol(lhs.first) - InttDefs::getCol(rhs.first)) <= 1)
-    {
-      if (std::abs(InttDefs::getRow(lhs.first) - InttDefs::getRow(rhs.first)) <= 1)
-      {
-        return true;
-      }
-    }
-  }
-  else if (std::abs(InttDefs::getCol(lhs.first) - InttDefs::getCol(rhs.first)) == 0)
-  {
-    if (std::abs(InttDefs::getRow(lhs.first) - InttDefs::getRow(rhs.first)) <= 1)
-    {
-      return true;
-    }
-  }
-
-  return false;
-}
-
-bool InttClusterizer::ladder_are_adjacent(RawHit* lhs, RawHit* rhs, const int layer) const
-{
-  if (get_z_clustering(layer))
-  {
-    if (std::abs((int) (lhs->getPhiBin()) - (int) (rhs->getPhiBin())) <= 1)  // col
-    {
-      if (std::abs((int) (lhs->getTBin()) - (int) (rhs->getTBin())) <= 1)  // Row
-      {
-        return true;
-      }
-    }
-  }
-  else if (std::abs((int) (lhs->getPhiBin()) - (int)(rhs->getPhiBin())) <= 1)
-  {
-    if (std::abs((int) (lhs->getTBin()) - (int) (rhs->getTBin())) == 0)
-    {
-      return true;
-    }
-  }
-
-  return false;
-}
-
 InttClusterizer::InttClusterizer(const std::string& name,
                                  unsigned int /*min_layer*/,
                                  unsigned int /*max_layer*/)
@@ -145,7 +100,7 @@ int InttClusterizer::InitRun(PHCompositeNode* topNode)
       dstNode->addNode(DetNode);
     }
 
-    trkrclusters = new TrkrClusterContainerv4;
+    trkrclusters = new TrkrClusterContainerv5;
     PHIODataNode<PHObject>* TrkrClusterContainerNode =
         new PHIODataNode<PHObject>(trkrclusters, "TRKR_CLUSTER", "PHObject");
     DetNode->addNode(TrkrClusterContainerNode);
@@ -358,19 +313,28 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
   // Clustering
   //-----------
 
-  // loop over the InttHitSet objects
+  // collect the InttHitSet objects, they are clustered independently
+  std::vector<std::pair<TrkrDefs::hitsetkey, TrkrHitSet*>> hitsets;
   TrkrHitSetContainer::ConstRange hitsetrange =
       m_hits->getHitSets(TrkrDefs::TrkrId::inttId);
   for (TrkrHitSetContainer::ConstIterator hitsetitr = hitsetrange.first;
        hitsetitr != hitsetrange.second;
        ++hitsetitr)
+  {
+    hitsets.emplace_back(hitsetitr->first, hitsetitr->second);
+  }
+  std::vector<HitSetClusters> results(hitsets.size());
+
+  auto cluster_hitset = [&](std::size_t ihitset)
   {
     // Each hitset contains only hits that are clusterizable - i.e. belong to a single sensor
-    TrkrHitSet* hitset = hitsetitr->second;
+    const TrkrDefs::hitsetkey hitsetkey = hitsets[ihitset].first;
+    TrkrHitSet* hitset = hitsets[ihitset].second;
+    auto& result = results[ihitset];
 
     if (Verbosity() > 1)
     {
-      std::cout << "InttClusterizer found hitsetkey " << hitsetitr->first << std::endl;
+      std::cout << "InttClusterizer found hitsetkey " << hitsetkey << std::endl;
     }
     if (Verbosity() > 2)
     {
@@ -378,66 +342,42 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
     }
 
     // we have a single hitset, get the info that identifies the sensor
-    int layer = TrkrDefs::getLayer(hitsetitr->first);
-    int ladder_z_index = InttDefs::getLadderZId(hitsetitr->first);
+    int layer = TrkrDefs::getLayer(hitsetkey);
+    int ladder_z_index = InttDefs::getLadderZId(hitsetkey);
     int type = (ladder_z_index == 0 || ladder_z_index == 2) ? 0 : 1; // ladder ID 0 and 2 are type-A (1.6 cm), ladder ID 1 and 3 are type-B (2.0 cm)
 
     // we will need the geometry object for this layer to get the global position
     CylinderGeomIntt* geom = dynamic_cast<CylinderGeomIntt*>(geom_container->GetLayerGeom(layer));
     float pitch = geom->get_strip_y_spacing();
     float length = geom->get_strip_z_spacing(type);
+    const bool e_weights = get_energy_weighting(layer);
 
     // fill a vector of hits to make things easier - gets every hit in the hitset
-    std::vector<std::pair<TrkrDefs::hitkey, TrkrHit*>> hitvec;
+    // buffers are reused across hitsets processed by the same thread
+    thread_local std::vector<std::pair<TrkrDefs::hitkey, TrkrHit*>> hitvec;
+    thread_local std::vector<PixelClusterLabeler::Cell> cells;
+    hitvec.clear();
+    cells.clear();
     TrkrHitSet::ConstRange hitrangei = hitset->getHits();
     for (TrkrHitSet::ConstIterator hitr = hitrangei.first;
          hitr != hitrangei.second;
          ++hitr)
     {
       hitvec.emplace_back(hitr->first, hitr->second);
+      cells.emplace_back(InttDefs::getCol(hitr->first), InttDefs::getRow(hitr->first));
     }
     if (Verbosity() > 2)
     {
       std::cout << "hitvec.size(): " << hitvec.size() << std::endl;
     }
 
-    using Graph = boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS>;
-    Graph G;
-
-    // Find adjacent strips
-    for (unsigned int i = 0; i < hitvec.size(); i++)
-    {
-      for (unsigned int j = i + 1; j < hitvec.size(); j++)
-      {
-        if (ladder_are_adjacent(hitvec[i], hitvec[j], layer))
-        {
-          add_edge(i, j, G);
-        }
-      }
-
-      add_edge(i, i, G);
-    }
-
-    // Find the connections between the vertices of the graph (vertices are the rawhits,
-    // connections are made when they are adjacent to one another)
-    std::vector<int> component(num_vertices(G));
-
-    // this is the actual clustering, performed by boost
-    connected_components(G, component.data());
-
-    // Loop over the components(hit cells) compiling a list of the
-    // unique connected groups (ie. clusters).
-    std::set<int> cluster_ids;  // unique components
-
-    std::multimap<int, std::pair<TrkrDefs::hitkey, TrkrHit*>> clusters;
-    for (unsigned int i = 0; i < component.size(); i++)
-    {
-      cluster_ids.insert(component[i]);                          // one entry per unique cluster id
-      clusters.insert(std::make_pair(component[i], hitvec[i]));  // multiple entries per unique cluster id
-    }
+    // Find adjacent strips: strips are adjacent if rows are adjacent and columns identical,
+    // or adjacent with z clustering
+    thread_local PixelClusterLabeler labeler;
+    const unsigned int nclusters = labeler.run(cells, get_z_clustering(layer) ? 1 : 0, 1);
 
     // loop over the cluster ID's and make the clusters from the connected hits
-    for (int clusid : cluster_ids)
+    for (unsigned int clusid = 0; clusid < nclusters; ++clusid)
     {
       // std::cout << " intt clustering: add cluster number " << clusid << std::endl;
 
@@ -453,7 +393,7 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
       short int crossing = InttDefs::getTimeBucketId(hitset->getHitSetKey());
 
       // Add clusterkey/bunch crossing to mmap
-      m_clustercrossingassoc->addAssoc(ckey, crossing);
+      result.crossings.emplace_back(ckey, crossing);
 
       // determine the size of the cluster in phi and z, useful for track fitting the cluster
       std::set<int> phibins;
@@ -469,18 +409,17 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
       // std::cout << PHWHERE << " ckey " << ckey << ":" << std::endl;
 
       // get all hits for this cluster ID only
-      const auto clusrange = clusters.equal_range(clusid);
-      for (auto mapiter = clusrange.first; mapiter != clusrange.second; ++mapiter)
+      for (const auto& ihit : labeler.cluster(clusid))
       {
-        // mapiter->second.first  is the hit key
-        // std::cout << " adding hitkey " << mapiter->second.first << std::endl;
-        int col = InttDefs::getCol((mapiter->second).first);
-        int row = InttDefs::getRow((mapiter->second).first);
+        // hit.first  is the hit key
+        const auto& hit = hitvec[ihit];
+        int col = InttDefs::getCol(hit.first);
+        int row = InttDefs::getRow(hit.first);
         zbins.insert(col);
         phibins.insert(row);
 
-        // mapiter->second.second is the hit
-        unsigned int hit_adc = (mapiter->second).second->getAdc();
+        // hit.second is the hit
+        unsigned int hit_adc = hit.second->getAdc();
 
         // now get the positions from the geometry
         double local_hit_location[3] = {0., 0., 0.};
@@ -490,7 +429,7 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
                                             row, col,
                                             local_hit_location);
 
-        if (_make_e_weights[layer])
+        if (e_weights)
         {
           xlocalsum += local_hit_location[0] * (double) hit_adc;
           ylocalsum += local_hit_location[1] * (double) hit_adc;
@@ -507,7 +446,7 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
         ++nhits;
 
         // add this cluster-hit association to the association map of (clusterkey,hitkey)
-        m_clusterhitassoc->addAssoc(ckey, mapiter->second.first);
+        result.associations.emplace_back(ckey, hit.first);
 
         if (Verbosity() > 2)
         {
@@ -550,7 +489,7 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
       double cluslocaly = std::numeric_limits<double>::quiet_NaN();
       double cluslocalz = std::numeric_limits<double>::quiet_NaN();
 
-      if (_make_e_weights[layer])
+      if (e_weights)
       {
         cluslocaly = ylocalsum / (double) clus_adc;
         cluslocalz = zlocalsum / (double) clus_adc;
@@ -579,10 +518,21 @@ void InttClusterizer::ClusterLadderCells(PHCompositeNode* topNode)
         clus->identify();
       }
 
-      m_clusterlist->addClusterSpecifyKey(ckey, clus.release());
+      result.clusters.emplace_back(ckey, clus.release());
 
     }  // end loop over cluster ID's
-  }    // end loop over hitsets
+  };
+
+  // cluster the sensors on the shared worker pool, verbose or sequential mode runs them one by one in this thread
+  Fun4AllServer::instance()->TaskScheduler()->parallel_for(
+      Name(), hitsets.size(), cluster_hitset,
+      (do_sequential || Verbosity() > 0) ? 1 : 0);
+
+  // merge in hitset order
+  for (auto& result : results)
+  {
+    store(result);
+  }
 
   if (Verbosity() > 2)
   {
@@ -621,19 +571,28 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
   // Clustering
   //-----------
 
-  // loop over the InttHitSet objects
+  // collect the InttHitSet objects, they are clustered independently
+  std::vector<std::pair<TrkrDefs::hitsetkey, RawHitSet*>> hitsets;
   RawHitSetContainer::ConstRange hitsetrange =
       m_rawhits->getHitSets(TrkrDefs::TrkrId::inttId);
   for (RawHitSetContainer::ConstIterator hitsetitr = hitsetrange.first;
        hitsetitr != hitsetrange.second;
        ++hitsetitr)
+  {
+    hitsets.emplace_back(hitsetitr->first, hitsetitr->second);
+  }
+  std::vector<HitSetClusters> results(hitsets.size());
+
+  auto cluster_hitset = [&](std::size_t ihitset)
   {
     // Each hitset contains only hits that are clusterizable - i.e. belong to a single sensor
-    RawHitSet* hitset = hitsetitr->second;
+    const TrkrDefs::hitsetkey hitsetkey = hitsets[ihitset].first;
+    RawHitSet* hitset = hitsets[ihitset].second;
+    auto& result = results[ihitset];
 
     if (Verbosity() > 1)
     {
-      std::cout << "InttClusterizer found hitsetkey " << hitsetitr->first << std::endl;
+      std::cout << "InttClusterizer found hitsetkey " << hitsetkey << std::endl;
     }
     if (Verbosity() > 2)
     {
@@ -641,19 +600,24 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
     }
 
     // we have a single hitset, get the info that identifies the sensor
-    int layer = TrkrDefs::getLayer(hitsetitr->first);
-    int ladder_z_index = InttDefs::getLadderZId(hitsetitr->first);
+    int layer = TrkrDefs::getLayer(hitsetkey);
+    int ladder_z_index = InttDefs::getLadderZId(hitsetkey);
     int type = (ladder_z_index == 0 || ladder_z_index == 2) ? 0 : 1; // ladder ID 0 and 2 are type-A (1.6 cm), ladder ID 1 and 3 are type-B (2.0 cm)
 
     // we will need the geometry object for this layer to get the global position
     CylinderGeomIntt* geom = dynamic_cast<CylinderGeomIntt*>(geom_container->GetLayerGeom(layer));
     float pitch = geom->get_strip_y_spacing();
     float length = geom->get_strip_z_spacing(type);
+    const bool e_weights = get_energy_weighting(layer);
 
     // fill a vector of hits to make things easier - gets every hit in the hitset
-    std::vector<RawHit*> hitvec;
-    // int sector = InttDefs::getLadderPhiId(hitsetitr->first);
-    // int side = InttDefs::getLadderZId(hitsetitr->first);
+    // buffers are reused across hitsets processed by the same thread
+    thread_local std::vector<RawHit*> hitvec;
+    thread_local std::vector<PixelClusterLabeler::Cell> cells;
+    hitvec.clear();
+    cells.clear();
+    // int sector = InttDefs::getLadderPhiId(hitsetkey);
+    // int side = InttDefs::getLadderZId(hitsetkey);
 
     RawHitSet::ConstRange hitrangei = hitset->getHits();
     for (RawHitSet::ConstIterator hitr = hitrangei.first;
@@ -664,49 +628,20 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
       // unsigned short it = (*hitr)->getTBin();
       //	std::cout << " intt layer " << layer << " sector: " << sector << " side " << side << " col: " << iphi << " row " << it << std::endl;
       hitvec.push_back((*hitr));
+      cells.emplace_back((*hitr)->getTBin(), (*hitr)->getPhiBin());
     }
     if (Verbosity() > 2)
     {
       std::cout << "hitvec.size(): " << hitvec.size() << std::endl;
     }
 
-    using Graph = boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS>;
-    Graph G;
-
-    // Find adjacent strips
-    for (unsigned int i = 0; i < hitvec.size(); i++)
-    {
-      for (unsigned int j = i + 1; j < hitvec.size(); j++)
-      {
-        if (ladder_are_adjacent(hitvec[i], hitvec[j], layer))
-        {
-          add_edge(i, j, G);
-        }
-      }
-
-      add_edge(i, i, G);
-    }
-
-    // Find the connections between the vertices of the graph (vertices are the rawhits,
-    // connections are made when they are adjacent to one another)
-    std::vector<int> component(num_vertices(G));
-
-    // this is the actual clustering, performed by boost
-    connected_components(G, component.data());
-
-    // Loop over the components(hit cells) compiling a list of the
-    // unique connected groups (ie. clusters).
-    std::set<int> cluster_ids;  // unique components
-
-    std::multimap<int, RawHit*> clusters;
-    for (unsigned int i = 0; i < component.size(); i++)
-    {
-      cluster_ids.insert(component[i]);                          // one entry per unique cluster id
-      clusters.insert(std::make_pair(component[i], hitvec[i]));  // multiple entries per unique cluster id
-    }
+    // Find adjacent strips: strips are adjacent if phi bins are adjacent and time bins identical,
+    // or adjacent with z clustering
+    thread_local PixelClusterLabeler labeler;
+    const unsigned int nclusters = labeler.run(cells, get_z_clustering(layer) ? 1 : 0, 1);
 
     // loop over the cluster ID's and make the clusters from the connected hits
-    for (int clusid : cluster_ids)
+    for (unsigned int clusid = 0; clusid < nclusters; ++clusid)
     {
       // std::cout << " intt clustering: add cluster number " << clusid << std::endl;
       // make the cluster directly in the node tree
@@ -721,7 +656,7 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
       short int crossing = InttDefs::getTimeBucketId(hitset->getHitSetKey());
 
       // Add clusterkey/bunch crossing to mmap
-      m_clustercrossingassoc->addAssoc(ckey, crossing);
+      result.crossings.emplace_back(ckey, crossing);
 
       // determine the size of the cluster in phi and z, useful for track fitting the cluster
       std::set<int> phibins;
@@ -739,14 +674,12 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
       std::map<int, unsigned int> m_z;  // hold data for
 
       // get all hits for this cluster ID only
-      const auto clusrange = clusters.equal_range(clusid);
-      for (auto mapiter = clusrange.first; mapiter != clusrange.second; ++mapiter)
+      for (const auto& ihit : labeler.cluster(clusid))
       {
-        // mapiter->second.first  is the hit key
-        // std::cout << " adding hitkey " << mapiter->second.first << std::endl;
-        const auto energy = (mapiter->second)->getAdc();
-        int col = (mapiter->second)->getPhiBin();
-        int row = (mapiter->second)->getTBin();
+        RawHit* hit = hitvec[ihit];
+        const auto energy = hit->getAdc();
+        int col = hit->getPhiBin();
+        int row = hit->getTBin();
         //	    std::cout << " found Tbin(row) " << row << " Phibin(col) " << col << std::endl;
         zbins.insert(col);
         phibins.insert(row);
@@ -766,8 +699,7 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
           }
         }
 
-        // mapiter->second.second is the hit
-        unsigned int hit_adc = (mapiter->second)->getAdc();
+        unsigned int hit_adc = hit->getAdc();
 
         // now get the positions from the geometry
         double local_hit_location[3] = {0., 0., 0.};
@@ -777,7 +709,7 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
                                             row, col,
                                             local_hit_location);
 
-        if (_make_e_weights[layer])
+        if (e_weights)
         {
           xlocalsum += local_hit_location[0] * (double) hit_adc;
           ylocalsum += local_hit_location[1] * (double) hit_adc;
@@ -793,9 +725,6 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
         clus_adc += hit_adc;
         ++nhits;
 
-        // add this cluster-hit association to the association map of (clusterkey,hitkey)
-        //	    m_clusterhitassoc->addAssoc(ckey, mapiter->second.first);
-
         if (Verbosity() > 2)
         {
           std::cout << "     nhits = " << nhits << std::endl;
@@ -816,15 +745,7 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
             std::cout << " m_phi(" << hit.first << " : " << hit.second << ") " << std::endl;
           }
         }
-        for (auto& hit : m_phi)
-        {
-          mClusHitsVerbose->addPhiHit(hit.first, (float) hit.second);
-        }
-        for (auto& hit : m_z)
-        {
-          mClusHitsVerbose->addZHit(hit.first, (float) hit.second);
-        }
-        mClusHitsVerbose->push_hits(ckey);
+        result.verbose.push_back({ckey, {m_phi.begin(), m_phi.end()}, {m_z.begin(), m_z.end()}});
       }
 
       static const float invsqrt12 = 1. / sqrt(12);
@@ -857,7 +778,7 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
       double cluslocaly = std::numeric_limits<double>::quiet_NaN();
       double cluslocalz = std::numeric_limits<double>::quiet_NaN();
 
-      if (_make_e_weights[layer])
+      if (e_weights)
       {
         cluslocaly = ylocalsum / (double) clus_adc;
         cluslocalz = zlocalsum / (double) clus_adc;
@@ -885,10 +806,21 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
         clus->identify();
       }
 
-      m_clusterlist->addClusterSpecifyKey(ckey, clus.release());
+      result.clusters.emplace_back(ckey, clus.release());
 
     }  // end loop over cluster ID's
-  }    // end loop over hitsets
+  };
+
+  // cluster the sensors on the shared worker pool, verbose or sequential mode runs them one by one in this thread
+  Fun4AllServer::instance()->TaskScheduler()->parallel_for(
+      Name(), hitsets.size(), cluster_hitset,
+      (do_sequential || Verbosity() > 0) ? 1 : 0);
+
+  // merge in hitset order
+  for (auto& result : results)
+  {
+    store(result);
+  }
 
   if (Verbosity() > 2)
   {
@@ -906,6 +838,38 @@ void InttClusterizer::ClusterLadderCellsRaw(PHCompositeNode* topNode)
   return;
 }
 
+void InttClusterizer::store(HitSetClusters& result)
+{
+  for (const auto& [ckey, crossing] : result.crossings)
+  {
+    m_clustercrossingassoc->addAssoc(ckey, crossing);
+  }
+
+  for (const auto& [ckey, hitkey] : result.associations)
+  {
+    m_clusterhitassoc->addAssoc(ckey, hitkey);
+  }
+
+  for (const auto& verbose : result.verbose)
+  {
+    for (const auto& hit : verbose.phi)
+    {
+      mClusHitsVerbose->addPhiHit(hit.first, (float) hit.second);
+    }
+    for (const auto& hit : verbose.z)
+    {
+      mClusHitsVerbose->addZHit(hit.first, (float) hit.second);
+    }
+    mClusHitsVerbose->push_hits(verbose.ckey);
+  }
+
+  for (const auto& [ckey, cluster] : result.clusters)
+  {
+    m_clusterlist->addClusterSpecifyKey(ckey, cluster);
+  }
+  result = HitSetClusters();
+}
+
 void InttClusterizer::PrintClusters(PHCompositeNode* topNode)
 {
   if (Verbosity() > 1)
@@ -9,15 +9,15 @@
 #include <map>
 #include <string>
 #include <utility>
+#include <vector>
 
 class ClusHitsVerbosev1;
 class PHCompositeNode;
 class TrkrHitSetContainer;
+class TrkrCluster;
 class TrkrClusterContainer;
 class TrkrClusterHitAssoc;
 class TrkrClusterCrossingAssoc;
-class TrkrHit;
-class RawHit;
 class RawHitSetContainer;
 
 class InttClusterizer : public SubsysReco
@@ -71,6 +71,7 @@ class InttClusterizer : public SubsysReco
 
   void set_do_hit_association(bool do_assoc) { do_hit_assoc = do_assoc; }
   void set_read_raw(bool read_raw) { do_read_raw = read_raw; }
+  void set_do_sequential(bool b) { do_sequential = b; }
 
   // for saving verbose clusters
   void set_ClusHitsVerbose(bool set = true) { record_ClusHitsVerbose = set; };
@@ -78,12 +79,27 @@ class InttClusterizer : public SubsysReco
 
  private:
   bool record_ClusHitsVerbose{false};
-  bool ladder_are_adjacent(const std::pair<TrkrDefs::hitkey, TrkrHit *> &lhs, const std::pair<TrkrDefs::hitkey, TrkrHit *> &rhs, const int layer) const;
-  bool ladder_are_adjacent(RawHit *lhs, RawHit *rhs, const int layer) const;
+
+  //! clusters and associations found in one hitset, stored in the node tree once all hitsets are processed
+  struct HitSetClusters
+  {
+    struct VerboseHits
+    {
+      TrkrDefs::cluskey ckey{0};
+      std::vector<std::pair<int, unsigned int>> phi;
+      std::vector<std::pair<int, unsigned int>> z;
+    };
+
+    std::vector<std::pair<TrkrDefs::cluskey, TrkrCluster *>> clusters;
+    std::vector<std::pair<TrkrDefs::cluskey, short int>> crossings;
+    std::vector<std::pair<TrkrDefs::cluskey, TrkrDefs::hitkey>> associations;
+    std::vector<VerboseHits> verbose;
+  };
 
   void CalculateLadderThresholds(PHCompositeNode *topNode);
   void ClusterLadderCells(PHCompositeNode *topNode);
   void ClusterLadderCellsRaw(PHCompositeNode *topNode);
+  void store(HitSetClusters &result);
   void PrintClusters(PHCompositeNode *topNode);
 
   // node tree storage pointers
@@ -100,6 +116,7 @@ class InttClusterizer : public SubsysReco
   std::map<int, bool> _make_e_weights;        // layer->energy_weighting_option
   bool do_hit_assoc = true;
   bool do_read_raw = false;
+  bool do_sequential = false;
 };
 
 #endif
@@ -11,7 +11,7 @@
 #include <g4detectors/PHG4CylinderGeom.h>           // for PHG4CylinderGeom
 
 #include <trackbase/ActsGeometry.h>
-#include <trackbase/TrkrClusterContainerv4.h>        // for TrkrCluster
+#include <trackbase/TrkrClusterContainerv5.h>        // for TrkrCluster
 #include <trackbase/TrkrClusterv5.h>
 #include <trackbase/TrkrDefs.h>
 #include <trackbase/TrkrHitSet.h>
@@ -126,7 +126,7 @@ int MicromegasClusterizer::InitRun(PHCompositeNode *topNode)
       dstNode->addNode(trkrNode);
     }
 
-    trkrClusterContainer = new TrkrClusterContainerv4;
+    trkrClusterContainer = new TrkrClusterContainerv5;
     auto TrkrClusterContainerNode = new PHIODataNode<PHObject>(trkrClusterContainer, "TRKR_CLUSTER", "PHObject");
     trkrNode->addNode(TrkrClusterContainerNode);
   }
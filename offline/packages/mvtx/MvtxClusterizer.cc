@@ -12,7 +12,8 @@
 
 #include <trackbase/ClusHitsVerbosev1.h>
 #include <trackbase/MvtxDefs.h>
-#include <trackbase/TrkrClusterContainerv4.h>
+#include <trackbase/PixelClusterLabeler.h>
+#include <trackbase/TrkrClusterContainerv5.h>
 #include <trackbase/TrkrClusterHitAssocv3.h>
 #include <trackbase/TrkrClusterv3.h>
 #include <trackbase/TrkrClusterv4.h>
@@ -27,6 +28,8 @@
 #include <trackbase/RawHitSetContainer.h>
 
 #include <fun4all/Fun4AllReturnCodes.h>
+#include <fun4all/Fun4AllServer.h>
+#include <fun4all/Fun4AllTaskScheduler.h>
 #include <fun4all/SubsysReco.h>  // for SubsysReco
 
 #include <phool/PHCompositeNode.h>
@@ -42,20 +45,14 @@
 #include <TMatrixTUtils.h>  // for TMatrixTRow
 #include <TVector3.h>
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-#include <boost/graph/adjacency_list.hpp>
-#pragma GCC diagnostic pop
-
-#include <boost/graph/connected_components.hpp>
-
 #include <array>
 #include <cmath>
 #include <cstdlib>  // for exit
 #include <iostream>
-#include <map>  // for multimap<>::iterator
+#include <map>
 #include <set>  // for set, set<>::iterator
 #include <string>
+#include <utility>
 #include <vector>  // for vector
 
 namespace
@@ -67,50 +64,77 @@ namespace
   {
     return x * x;
   }
-}  // namespace
 
-bool MvtxClusterizer::are_adjacent(
-    const std::pair<TrkrDefs::hitkey, TrkrHit *> &lhs,
-    const std::pair<TrkrDefs::hitkey, TrkrHit *> &rhs) const
-{
-  if (GetZClustering())
+  /// cluster position errors, in phi and z, from pixel pitch, length and cluster sizes
+  std::pair<double, double> get_errors(double pitch, double length, unsigned int phisize, unsigned int zsize)
   {
-    return
+    static const double invsqrt12 = 1. / std::sqrt(12);
 
-        // column adjacent
-        ((MvtxDefs::getCol(lhs.first) > MvtxDefs::getCol(rhs.first)) ? MvtxDefs::getCol(lhs.first) <= MvtxDefs::getCol(rhs.first) + 1 : MvtxDefs::getCol(rhs.first) <= MvtxDefs::getCol(lhs.first) + 1) &&
+    // scale factors (phi direction)
+    /*
+      they corresponds to clusters of size (2,2), (2,3), (3,2) and (3,3) in
+      phi and z
+      other clusters, which are very few and pathological, get a scale factor
+      of 1
+      These scale factors are applied to produce cluster pulls with width
+      unity
+    */
 
-        // row adjacent
-        ((MvtxDefs::getRow(lhs.first) > MvtxDefs::getRow(rhs.first)) ? MvtxDefs::getRow(lhs.first) <= MvtxDefs::getRow(rhs.first) + 1 : MvtxDefs::getRow(rhs.first) <= MvtxDefs::getRow(lhs.first) + 1);
-  }
-  return
-      // column identical
-      MvtxDefs::getCol(rhs.first) == MvtxDefs::getCol(lhs.first) &&
+    double phierror = pitch * invsqrt12;
 
-      // row adjacent
-      ((MvtxDefs::getRow(lhs.first) > MvtxDefs::getRow(rhs.first)) ? MvtxDefs::getRow(lhs.first) <= MvtxDefs::getRow(rhs.first) + 1 : MvtxDefs::getRow(rhs.first) <= MvtxDefs::getRow(lhs.first) + 1);
-}
+    static constexpr std::array<double, 7> scalefactors_phi = {
+        {0.36, 0.6, 0.37, 0.49, 0.4, 0.37, 0.33}};
 
-bool MvtxClusterizer::are_adjacent(RawHit *lhs, RawHit *rhs) const
-{
-  if (GetZClustering())
-  {
-    return
+    if ((phisize == 1 && zsize == 1) ||
+        (phisize == 2 && zsize == 2))
+    {
+      phierror *= scalefactors_phi[0];
+    }
+    else if ((phisize == 2 && zsize == 1) ||
+             (phisize == 2 && zsize == 3))
+    {
+      phierror *= scalefactors_phi[1];
+    }
+    else if ((phisize == 1 && zsize == 2) ||
+             (phisize == 3 && zsize == 2))
+    {
+      phierror *= scalefactors_phi[2];
+    }
+    else if (phisize == 3 && zsize == 3)
+    {
+      phierror *= scalefactors_phi[3];
+    }
 
-        // phi adjacent (== column)
-        ((lhs->getPhiBin() > rhs->getPhiBin()) ? lhs->getPhiBin() <= rhs->getPhiBin() + 1 : rhs->getPhiBin() <= lhs->getPhiBin() + 1) &&
+    // scale factors (z direction)
+    /*
+      they corresponds to clusters of size (2,2), (2,3), (3,2) and (3,3) in z
+      and phi
+      other clusters, which are very few and pathological, get a scale factor
+      of 1
+    */
+    static constexpr std::array<double, 4> scalefactors_z = {
+        {0.47, 0.48, 0.71, 0.55}};
+    double zerror = length * invsqrt12;
+    if (zsize == 2 && phisize == 2)
+    {
+      zerror *= scalefactors_z[0];
+    }
+    else if (zsize == 2 && phisize == 3)
+    {
+      zerror *= scalefactors_z[1];
+    }
+    else if (zsize == 3 && phisize == 2)
+    {
+      zerror *= scalefactors_z[2];
+    }
+    else if (zsize == 3 && phisize == 3)
+    {
+      zerror *= scalefactors_z[3];
+    }
 
-        // time adjacent (== row)
-        ((lhs->getTBin() > rhs->getTBin()) ? lhs->getTBin() <= rhs->getTBin() + 1 : rhs->getTBin() <= lhs->getTBin() + 1);
+    return std::make_pair(phierror, zerror);
   }
-  return
-
-      // phi identical (== column)
-      lhs->getPhiBin() == rhs->getPhiBin() &&
-
-      // time adjacent (== row)
-      ((lhs->getTBin() > rhs->getTBin()) ? lhs->getTBin() <= rhs->getTBin() + 1 : rhs->getTBin() <= lhs->getTBin() + 1);
-}
+}  // namespace
 
 MvtxClusterizer::MvtxClusterizer(const std::string &name)
   : SubsysReco(name)
@@ -157,7 +181,7 @@ int MvtxClusterizer::InitRun(PHCompositeNode *topNode)
       dstNode->addNode(DetNode);
     }
 
-    trkrclusters = new TrkrClusterContainerv4;
+    trkrclusters = new TrkrClusterContainerv5;
     PHIODataNode<PHObject> *TrkrClusterContainerNode =
         new PHIODataNode<PHObject>(trkrclusters, "TRKR_CLUSTER", "PHObject");
     DetNode->addNode(TrkrClusterContainerNode);
@@ -302,21 +326,29 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
   // Clustering
   //-----------
 
-  // loop over each MvtxHitSet object (chip)
+  // collect MvtxHitSet objects (chips), they are clustered independently
+  std::vector<TrkrHitSet *> hitsets;
   TrkrHitSetContainer::ConstRange hitsetrange =
       m_hits->getHitSets(TrkrDefs::TrkrId::mvtxId);
   for (TrkrHitSetContainer::ConstIterator hitsetitr = hitsetrange.first;
        hitsetitr != hitsetrange.second; ++hitsetitr)
   {
-    TrkrHitSet *hitset = hitsetitr->second;
+    hitsets.push_back(hitsetitr->second);
+  }
+  std::vector<HitSetClusters> results(hitsets.size());
+
+  auto cluster_hitset = [&](std::size_t ihitset)
+  {
+    TrkrHitSet *hitset = hitsets[ihitset];
+    auto &result = results[ihitset];
 
     if (Verbosity() > 0)
     {
-      unsigned int layer = TrkrDefs::getLayer(hitsetitr->first);
-      unsigned int stave = MvtxDefs::getStaveId(hitsetitr->first);
-      unsigned int chip = MvtxDefs::getChipId(hitsetitr->first);
-      unsigned int strobe = MvtxDefs::getStrobeId(hitsetitr->first);
-      std::cout << "MvtxClusterizer found hitsetkey " << hitsetitr->first
+      unsigned int layer = TrkrDefs::getLayer(hitset->getHitSetKey());
+      unsigned int stave = MvtxDefs::getStaveId(hitset->getHitSetKey());
+      unsigned int chip = MvtxDefs::getChipId(hitset->getHitSetKey());
+      unsigned int strobe = MvtxDefs::getStrobeId(hitset->getHitSetKey());
+      std::cout << "MvtxClusterizer found hitsetkey " << hitset->getHitSetKey()
                 << " layer " << layer << " stave " << stave << " chip " << chip
                 << " strobe " << strobe << std::endl;
     }
@@ -326,14 +358,18 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
       hitset->identify();
     }
 
-    // fill a vector of hits to make things easier
-    std::vector<std::pair<TrkrDefs::hitkey, TrkrHit *> > hitvec;
+    // fill a vector of hits to make things easier, reusing this thread's buffers
+    thread_local std::vector<std::pair<TrkrDefs::hitkey, TrkrHit *> > hitvec;
+    thread_local std::vector<PixelClusterLabeler::Cell> cells;
+    hitvec.clear();
+    cells.clear();
 
     TrkrHitSet::ConstRange hitrangei = hitset->getHits();
     for (TrkrHitSet::ConstIterator hitr = hitrangei.first;
          hitr != hitrangei.second; ++hitr)
     {
       hitvec.emplace_back(hitr->first, hitr->second);
+      cells.emplace_back(MvtxDefs::getCol(hitr->first), MvtxDefs::getRow(hitr->first));
     }
     if (Verbosity() > 2)
     {
@@ -352,42 +388,15 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
       }
     }
 
-    // do the clustering
-    using Graph = boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS>;
-    Graph G;
-
-    // loop over hits in this chip
-    for (unsigned int i = 0; i < hitvec.size(); i++)
-    {
-      for (unsigned int j = 0; j < hitvec.size(); j++)
-      {
-        if (are_adjacent(hitvec[i], hitvec[j]))
-        {
-          add_edge(i, j, G);
-        }
-      }
-    }
-
-    // Find the connections between the vertices of the graph (vertices are the
-    // rawhits,
-    // connections are made when they are adjacent to one another)
-    std::vector<int> component(num_vertices(G));
-
-    // this is the actual clustering, performed by boost
-    boost::connected_components(G, component.data());
+    // do the clustering: hits are adjacent if rows are adjacent and columns identical,
+    // or adjacent with z clustering
+    thread_local PixelClusterLabeler labeler;
+    const unsigned int nclusters = labeler.run(cells, GetZClustering() ? 1 : 0, 1);
 
-    // Loop over the components(hits) compiling a list of the
-    // unique connected groups (ie. clusters).
-    std::set<int> cluster_ids;  // unique components
-    std::multimap<int, std::pair<TrkrDefs::hitkey, TrkrHit *> > clusters;
-    for (unsigned int i = 0; i < component.size(); i++)
+    // loop over the connected groups of hits (ie. clusters)
+    for (unsigned int clusid = 0; clusid < nclusters; ++clusid)
     {
-      cluster_ids.insert(component[i]);
-      clusters.insert(make_pair(component[i], hitvec[i]));
-    }
-    for (const auto &clusid : cluster_ids)
-    {
-      auto clusrange = clusters.equal_range(clusid);
+      const auto clushits = labeler.cluster(clusid);
       auto ckey = TrkrDefs::genClusKey(hitset->getHitSetKey(), clusid);
 
       // determine the size of the cluster in phi and z
@@ -399,8 +408,7 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
       // determine the cluster position...
       double locxsum = 0.;
       double loczsum = 0.;
-      const unsigned int nhits =
-          std::distance(clusrange.first, clusrange.second);
+      const unsigned int nhits = clushits.size();
 
       double locclusx = std::numeric_limits<double>::quiet_NaN();
       double locclusz = std::numeric_limits<double>::quiet_NaN();
@@ -413,13 +421,14 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
         exit(1);
       }
 
-      for (auto mapiter = clusrange.first; mapiter != clusrange.second;
-           ++mapiter)
+      for (const auto &ihit : clushits)
       {
+        const auto &hit = hitvec[ihit];
+
         // size
-        const auto energy = (mapiter->second).second->getAdc();
-        int col = MvtxDefs::getCol((mapiter->second).first);
-        int row = MvtxDefs::getRow((mapiter->second).first);
+        const auto energy = hit.second->getAdc();
+        int col = MvtxDefs::getCol(hit.first);
+        int row = MvtxDefs::getRow(hit.first);
         zbins.insert(col);
         phibins.insert(row);
 
@@ -454,9 +463,9 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
         loczsum += local_coords.Z();
         // add the association between this cluster key and this hitkey to the
         // table
-        m_clusterhitassoc->addAssoc(ckey, mapiter->second.first);
+        result.associations.emplace_back(ckey, hit.first);
 
-      }  // mapiter
+      }  // hit loop
 
       if (mClusHitsVerbose)
       {
@@ -468,15 +477,7 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
                       << std::endl;
           }
         }
-        for (auto &hit : m_phi)
-        {
-          mClusHitsVerbose->addPhiHit(hit.first, (float) hit.second);
-        }
-        for (auto &hit : m_z)
-        {
-          mClusHitsVerbose->addZHit(hit.first, (float) hit.second);
-        }
-        mClusHitsVerbose->push_hits(ckey);
+        result.verbose.push_back({ckey, {m_phi.begin(), m_phi.end()}, {m_z.begin(), m_z.end()}});
       }
 
       // This is the local position
@@ -488,69 +489,7 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
       const double phisize = phibins.size() * pitch;
       const double zsize = zbins.size() * length;
 
-      static const double invsqrt12 = 1. / std::sqrt(12);
-
-      // scale factors (phi direction)
-      /*
-        they corresponds to clusters of size (2,2), (2,3), (3,2) and (3,3) in
-        phi and z
-        other clusters, which are very few and pathological, get a scale factor
-        of 1
-        These scale factors are applied to produce cluster pulls with width
-        unity
-      */
-
-      double phierror = pitch * invsqrt12;
-
-      static constexpr std::array<double, 7> scalefactors_phi = {
-          {0.36, 0.6, 0.37, 0.49, 0.4, 0.37, 0.33}};
-
-      if ((phibins.size() == 1 && zbins.size() == 1) ||
-          (phibins.size() == 2 && zbins.size() == 2))
-      {
-        phierror *= scalefactors_phi[0];
-      }
-      else if ((phibins.size() == 2 && zbins.size() == 1) ||
-               (phibins.size() == 2 && zbins.size() == 3))
-      {
-        phierror *= scalefactors_phi[1];
-      }
-      else if ((phibins.size() == 1 && zbins.size() == 2) ||
-               (phibins.size() == 3 && zbins.size() == 2))
-      {
-        phierror *= scalefactors_phi[2];
-      }
-      else if (phibins.size() == 3 && zbins.size() == 3)
-      {
-        phierror *= scalefactors_phi[3];
-      }
-
-      // scale factors (z direction)
-      /*
-        they corresponds to clusters of size (2,2), (2,3), (3,2) and (3,3) in z
-        and phi
-        other clusters, which are very few and pathological, get a scale factor
-        of 1
-      */
-      static constexpr std::array<double, 4> scalefactors_z = {
-          {0.47, 0.48, 0.71, 0.55}};
-      double zerror = length * invsqrt12;
-      if (zbins.size() == 2 && phibins.size() == 2)
-      {
-        zerror *= scalefactors_z[0];
-      }
-      else if (zbins.size() == 2 && phibins.size() == 3)
-      {
-        zerror *= scalefactors_z[1];
-      }
-      else if (zbins.size() == 3 && phibins.size() == 2)
-      {
-        zerror *= scalefactors_z[2];
-      }
-      else if (zbins.size() == 3 && phibins.size() == 3)
-      {
-        zerror *= scalefactors_z[3];
-      }
+      const auto [phierror, zerror] = get_errors(pitch, length, phibins.size(), zbins.size());
 
       if (Verbosity() > 0)
       {
@@ -582,11 +521,22 @@ void MvtxClusterizer::ClusterMvtx(PHCompositeNode *topNode)
 
       if (zbins.size() <= 127)
       {
-        m_clusterlist->addClusterSpecifyKey(ckey, clus.release());
+        result.clusters.emplace_back(ckey, clus.release());
       }
 
-    }  // clusitr loop
-  }  // loop over hitsets
+    }  // clusid loop
+  };
+
+  // cluster the chips on the shared worker pool, verbose or sequential mode runs them one by one in this thread
+  Fun4AllServer::instance()->TaskScheduler()->parallel_for(
+      Name(), hitsets.size(), cluster_hitset,
+      (do_sequential || Verbosity() > 0) ? 1 : 0);
+
+  // merge in hitset order
+  for (auto &result : results)
+  {
+    store(result);
+  }
 
   if (Verbosity() > 1)
   {
@@ -616,21 +566,29 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
   // Clustering
   //-----------
 
-  // loop over each MvtxHitSet object (chip)
+  // collect MvtxHitSet objects (chips), they are clustered independently
+  std::vector<RawHitSet *> hitsets;
   RawHitSetContainer::ConstRange hitsetrange =
       m_rawhits->getHitSets(TrkrDefs::TrkrId::mvtxId);
   for (RawHitSetContainer::ConstIterator hitsetitr = hitsetrange.first;
        hitsetitr != hitsetrange.second; ++hitsetitr)
   {
-    RawHitSet *hitset = hitsetitr->second;
+    hitsets.push_back(hitsetitr->second);
+  }
+  std::vector<HitSetClusters> results(hitsets.size());
+
+  auto cluster_hitset = [&](std::size_t ihitset)
+  {
+    RawHitSet *hitset = hitsets[ihitset];
+    auto &result = results[ihitset];
 
     if (Verbosity() > 0)
     {
-      unsigned int layer = TrkrDefs::getLayer(hitsetitr->first);
-      unsigned int stave = MvtxDefs::getStaveId(hitsetitr->first);
-      unsigned int chip = MvtxDefs::getChipId(hitsetitr->first);
-      unsigned int strobe = MvtxDefs::getStrobeId(hitsetitr->first);
-      std::cout << "MvtxClusterizer found hitsetkey " << hitsetitr->first
+      unsigned int layer = TrkrDefs::getLayer(hitset->getHitSetKey());
+      unsigned int stave = MvtxDefs::getStaveId(hitset->getHitSetKey());
+      unsigned int chip = MvtxDefs::getChipId(hitset->getHitSetKey());
+      unsigned int strobe = MvtxDefs::getStrobeId(hitset->getHitSetKey());
+      std::cout << "MvtxClusterizer found hitsetkey " << hitset->getHitSetKey()
                 << " layer " << layer << " stave " << stave << " chip " << chip
                 << " strobe " << strobe << std::endl;
     }
@@ -640,59 +598,33 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
       hitset->identify();
     }
 
-    // fill a vector of hits to make things easier
-    std::vector<RawHit *> hitvec;
+    // fill a vector of hits to make things easier, reusing this thread's buffers
+    thread_local std::vector<RawHit *> hitvec;
+    thread_local std::vector<PixelClusterLabeler::Cell> cells;
+    hitvec.clear();
+    cells.clear();
 
     RawHitSet::ConstRange hitrangei = hitset->getHits();
     for (RawHitSet::ConstIterator hitr = hitrangei.first;
          hitr != hitrangei.second; ++hitr)
     {
       hitvec.push_back((*hitr));
+      cells.emplace_back((*hitr)->getPhiBin(), (*hitr)->getTBin());
     }
     if (Verbosity() > 2)
     {
       std::cout << "hitvec.size(): " << hitvec.size() << std::endl;
     }
 
-    // do the clustering
-    using Graph = boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS>;
-    Graph G;
-
-    // loop over hits in this chip
-    for (unsigned int i = 0; i < hitvec.size(); i++)
-    {
-      for (unsigned int j = 0; j < hitvec.size(); j++)
-      {
-        if (are_adjacent(hitvec[i], hitvec[j]))
-        {
-          add_edge(i, j, G);
-        }
-      }
-    }
-
-    // Find the connections between the vertices of the graph (vertices are the
-    // rawhits,
-    // connections are made when they are adjacent to one another)
-    std::vector<int> component(num_vertices(G));
-
-    // this is the actual clustering, performed by boost
-    boost::connected_components(G, component.data());
+    // do the clustering: hits are adjacent if time bins (== row) are adjacent and phi bins (== column) identical,
+    // or adjacent with z clustering
+    thread_local PixelClusterLabeler labeler;
+    const unsigned int nclusters = labeler.run(cells, GetZClustering() ? 1 : 0, 1);
 
-    // Loop over the components(hits) compiling a list of the
-    // unique connected groups (ie. clusters).
-    std::set<int> cluster_ids;  // unique components
-
-    std::multimap<int, RawHit *> clusters;
-    for (unsigned int i = 0; i < component.size(); i++)
-    {
-      cluster_ids.insert(component[i]);
-      clusters.emplace(component[i], hitvec[i]);
-    }
-    //    std::cout << "found cluster #: "<< clusters.size()<< std::endl;
     // loop over the componenets and make clusters
-    for (const auto &clusid : cluster_ids)
+    for (unsigned int clusid = 0; clusid < nclusters; ++clusid)
     {
-      auto clusrange = clusters.equal_range(clusid);
+      const auto clushits = labeler.cluster(clusid);
 
       // make the cluster directly in the node tree
       auto ckey = TrkrDefs::genClusKey(hitset->getHitSetKey(), clusid);
@@ -704,8 +636,7 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
       // determine the cluster position...
       double locxsum = 0.;
       double loczsum = 0.;
-      const unsigned int nhits =
-          std::distance(clusrange.first, clusrange.second);
+      const unsigned int nhits = clushits.size();
 
       double locclusx = NAN;
       double locclusz = NAN;
@@ -719,12 +650,11 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
         exit(1);
       }
 
-      for (auto mapiter = clusrange.first; mapiter != clusrange.second;
-           ++mapiter)
+      for (const auto &ihit : clushits)
       {
         // size
-        int col = (mapiter->second)->getPhiBin();
-        int row = (mapiter->second)->getTBin();
+        int col = hitvec[ihit]->getPhiBin();
+        int row = hitvec[ihit]->getTBin();
         zbins.insert(col);
         phibins.insert(row);
 
@@ -742,11 +672,8 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
         // update cluster position
         locxsum += local_coords.X();
         loczsum += local_coords.Z();
-        // add the association between this cluster key and this hitkey to the
-        // table
-        //	      m_clusterhitassoc->addAssoc(ckey, mapiter->second.first);
 
-      }  // mapiter
+      }  // hit loop
 
       // This is the local position
       locclusx = locxsum / nhits;
@@ -759,69 +686,7 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
       const double phisize = phibins.size() * pitch;
       const double zsize = zbins.size() * length;
 
-      static const double invsqrt12 = 1. / std::sqrt(12);
-
-      // scale factors (phi direction)
-      /*
-        they corresponds to clusters of size (2,2), (2,3), (3,2) and (3,3) in
-        phi and z
-        other clusters, which are very few and pathological, get a scale factor
-        of 1
-        These scale factors are applied to produce cluster pulls with width
-        unity
-      */
-
-      double phierror = pitch * invsqrt12;
-
-      static constexpr std::array<double, 7> scalefactors_phi = {
-          {0.36, 0.6, 0.37, 0.49, 0.4, 0.37, 0.33}};
-      if ((phibins.size() == 1 && zbins.size() == 1) ||
-          (phibins.size() == 2 && zbins.size() == 2))
-      {
-        phierror *= scalefactors_phi[0];
-      }
-      else if ((phibins.size() == 2 && zbins.size() == 1) ||
-               (phibins.size() == 2 && zbins.size() == 3))
-      {
-        phierror *= scalefactors_phi[1];
-      }
-      else if ((phibins.size() == 1 && zbins.size() == 2) ||
-               (phibins.size() == 3 && zbins.size() == 2))
-      {
-        phierror *= scalefactors_phi[2];
-      }
-      else if (phibins.size() == 3 && zbins.size() == 3)
-      {
-        phierror *= scalefactors_phi[3];
-      }
-
-      // scale factors (z direction)
-      /*
-        they corresponds to clusters of size (2,2), (2,3), (3,2) and (3,3) in z
-        and phi
-        other clusters, which are very few and pathological, get a scale factor
-        of 1
-      */
-      static constexpr std::array<double, 4> scalefactors_z = {
-          {0.47, 0.48, 0.71, 0.55}};
-      double zerror = length * invsqrt12;
-
-      if (zbins.size() == 2 && phibins.size() == 2)
-      {
-        zerror *= scalefactors_z[0];
-      }
-      else if (zbins.size() == 2 && phibins.size() == 3)
-      {
-        zerror *= scalefactors_z[1];
-      }
-      else if (zbins.size() == 3 && phibins.size() == 2)
-      {
-        zerror *= scalefactors_z[2];
-      }
-      else if (zbins.size() == 3 && phibins.size() == 3)
-      {
-        zerror *= scalefactors_z[3];
-      }
+      const auto [phierror, zerror] = get_errors(pitch, length, phibins.size(), zbins.size());
 
       if (Verbosity() > 0)
       {
@@ -853,10 +718,21 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
 
       if (zbins.size() <= 127)
       {
-        m_clusterlist->addClusterSpecifyKey(ckey, clus.release());
+        result.clusters.emplace_back(ckey, clus.release());
       }
-    }  // clusitr loop
-  }  // loop over hitsets
+    }  // clusid loop
+  };
+
+  // cluster the chips on the shared worker pool, verbose or sequential mode runs them one by one in this thread
+  Fun4AllServer::instance()->TaskScheduler()->parallel_for(
+      Name(), hitsets.size(), cluster_hitset,
+      (do_sequential || Verbosity() > 0) ? 1 : 0);
+
+  // merge in hitset order
+  for (auto &result : results)
+  {
+    store(result);
+  }
 
   if (Verbosity() > 1)
   {
@@ -867,6 +743,33 @@ void MvtxClusterizer::ClusterMvtxRaw(PHCompositeNode *topNode)
   return;
 }
 
+void MvtxClusterizer::store(HitSetClusters &result)
+{
+  for (const auto &[ckey, hitkey] : result.associations)
+  {
+    m_clusterhitassoc->addAssoc(ckey, hitkey);
+  }
+
+  for (const auto &verbose : result.verbose)
+  {
+    for (const auto &hit : verbose.phi)
+    {
+      mClusHitsVerbose->addPhiHit(hit.first, (float) hit.second);
+    }
+    for (const auto &hit : verbose.z)
+    {
+      mClusHitsVerbose->addZHit(hit.first, (float) hit.second);
+    }
+    mClusHitsVerbose->push_hits(verbose.ckey);
+  }
+
+  for (const auto &[ckey, cluster] : result.clusters)
+  {
+    m_clusterlist->addClusterSpecifyKey(ckey, cluster);
+  }
+  result = HitSetClusters();
+}
+
 void MvtxClusterizer::PrintClusters(PHCompositeNode *topNode)
 {
   if (Verbosity() > 0)
@@ -13,14 +13,13 @@
 
 #include <string>  // for string
 #include <utility>
+#include <vector>
 
 class ClusHitsVerbose;
 class PHCompositeNode;
-class TrkrHit;
 class TrkrHitSetContainer;
 class TrkrClusterContainer;
 class TrkrClusterHitAssoc;
-class RawHit;
 class RawHitSet;
 class RawHitSetContainer;
 
@@ -60,16 +59,30 @@ class MvtxClusterizer : public SubsysReco
   void set_do_hit_association(bool do_assoc) { do_hit_assoc = do_assoc; }
   void set_read_raw(bool read_raw) { do_read_raw = read_raw; }
   void set_ClusHitsVerbose(bool set = true) { record_ClusHitsVerbose = set; };
+  void set_do_sequential(bool b) { do_sequential = b; }
   ClusHitsVerbose *mClusHitsVerbose{nullptr};
 
  private:
-  // bool are_adjacent(const pixel lhs, const pixel rhs);
   bool record_ClusHitsVerbose{false};
-  bool are_adjacent(const std::pair<TrkrDefs::hitkey, TrkrHit *> &lhs, const std::pair<TrkrDefs::hitkey, TrkrHit *> &rhs) const;
-  bool are_adjacent(RawHit *lhs, RawHit *rhs) const;
+
+  //! clusters and associations found in one hitset, stored in the node tree once all hitsets are processed
+  struct HitSetClusters
+  {
+    struct VerboseHits
+    {
+      TrkrDefs::cluskey ckey{0};
+      std::vector<std::pair<int, unsigned int>> phi;
+      std::vector<std::pair<int, unsigned int>> z;
+    };
+
+    std::vector<std::pair<TrkrDefs::cluskey, TrkrCluster *>> clusters;
+    std::vector<std::pair<TrkrDefs::cluskey, TrkrDefs::hitkey>> associations;
+    std::vector<VerboseHits> verbose;
+  };
 
   void ClusterMvtx(PHCompositeNode *topNode);
   void ClusterMvtxRaw(PHCompositeNode *topNode);
+  void store(HitSetClusters &result);
   void PrintClusters(PHCompositeNode *topNode);
 
   // node tree storage pointers
@@ -83,6 +96,7 @@ class MvtxClusterizer : public SubsysReco
   bool m_makeZClustering {true};  // z_clustering_option
   bool do_hit_assoc {true};
   bool do_read_raw {false};
+  bool do_sequential {false};
 };
 
 #endif  // MVTX_MVTXCLUSTERIZER_H
@@ -27,8 +27,208 @@
 #include <gsl/gsl_randist.h>
 #include <gsl/gsl_rng.h>  // for gsl_rng_uniform_pos
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
+
+namespace
+{
+  // bin widths of the eta-phi indices of the cluster centroids and towers
+  constexpr float centroid_bin_width = 0.2;
+  constexpr float EM_tower_bin_width = 0.1;
+  constexpr float HAD_tower_bin_width = 0.2;
+
+  // towers closer than this in both eta and phi link a cluster to a track or EM cluster
+  constexpr double EM_tower_window = 0.025 * 2.5;
+  constexpr double HAD_tower_window = 0.1 * 1.5;
+
+  bool tower_overlaps(float tower_eta, float tower_phi, float eta, float phi, double window)
+  {
+    float deta = tower_eta - eta;
+    float dphi = tower_phi - phi;
+    if (dphi > M_PI)
+    {
+      dphi -= 2 * M_PI;
+    }
+    if (dphi < -M_PI)
+    {
+      dphi += 2 * M_PI;
+    }
+    return (std::fabs(deta) < window && std::fabs(dphi) < window);
+  }
+
+  //! eta-phi binned index of a set of points, wrapping around in phi
+  /*!
+   * query() returns a superset of the points within a box around the query
+   * point, the exact distance cut is left to the caller. Points with a
+   * non-finite coordinate are returned by every query, so that the result of
+   * the exact cut is the same as when looping over all points.
+   */
+  class EtaPhiIndex
+  {
+   public:
+    explicit EtaPhiIndex(float bin_width)
+      : m_bin_width(bin_width)
+      , m_eta_bin_width(bin_width)
+      , m_nphi(std::max(1, static_cast<int>(2 * M_PI / bin_width)))
+      , m_phi_bin_width(static_cast<float>(2 * M_PI / m_nphi))
+    {
+    }
+
+    void build(const std::vector<float> &eta, const std::vector<float> &phi)
+    {
+      m_npoints = eta.size();
+      m_bin_start.clear();
+      m_points.clear();
+      m_unbinned.clear();
+
+      m_eta_min = std::numeric_limits<float>::max();
+      float eta_max = std::numeric_limits<float>::lowest();
+      for (unsigned int i = 0; i < m_npoints; i++)
+      {
+        if (std::isfinite(eta[i]) && std::isfinite(phi[i]))
+        {
+          m_eta_min = std::min(m_eta_min, eta[i]);
+          eta_max = std::max(eta_max, eta[i]);
+        }
+      }
+      // widen the eta bins rather than allocating an excessive number of them
+      m_eta_bin_width = m_bin_width;
+      if (eta_max >= m_eta_min)
+      {
+        m_eta_bin_width = std::max(m_bin_width, (eta_max - m_eta_min) / max_eta_bins);
+      }
+      m_neta = (eta_max < m_eta_min) ? 0 : eta_bin(eta_max) + 1;
+
+      // counting sort of the points into their bins
+      std::vector<unsigned int> bin(m_npoints);
+      m_bin_start.assign(m_neta * m_nphi + 1, 0);
+      for (unsigned int i = 0; i < m_npoints; i++)
+      {
+        if (std::isfinite(eta[i]) && std::isfinite(phi[i]))
+        {
+          bin[i] = eta_bin(eta[i]) * m_nphi + phi_bin(phi[i]);
+          m_bin_start[bin[i] + 1]++;
+        }
+        else
+        {
+          m_unbinned.push_back(i);
+        }
+      }
+      for (unsigned int b = 1; b < m_bin_start.size(); b++)
+      {
+        m_bin_start[b] += m_bin_start[b - 1];
+      }
+      m_points.resize(m_npoints - m_unbinned.size());
+      std::vector<unsigned int> fill(m_bin_start.begin(), m_bin_start.end() - 1);
+      for (unsigned int i = 0; i < m_npoints; i++)
+      {
+        if (std::isfinite(eta[i]) && std::isfinite(phi[i]))
+        {
+          m_points[fill[bin[i]]++] = i;
+        }
+      }
+    }
+
+    //! append the indices of the points within half_width in eta and phi of (eta, phi), plus a margin
+    void query(float eta, float phi, float half_width, std::vector<unsigned int> &result) const
+    {
+      result.insert(result.end(), m_unbinned.begin(), m_unbinned.end());
+      if (m_neta == 0)
+      {
+        return;
+      }
+
+      if (!std::isfinite(eta) || !std::isfinite(phi))
+      {
+        result.insert(result.end(), m_points.begin(), m_points.end());
+        return;
+      }
+
+      // one extra bin on each side guards against rounding at the bin edges
+      float eta_lo_f = std::floor((eta - half_width - m_eta_min) / m_eta_bin_width) - 1;
+      float eta_hi_f = std::floor((eta + half_width - m_eta_min) / m_eta_bin_width) + 1;
+      if (eta_hi_f < 0 || eta_lo_f >= m_neta)
+      {
+        return;
+      }
+      int eta_lo = std::max(static_cast<int>(eta_lo_f), 0);
+      int eta_hi = std::min(static_cast<int>(std::min(eta_hi_f, static_cast<float>(m_neta))), m_neta - 1);
+
+      int phi_center = phi_bin(phi);
+      int phi_reach = static_cast<int>(std::ceil(half_width / m_phi_bin_width)) + 1;
+      int phi_lo = phi_center - phi_reach;
+      int phi_hi = phi_center + phi_reach;
+      if (phi_hi - phi_lo + 1 >= m_nphi)
+      {
+        phi_lo = 0;
+        phi_hi = m_nphi - 1;
+      }
+
+      for (int ieta = eta_lo; ieta <= eta_hi; ieta++)
+      {
+        for (int iphi = phi_lo; iphi <= phi_hi; iphi++)
+        {
+          int b = ieta * m_nphi + ((iphi % m_nphi) + m_nphi) % m_nphi;
+          result.insert(result.end(), m_points.begin() + m_bin_start[b], m_points.begin() + m_bin_start[b + 1]);
+        }
+      }
+    }
+
+   private:
+    int eta_bin(float eta) const
+    {
+      return std::min(static_cast<int>((eta - m_eta_min) / m_eta_bin_width), max_eta_bins - 1);
+    }
+
+    int phi_bin(float phi) const
+    {
+      double wrapped = phi - 2 * M_PI * std::floor(phi / (2 * M_PI));
+      return std::min(static_cast<int>(wrapped / m_phi_bin_width), m_nphi - 1);
+    }
+
+    static constexpr int max_eta_bins = 1000;
+
+    float m_bin_width;
+    float m_eta_bin_width;
+    int m_nphi;
+    float m_phi_bin_width;
+
+    unsigned int m_npoints {0};
+    float m_eta_min {0};
+    int m_neta {0};
+
+    std::vector<unsigned int> m_bin_start;
+    std::vector<unsigned int> m_points;
+    std::vector<unsigned int> m_unbinned;
+  };
+
+  //! flag the clusters owning a tower that overlaps with (eta, phi)
+  void find_tower_overlaps(const EtaPhiIndex &index, const std::vector<float> &tower_eta, const std::vector<float> &tower_phi,
+                           const std::vector<unsigned int> &tower_cluster, float eta, float phi, double window,
+                           std::vector<unsigned int> &towers, std::vector<char> &overlap)
+  {
+    towers.clear();
+    index.query(eta, phi, window, towers);
+    for (unsigned int tow : towers)
+    {
+      if (tower_overlaps(tower_eta[tow], tower_phi[tow], eta, phi, window))
+      {
+        overlap[tower_cluster[tow]] = 1;
+      }
+    }
+  }
+
+  //! clear the flags set by find_tower_overlaps
+  void clear_tower_overlaps(const std::vector<unsigned int> &towers, const std::vector<unsigned int> &tower_cluster, std::vector<char> &overlap)
+  {
+    for (unsigned int tow : towers)
+    {
+      overlap[tower_cluster[tow]] = 0;
+    }
+  }
+}  // namespace
 
 // examine second value of std::pair, sort by smallest
 bool sort_by_pair_second_lowest(const std::pair<int, float> &a, const std::pair<int, float> &b)
@@ -135,6 +335,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
   _pflow_EM_phi.clear();
   _pflow_EM_tower_eta.clear();
   _pflow_EM_tower_phi.clear();
+  _pflow_EM_tower_cluster.clear();
   _pflow_EM_match_HAD.clear();
   _pflow_EM_match_TRK.clear();
   _pflow_EM_cluster.clear();
@@ -144,6 +345,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
   _pflow_HAD_phi.clear();
   _pflow_HAD_tower_eta.clear();
   _pflow_HAD_tower_phi.clear();
+  _pflow_HAD_tower_cluster.clear();
   _pflow_HAD_match_EM.clear();
   _pflow_HAD_match_TRK.clear();
   _pflow_HAD_cluster.clear();
@@ -258,6 +460,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
       _pflow_EM_eta.push_back(cluster_eta);
       _pflow_EM_phi.push_back(cluster_phi);
       _pflow_EM_cluster.push_back(hiter->second);
+      const unsigned int this_cluster = _pflow_EM_cluster.size() - 1;
       _pflow_EM_match_HAD.emplace_back();
       _pflow_EM_match_TRK.emplace_back();
 
@@ -266,9 +469,6 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         std::cout << " EM topoCluster with E = " << cluster_E << ", eta / phi = " << cluster_eta << " / " << cluster_phi << " , nTow = " << hiter->second->getNTowers() << std::endl;
       }
 
-      std::vector<float> this_cluster_tower_eta;
-      std::vector<float> this_cluster_tower_phi;
-
       // read in towers
       RawCluster::TowerConstRange begin_end_towers = hiter->second->get_towers();
       for (RawCluster::TowerConstIterator iter = begin_end_towers.first; iter != begin_end_towers.second; ++iter)
@@ -277,8 +477,9 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         {
           RawTowerGeom *tower_geom = geomEM->get_tower_geometry(iter->first);
 
-          this_cluster_tower_phi.push_back(tower_geom->get_phi());
-          this_cluster_tower_eta.push_back(tower_geom->get_eta());
+          _pflow_EM_tower_phi.push_back(tower_geom->get_phi());
+          _pflow_EM_tower_eta.push_back(tower_geom->get_eta());
+          _pflow_EM_tower_cluster.push_back(this_cluster);
         }
         else
         {
@@ -287,8 +488,6 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         }
       }  // close tower loop
 
-      _pflow_EM_tower_eta.push_back(this_cluster_tower_eta);
-      _pflow_EM_tower_phi.push_back(this_cluster_tower_phi);
 
     }  // close cluster loop
 
@@ -318,6 +517,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
       _pflow_HAD_eta.push_back(cluster_eta);
       _pflow_HAD_phi.push_back(cluster_phi);
       _pflow_HAD_cluster.push_back(hiter->second);
+      const unsigned int this_cluster = _pflow_HAD_cluster.size() - 1;
 
       _pflow_HAD_match_EM.emplace_back();
       _pflow_HAD_match_TRK.emplace_back();
@@ -327,9 +527,6 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         std::cout << " HAD topoCluster with E = " << cluster_E << ", eta / phi = " << cluster_eta << " / " << cluster_phi << " , nTow = " << hiter->second->getNTowers() << std::endl;
       }
 
-      std::vector<float> this_cluster_tower_eta;
-      std::vector<float> this_cluster_tower_phi;
-
       // read in towers
       RawCluster::TowerConstRange begin_end_towers = hiter->second->get_towers();
       for (RawCluster::TowerConstIterator iter = begin_end_towers.first; iter != begin_end_towers.second; ++iter)
@@ -338,16 +535,18 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         {
           RawTowerGeom *tower_geom = geomIH->get_tower_geometry(iter->first);
 
-          this_cluster_tower_phi.push_back(tower_geom->get_phi());
-          this_cluster_tower_eta.push_back(tower_geom->get_eta());
+          _pflow_HAD_tower_phi.push_back(tower_geom->get_phi());
+          _pflow_HAD_tower_eta.push_back(tower_geom->get_eta());
+          _pflow_HAD_tower_cluster.push_back(this_cluster);
         }
 
         else if (RawTowerDefs::decode_caloid(iter->first) == RawTowerDefs::CalorimeterId::HCALOUT)
         {
           RawTowerGeom *tower_geom = geomOH->get_tower_geometry(iter->first);
 
-          this_cluster_tower_phi.push_back(tower_geom->get_phi());
-          this_cluster_tower_eta.push_back(tower_geom->get_eta());
+          _pflow_HAD_tower_phi.push_back(tower_geom->get_phi());
+          _pflow_HAD_tower_eta.push_back(tower_geom->get_eta());
+          _pflow_HAD_tower_cluster.push_back(this_cluster);
         }
         else
         {
@@ -357,13 +556,27 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
 
       }  // close tower loop
 
-      _pflow_HAD_tower_eta.push_back(this_cluster_tower_eta);
-      _pflow_HAD_tower_phi.push_back(this_cluster_tower_phi);
 
     }  // close cluster loop
 
   }  // close
 
+  // index the cluster centroids and towers in eta-phi, so that each link only
+  // considers the clusters and towers in the neighbourhood of the track or cluster
+  EtaPhiIndex EM_index(centroid_bin_width);
+  EtaPhiIndex HAD_index(centroid_bin_width);
+  EtaPhiIndex EM_tower_index(EM_tower_bin_width);
+  EtaPhiIndex HAD_tower_index(HAD_tower_bin_width);
+  EM_index.build(_pflow_EM_eta, _pflow_EM_phi);
+  HAD_index.build(_pflow_HAD_eta, _pflow_HAD_phi);
+  EM_tower_index.build(_pflow_EM_tower_eta, _pflow_EM_tower_phi);
+  HAD_tower_index.build(_pflow_HAD_tower_eta, _pflow_HAD_tower_phi);
+
+  std::vector<unsigned int> candidates;
+  std::vector<unsigned int> towers;
+  std::vector<char> EM_tower_overlap(_pflow_EM_E.size(), 0);
+  std::vector<char> HAD_tower_overlap(_pflow_HAD_E.size(), 0);
+
   // BEGIN LINKING STEP
 
   // Link TRK -> EM (best match, but keep reserve of others), and TRK -> HAD (best match)
@@ -383,7 +596,13 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
     float min_em_dR = 0.2;
     int min_em_index = -1;
 
-    for (unsigned int em = 0; em < _pflow_EM_E.size(); em++)
+    candidates.clear();
+    EM_index.query(_pflow_TRK_EMproj_eta[trk], _pflow_TRK_EMproj_phi[trk], 0.2, candidates);
+    std::sort(candidates.begin(), candidates.end());
+    find_tower_overlaps(EM_tower_index, _pflow_EM_tower_eta, _pflow_EM_tower_phi, _pflow_EM_tower_cluster,
+                        _pflow_TRK_EMproj_eta[trk], _pflow_TRK_EMproj_phi[trk], EM_tower_window, towers, EM_tower_overlap);
+
+    for (unsigned int em : candidates)
     {
       float dR = calculate_dR(_pflow_TRK_EMproj_eta[trk], _pflow_EM_eta[em], _pflow_TRK_EMproj_phi[trk], _pflow_EM_phi[em]);
 
@@ -392,30 +611,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         continue;
       }
 
-      bool has_overlap = false;
-
-      for (unsigned int tow = 0; tow < _pflow_EM_tower_eta.at(em).size(); tow++)
-      {
-        float tower_eta = _pflow_EM_tower_eta.at(em).at(tow);
-        float tower_phi = _pflow_EM_tower_phi.at(em).at(tow);
-
-        float deta = tower_eta - _pflow_TRK_EMproj_eta[trk];
-        float dphi = tower_phi - _pflow_TRK_EMproj_phi[trk];
-        if (dphi > M_PI)
-        {
-          dphi -= 2 * M_PI;
-        }
-        if (dphi < -M_PI)
-        {
-          dphi += 2 * M_PI;
-        }
-
-        if (std::fabs(deta) < 0.025 * 2.5 && std::fabs(dphi) < 0.025 * 2.5)
-        {
-          has_overlap = true;
-          break;
-        }
-      }
+      bool has_overlap = EM_tower_overlap[em];
 
       if (has_overlap)
       {
@@ -434,6 +630,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         }
       }
     }
+    clear_tower_overlaps(towers, _pflow_EM_tower_cluster, EM_tower_overlap);
 
     // sort possible matches
 
@@ -479,7 +676,13 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
     float max_had_pt = 0;
 
     // TODO: sequential linking should better happen here -- i.e. allow EM-matched HAD's into the possible pool
-    for (unsigned int had = 0; had < _pflow_HAD_E.size(); had++)
+    candidates.clear();
+    HAD_index.query(_pflow_TRK_HADproj_eta[trk], _pflow_TRK_HADproj_phi[trk], 0.5, candidates);
+    std::sort(candidates.begin(), candidates.end());
+    find_tower_overlaps(HAD_tower_index, _pflow_HAD_tower_eta, _pflow_HAD_tower_phi, _pflow_HAD_tower_cluster,
+                        _pflow_TRK_HADproj_eta[trk], _pflow_TRK_HADproj_phi[trk], HAD_tower_window, towers, HAD_tower_overlap);
+
+    for (unsigned int had : candidates)
     {
       float dR = calculate_dR(_pflow_TRK_HADproj_eta[trk], _pflow_HAD_eta[had], _pflow_TRK_HADproj_phi[trk], _pflow_HAD_phi[had]);
 
@@ -488,30 +691,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         continue;
       }
 
-      bool has_overlap = false;
-
-      for (unsigned int tow = 0; tow < _pflow_HAD_tower_eta.at(had).size(); tow++)
-      {
-        float tower_eta = _pflow_HAD_tower_eta.at(had).at(tow);
-        float tower_phi = _pflow_HAD_tower_phi.at(had).at(tow);
-
-        float deta = tower_eta - _pflow_TRK_HADproj_eta[trk];
-        float dphi = tower_phi - _pflow_TRK_HADproj_phi[trk];
-        if (dphi > M_PI)
-        {
-          dphi -= 2 * M_PI;
-        }
-        if (dphi < -M_PI)
-        {
-          dphi += 2 * M_PI;
-        }
-
-        if (std::fabs(deta) < 0.1 * 1.5 && std::fabs(dphi) < 0.1 * 1.5)
-        {
-          has_overlap = true;
-          break;
-        }
-      }
+      bool has_overlap = HAD_tower_overlap[had];
 
       if (has_overlap)
       {
@@ -535,6 +715,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         }
       }
     }
+    clear_tower_overlaps(towers, _pflow_HAD_tower_cluster, HAD_tower_overlap);
 
     if (min_had_index > -1)
     {
@@ -573,7 +754,13 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
     int min_had_index = -1;
     float max_had_pt = 0;
 
-    for (unsigned int had = 0; had < _pflow_HAD_E.size(); had++)
+    candidates.clear();
+    HAD_index.query(_pflow_EM_eta[em], _pflow_EM_phi[em], 0.5, candidates);
+    std::sort(candidates.begin(), candidates.end());
+    find_tower_overlaps(HAD_tower_index, _pflow_HAD_tower_eta, _pflow_HAD_tower_phi, _pflow_HAD_tower_cluster,
+                        _pflow_EM_eta[em], _pflow_EM_phi[em], HAD_tower_window, towers, HAD_tower_overlap);
+
+    for (unsigned int had : candidates)
     {
       float dR = calculate_dR(_pflow_EM_eta[em], _pflow_HAD_eta[had], _pflow_EM_phi[em], _pflow_HAD_phi[had]);
       if (dR > 0.5)
@@ -581,30 +768,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         continue;
       }
 
-      bool has_overlap = false;
-
-      for (unsigned int tow = 0; tow < _pflow_HAD_tower_eta.at(had).size(); tow++)
-      {
-        float tower_eta = _pflow_HAD_tower_eta.at(had).at(tow);
-        float tower_phi = _pflow_HAD_tower_phi.at(had).at(tow);
-
-        float deta = tower_eta - _pflow_EM_eta[em];
-        float dphi = tower_phi - _pflow_EM_phi[em];
-        if (dphi > M_PI)
-        {
-          dphi -= 2 * M_PI;
-        }
-        if (dphi < -M_PI)
-        {
-          dphi += 2 * M_PI;
-        }
-
-        if (std::fabs(deta) < 0.1 * 1.5 && std::fabs(dphi) < 0.1 * 1.5)
-        {
-          has_overlap = true;
-          break;
-        }
-      }
+      bool has_overlap = HAD_tower_overlap[had];
 
       if (has_overlap)
       {
@@ -628,6 +792,7 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
         }
       }
     }
+    clear_tower_overlaps(towers, _pflow_HAD_tower_cluster, HAD_tower_overlap);
 
     if (min_had_index > -1)
     {
@@ -65,8 +65,10 @@ class ParticleFlowReco : public SubsysReco
   std::vector<float> _pflow_EM_eta;
   std::vector<float> _pflow_EM_phi;
   std::vector<RawCluster *> _pflow_EM_cluster;
-  std::vector<std::vector<float> > _pflow_EM_tower_eta;
-  std::vector<std::vector<float> > _pflow_EM_tower_phi;
+  // towers of all EM clusters, _pflow_EM_tower_cluster is the index of the owning cluster
+  std::vector<float> _pflow_EM_tower_eta;
+  std::vector<float> _pflow_EM_tower_phi;
+  std::vector<unsigned int> _pflow_EM_tower_cluster;
   std::vector<std::vector<int> > _pflow_EM_match_HAD;
   std::vector<std::vector<int> > _pflow_EM_match_TRK;
 
@@ -74,8 +76,10 @@ class ParticleFlowReco : public SubsysReco
   std::vector<float> _pflow_HAD_eta;
   std::vector<float> _pflow_HAD_phi;
   std::vector<RawCluster *> _pflow_HAD_cluster;
-  std::vector<std::vector<float> > _pflow_HAD_tower_eta;
-  std::vector<std::vector<float> > _pflow_HAD_tower_phi;
+  // towers of all HAD clusters, _pflow_HAD_tower_cluster is the index of the owning cluster
+  std::vector<float> _pflow_HAD_tower_eta;
+  std::vector<float> _pflow_HAD_tower_phi;
+  std::vector<unsigned int> _pflow_HAD_tower_cluster;
   std::vector<std::vector<int> > _pflow_HAD_match_EM;
   std::vector<std::vector<int> > _pflow_HAD_match_TRK;
 
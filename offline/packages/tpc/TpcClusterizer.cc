@@ -11,7 +11,7 @@
 
 #include <trackbase/ClusHitsVerbosev1.h>
 #include <trackbase/TpcDefs.h>
-#include <trackbase/TrkrClusterContainerv4.h>
+#include <trackbase/TrkrClusterContainerv5.h>
 #include <trackbase/TrkrClusterHitAssocv3.h>
 #include <trackbase/TrkrClusterv3.h>
 #include <trackbase/TrkrClusterv4.h>
@@ -28,6 +28,8 @@
 #include <trackbase/RawHitSetContainer.h>
 
 #include <fun4all/Fun4AllReturnCodes.h>
+#include <fun4all/Fun4AllServer.h>
+#include <fun4all/Fun4AllTaskScheduler.h>
 #include <fun4all/SubsysReco.h>  // for SubsysReco
 
 #include <g4detectors/PHG4TpcGeom.h>
@@ -64,8 +66,6 @@
 #include <utility>  // for pair
 #include <vector>
 #include <unordered_set>
-// Terra incognita....
-#include <pthread.h>
 
 namespace
 {
@@ -124,6 +124,15 @@ namespace
   const int nd = 5;
   torch::jit::script::Module module_pos;
 
+  // cluster waiting for the NN position refinement
+  struct nn_cluster
+  {
+    TrkrCluster *cluster = nullptr;
+    const TrainingHits *training_hits = nullptr;
+    Surface surface;
+    double radius = 0;
+  };
+
   struct thread_data
   {
     PHG4TpcGeom *layergeom = nullptr;
@@ -166,14 +175,13 @@ namespace
     std::vector<assoc> association_vector;
     std::vector<TrkrCluster *> cluster_vector;
     std::vector<TrainingHits *> v_hits;
+    std::vector<nn_cluster> nn_clusters;
     int verbosity = 0;
     bool fillClusHitsVerbose = false;
     vec_dVerbose phivec_ClusHitsVerbose;  // only fill if fillClusHitsVerbose
     vec_dVerbose zvec_ClusHitsVerbose;    // only fill if fillClusHitsVerbose
   };
 
-  pthread_mutex_t mythreadlock;
-
   void remove_hit(double adc, int phibin, int tbin, int edge, std::multimap<unsigned short, ihit> &all_hit_map, std::vector<std::vector<unsigned short>> &adcval)
   {
     using hit_iterator = std::multimap<unsigned short, ihit>::iterator;
@@ -981,39 +989,11 @@ namespace
       b_made_cluster = true;
     }
 
-    // This code needs to be reviewed in case of a non-zero TPC tilt - ADF 6/16/26
+    // the NN position refinement is done for all sectors at once, see refine_cluster_positions
     if (use_nn && clus_base && training_hits)
     {
-      try
-      {
-        // Create a vector of inputs
-        std::vector<torch::jit::IValue> inputs;
-        inputs.emplace_back(torch::stack({torch::from_blob(std::vector<double>(training_hits->v_adc.begin(), training_hits->v_adc.end()).data(), {1, 2 * nd + 1, 2 * nd + 1}, torch::kFloat32),
-                                          torch::full({1, 2 * nd + 1, 2 * nd + 1}, std::clamp((training_hits->layer - 7) / 16, 0, 2), torch::kFloat32),
-                                          torch::full({1, 2 * nd + 1, 2 * nd + 1}, training_hits->z / radius, torch::kFloat32)},
-                                         1));
-
-        // Execute the model and turn its output into a tensor
-        at::Tensor ten_pos = module_pos.forward(inputs).toTensor();
-        double nn_phi = training_hits->phi + std::clamp(ten_pos[0][0][0].item<double>(), -(double) nd, (double) nd) * training_hits->phistep;
-        double nn_z = training_hits->z + std::clamp(ten_pos[0][1][0].item<double>(), -(double) nd, (double) nd) * training_hits->zstep;
-        double nn_x = radius * std::cos(nn_phi);
-        double nn_y = radius * std::sin(nn_phi);
-
-        Acts::Vector3 nn_env_global(nn_x, nn_y, nn_z);
-        Acts::Vector3 nn_global = my_data.tGeometry->transformTpcEnvelopeToWorld(nn_env_global);
-        nn_global *= Acts::UnitConstants::cm;
-         Acts::Vector3 nn_local = surface->localToGlobalTransform(my_data.tGeometry->geometry().geoContext).inverse() * nn_global;
-        nn_local /= Acts::UnitConstants::cm;
-        double nn_t = my_data.m_tdriftmax - std::fabs(nn_z) / my_data.tGeometry->get_drift_velocity();
-        clus_base->setLocalX(nn_local(0));
-        clus_base->setLocalY(nn_t);
-      }
-      catch (const c10::Error &e)
-      {
-        std::cout << PHWHERE << "Error: Failed to execute NN modules" << std::endl;
-      }
-    }  // use_nn
+      my_data.nn_clusters.push_back({clus_base, training_hits, surface, radius});
+    }
 
     if (my_data.fillClusHitsVerbose && b_made_cluster)
     {
@@ -1384,11 +1364,94 @@ namespace
     // pthread_exit(nullptr);
   }
 
-  void *ProcessSector(void *threadarg)
+  // refine the position of the clusters collected in all sectors with the NN, in batches of up to max_batch clusters
+  // This code needs to be reviewed in case of a non-zero TPC tilt - ADF 6/16/26
+  void refine_cluster_positions(std::vector<thread_data> &sectors, unsigned int max_batch)
   {
-    auto *my_data = static_cast<thread_data *>(threadarg);
-    ProcessSectorData(my_data);
-    pthread_exit(nullptr);
+    constexpr int width = 2 * nd + 1;
+
+    // flatten the clusters of all sectors, keeping track of the sector they belong to
+    std::vector<std::pair<const thread_data *, const nn_cluster *>> clusters;
+    for (const auto &data : sectors)
+    {
+      for (const auto &entry : data.nn_clusters)
+      {
+        clusters.emplace_back(&data, &entry);
+      }
+    }
+    if (clusters.empty())
+    {
+      return;
+    }
+
+    // network input, reused across batches and events
+    static torch::Tensor input;
+    const int64_t batch = std::min<std::size_t>(std::max(max_batch, 1U), clusters.size());
+    if (!input.defined() || input.size(0) < batch)
+    {
+      input = torch::empty({batch, 3, width, width}, torch::kFloat32);
+    }
+
+    torch::NoGradGuard no_grad;
+    for (std::size_t first = 0; first < clusters.size(); first += batch)
+    {
+      const int64_t n = std::min<std::size_t>(batch, clusters.size() - first);
+
+      // fill adc window, layer and z/r channels
+      auto in = input.accessor<float, 4>();
+      for (int64_t i = 0; i < n; ++i)
+      {
+        const auto *training_hits = clusters[first + i].second->training_hits;
+        const float layer = std::clamp((training_hits->layer - 7) / 16, 0, 2);
+        const float zr = training_hits->z / clusters[first + i].second->radius;
+        for (int iphi = 0; iphi < width; ++iphi)
+        {
+          for (int it = 0; it < width; ++it)
+          {
+            in[i][0][iphi][it] = training_hits->v_adc[iphi * width + it];
+            in[i][1][iphi][it] = layer;
+            in[i][2][iphi][it] = zr;
+          }
+        }
+      }
+
+      at::Tensor ten_pos;
+      try
+      {
+        // Execute the model and turn its output into a tensor
+        std::vector<torch::jit::IValue> inputs;
+        inputs.emplace_back(input.narrow(0, 0, n));
+        ten_pos = module_pos.forward(inputs).toTensor().to(torch::kFloat64).contiguous();
+      }
+      catch (const c10::Error &e)
+      {
+        std::cout << PHWHERE << "Error: Failed to execute NN modules" << std::endl;
+        continue;
+      }
+
+      // scatter the refined positions back to the clusters
+      const auto pos = ten_pos.accessor<double, 3>();
+      for (int64_t i = 0; i < n; ++i)
+      {
+        const auto &my_data = *clusters[first + i].first;
+        const auto &entry = *clusters[first + i].second;
+        const auto *training_hits = entry.training_hits;
+
+        double nn_phi = training_hits->phi + std::clamp(pos[i][0][0], -(double) nd, (double) nd) * training_hits->phistep;
+        double nn_z = training_hits->z + std::clamp(pos[i][1][0], -(double) nd, (double) nd) * training_hits->zstep;
+        double nn_x = entry.radius * std::cos(nn_phi);
+        double nn_y = entry.radius * std::sin(nn_phi);
+
+        Acts::Vector3 nn_env_global(nn_x, nn_y, nn_z);
+        Acts::Vector3 nn_global = my_data.tGeometry->transformTpcEnvelopeToWorld(nn_env_global);
+        nn_global *= Acts::UnitConstants::cm;
+        Acts::Vector3 nn_local = entry.surface->localToGlobalTransform(my_data.tGeometry->geometry().geoContext).inverse() * nn_global;
+        nn_local /= Acts::UnitConstants::cm;
+        double nn_t = my_data.m_tdriftmax - std::fabs(nn_z) / my_data.tGeometry->get_drift_velocity();
+        entry.cluster->setLocalX(nn_local(0));
+        entry.cluster->setLocalY(nn_t);
+      }
+    }
   }
 }  // namespace
 
@@ -1454,7 +1517,7 @@ int TpcClusterizer::InitRun(PHCompositeNode *topNode)
       dstNode->addNode(DetNode);
     }
 
-    trkrclusters = new TrkrClusterContainerv4;
+    trkrclusters = new TrkrClusterContainerv5;
     PHIODataNode<PHObject> *TrkrClusterContainerNode =
         new PHIODataNode<PHObject>(trkrclusters, "TRKR_CLUSTER", "PHObject");
     DetNode->addNode(TrkrClusterContainerNode);
@@ -1685,27 +1748,9 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
       rawhitsetrange = m_rawhits->getHitSets(TrkrDefs::TrkrId::tpcId);
       num_hitsets = std::distance(rawhitsetrange.first, rawhitsetrange.second);
     }
-  // create structure to store given thread and associated data
-  struct thread_pair_t
-  {
-    pthread_t thread{};
-    thread_data data;
-  };
-
-  // create vector of thread pairs and reserve the right size upfront to avoid reallocation
-  std::vector<thread_pair_t> threads;
-  threads.reserve(num_hitsets);
-
-  pthread_attr_t attr;
-  pthread_attr_init(&attr);
-  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-
-  if (pthread_mutex_init(&mythreadlock, nullptr) != 0)
-  {
-    std::cout << std::endl
-              << " mutex init failed" << std::endl;
-    return 1;
-  }
+  // create vector of per sector data and reserve the right size upfront to avoid reallocation
+  std::vector<thread_data> sectors;
+  sectors.reserve(num_hitsets);
 //  int count = 0;
 
   if (!do_read_raw)
@@ -1721,40 +1766,40 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
       unsigned int sector = TpcDefs::getSectorId(hitsetitr->first);
       PHG4TpcGeom *layergeom = geom_container->GetLayerCellGeom(layer);
 
-      // instanciate new thread pair, at the end of thread vector
-      thread_pair_t &thread_pair = threads.emplace_back();
+      // instanciate new sector data, at the end of sector vector
+      thread_data &sector_data = sectors.emplace_back();
       if (mClusHitsVerbose)
       {
-        thread_pair.data.fillClusHitsVerbose = true;
+        sector_data.fillClusHitsVerbose = true;
       };
 
-      thread_pair.data.layergeom = layergeom;
-      thread_pair.data.hitset = hitset;
-      thread_pair.data.rawhitset = nullptr;
-      thread_pair.data.layer = layer;
-      thread_pair.data.pedestal = pedestal;
-      thread_pair.data.seed_threshold = seed_threshold;
-      thread_pair.data.edge_threshold = edge_threshold;
-      thread_pair.data.sector = sector;
-      thread_pair.data.side = side;
-      thread_pair.data.do_assoc = do_hit_assoc;
-      thread_pair.data.do_wedge_emulation = do_wedge_emulation;
-      thread_pair.data.do_singles = do_singles;
-      thread_pair.data.tGeometry = m_tGeometry;
-      thread_pair.data.maxHalfSizeT = MaxClusterHalfSizeT;
-      thread_pair.data.maxHalfSizePhi = MaxClusterHalfSizePhi;
-      thread_pair.data.verbosity = Verbosity();
-      thread_pair.data.do_split = do_split;
-      thread_pair.data.FixedWindow = do_fixed_window;
-      thread_pair.data.min_err_squared = min_err_squared;
-      thread_pair.data.min_clus_size = min_clus_size;
-      thread_pair.data.min_adc_sum = min_adc_sum;
+      sector_data.layergeom = layergeom;
+      sector_data.hitset = hitset;
+      sector_data.rawhitset = nullptr;
+      sector_data.layer = layer;
+      sector_data.pedestal = pedestal;
+      sector_data.seed_threshold = seed_threshold;
+      sector_data.edge_threshold = edge_threshold;
+      sector_data.sector = sector;
+      sector_data.side = side;
+      sector_data.do_assoc = do_hit_assoc;
+      sector_data.do_wedge_emulation = do_wedge_emulation;
+      sector_data.do_singles = do_singles;
+      sector_data.tGeometry = m_tGeometry;
+      sector_data.maxHalfSizeT = MaxClusterHalfSizeT;
+      sector_data.maxHalfSizePhi = MaxClusterHalfSizePhi;
+      sector_data.verbosity = Verbosity();
+      sector_data.do_split = do_split;
+      sector_data.FixedWindow = do_fixed_window;
+      sector_data.min_err_squared = min_err_squared;
+      sector_data.min_clus_size = min_clus_size;
+      sector_data.min_adc_sum = min_adc_sum;
 
       // --- pass dead/hot map info ---
-      thread_pair.data.deadMap  = &m_deadChannelMap;
-      thread_pair.data.hotMap   = &m_hotChannelMap;
-      thread_pair.data.maskDead = m_maskDeadChannels;
-      thread_pair.data.maskHot  = m_maskHotChannels;
+      sector_data.deadMap  = &m_deadChannelMap;
+      sector_data.hotMap   = &m_hotChannelMap;
+      sector_data.maskDead = m_maskDeadChannels;
+      sector_data.maskHot  = m_maskHotChannels;
 
       unsigned short NPhiBins = (unsigned short) layergeom->get_phibins();
       unsigned short NPhiBinsSector = NPhiBins / 12;
@@ -1774,72 +1819,17 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
 
       m_tdriftmax = layergeom->get_max_driftlength() / m_tGeometry->get_drift_velocity(); 
       //  std::cout << "     m_tdriftmax " << m_tdriftmax << " drift velocity reco " << m_tGeometry->get_drift_velocity() << std::endl;
-      thread_pair.data.m_tdriftmax = m_tdriftmax;
-
-      thread_pair.data.phibins = NPhiBinsSector;
-      thread_pair.data.phioffset = PhiOffset;
-      thread_pair.data.tbins = NTBinsSide;
-      thread_pair.data.toffset = TOffset;
-      thread_pair.data.debug = m_debug;
-      thread_pair.data.radius = layergeom->get_radius();
-      thread_pair.data.drift_velocity = m_tGeometry->get_drift_velocity();
-      thread_pair.data.pads_per_sector = 0;
-      thread_pair.data.phistep = 0;
-      int rc;
-      rc = pthread_create(&thread_pair.thread, &attr, ProcessSector, (void *) &thread_pair.data);
-
-      if (rc)
-      {
-        std::cout << "Error:unable to create thread," << rc << std::endl;
-      }
-      if (do_sequential)
-      {
-        int rc2 = pthread_join(thread_pair.thread, nullptr);
-        if (rc2)
-        {
-          std::cout << "Error:unable to join," << rc2 << std::endl;
-        }
-
-        // get the hitsetkey from thread data
-        const auto &data(thread_pair.data);
-        const auto hitsetkey = TpcDefs::genHitSetKey(data.layer, data.sector, data.side);
-
-        // copy clusters to map
-        for (uint32_t index = 0; index < data.cluster_vector.size(); ++index)
-        {
-          // generate cluster key
-          const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
-
-          // get cluster
-          auto *cluster = data.cluster_vector[index];
-
-          // insert in map
-          m_clusterlist->addClusterSpecifyKey(ckey, cluster);
-
-          if (mClusHitsVerbose)
-          {
-            for (const auto &hit : data.phivec_ClusHitsVerbose[index])
-            {
-              mClusHitsVerbose->addPhiHit(hit.first, hit.second);
-            }
-            for (const auto &hit : data.zvec_ClusHitsVerbose[index])
-            {
-              mClusHitsVerbose->addZHit(hit.first, hit.second);
-            }
-            mClusHitsVerbose->push_hits(ckey);
-          }
-        }
-
-        // copy hit associations to map
-        for (const auto &[index, hkey] : thread_pair.data.association_vector)
-        {
-          // generate cluster key
-          const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
-
-          // add to association table
-          m_clusterhitassoc->addAssoc(ckey, hkey);
-        }
-      }
+      sector_data.m_tdriftmax = m_tdriftmax;
+
+      sector_data.phibins = NPhiBinsSector;
+      sector_data.phioffset = PhiOffset;
+      sector_data.tbins = NTBinsSide;
+      sector_data.toffset = TOffset;
+      sector_data.debug = m_debug;
+      sector_data.radius = layergeom->get_radius();
+      sector_data.drift_velocity = m_tGeometry->get_drift_velocity();
+      sector_data.pads_per_sector = 0;
+      sector_data.phistep = 0;
 //      count++;
     }
   }
@@ -1859,29 +1849,29 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
       unsigned int sector = TpcDefs::getSectorId(hitsetitr->first);
       PHG4TpcGeom *layergeom = geom_container->GetLayerCellGeom(layer);
 
-      // instanciate new thread pair, at the end of thread vector
-      thread_pair_t &thread_pair = threads.emplace_back();
-
-      thread_pair.data.layergeom = layergeom;
-      thread_pair.data.hitset = nullptr;
-      thread_pair.data.rawhitset = hitset;
-      thread_pair.data.layer = layer;
-      thread_pair.data.pedestal = pedestal;
-      thread_pair.data.sector = sector;
-      thread_pair.data.side = side;
-      thread_pair.data.debug = m_debug;
-      thread_pair.data.do_assoc = do_hit_assoc;
-      thread_pair.data.do_wedge_emulation = do_wedge_emulation;
-      thread_pair.data.tGeometry = m_tGeometry;
-      thread_pair.data.maxHalfSizeT = MaxClusterHalfSizeT;
-      thread_pair.data.maxHalfSizePhi = MaxClusterHalfSizePhi;
-      thread_pair.data.verbosity = Verbosity();
+      // instanciate new sector data, at the end of sector vector
+      thread_data &sector_data = sectors.emplace_back();
+
+      sector_data.layergeom = layergeom;
+      sector_data.hitset = nullptr;
+      sector_data.rawhitset = hitset;
+      sector_data.layer = layer;
+      sector_data.pedestal = pedestal;
+      sector_data.sector = sector;
+      sector_data.side = side;
+      sector_data.debug = m_debug;
+      sector_data.do_assoc = do_hit_assoc;
+      sector_data.do_wedge_emulation = do_wedge_emulation;
+      sector_data.tGeometry = m_tGeometry;
+      sector_data.maxHalfSizeT = MaxClusterHalfSizeT;
+      sector_data.maxHalfSizePhi = MaxClusterHalfSizePhi;
+      sector_data.verbosity = Verbosity();
 
       // --- pass dead/hot map info ---
-      thread_pair.data.deadMap  = &m_deadChannelMap;
-      thread_pair.data.hotMap   = &m_hotChannelMap;
-      thread_pair.data.maskDead = m_maskDeadChannels;
-      thread_pair.data.maskHot  = m_maskHotChannels;
+      sector_data.deadMap  = &m_deadChannelMap;
+      sector_data.hotMap   = &m_hotChannelMap;
+      sector_data.maskDead = m_maskDeadChannels;
+      sector_data.maskHot  = m_maskHotChannels;
 
       unsigned short NPhiBins = (unsigned short) layergeom->get_phibins();
       unsigned short NPhiBinsSector = NPhiBins / 12;
@@ -1893,12 +1883,12 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
 
       m_tdriftmax = layergeom->get_max_driftlength() / m_tGeometry->get_drift_velocity(); 
       //      std::cout << "     m_tdriftmax " << m_tdriftmax << " drift velocity reco " << m_tGeometry->get_drift_velocity() << std::endl;
-      thread_pair.data.m_tdriftmax = m_tdriftmax;
+      sector_data.m_tdriftmax = m_tdriftmax;
 
-      thread_pair.data.phibins = NPhiBinsSector;
-      thread_pair.data.phioffset = PhiOffset;
-      thread_pair.data.tbins = NTBinsSide;
-      thread_pair.data.toffset = TOffset;
+      sector_data.phibins = NPhiBinsSector;
+      sector_data.phioffset = PhiOffset;
+      sector_data.tbins = NTBinsSide;
+      sector_data.toffset = TOffset;
       
       /*
       PHG4TpcGeom *testlayergeom = geom_container->GetLayerCellGeom(32);
@@ -1923,118 +1913,72 @@ int TpcClusterizer::process_event(PHCompositeNode *topNode)
       }
       continue;
       */
-      int rc = 0;
-      //      if(layer==32)
-      rc = pthread_create(&thread_pair.thread, &attr, ProcessSector, (void *) &thread_pair.data);
-      //      else
-      // continue;
-
-      if (rc)
-      {
-        std::cout << "Error:unable to create thread," << rc << std::endl;
-      }
-
-      if (do_sequential)
-      {
-        int rc2 = pthread_join(thread_pair.thread, nullptr);
-        if (rc2)
-        {
-          std::cout << "Error:unable to join," << rc2 << std::endl;
-        }
-
-        // get the hitsetkey from thread data
-        const auto &data(thread_pair.data);
-        const auto hitsetkey = TpcDefs::genHitSetKey(data.layer, data.sector, data.side);
-
-        // copy clusters to map
-        for (uint32_t index = 0; index < data.cluster_vector.size(); ++index)
-        {
-          // generate cluster key
-          const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
-
-          // get cluster
-          auto *cluster = data.cluster_vector[index];
-
-          // insert in map
-          m_clusterlist->addClusterSpecifyKey(ckey, cluster);
-        }
-
-        // copy hit associations to map
-        for (const auto &[index, hkey] : thread_pair.data.association_vector)
-        {
-          // generate cluster key
-          const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
-
-          // add to association table
-          m_clusterhitassoc->addAssoc(ckey, hkey);
-        }
-      }
 //      count++;
     }
   }
 
-  pthread_attr_destroy(&attr);
 //  count = 0;
-  // wait for completion of all threads
-  if (!do_sequential)
+  // cluster the sectors on the shared worker pool, sequential mode runs them one by one in this thread
+  Fun4AllServer::instance()->TaskScheduler()->parallel_for(
+      Name(), sectors.size(), [&sectors](std::size_t i)
+      { ProcessSectorData(&sectors[i]); },
+      do_sequential ? 1 : 0);
+
+  // batched NN refinement of the cluster positions, before the clusters are moved to the container
+  if (use_nn)
   {
-    for (const auto &thread_pair : threads)
-    {
-      int rc2 = pthread_join(thread_pair.thread, nullptr);
-      if (rc2)
-      {
-        std::cout << "Error:unable to join," << rc2 << std::endl;
-      }
+    refine_cluster_positions(sectors, m_nn_batch_size);
+  }
 
-      // get the hitsetkey from thread data
-      const auto &data(thread_pair.data);
-      const auto hitsetkey = TpcDefs::genHitSetKey(data.layer, data.sector, data.side);
+  // merge the per sector results in hitset order
+  for (const auto &data : sectors)
+  {
+    const auto hitsetkey = TpcDefs::genHitSetKey(data.layer, data.sector, data.side);
 
-      // copy clusters to map
-      for (uint32_t index = 0; index < data.cluster_vector.size(); ++index)
-      {
-        // generate cluster key
-        const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
+    // copy clusters to map
+    for (uint32_t index = 0; index < data.cluster_vector.size(); ++index)
+    {
+      // generate cluster key
+      const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
 
-        // get cluster
-        auto *cluster = data.cluster_vector[index];
+      // get cluster
+      auto *cluster = data.cluster_vector[index];
 
-        // insert in map
-        // std::cout << "X: " << cluster->getLocalX() << "Y: " << cluster->getLocalY() << std::endl;
-        m_clusterlist->addClusterSpecifyKey(ckey, cluster);
+      // insert in map
+      // std::cout << "X: " << cluster->getLocalX() << "Y: " << cluster->getLocalY() << std::endl;
+      m_clusterlist->addClusterSpecifyKey(ckey, cluster);
 
-        if (mClusHitsVerbose)
+      if (mClusHitsVerbose)
+      {
+        for (const auto &hit : data.phivec_ClusHitsVerbose[index])
         {
-          for (const auto &hit : data.phivec_ClusHitsVerbose[index])
-          {
-            mClusHitsVerbose->addPhiHit(hit.first, (double) hit.second);
-          }
-          for (const auto &hit : data.zvec_ClusHitsVerbose[index])
-          {
-            mClusHitsVerbose->addZHit(hit.first, (double) hit.second);
-          }
-          mClusHitsVerbose->push_hits(ckey);
+          mClusHitsVerbose->addPhiHit(hit.first, (double) hit.second);
+        }
+        for (const auto &hit : data.zvec_ClusHitsVerbose[index])
+        {
+          mClusHitsVerbose->addZHit(hit.first, (double) hit.second);
         }
+        mClusHitsVerbose->push_hits(ckey);
       }
+    }
 
-      // copy hit associations to map
-      for (const auto &[index, hkey] : thread_pair.data.association_vector)
-      {
-        // generate cluster key
-        const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
+    // copy hit associations to map
+    for (const auto &[index, hkey] : data.association_vector)
+    {
+      // generate cluster key
+      const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
 
-        // add to association table
-        m_clusterhitassoc->addAssoc(ckey, hkey);
-      }
+      // add to association table
+      m_clusterhitassoc->addAssoc(ckey, hkey);
+    }
 
-      for (auto *v_hit : thread_pair.data.v_hits)
+    for (auto *v_hit : data.v_hits)
+    {
+      if (_store_hits)
       {
-        if (_store_hits)
-        {
-          m_training->v_hits.emplace_back(*v_hit);
-        }
-        delete v_hit;
+        m_training->v_hits.emplace_back(*v_hit);
       }
+      delete v_hit;
     }
   }
 
@@ -39,6 +39,8 @@ public:
   void set_sector_fiducial_cut(const double cut) { SectorFiducialCut = cut; }
   void set_store_hits(bool store_hits) { _store_hits = store_hits; }
   void set_use_nn(bool use_nn) { _use_nn = use_nn; }
+  //! maximum number of clusters passed to the NN in a single forward pass
+  void set_nn_batch_size(unsigned int size) { m_nn_batch_size = size; }
   void set_do_hit_association(bool do_assoc) { do_hit_assoc = do_assoc; }
   void set_do_wedge_emulation(bool do_wedge) { do_wedge_emulation = do_wedge; }
   void set_do_sequential(bool do_seq) { do_sequential = do_seq; }
@@ -110,6 +112,7 @@ public:
   bool m_rejectEvent = true;
   bool _store_hits = false;
   bool _use_nn = false;
+  unsigned int m_nn_batch_size = 4096;
   bool do_hit_assoc = true;
   bool do_wedge_emulation = false;
   bool do_read_raw = false;
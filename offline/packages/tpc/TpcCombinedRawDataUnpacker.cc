@@ -5,8 +5,7 @@
 #include <trackbase/TrkrHit.h>
 #include <trackbase/TrkrHitSet.h>
 #include <trackbase/TrkrHitSetContainer.h>
-#include <trackbase/TrkrHitSetContainerv1.h>
-#include <trackbase/TrkrHitv2.h>
+#include <trackbase/TrkrHitSetContainerv3.h>
 
 #include <g4detectors/PHG4TpcGeom.h>
 #include <g4detectors/PHG4TpcGeomContainer.h>
@@ -162,7 +161,7 @@ int TpcCombinedRawDataUnpacker::InitRun(PHCompositeNode* topNode)
       std::cout << "\tMaking TrkrHitSetContainer" << std::endl;
     }
 
-    trkr_hit_set_container = new TrkrHitSetContainerv1;
+    trkr_hit_set_container = new TrkrHitSetContainerv3;
     PHIODataNode<PHObject>* new_node = new PHIODataNode<PHObject>(trkr_hit_set_container, "TRKR_HITSET", "PHObject");
     trkr_node->addNode(new_node);
   }
@@ -449,9 +448,8 @@ int TpcCombinedRawDataUnpacker::process_event(PHCompositeNode* topNode)
         hit = hit_set_container_itr->second->getHit(hit_key);
         if (!hit)
         {
-          hit = new TrkrHitv2();
+          hit = hit_set_container_itr->second->findOrAddHit(hit_key);
           hit->setAdc(double(adc) - hpedestal);
-          hit_set_container_itr->second->addHitSpecificKey(hit_key, hit);
         }
 
         if (m_writeTree)
@@ -42,6 +42,85 @@ namespace
     return check_boundaries(h->GetXaxis(), r) && check_boundaries(h->GetYaxis(), phi);
   }
 
+  using Grid = TpcDistortionCorrectionContainer::Grid;
+  using GridAxis = TpcDistortionCorrectionContainer::GridAxis;
+
+  // bin center, same as TAxis::GetBinCenter for uniform binning
+  inline double get_bin_center(const GridAxis& axis, int bin)
+  {
+    return axis.min + (bin - 1) * axis.width + 0.5 * axis.width;
+  }
+
+  // get lower bin and fraction used for interpolation, same as TH1::Interpolate
+  /* returns false if the value is not within the range of the axis, or into the first or last bin, same as check_boundaries */
+  inline bool get_interpolation_bin(const GridAxis& axis, double value, int& bin, double& fraction)
+  {
+    // same as TAxis::FindFixBin
+    if (!(value >= axis.min && value < axis.max))
+    {
+      return false;
+    }
+    bin = 1 + int(axis.nbins * (value - axis.min) / (axis.max - axis.min));
+    if (bin < 2 || bin >= axis.nbins)
+    {
+      return false;
+    }
+
+    if (value < get_bin_center(axis, bin))
+    {
+      --bin;
+    }
+    fraction = (value - get_bin_center(axis, bin)) / axis.width;
+    return true;
+  }
+
+  // linear interpolation of all distortions in the grid, in one pass
+  /* z is ignored for 2D grids */
+  inline bool interpolate(const Grid& grid, double phi, double r, double z, double& dphi, double& dr, double& dz)
+  {
+    int iphi = 0;
+    int ir = 0;
+    int iz = 0;
+    double fphi = 0;
+    double fr = 0;
+    double fz = 0;
+    if (!(get_interpolation_bin(grid.axis[0], phi, iphi, fphi) && get_interpolation_bin(grid.axis[1], r, ir, fr)))
+    {
+      return false;
+    }
+
+    if (grid.zstride && !get_interpolation_bin(grid.axis[2], z, iz, fz))
+    {
+      return false;
+    }
+
+    dphi = 0;
+    dr = 0;
+    dz = 0;
+    constexpr int node_size = TpcDistortionCorrectionContainer::kGridNodeSize;
+    const float* base = &grid.values()[node_size * (iphi + grid.ystride * ir + grid.zstride * iz)];
+    const int ncorners = grid.zstride ? 8 : 4;
+    for (int corner = 0; corner < ncorners; ++corner)
+    {
+      const int cphi = corner & 1;
+      const int cr = (corner >> 1) & 1;
+      const int cz = (corner >> 2) & 1;
+      const double weight = (cphi ? fphi : 1 - fphi) * (cr ? fr : 1 - fr) * (cz ? fz : 1 - fz);
+      const float* node = base + node_size * (cphi + grid.ystride * cr + grid.zstride * cz);
+      dphi += weight * node[0];
+      dr += weight * node[1];
+      dz += weight * node[2];
+    }
+    return true;
+  }
+
+  // true if the grid matching the given side can be used in place of the histograms
+  inline bool use_grid(const TpcDistortionCorrectionContainer* dcc, int index)
+  {
+    const auto& grid = dcc->m_grids[index];
+    return !grid.values().empty() && (dcc->m_dimensions == 3) == (grid.zstride != 0);
+  }
+
 }  // namespace
 
 //________________________________________________________
@@ -82,8 +161,35 @@ Acts::Vector3 TpcDistortionCorrection::get_corrected_position(const Acts::Vector
   dr=0;
   dz=0;
   
-  //get the corrections from the histograms
-  if (dcc->m_dimensions == 3)
+  //get the corrections from the flat grid if available, from the histograms otherwise
+  if (use_grid(dcc, index))
+  {
+    double zterm = 1.0;
+    if (dcc->m_dimensions == 2 && dcc->m_interpolate_z)
+    {
+      zterm = (1. - std::abs(z) / 102.605);
+    }
+
+    double grid_dphi = 0;
+    double grid_dr = 0;
+    double grid_dz = 0;
+    if (interpolate(dcc->m_grids[index], phi, r, z, grid_dphi, grid_dr, grid_dz))
+    {
+      if (mask & COORD_PHI)
+      {
+        dphi = grid_dphi * zterm / divisor;
+      }
+      if (mask & COORD_R)
+      {
+        dr = grid_dr * zterm;
+      }
+      if (mask & COORD_Z)
+      {
+        dz = grid_dz * zterm;
+      }
+    }
+  }
+  else if (dcc->m_dimensions == 3)
   {
     if (dcc->m_hDPint[index] && (mask & COORD_PHI) && check_boundaries(dcc->m_hDPint[index], phi, r, z))
     {
@@ -138,3 +244,12 @@ if(dcc->m_use_scalefactor)
 
   return {x_new, y_new, z_new};
 }
+
+//________________________________________________________
+void TpcDistortionCorrection::get_corrected_positions(std::span<Acts::Vector3> positions, const TpcDistortionCorrectionContainer* dcc, unsigned int mask) const
+{
+  for (auto& position : positions)
+  {
+    position = get_corrected_position(position, dcc, mask);
+  }
+}
@@ -7,13 +7,50 @@
 
 #include "TpcDistortionCorrectionContainer.h"
 
+#include <phool/PHGridFile.h>
+
+#include <TAxis.h>
 #include <TFile.h>
 #include <TH1.h>
 #include <TObject.h>
 
+#include <cassert>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <memory>
 
+namespace
+{
+  // content type of the binary cache
+  constexpr uint32_t kCacheType = PHGridFile::typeId("TPCD");
+
+  // dimension, then number of bins, min and max for each axis
+  using CacheAxisParameters = std::array<double, 10>;
+
+  // copy uniform axis parameters, returns false for variable bin sizes
+  bool copy_axis(const TAxis* axis, TpcDistortionCorrectionContainer::GridAxis& grid_axis)
+  {
+    if (axis->IsVariableBinSize())
+    {
+      return false;
+    }
+    grid_axis.nbins = axis->GetNbins();
+    grid_axis.min = axis->GetXmin();
+    grid_axis.max = axis->GetXmax();
+    grid_axis.width = (grid_axis.max - grid_axis.min) / grid_axis.nbins;
+    return true;
+  }
+
+  // true if both axis have the same binning
+  bool same_binning(const TAxis* first, const TAxis* second)
+  {
+    return first->GetNbins() == second->GetNbins() &&
+           first->GetXmin() == second->GetXmin() &&
+           first->GetXmax() == second->GetXmax();
+  }
+}  // namespace
+
 //_______________________________________________________________
 void TpcDistortionCorrectionContainer::load_histograms( const std::string& source )
 {
@@ -35,6 +72,167 @@ void TpcDistortionCorrectionContainer::load_histograms( const std::string& sourc
     m_hDZint[j] = dynamic_cast<TH1*>(distortion_tfile->Get((std::string("hIntDistortionZ")+extension[j]).c_str()));
     assert(m_hDZint[j]);
   }
+
+  build_grids();
+}
+
+//_______________________________________________________________
+void TpcDistortionCorrectionContainer::build_grids()
+{
+  clear_grids();
+  for (int j = 0; j < 2; ++j)
+  {
+    const TH1* hphi = m_hDPint[j];
+    const TH1* hr = m_hDRint[j];
+    const TH1* hz = m_hDZint[j];
+    if (!(hphi && hr && hz))
+    {
+      continue;
+    }
+
+    const int dimension = hphi->GetDimension();
+    if (dimension < 2 || dimension > 3 || hr->GetDimension() != dimension || hz->GetDimension() != dimension)
+    {
+      continue;
+    }
+
+    const std::array<const TAxis*, 3> axes = {{hphi->GetXaxis(), hphi->GetYaxis(), hphi->GetZaxis()}};
+    bool valid = true;
+    auto& grid = m_grids[j];
+    for (int i = 0; i < dimension; ++i)
+    {
+      valid = valid && copy_axis(axes[i], grid.axis[i]);
+    }
+    for (const auto& h : {hr, hz})
+    {
+      valid = valid && same_binning(axes[0], h->GetXaxis()) && same_binning(axes[1], h->GetYaxis());
+      if (dimension == 3)
+      {
+        valid = valid && same_binning(axes[2], h->GetZaxis());
+      }
+    }
+
+    if (!valid)
+    {
+      std::cout << "TpcDistortionCorrectionContainer::build_grids - non uniform binning for side " << j << ", using histograms" << std::endl;
+      grid = Grid();
+      continue;
+    }
+
+    // same layout as the histogram global bin index
+    grid.ystride = grid.axis[0].nbins + 2;
+    grid.zstride = dimension == 3 ? grid.ystride * (grid.axis[1].nbins + 2) : 0;
+    const int ncells = grid.ystride * (grid.axis[1].nbins + 2) * (dimension == 3 ? grid.axis[2].nbins + 2 : 1);
+    grid.storage.assign(kGridNodeSize * ncells, 0);
+    for (int bin = 0; bin < ncells; ++bin)
+    {
+      float* node = &grid.storage[kGridNodeSize * bin];
+      node[0] = hphi->GetBinContent(bin);
+      node[1] = hr->GetBinContent(bin);
+      node[2] = hz->GetBinContent(bin);
+    }
+  }
+}
+
+//_______________________________________________________________
+void TpcDistortionCorrectionContainer::clear_grids()
+{
+  for (auto& grid : m_grids)
+  {
+    grid = Grid();
+  }
+  m_cache.reset();
+}
+
+//_______________________________________________________________
+bool TpcDistortionCorrectionContainer::load_cache(const std::string& source)
+{
+  std::shared_ptr<const PHGridFile> cache = PHGridFile::openCache(source, kCacheType);
+  if (!cache)
+  {
+    return false;
+  }
+
+  // one array with the axis parameters and one with the values for each side
+  if (cache->size() != 4)
+  {
+    std::cout << "TpcDistortionCorrectionContainer::load_cache - invalid cache for " << source << std::endl;
+    return false;
+  }
+
+  std::array<Grid, 2> grids;
+  int dimension = 0;
+  for (int j = 0; j < 2; ++j)
+  {
+    const auto parameters = cache->array(2 * j);
+    if (parameters.size_bytes() != sizeof(CacheAxisParameters))
+    {
+      std::cout << "TpcDistortionCorrectionContainer::load_cache - invalid cache for " << source << std::endl;
+      return false;
+    }
+    CacheAxisParameters axis_parameters{};
+    std::memcpy(axis_parameters.data(), parameters.data(), sizeof(CacheAxisParameters));
+
+    // dimension, then number of bins, min and max for each axis
+    dimension = axis_parameters[0];
+    for (int i = 0; i < 3; ++i)
+    {
+      auto& axis = grids[j].axis[i];
+      axis.nbins = axis_parameters[1 + 3 * i];
+      axis.min = axis_parameters[2 + 3 * i];
+      axis.max = axis_parameters[3 + 3 * i];
+      axis.width = axis.nbins > 0 ? (axis.max - axis.min) / axis.nbins : 0;
+    }
+    grids[j].ystride = grids[j].axis[0].nbins + 2;
+    grids[j].zstride = dimension == 3 ? grids[j].ystride * (grids[j].axis[1].nbins + 2) : 0;
+    grids[j].mapped = cache->array(2 * j + 1);
+
+    const size_t ncells = grids[j].ystride * (grids[j].axis[1].nbins + 2) * (dimension == 3 ? grids[j].axis[2].nbins + 2 : 1);
+    if ((dimension != 2 && dimension != 3) || grids[j].axis[0].nbins <= 0 || grids[j].axis[1].nbins <= 0 || grids[j].mapped.size() != kGridNodeSize * ncells)
+    {
+      std::cout << "TpcDistortionCorrectionContainer::load_cache - invalid cache for " << source << std::endl;
+      return false;
+    }
+  }
+
+  std::cout << "TpcDistortionCorrectionContainer::load_cache - reading corrections from " << PHGridFile::cacheName(source) << std::endl;
+  clear_grids();
+  m_grids = std::move(grids);
+  m_cache = std::move(cache);
+  m_dimensions = dimension;
+  return true;
+}
+
+//_______________________________________________________________
+bool TpcDistortionCorrectionContainer::save_cache(const std::string& source) const
+{
+  std::vector<CacheAxisParameters> axis_parameters(2);
+  std::vector<std::span<const float>> arrays;
+  for (int j = 0; j < 2; ++j)
+  {
+    const auto& grid = m_grids[j];
+    if (grid.values().empty())
+    {
+      std::cout << "TpcDistortionCorrectionContainer::save_cache - no grid for side " << j << ", cache not written" << std::endl;
+      return false;
+    }
+
+    auto& parameters = axis_parameters[j];
+    parameters[0] = grid.zstride ? 3 : 2;
+    for (int i = 0; i < 3; ++i)
+    {
+      parameters[1 + 3 * i] = grid.axis[i].nbins;
+      parameters[2 + 3 * i] = grid.axis[i].min;
+      parameters[3 + 3 * i] = grid.axis[i].max;
+    }
+
+    // doubles are stored as raw bytes, to keep the axis boundaries exact
+    arrays.emplace_back(reinterpret_cast<const float*>(parameters.data()), sizeof(CacheAxisParameters) / sizeof(float));
+    arrays.push_back(grid.values());
+  }
+
+  std::cout << "TpcDistortionCorrectionContainer::save_cache - writing " << PHGridFile::cacheName(source) << std::endl;
+  return PHGridFile::writeCache(source, kCacheType, arrays);
 }
 
 //_______________________________________________________________
@@ -8,7 +8,12 @@
  */
 
 #include <array>
+#include <memory>
+#include <span>
 #include <string>
+#include <vector>
+
+class PHGridFile;
 
 class TH1;
 
@@ -24,6 +29,28 @@ class TpcDistortionCorrectionContainer
   //! save histograms to out file
   void save_histograms( const std::string& /*destination*/ ) const;
 
+  //! copy the distortion histograms into m_grids
+  /**
+   * called by load_histograms. It must be called again if the histograms are
+   * changed afterwards, or clear_grids must be called to use the histograms directly.
+   * The grid of a given side is left empty if any histogram is missing, if they do not
+   * share the same binning or if the binning is not uniform.
+   */
+  void build_grids();
+
+  //! remove grids, distortions are interpolated from the histograms
+  void clear_grids();
+
+  //! map the grids from the binary cache of a given source file (see PHGridFile)
+  /**
+   * no histogram is loaded in this case. Returns false if there is no valid
+   * cache with a grid for each side.
+   */
+  bool load_cache( const std::string& /*source*/ );
+
+  //! write the grids to the binary cache of a given source file
+  bool save_cache( const std::string& /*source*/ ) const;
+
   //! flag to tell us whether to read z data or just 2d data
   int m_dimensions = 3;
 
@@ -48,6 +75,43 @@ class TpcDistortionCorrectionContainer
    */
   std::array<TH1*, 2> m_hentries = {{nullptr, nullptr}};
   //@}
+
+  //!@name flat copy of the distortion histograms, used instead of TH1::Interpolate
+  //@{
+
+  //! uniform axis, same convention as TAxis
+  struct GridAxis
+  {
+    int nbins = 0;
+    double min = 0;
+    double max = 0;
+    double width = 0;
+  };
+
+  //! all bins, including underflow and overflow, indexed like the histogram global bin
+  /** each bin holds dphi, dr, dz and one padding value, so that a bin is 16 bytes */
+  struct Grid
+  {
+    std::array<GridAxis, 3> axis;
+    //! bin values, from storage or from the mapped cache file
+    /** built on access, so that copies of the grid do not point to the storage of the original */
+    std::span<const float> values() const { return storage.empty() ? mapped : std::span<const float>(storage); }
+    //! view on the mapped cache file, kept alive by m_cache
+    std::span<const float> mapped;
+    std::vector<float> storage;
+    //! offset between consecutive bins along y and z
+    int ystride = 0;
+    int zstride = 0;
+  };
+
+  //! number of values per bin in Grid::values
+  static constexpr int kGridNodeSize = 4;
+
+  std::array<Grid, 2> m_grids;
+
+  //! binary cache the grids point to, if loaded from cache
+  std::shared_ptr<const PHGridFile> m_cache;
+  //@}
 };
 
 #endif
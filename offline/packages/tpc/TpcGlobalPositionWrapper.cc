@@ -72,6 +72,31 @@ Acts::Vector3 TpcGlobalPositionWrapper::applyDistortionCorrections(Acts::Vector3
   return global;
 }
 
+//____________________________________________________________________________________________________________________
+void TpcGlobalPositionWrapper::applyDistortionCorrections(std::span<Acts::Vector3> positions) const
+{
+  // apply distortion corrections, one container at a time
+  if (m_enable_module_edge_corr && m_dcc_module_edge)
+  {
+    m_distortionCorrection.get_corrected_positions(positions, m_dcc_module_edge);
+  }
+
+  if (m_enable_static_corr && m_dcc_static)
+  {
+    m_distortionCorrection.get_corrected_positions(positions, m_dcc_static);
+  }
+
+  if (m_enable_average_corr && m_dcc_average)
+  {
+    m_distortionCorrection.get_corrected_positions(positions, m_dcc_average);
+  }
+
+  if (m_enable_fluctuation_corr && m_dcc_fluctuation)
+  {
+    m_distortionCorrection.get_corrected_positions(positions, m_dcc_fluctuation);
+  }
+}
+
 //____________________________________________________________________________________________________________________
 Acts::Vector3 TpcGlobalPositionWrapper::getGlobalPositionDistortionCorrected(const TrkrDefs::cluskey& key, TrkrCluster* cluster, short int crossing ) const
 {
@@ -51,6 +51,9 @@ class TpcGlobalPositionWrapper
   //! apply all loaded distortion corrections to a given position
   Acts::Vector3 applyDistortionCorrections( Acts::Vector3 /*source*/ ) const;
 
+  //! apply all loaded distortion corrections to a set of positions, in place
+  void applyDistortionCorrections( std::span<Acts::Vector3> /*positions*/ ) const;
+
   //! get distortion corrected global position from cluster
   /**
    * first converts cluster position local coordinate to global coordinates
@@ -83,11 +83,19 @@ int TpcLoadDistortionCorrection::InitRun(PHCompositeNode* topNode)
       runNode->addNode(node);
     }
 
-    // load histograms from file
-    distortion_correction_object->load_histograms(m_correction_filename[i]);
+    // load grids from the binary cache next to the file if any, histograms from file otherwise
+    if (!distortion_correction_object->load_cache(m_correction_filename[i]))
+    {
+      distortion_correction_object->load_histograms(m_correction_filename[i]);
+
+      // assign correction object dimension from histograms dimention, assuming all histograms have the same
+      distortion_correction_object->m_dimensions = distortion_correction_object->m_hDPint[0]->GetDimension();
 
-    // assign correction object dimension from histograms dimention, assuming all histograms have the same
-    distortion_correction_object->m_dimensions = distortion_correction_object->m_hDPint[0]->GetDimension();
+      if (m_write_cache)
+      {
+        distortion_correction_object->save_cache(m_correction_filename[i]);
+      }
+    }
 
     // only dimensions 2 or 3 are supported
     assert(distortion_correction_object->m_dimensions == 2 || distortion_correction_object->m_dimensions == 3);
@@ -103,7 +111,7 @@ int TpcLoadDistortionCorrection::InitRun(PHCompositeNode* topNode)
     distortion_correction_object->m_scalefactor = m_scalefactor[i];
 
 
-    if (Verbosity())
+    if (Verbosity() && distortion_correction_object->m_hDPint[0])
     {
       for (const auto& h : {
                distortion_correction_object->m_hDPint[0], distortion_correction_object->m_hDPint[1],
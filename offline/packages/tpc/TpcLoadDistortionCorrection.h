@@ -75,6 +75,13 @@ class TpcLoadDistortionCorrection : public SubsysReco
     m_interpolate_z[i] = flag;
   }
 
+  //! write the binary cache (see PHGridFile) next to each correction file read from ROOT
+  /** later jobs use the cache automatically, without reading the histograms */
+  void set_write_cache(bool flag)
+  {
+    m_write_cache = flag;
+  }
+
   //! node name
   void set_node_name(const std::string& value)
   {
@@ -105,6 +112,9 @@ class TpcLoadDistortionCorrection : public SubsysReco
   //! z interpolation
   std::array<bool,nDistortionTypes> m_interpolate_z = {true,true,true,true};
 
+  //! write binary cache after reading histograms
+  bool m_write_cache = false;
+
   //! distortion object node name
   std::array<std::string,nDistortionTypes> m_node_name = {"TpcDistortionCorrectionContainerStatic", "TpcDistortionCorrectionContainerAverage", "TpcDistortionCorrectionContainerFluctuation","TpcDistortionCorrectionContainerModuleEdge"};
 };
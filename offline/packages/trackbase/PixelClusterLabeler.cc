@@ -0,0 +1,109 @@
+/**
+ * @file trackbase/PixelClusterLabeler.cc
+ * @brief Implementation of PixelClusterLabeler
+ */
+#include "PixelClusterLabeler.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+//_________________________________________________________________
+unsigned int PixelClusterLabeler::find(unsigned int i)
+{
+  // path halving
+  while (m_parent[i] != i)
+  {
+    m_parent[i] = m_parent[m_parent[i]];
+    i = m_parent[i];
+  }
+  return i;
+}
+
+//_________________________________________________________________
+void PixelClusterLabeler::merge(unsigned int i, unsigned int j)
+{
+  i = find(i);
+  j = find(j);
+  if (i == j)
+  {
+    return;
+  }
+
+  // keep the lowest index as root
+  if (j < i)
+  {
+    std::swap(i, j);
+  }
+  m_parent[j] = i;
+}
+
+//_________________________________________________________________
+unsigned int PixelClusterLabeler::run(std::span<const Cell> cells, int max_du, int max_dv)
+{
+  const unsigned int nhits = cells.size();
+
+  // sort hit indices by coordinates
+  m_sorted.resize(nhits);
+  std::iota(m_sorted.begin(), m_sorted.end(), 0);
+  std::sort(m_sorted.begin(), m_sorted.end(), [&cells](unsigned int lhs, unsigned int rhs)
+            { return cells[lhs] < cells[rhs]; });
+
+  m_parent.resize(nhits);
+  std::iota(m_parent.begin(), m_parent.end(), 0);
+
+  // merge each hit with its neighbors further down the sorted list
+  const auto less = [&cells](unsigned int index, const Cell& cell)
+  { return cells[index] < cell; };
+  for (unsigned int i = 0; i < nhits; ++i)
+  {
+    const auto& [u, v] = cells[m_sorted[i]];
+    for (int du = 0; du <= max_du; ++du)
+    {
+      // for the same first coordinate, only the hits after this one need to be checked
+      auto iter = du == 0 ? m_sorted.begin() + i + 1 : std::lower_bound(m_sorted.begin() + i + 1, m_sorted.end(), Cell(u + du, v - max_dv), less);
+      for (; iter != m_sorted.end(); ++iter)
+      {
+        const auto& cell = cells[*iter];
+        if (cell.first != u + du || cell.second > v + max_dv)
+        {
+          break;
+        }
+        if (cell.second >= v - max_dv)
+        {
+          merge(m_sorted[i], *iter);
+        }
+      }
+    }
+  }
+
+  // number clusters in order of their first hit
+  static constexpr unsigned int unassigned = std::numeric_limits<unsigned int>::max();
+  m_labels.assign(nhits, unassigned);
+  unsigned int nclusters = 0;
+  for (unsigned int i = 0; i < nhits; ++i)
+  {
+    const unsigned int root = find(i);
+    if (m_labels[root] == unassigned)
+    {
+      m_labels[root] = nclusters++;
+    }
+    m_labels[i] = m_labels[root];
+  }
+
+  // list hits per cluster, in input order
+  m_offsets.assign(nclusters + 1, 0);
+  for (const auto& label : m_labels)
+  {
+    ++m_offsets[label + 1];
+  }
+  std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+  m_members.resize(nhits);
+  m_sorted.assign(m_offsets.begin(), m_offsets.end() - 1);
+  for (unsigned int i = 0; i < nhits; ++i)
+  {
+    m_members[m_sorted[m_labels[i]]++] = i;
+  }
+
+  return nclusters;
+}
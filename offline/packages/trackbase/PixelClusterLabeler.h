@@ -0,0 +1,58 @@
+#ifndef TRACKBASE_PIXELCLUSTERLABELER_H
+#define TRACKBASE_PIXELCLUSTERLABELER_H
+
+/**
+ * @file trackbase/PixelClusterLabeler.h
+ * @brief Connected component labeling of hits on a 2D grid of pixels or strips
+ */
+
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * Groups hits into clusters of adjacent cells.
+ * Two hits are adjacent when their first coordinates differ by at most max_du
+ * and their second coordinates by at most max_dv.
+ * Hits are sorted by coordinates and merged with a union-find, in O(N log N),
+ * instead of testing all pairs.
+ *
+ * Cluster ids are assigned in order of the first hit of each cluster in the input,
+ * and hits are listed in input order within each cluster, which is the same
+ * numbering as boost::connected_components on the graph of adjacent hits.
+ *
+ * The labeler keeps its buffers between calls. It is not thread safe, use one per thread.
+ */
+class PixelClusterLabeler
+{
+ public:
+  //! hit coordinates on the grid
+  using Cell = std::pair<int, int>;
+
+  //! run the labeling, returns the number of clusters
+  unsigned int run(std::span<const Cell> cells, int max_du, int max_dv);
+
+  //! number of clusters from the last call
+  unsigned int nclusters() const { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+
+  //! input index of the hits in a given cluster, in input order
+  std::span<const unsigned int> cluster(unsigned int id) const
+  {
+    return std::span<const unsigned int>(m_members).subspan(m_offsets[id], m_offsets[id + 1] - m_offsets[id]);
+  }
+
+  //! cluster id of each input hit
+  const std::vector<unsigned int>& labels() const { return m_labels; }
+
+ private:
+  unsigned int find(unsigned int i);
+  void merge(unsigned int i, unsigned int j);
+
+  std::vector<unsigned int> m_sorted;
+  std::vector<unsigned int> m_parent;
+  std::vector<unsigned int> m_labels;
+  std::vector<unsigned int> m_offsets;
+  std::vector<unsigned int> m_members;
+};
+
+#endif
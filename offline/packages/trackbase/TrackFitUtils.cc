@@ -389,7 +389,7 @@ unsigned int TrackFitUtils::addClustersOnLine(TrackFitUtils::line_fit_output_t&
   }
   for (const auto& det : detectors)
   {
-    for (const auto& hitsetkey : clusterContainer->getHitSetKeys(det))
+    for (const auto& hitsetkey : clusterContainer->getHitSetKeyView(det))
     {
       if (TrkrDefs::getLayer(hitsetkey) < startLayer ||
           TrkrDefs::getLayer(hitsetkey) > endLayer)
@@ -397,13 +397,9 @@ unsigned int TrackFitUtils::addClustersOnLine(TrackFitUtils::line_fit_output_t&
         continue;
       }
 
-      auto range = clusterContainer->getClusters(hitsetkey);
-      for (auto clusIter = range.first; clusIter != range.second; ++clusIter)
+      // read only access, these helpers may run concurrently on the same container
+      for (const auto& [cluskey, cluster] : clusterContainer->getHitSetClusters(hitsetkey))
       {
-        TrkrDefs::cluskey const cluskey = clusIter->first;
-
-        TrkrCluster* cluster = clusIter->second;
-
         auto global = tGeometry->getGlobalPosition(cluskey, cluster);
         float x, y;
         if (isXY)
@@ -511,7 +507,7 @@ unsigned int TrackFitUtils::addClusters(std::vector<float>& fitpars,
 
   for (const auto& det : detectors)
   {
-    for (const auto& hitsetkey : _cluster_map->getHitSetKeys(det))
+    for (const auto& hitsetkey : _cluster_map->getHitSetKeyView(det))
     {
       if (TrkrDefs::getLayer(hitsetkey) < startLayer ||
           TrkrDefs::getLayer(hitsetkey) > endLayer)
@@ -519,13 +515,9 @@ unsigned int TrackFitUtils::addClusters(std::vector<float>& fitpars,
         continue;
       }
 
-      auto range = _cluster_map->getClusters(hitsetkey);
-      for (auto clusIter = range.first; clusIter != range.second; ++clusIter)
+      // read only access, these helpers may run concurrently on the same container
+      for (const auto& [cluskey, cluster] : _cluster_map->getHitSetClusters(hitsetkey))
       {
-        TrkrDefs::cluskey const cluskey = clusIter->first;
-
-        TrkrCluster* cluster = clusIter->second;
-
         auto global = _tGeometry->getGlobalPosition(cluskey, cluster);
 
         Acts::Vector3 pca = get_helix_pca(fitpars, global);
@@ -8,7 +8,7 @@
 namespace
 {
   TrkrClusterContainer::Map dummy_map;
-}
+}  // namespace
 
 //__________________________________________________________
 TrkrClusterContainer::ConstRange TrkrClusterContainer::getClusters() const
@@ -21,3 +21,28 @@ TrkrClusterContainer::ConstRange TrkrClusterContainer::getClusters(TrkrDefs::hit
 {
   return std::make_pair(dummy_map.cbegin(), dummy_map.cend());
 }
+
+//__________________________________________________________
+TrkrClusterContainer::HitSetClusterRange TrkrClusterContainer::getHitSetClusters(TrkrDefs::hitsetkey /*hitsetkey*/) const
+{
+  std::cout << "TrkrClusterContainer::getHitSetClusters - not implemented for " << ClassName() << std::endl;
+  return HitSetClusterRange();
+}
+
+//__________________________________________________________
+TrkrClusterContainer::HitSetKeyView TrkrClusterContainer::getHitSetKeyView() const
+{
+  return HitSetKeyView(getHitSetKeys());
+}
+
+//__________________________________________________________
+TrkrClusterContainer::HitSetKeyView TrkrClusterContainer::getHitSetKeyView(const TrkrDefs::TrkrId trackerid) const
+{
+  return HitSetKeyView(getHitSetKeys(trackerid));
+}
+
+//__________________________________________________________
+TrkrClusterContainer::HitSetKeyView TrkrClusterContainer::getHitSetKeyView(const TrkrDefs::TrkrId trackerid, const uint8_t layer) const
+{
+  return HitSetKeyView(getHitSetKeys(trackerid, layer));
+}
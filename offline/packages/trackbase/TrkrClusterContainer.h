@@ -14,7 +14,9 @@
 
 #include <iostream>  // for cout, ostream
 #include <map>
+#include <span>
 #include <utility>  // for pair
+#include <vector>
 
 class TrkrCluster;
 
@@ -34,6 +36,135 @@ class TrkrClusterContainer : public PHObject
 
   using HitSetKeyList = std::vector<TrkrDefs::hitsetkey>;
 
+  //! sorted hitset keys, either a view on the container storage or an owned copy
+  class HitSetKeyView
+  {
+   public:
+    using Span = std::span<const TrkrDefs::hitsetkey>;
+
+    HitSetKeyView() = default;
+
+    //! view on keys owned by the container
+    HitSetKeyView(Span keys)
+      : m_keys(keys)
+    {
+    }
+
+    //! view on keys owned by the container
+    template <class It>
+    HitSetKeyView(It begin, It end)
+      : m_keys(begin, end)
+    {
+    }
+
+    //! owned copy of the keys
+    explicit HitSetKeyView(HitSetKeyList&& keys)
+      : m_owned(std::move(keys))
+      , m_keys(m_owned)
+      , m_owning(true)
+    {
+    }
+
+    // the span must follow the owned keys
+    HitSetKeyView(const HitSetKeyView& other)
+      : m_owned(other.m_owned)
+      , m_keys(other.m_owning ? Span(m_owned) : other.m_keys)
+      , m_owning(other.m_owning)
+    {
+    }
+
+    HitSetKeyView(HitSetKeyView&& other) noexcept
+      : m_owned(std::move(other.m_owned))
+      , m_keys(other.m_owning ? Span(m_owned) : other.m_keys)
+      , m_owning(other.m_owning)
+    {
+    }
+
+    HitSetKeyView& operator=(HitSetKeyView other) noexcept
+    {
+      m_owned = std::move(other.m_owned);
+      m_owning = other.m_owning;
+      m_keys = m_owning ? Span(m_owned) : other.m_keys;
+      return *this;
+    }
+
+    ~HitSetKeyView() = default;
+
+    Span::iterator begin() const { return m_keys.begin(); }
+    Span::iterator end() const { return m_keys.end(); }
+    size_t size() const { return m_keys.size(); }
+    bool empty() const { return m_keys.empty(); }
+    const TrkrDefs::hitsetkey& operator[](size_t i) const { return m_keys[i]; }
+
+   private:
+    HitSetKeyList m_owned;
+    Span m_keys;
+    bool m_owning = false;
+  };
+
+  //! clusters of a given hitset, read from the container storage without copy
+  /** dereferencing an iterator gives a (cluster key, cluster) pair, empty slots are skipped */
+  class HitSetClusterRange
+  {
+   public:
+    using Span = std::span<TrkrCluster* const>;
+
+    class ConstIterator
+    {
+     public:
+      ConstIterator(TrkrDefs::hitsetkey hitsetkey, Span clusters, size_t index)
+        : m_hitsetkey(hitsetkey)
+        , m_clusters(clusters)
+        , m_index(index)
+      {
+        skip();
+      }
+
+      std::pair<TrkrDefs::cluskey, TrkrCluster*> operator*() const
+      {
+        return std::make_pair(TrkrDefs::genClusKey(m_hitsetkey, m_index), m_clusters[m_index]);
+      }
+
+      ConstIterator& operator++()
+      {
+        ++m_index;
+        skip();
+        return *this;
+      }
+
+      bool operator==(const ConstIterator& other) const { return m_index == other.m_index; }
+      bool operator!=(const ConstIterator& other) const { return m_index != other.m_index; }
+
+     private:
+      void skip()
+      {
+        while (m_index < m_clusters.size() && !m_clusters[m_index])
+        {
+          ++m_index;
+        }
+      }
+
+      TrkrDefs::hitsetkey m_hitsetkey = 0;
+      Span m_clusters;
+      size_t m_index = 0;
+    };
+
+    HitSetClusterRange() = default;
+
+    HitSetClusterRange(TrkrDefs::hitsetkey hitsetkey, Span clusters)
+      : m_hitsetkey(hitsetkey)
+      , m_clusters(clusters)
+    {
+    }
+
+    ConstIterator begin() const { return ConstIterator(m_hitsetkey, m_clusters, 0); }
+    ConstIterator end() const { return ConstIterator(m_hitsetkey, m_clusters, m_clusters.size()); }
+
+   private:
+    TrkrDefs::hitsetkey m_hitsetkey = 0;
+    Span m_clusters;
+  };
+
   //@}
 
   //! reset method
@@ -58,6 +189,14 @@ class TrkrClusterContainer : public PHObject
   //! get all clusters matching hitset
   virtual ConstRange getClusters(TrkrDefs::hitsetkey);
 
+  //! get all clusters matching hitset, without modifying the container
+  /**
+   * unlike getClusters(hitsetkey) it can be called concurrently.
+   * The range is valid until the container is modified.
+   * Only provided by containers storing one cluster vector per hitset (v4 and later)
+   */
+  virtual HitSetClusterRange getHitSetClusters(TrkrDefs::hitsetkey) const;
+
   //! find cluster matching given key
   virtual TrkrCluster* findCluster(TrkrDefs::cluskey) const { return nullptr; }
 
@@ -79,6 +218,17 @@ class TrkrClusterContainer : public PHObject
     return HitSetKeyList();
   }
 
+  //!@name sorted hitset keys without copy
+  /**
+   * the view is valid until the container is modified.
+   * The default implementation returns a copy of getHitSetKeys() owned by the view
+   */
+  //@{
+  virtual HitSetKeyView getHitSetKeyView() const;
+  virtual HitSetKeyView getHitSetKeyView(const TrkrDefs::TrkrId) const;
+  virtual HitSetKeyView getHitSetKeyView(const TrkrDefs::TrkrId, const uint8_t /* layer */) const;
+  //@}
+
   //! total number of clusters
   virtual unsigned int size() const { return 0; }
 
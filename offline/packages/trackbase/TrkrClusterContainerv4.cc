@@ -192,6 +192,18 @@ TrkrClusterContainerv4::getClusters(TrkrDefs::hitsetkey hitsetkey)
   return std::make_pair(m_tmpmap.cbegin(), m_tmpmap.cend());
 }
 
+//_________________________________________________________________
+TrkrClusterContainerv4::HitSetClusterRange
+TrkrClusterContainerv4::getHitSetClusters(TrkrDefs::hitsetkey hitsetkey) const
+{
+  const auto iter = m_clusmap.find(hitsetkey);
+  if (iter == m_clusmap.end())
+  {
+    return HitSetClusterRange();
+  }
+  return HitSetClusterRange(hitsetkey, iter->second);
+}
+
 //_________________________________________________________________
 TrkrCluster* TrkrClusterContainerv4::findCluster(TrkrDefs::cluskey key) const
 {
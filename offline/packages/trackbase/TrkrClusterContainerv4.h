@@ -42,6 +42,8 @@ class TrkrClusterContainerv4 : public TrkrClusterContainer
 
   ConstRange getClusters(TrkrDefs::hitsetkey) override;
 
+  HitSetClusterRange getHitSetClusters(TrkrDefs::hitsetkey) const override;
+
   TrkrCluster* findCluster(TrkrDefs::cluskey) const override;
 
   HitSetKeyList getHitSetKeys() const override;
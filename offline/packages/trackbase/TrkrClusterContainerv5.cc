@@ -0,0 +1,405 @@
+/**
+ * @file trackbase/TrkrClusterContainerv5.cc
+ * @brief Implementation of TrkrClusterContainerv5
+ */
+#include "TrkrClusterContainerv5.h"
+#include "TrkrCluster.h"
+#include "TrkrDefs.h"
+
+#include <TBuffer.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+  TrkrClusterContainer::Map dummy_map;
+
+  // the upper 16 bits of the hitsetkey (tracker id and layer) define the block
+  inline unsigned int get_block(const TrkrDefs::hitsetkey key)
+  {
+    return key >> 16U;
+  }
+}  // namespace
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::Reset()
+{
+  // delete all clusters, keep the emptied vectors for the next event
+  for (auto& clus_vector : m_clusters)
+  {
+    for (auto&& cluster : clus_vector)
+    {
+      delete cluster;
+    }
+    clus_vector.clear();
+    m_spare.push_back(std::move(clus_vector));
+  }
+  m_clusters.clear();
+  m_hitsetkeys.clear();
+  m_index.clear();
+  m_nclusters = 0;
+  m_sortedkeys.clear();
+  m_blockoffsets.assign(kNBlocks + 1, 0);
+
+  // also clear temporary map
+  {
+    Map empty;
+    m_tmpmap.swap(empty);
+  }
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::identify(std::ostream& os) const
+{
+  os << "-----TrkrClusterContainerv5-----" << std::endl;
+  os << "Number of clusters: " << size() << std::endl;
+
+  for (const auto& hitsetkey : m_sortedkeys)
+  {
+    const unsigned int layer = TrkrDefs::getLayer(hitsetkey);
+    os << "layer: " << layer << " hitsetkey: " << hitsetkey << std::endl;
+
+    for (const auto& cluster : m_clusters[findHitSet(hitsetkey)])
+    {
+      if (cluster)
+      {
+        cluster->identify(os);
+      }
+    }
+  }
+
+  os << "------------------------------" << std::endl;
+}
+
+//_________________________________________________________________
+int TrkrClusterContainerv5::findHitSet(TrkrDefs::hitsetkey hitsetkey) const
+{
+  const auto iter = m_index.find(hitsetkey);
+  if (iter == m_index.end())
+  {
+    return -1;
+  }
+  return iter->second;
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::rebuildIndex()
+{
+  // after reading back from the DST only the persistent vectors are filled
+  m_index.clear();
+  m_nclusters = 0;
+  for (unsigned int i = 0; i < m_hitsetkeys.size(); ++i)
+  {
+    m_index.emplace(m_hitsetkeys[i], i);
+    m_nclusters += std::count_if(m_clusters[i].begin(), m_clusters[i].end(), [](TrkrCluster* cluster)
+                                 { return cluster; });
+  }
+
+  m_sortedkeys = m_hitsetkeys;
+  std::sort(m_sortedkeys.begin(), m_sortedkeys.end());
+
+  // m_blockoffsets[block] is the first position in m_sortedkeys with a block >= block
+  for (unsigned int block = 0; block <= kNBlocks; ++block)
+  {
+    m_blockoffsets[block] = std::lower_bound(m_sortedkeys.begin(), m_sortedkeys.end(), block << 16U) - m_sortedkeys.begin();
+  }
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::insertSortedKey(const TrkrDefs::hitsetkey hitsetkey)
+{
+  m_sortedkeys.insert(std::lower_bound(m_sortedkeys.begin(), m_sortedkeys.end(), hitsetkey), hitsetkey);
+  for (unsigned int block = get_block(hitsetkey) + 1; block <= kNBlocks; ++block)
+  {
+    ++m_blockoffsets[block];
+  }
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::eraseSortedKey(const TrkrDefs::hitsetkey hitsetkey)
+{
+  const auto iter = std::lower_bound(m_sortedkeys.begin(), m_sortedkeys.end(), hitsetkey);
+  if (iter == m_sortedkeys.end() || *iter != hitsetkey)
+  {
+    return;
+  }
+  m_sortedkeys.erase(iter);
+  for (unsigned int block = get_block(hitsetkey) + 1; block <= kNBlocks; ++block)
+  {
+    --m_blockoffsets[block];
+  }
+}
+
+//_________________________________________________________________
+TrkrClusterContainer::HitSetKeyView TrkrClusterContainerv5::keyRange(const TrkrDefs::hitsetkey keylo, const TrkrDefs::hitsetkey keyhi) const
+{
+  // block aligned ranges come straight from the offset table
+  const unsigned int blocklo = get_block(keylo);
+  const unsigned int blockhi = get_block(keyhi) + 1;
+  if (blockhi <= kNBlocks)
+  {
+    return HitSetKeyView(m_sortedkeys.begin() + m_blockoffsets[blocklo], m_sortedkeys.begin() + m_blockoffsets[blockhi]);
+  }
+  const auto begin = std::lower_bound(m_sortedkeys.begin(), m_sortedkeys.end(), keylo);
+  const auto end = std::upper_bound(begin, m_sortedkeys.end(), keyhi);
+  return HitSetKeyView(begin, end);
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::removeCluster(TrkrDefs::cluskey key)
+{
+  // find relevant cluster vector if any and remove corresponding cluster
+  const int pos = findHitSet(TrkrDefs::getHitSetKeyFromClusKey(key));
+  if (pos < 0)
+  {
+    return;
+  }
+  auto& clus_vector = m_clusters[pos];
+  const auto index = TrkrDefs::getClusIndex(key);
+  if (index < clus_vector.size() && clus_vector[index])
+  {
+    // delete corresponding element and set to null
+    delete clus_vector[index];
+    clus_vector[index] = nullptr;
+    --m_nclusters;
+  }
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::removeClusters(TrkrDefs::hitsetkey hitsetkey)
+{
+  const int pos = findHitSet(hitsetkey);
+
+  // do nothing if not found
+  if (pos < 0)
+  {
+    return;
+  }
+
+  // delete all clusters
+  auto& clus_vector = m_clusters[pos];
+  for (auto&& cluster : clus_vector)
+  {
+    if (cluster)
+    {
+      delete cluster;
+      --m_nclusters;
+    }
+  }
+  clus_vector.clear();
+  m_spare.push_back(std::move(clus_vector));
+
+  // move the last entry into the free slot
+  const unsigned int last = m_hitsetkeys.size() - 1;
+  if (static_cast<unsigned int>(pos) != last)
+  {
+    m_hitsetkeys[pos] = m_hitsetkeys[last];
+    m_clusters[pos] = std::move(m_clusters[last]);
+    m_index[m_hitsetkeys[pos]] = pos;
+  }
+  m_hitsetkeys.pop_back();
+  m_clusters.pop_back();
+  m_index.erase(hitsetkey);
+  eraseSortedKey(hitsetkey);
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::addClusterSpecifyKey(const TrkrDefs::cluskey key, TrkrCluster* newclus)
+{
+  // get hitsetkey from cluster
+  const TrkrDefs::hitsetkey hitsetkey = TrkrDefs::getHitSetKeyFromClusKey(key);
+
+  // find relevant vector or create one if not found
+  int pos = findHitSet(hitsetkey);
+  if (pos < 0)
+  {
+    pos = m_hitsetkeys.size();
+    m_hitsetkeys.push_back(hitsetkey);
+    if (m_spare.empty())
+    {
+      m_clusters.emplace_back();
+    }
+    else
+    {
+      m_clusters.push_back(std::move(m_spare.back()));
+      m_spare.pop_back();
+    }
+    m_index.emplace(hitsetkey, pos);
+    insertSortedKey(hitsetkey);
+  }
+  auto& clus_vector = m_clusters[pos];
+
+  // get cluster index in vector
+  const auto index = TrkrDefs::getClusIndex(key);
+
+  // compare index to vector size
+  if (index < clus_vector.size())
+  {
+    /*
+     * if index is already contained in vector, check corresponding element
+     * and assign newclus if null
+     * print error message and exit otherwise
+     */
+    if (!clus_vector[index])
+    {
+      clus_vector[index] = newclus;
+    }
+    else
+    {
+      std::cout << "TrkrClusterContainerv5::AddClusterSpecifyKey: duplicate key: " << key << " exiting now" << std::endl;
+      exit(1);
+    }
+  }
+  else if (index == clus_vector.size())
+  {
+    // if index matches the vector size, just push back the new cluster
+    clus_vector.push_back(newclus);
+  }
+  else
+  {
+    // if index exceeds the vector size, resize cluster to the right size with nullptr, and assign
+    clus_vector.resize(index + 1, nullptr);
+    clus_vector[index] = newclus;
+  }
+  if (newclus)
+  {
+    ++m_nclusters;
+  }
+}
+
+TrkrClusterContainerv5::ConstRange
+TrkrClusterContainerv5::getClusters() const
+{
+  std::cout << "deprecated function in TrkrClusterContainerv5, user getClusters(TrkrDefs:hitsetkey)"
+            << std::endl;
+  return std::make_pair(dummy_map.begin(), dummy_map.begin());
+}
+
+//_________________________________________________________________
+TrkrClusterContainerv5::ConstRange
+TrkrClusterContainerv5::getClusters(TrkrDefs::hitsetkey hitsetkey)
+{
+  // clear temporary map
+  {
+    Map empty;
+    m_tmpmap.swap(empty);
+  }
+
+  // find relevant vector
+  const int pos = findHitSet(hitsetkey);
+  if (pos >= 0)
+  {
+    // copy content in temporary map
+    const auto& clusters = m_clusters[pos];
+    for (size_t index = 0; index < clusters.size(); ++index)
+    {
+      const auto& cluster = clusters[index];
+      if (cluster)
+      {
+        // generate cluster key from hitset and index
+        const auto ckey = TrkrDefs::genClusKey(hitsetkey, index);
+
+        // insert in map
+        m_tmpmap.insert(m_tmpmap.end(), std::make_pair(ckey, cluster));
+      }
+    }
+  }
+
+  // return temporary map range
+  return std::make_pair(m_tmpmap.cbegin(), m_tmpmap.cend());
+}
+
+//_________________________________________________________________
+TrkrClusterContainerv5::HitSetClusterRange
+TrkrClusterContainerv5::getHitSetClusters(TrkrDefs::hitsetkey hitsetkey) const
+{
+  const int pos = findHitSet(hitsetkey);
+  if (pos < 0)
+  {
+    return HitSetClusterRange();
+  }
+  return HitSetClusterRange(hitsetkey, m_clusters[pos]);
+}
+
+//_________________________________________________________________
+TrkrCluster* TrkrClusterContainerv5::findCluster(TrkrDefs::cluskey key) const
+{
+  const int pos = findHitSet(TrkrDefs::getHitSetKeyFromClusKey(key));
+  if (pos < 0)
+  {
+    return nullptr;
+  }
+
+  // local reference to vector
+  const auto& clus_vector = m_clusters[pos];
+
+  // get cluster position in vector
+  const auto index = TrkrDefs::getClusIndex(key);
+  if (index < clus_vector.size())
+  {
+    return clus_vector[index];
+  }
+  return nullptr;
+}
+
+//_________________________________________________________________
+TrkrClusterContainer::HitSetKeyList TrkrClusterContainerv5::getHitSetKeys() const
+{
+  return m_sortedkeys;
+}
+
+//_________________________________________________________________
+TrkrClusterContainer::HitSetKeyList TrkrClusterContainerv5::getHitSetKeys(const TrkrDefs::TrkrId trackerid) const
+{
+  const auto keys = keyRange(TrkrDefs::getHitSetKeyLo(trackerid), TrkrDefs::getHitSetKeyHi(trackerid));
+  return HitSetKeyList(keys.begin(), keys.end());
+}
+
+//_________________________________________________________________
+TrkrClusterContainer::HitSetKeyList TrkrClusterContainerv5::getHitSetKeys(const TrkrDefs::TrkrId trackerid, const uint8_t layer) const
+{
+  const auto keys = keyRange(TrkrDefs::getHitSetKeyLo(trackerid, layer), TrkrDefs::getHitSetKeyHi(trackerid, layer));
+  return HitSetKeyList(keys.begin(), keys.end());
+}
+
+//_________________________________________________________________
+TrkrClusterContainer::HitSetKeyView TrkrClusterContainerv5::getHitSetKeyView() const
+{
+  return HitSetKeyView(m_sortedkeys.cbegin(), m_sortedkeys.cend());
+}
+
+//_________________________________________________________________
+TrkrClusterContainer::HitSetKeyView TrkrClusterContainerv5::getHitSetKeyView(const TrkrDefs::TrkrId trackerid) const
+{
+  return keyRange(TrkrDefs::getHitSetKeyLo(trackerid), TrkrDefs::getHitSetKeyHi(trackerid));
+}
+
+//_________________________________________________________________
+TrkrClusterContainer::HitSetKeyView TrkrClusterContainerv5::getHitSetKeyView(const TrkrDefs::TrkrId trackerid, const uint8_t layer) const
+{
+  return keyRange(TrkrDefs::getHitSetKeyLo(trackerid, layer), TrkrDefs::getHitSetKeyHi(trackerid, layer));
+}
+
+//_________________________________________________________________
+unsigned int TrkrClusterContainerv5::size() const
+{
+  return m_nclusters;
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::Streamer(TBuffer& R__b)
+{
+  if (R__b.IsReading())
+  {
+    // the index is rebuilt from the persistent vectors right away,
+    // so that const access does not need to modify the container
+    Reset();
+    R__b.ReadClassBuffer(TrkrClusterContainerv5::Class(), this);
+    rebuildIndex();
+  }
+  else
+  {
+    R__b.WriteClassBuffer(TrkrClusterContainerv5::Class(), this);
+  }
+}
@@ -0,0 +1,129 @@
+#ifndef TRACKBASE_TRKRCLUSTERCONTAINERV5_H
+#define TRACKBASE_TRKRCLUSTERCONTAINERV5_H
+
+/**
+ * @file trackbase/TrkrClusterContainerv5.h
+ * @brief Cluster container with hashed hitset index
+ */
+
+#include "TrkrClusterContainer.h"
+
+#include <phool/PHObject.h>
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+class TrkrCluster;
+
+/**
+ * @brief Cluster container object
+ *
+ * Same content as TrkrClusterContainerv4 (one vector of clusters per hitset,
+ * indexed by the cluster index) but the per hitset vectors are stored contiguously
+ * and are found through a hash table, so findCluster does not need a tree lookup.
+ * The sorted hitset key list is cached together with the offsets of every
+ * (detector, layer) block in it, getHitSetKeys(det, layer) only copies that block
+ * and getHitSetKeyView(det, layer) returns it without copy.
+ * The cluster vectors keep their capacity across events.
+ * The index and key list are kept up to date by the modifying methods and rebuilt
+ * when reading back from the DST, so const accessors never modify the container
+ * and can be called concurrently.
+ */
+class TrkrClusterContainerv5 : public TrkrClusterContainer
+{
+ public:
+  TrkrClusterContainerv5() = default;
+
+  ~TrkrClusterContainerv5() override
+  {
+    TrkrClusterContainerv5::Reset();
+  }
+
+  // TrkrClusterContainerv5 contains pointers to memory
+  // copy ctor and = operator need explicit implementation, do just delete it here
+  TrkrClusterContainerv5(const TrkrClusterContainerv5&) = delete;
+  TrkrClusterContainerv5& operator=(const TrkrClusterContainerv5&) = delete;
+
+  /**
+   * delete and remove all stored clusters
+   * effectively leaving the container empty
+   */
+  void Reset() override;
+
+  void identify(std::ostream& os = std::cout) const override;
+
+  void addClusterSpecifyKey(const TrkrDefs::cluskey, TrkrCluster*) override;
+
+  //! remove cluster matching a given cluster key
+  void removeCluster(TrkrDefs::cluskey) override;
+
+  //! delete and remove all the clusters matching a given key
+  void removeClusters(TrkrDefs::hitsetkey) override;
+
+  ConstRange getClusters() const override;  // deprecated
+
+  ConstRange getClusters(TrkrDefs::hitsetkey) override;
+
+  HitSetClusterRange getHitSetClusters(TrkrDefs::hitsetkey) const override;
+
+  TrkrCluster* findCluster(TrkrDefs::cluskey) const override;
+
+  HitSetKeyList getHitSetKeys() const override;
+
+  HitSetKeyList getHitSetKeys(const TrkrDefs::TrkrId) const override;
+
+  HitSetKeyList getHitSetKeys(const TrkrDefs::TrkrId, const uint8_t /* layer */) const override;
+
+  HitSetKeyView getHitSetKeyView() const override;
+
+  HitSetKeyView getHitSetKeyView(const TrkrDefs::TrkrId) const override;
+
+  HitSetKeyView getHitSetKeyView(const TrkrDefs::TrkrId, const uint8_t /* layer */) const override;
+
+  unsigned int size(void) const override;
+
+ private:
+  /// convenient alias
+  using Vector = std::vector<TrkrCluster*>;
+
+  //! number of (detector, layer) blocks in the dense offset table
+  static constexpr unsigned int kNBlocks = 4 * 256;
+
+  //! position of the hitset in m_hitsetkeys/m_clusters, -1 if not found
+  int findHitSet(TrkrDefs::hitsetkey) const;
+
+  //! rebuild the hash table, cluster count and sorted key list after reading back from the DST
+  void rebuildIndex();
+
+  //! add or remove a hitset key from the sorted key list and shift the block offsets
+  void insertSortedKey(const TrkrDefs::hitsetkey);
+  void eraseSortedKey(const TrkrDefs::hitsetkey);
+
+  //! keys between keylo and keyhi in the sorted list
+  HitSetKeyView keyRange(const TrkrDefs::hitsetkey keylo, const TrkrDefs::hitsetkey keyhi) const;
+
+  /// hitset keys and matching cluster vectors
+  std::vector<TrkrDefs::hitsetkey> m_hitsetkeys;
+  std::vector<Vector> m_clusters;
+
+  /// hitset key to position in m_hitsetkeys
+  std::unordered_map<TrkrDefs::hitsetkey, unsigned int> m_index;  //!
+
+  /// number of clusters (non null entries)
+  unsigned int m_nclusters = 0;  //!
+
+  /// sorted hitset keys and first position of each (detector, layer) block in it
+  HitSetKeyList m_sortedkeys;  //!
+  std::vector<unsigned int> m_blockoffsets = std::vector<unsigned int>(kNBlocks + 1, 0);  //!
+
+  /// cleared cluster vectors from previous events, reused to avoid reallocation
+  std::vector<Vector> m_spare;  //!
+
+  /// temporary map for getClusters(hitsetkey), use getHitSetClusters(hitsetkey) from concurrent code
+  Map m_tmpmap;  //!
+
+  ClassDefOverride(TrkrClusterContainerv5, 1)
+};
+
+#endif  // TRACKBASE_TRKRCLUSTERCONTAINERV5_H
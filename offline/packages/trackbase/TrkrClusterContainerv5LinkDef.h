@@ -0,0 +1,6 @@
+#ifdef __CINT__
+
+// custom Streamer, see TrkrClusterContainerv5::Streamer
+#pragma link C++ class TrkrClusterContainerv5 - ;
+
+#endif
@@ -5,6 +5,7 @@
  * @brief Implementation of TrkrHitSet
  */
 #include "TrkrHitSet.h"
+#include "TrkrHitv2.h"
 
 namespace
 {
@@ -17,6 +18,18 @@ TrkrHitSet::addHitSpecificKey(const TrkrDefs::hitkey /*unused*/, TrkrHit* /*unus
   return dummy_map.cbegin();
 }
 
+TrkrHit*
+TrkrHitSet::findOrAddHit(const TrkrDefs::hitkey key)
+{
+  TrkrHit* hit = getHit(key);
+  if (!hit)
+  {
+    hit = new TrkrHitv2;
+    addHitSpecificKey(key, hit);
+  }
+  return hit;
+}
+
 TrkrHitSet::ConstRange
 TrkrHitSet::getHits() const
 {
@@ -70,6 +70,16 @@ class TrkrHitSet : public PHObject
    */
   virtual ConstIterator addHitSpecificKey(const TrkrDefs::hitkey, TrkrHit*);
 
+  /**
+   * @brief Get the hit with this key, create it if it does not exist yet
+   * @param[in] key Hit key
+   * @param[out] Pointer to the hit, owned by this TrkrHitSet
+   *
+   * Replaces the getHit(), new TrkrHitv2, addHitSpecificKey() sequence.
+   * Implementations with pooled hit storage avoid the allocation.
+   */
+  virtual TrkrHit* findOrAddHit(const TrkrDefs::hitkey);
+
   /**
    * @brief Remove a hit using its key
    * @param[in] key to be removed
@@ -0,0 +1,272 @@
+/**
+ * @file trackbase/TrkrHitSetContainerv3.cc
+ * @brief Implementation for TrkrHitSetContainerv3
+ */
+#include "TrkrHitSetContainerv3.h"
+
+#include "TrkrDefs.h"
+#include "TrkrHit.h"
+#include "TrkrHitSetv2.h"
+
+#include <TBuffer.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <utility>  // for move
+
+TrkrHitSetContainerv3::~TrkrHitSetContainerv3()
+{
+  TrkrHitSetContainerv3::Reset();
+  for (auto* hitset : m_hitsetPool)
+  {
+    delete hitset;
+  }
+}
+
+void TrkrHitSetContainerv3::Reset()
+{
+  for (size_t i = 0; i < m_nPoolUsed; ++i)
+  {
+    m_hitsetPool[i]->Reset();
+  }
+  m_nPoolUsed = 0;
+
+  for (auto* hitset : m_adoptedHitSets)
+  {
+    delete hitset;
+  }
+  m_adoptedHitSets.clear();
+
+  // keep the map nodes for the next event
+  while (!m_hitmap.empty())
+  {
+    m_nodePool.push_back(m_hitmap.extract(m_hitmap.begin()));
+  }
+
+  // clear() keeps the capacity for the next event
+  m_hitsetkeys.clear();
+  m_nhits.clear();
+  m_hitkeys.clear();
+  m_adcs.clear();
+  m_packed = false;
+}
+
+void TrkrHitSetContainerv3::identify(std::ostream& os) const
+{
+  os << "TrkrHitSetContainerv3: Number of hitsets: " << size()
+     << " hitset pool size: " << m_hitsetPool.size() << std::endl;
+  for (const auto& pair : m_hitmap)
+  {
+    int layer = TrkrDefs::getLayer(pair.first);
+    os << "hitsetkey " << pair.first << " layer " << layer << std::endl;
+    pair.second->identify();
+  }
+  return;
+}
+
+PHObject* TrkrHitSetContainerv3::CloneMe() const
+{
+  auto* copy = new TrkrHitSetContainerv3;
+  pack(*copy);
+  copy->m_packed = true;
+  return copy;
+}
+
+TrkrHitSetContainerv3::ConstIterator
+TrkrHitSetContainerv3::addHitSet(TrkrHitSet* newhit)
+{
+  return addHitSetSpecifyKey(newhit->getHitSetKey(), newhit);
+}
+
+TrkrHitSetContainerv3::ConstIterator
+TrkrHitSetContainerv3::addHitSetSpecifyKey(const TrkrDefs::hitsetkey key, TrkrHitSet* newhit)
+{
+  unpack();
+  const auto it = m_hitmap.lower_bound(key);
+  if (it != m_hitmap.end() && !(key < it->first))
+  {
+    std::cout << "TrkrHitSetContainerv3::AddHitSpecifyKey: duplicate key: " << key << " exiting now" << std::endl;
+    exit(1);
+  }
+  m_adoptedHitSets.push_back(newhit);
+  return insertHitSet(it, key, newhit);
+}
+
+void TrkrHitSetContainerv3::removeHitSet(TrkrDefs::hitsetkey key)
+{
+  unpack();
+  auto iter = m_hitmap.find(key);
+  if (iter == m_hitmap.end())
+  {
+    return;
+  }
+  TrkrHitSet* hitset = iter->second;
+  m_nodePool.push_back(m_hitmap.extract(iter));
+  auto adopted = std::find(m_adoptedHitSets.begin(), m_adoptedHitSets.end(), hitset);
+  if (adopted != m_adoptedHitSets.end())
+  {
+    m_adoptedHitSets.erase(adopted);
+    delete hitset;
+  }
+  else
+  {
+    // pooled hitsets stay in the pool until the next Reset()
+    hitset->Reset();
+  }
+}
+
+void TrkrHitSetContainerv3::removeHitSet(TrkrHitSet* hitset)
+{
+  removeHitSet(hitset->getHitSetKey());
+}
+
+TrkrHitSetContainerv3::ConstRange
+TrkrHitSetContainerv3::getHitSets(const TrkrDefs::TrkrId trackerid) const
+{
+  const TrkrDefs::hitsetkey keylo = TrkrDefs::getHitSetKeyLo(trackerid);
+  const TrkrDefs::hitsetkey keyhi = TrkrDefs::getHitSetKeyHi(trackerid);
+  return std::make_pair(m_hitmap.lower_bound(keylo), m_hitmap.upper_bound(keyhi));
+}
+
+TrkrHitSetContainerv3::ConstRange
+TrkrHitSetContainerv3::getHitSets(const TrkrDefs::TrkrId trackerid, const uint8_t layer) const
+{
+  TrkrDefs::hitsetkey keylo = TrkrDefs::getHitSetKeyLo(trackerid, layer);
+  TrkrDefs::hitsetkey keyhi = TrkrDefs::getHitSetKeyHi(trackerid, layer);
+  return std::make_pair(m_hitmap.lower_bound(keylo), m_hitmap.upper_bound(keyhi));
+}
+
+TrkrHitSetContainerv3::ConstRange
+TrkrHitSetContainerv3::getHitSets() const
+{
+  return std::make_pair(m_hitmap.cbegin(), m_hitmap.cend());
+}
+
+TrkrHitSetContainerv3::Iterator
+TrkrHitSetContainerv3::findOrAddHitSet(TrkrDefs::hitsetkey key)
+{
+  unpack();
+  auto it = m_hitmap.lower_bound(key);
+  if (it == m_hitmap.end() || (key < it->first))
+  {
+    TrkrHitSetv2* hitset = newPooledHitSet();
+    hitset->setHitSetKey(key);
+    it = insertHitSet(it, key, hitset);
+  }
+  return it;
+}
+
+TrkrHitSet*
+TrkrHitSetContainerv3::findHitSet(TrkrDefs::hitsetkey key)
+{
+  unpack();
+  auto it = m_hitmap.find(key);
+  if (it != m_hitmap.end())
+  {
+    return it->second;
+  }
+  return nullptr;
+}
+
+unsigned int TrkrHitSetContainerv3::size() const
+{
+  if (m_packed)
+  {
+    return m_hitsetkeys.size();
+  }
+  return m_hitmap.size();
+}
+
+TrkrHitSetContainerv3::Iterator
+TrkrHitSetContainerv3::insertHitSet(ConstIterator hint, const TrkrDefs::hitsetkey key, TrkrHitSet* hitset)
+{
+  if (m_nodePool.empty())
+  {
+    return m_hitmap.emplace_hint(hint, key, hitset);
+  }
+  Map::node_type node = std::move(m_nodePool.back());
+  m_nodePool.pop_back();
+  node.key() = key;
+  node.mapped() = hitset;
+  return m_hitmap.insert(hint, std::move(node));
+}
+
+TrkrHitSetv2* TrkrHitSetContainerv3::newPooledHitSet()
+{
+  if (m_nPoolUsed == m_hitsetPool.size())
+  {
+    m_hitsetPool.push_back(new TrkrHitSetv2);
+  }
+  return m_hitsetPool[m_nPoolUsed++];
+}
+
+void TrkrHitSetContainerv3::pack(TrkrHitSetContainerv3& target) const
+{
+  if (m_packed)
+  {
+    // nothing was unpacked, the arrays are still up to date
+    if (&target != this)
+    {
+      target.m_hitsetkeys = m_hitsetkeys;
+      target.m_nhits = m_nhits;
+      target.m_hitkeys = m_hitkeys;
+      target.m_adcs = m_adcs;
+    }
+    return;
+  }
+  target.m_hitsetkeys.clear();
+  target.m_nhits.clear();
+  target.m_hitkeys.clear();
+  target.m_adcs.clear();
+  // the maps are sorted, so are the arrays
+  for (const auto& [hitsetkey, hitset] : m_hitmap)
+  {
+    target.m_hitsetkeys.push_back(hitsetkey);
+    target.m_nhits.push_back(hitset->size());
+    TrkrHitSet::ConstRange hitrange = hitset->getHits();
+    for (auto hititer = hitrange.first; hititer != hitrange.second; ++hititer)
+    {
+      target.m_hitkeys.push_back(hititer->first);
+      target.m_adcs.push_back(std::min<unsigned int>(hititer->second->getAdc(), USHRT_MAX));
+    }
+  }
+}
+
+void TrkrHitSetContainerv3::unpack()
+{
+  if (!m_packed)
+  {
+    return;
+  }
+  m_packed = false;
+  size_t ihit = 0;
+  for (size_t i = 0; i < m_hitsetkeys.size(); ++i)
+  {
+    TrkrHitSetv2* hitset = newPooledHitSet();
+    hitset->setHitSetKey(m_hitsetkeys[i]);
+    for (unsigned int j = 0; j < m_nhits[i]; ++j, ++ihit)
+    {
+      hitset->appendHit(m_hitkeys[ihit], m_adcs[ihit]);
+    }
+    insertHitSet(m_hitmap.end(), m_hitsetkeys[i], hitset);
+  }
+}
+
+void TrkrHitSetContainerv3::Streamer(TBuffer& R__b)
+{
+  if (R__b.IsReading())
+  {
+    Reset();
+    R__b.ReadClassBuffer(TrkrHitSetContainerv3::Class(), this);
+
+    // create the hitsets right away, const accessors must not modify the container
+    m_packed = true;
+    unpack();
+  }
+  else
+  {
+    pack(*this);
+    R__b.WriteClassBuffer(TrkrHitSetContainerv3::Class(), this);
+  }
+}
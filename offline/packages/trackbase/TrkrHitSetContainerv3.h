@@ -0,0 +1,103 @@
+#ifndef TRACKBASE_TrkrHitSetContainerv3_H
+#define TRACKBASE_TrkrHitSetContainerv3_H
+
+#include "TrkrDefs.h"
+#include "TrkrHitSetContainer.h"
+
+#include <cstddef>
+#include <iostream>  // for cout, ostream
+#include <map>
+#include <utility>  // for pair
+#include <vector>
+
+class PHObject;
+class TrkrHitSet;
+class TrkrHitSetv2;
+
+/**
+ * Container with flat hit storage.
+ * On the DST all hits are stored as sorted arrays (hitsetkey, number of hits per hitset,
+ * hitkey, adc) which keep their capacity across events. The TrkrHitSetv2 objects behind
+ * the TrkrHitSetContainer interface are pooled as well and reused after Reset().
+ * They are filled from the arrays at the end of the read Streamer, so that const access
+ * never modifies the container; the arrays are filled from the hitsets when the container
+ * is written out (custom Streamer).
+ * Only the adc of the hits is stored.
+ */
+class TrkrHitSetContainerv3 final : public TrkrHitSetContainer
+{
+ public:
+  TrkrHitSetContainerv3() = default;
+
+  ~TrkrHitSetContainerv3() override;
+
+  // TrkrHitSetContainerv3 contains pointers to memory
+  // copy ctor and = operator need explicit implementation, do just delete it here
+  TrkrHitSetContainerv3(const TrkrHitSetContainerv3&) = delete;
+  TrkrHitSetContainerv3& operator=(const TrkrHitSetContainerv3&) = delete;
+
+  void Reset() override;
+
+  void identify(std::ostream& = std::cout) const override;
+
+  //! copy of the flat storage, meant for writing out
+  /** the hitsets of the copy are only created by its first non-const access, until then the const accessors see no hitset */
+  PHObject* CloneMe() const override;
+
+  ConstIterator addHitSet(TrkrHitSet*) override;
+
+  ConstIterator addHitSetSpecifyKey(const TrkrDefs::hitsetkey, TrkrHitSet*) override;
+
+  void removeHitSet(TrkrDefs::hitsetkey) override;
+
+  void removeHitSet(TrkrHitSet*) override;
+
+  Iterator findOrAddHitSet(TrkrDefs::hitsetkey key) override;
+
+  ConstRange getHitSets(const TrkrDefs::TrkrId trackerid) const override;
+
+  ConstRange getHitSets(const TrkrDefs::TrkrId trackerid, const uint8_t layer) const override;
+
+  ConstRange getHitSets() const override;
+
+  TrkrHitSet* findHitSet(TrkrDefs::hitsetkey key) override;
+
+  unsigned int size() const override;
+
+ private:
+  //! fill the flat arrays of target from the hitsets
+  void pack(TrkrHitSetContainerv3& target) const;
+
+  //! create the hitsets from the flat arrays after reading back from the DST
+  void unpack();
+
+  TrkrHitSetv2* newPooledHitSet();
+
+  //! insert in the hitset map, reusing a recycled node if any
+  Iterator insertHitSet(ConstIterator hint, const TrkrDefs::hitsetkey, TrkrHitSet*);
+
+  //! flat storage, only valid for writing out or after reading back
+  std::vector<TrkrDefs::hitsetkey> m_hitsetkeys;
+  std::vector<unsigned int> m_nhits;
+  std::vector<TrkrDefs::hitkey> m_hitkeys;
+  std::vector<unsigned short> m_adcs;
+
+  //! arrays hold content which was not unpacked into hitsets yet
+  bool m_packed = false;  //!
+
+  Map m_hitmap;  //!
+
+  //! map nodes extracted from m_hitmap, reused by insertHitSet
+  std::vector<Map::node_type> m_nodePool;  //!
+
+  //! hitsets reused across events
+  std::vector<TrkrHitSetv2*> m_hitsetPool;  //!
+  size_t m_nPoolUsed = 0;  //!
+
+  //! hitsets handed over by addHitSetSpecifyKey(), deleted in Reset()
+  std::vector<TrkrHitSet*> m_adoptedHitSets;  //!
+
+  ClassDefOverride(TrkrHitSetContainerv3, 1)
+};
+
+#endif  // TRACKBASE_TrkrHitSetContainerv3_H
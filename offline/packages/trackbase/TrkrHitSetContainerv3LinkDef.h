@@ -0,0 +1,6 @@
+#ifdef __CINT__
+
+// custom Streamer, see TrkrHitSetContainerv3::Streamer
+#pragma link C++ class TrkrHitSetContainerv3 - ;
+
+#endif
@@ -0,0 +1,143 @@
+/**
+ * @file trackbase/TrkrHitSetv2.cc
+ * @brief Implementation of TrkrHitSetv2
+ */
+#include "TrkrHitSetv2.h"
+#include "TrkrHit.h"
+
+#include <cstdlib>  // for exit
+#include <iostream>
+#include <utility>  // for move
+
+void TrkrHitSetv2::Reset()
+{
+  m_hitSetKey = TrkrDefs::HITSETKEYMAX;
+
+  if (m_nAdoptedHits > 0)
+  {
+    for (auto&& [key, hit] : m_hits)
+    {
+      if (!dynamic_cast<PooledHit*>(hit))
+      {
+        delete hit;
+      }
+    }
+    m_nAdoptedHits = 0;
+  }
+
+  // keep the map nodes for the next event
+  while (!m_hits.empty())
+  {
+    m_nodePool.push_back(m_hits.extract(m_hits.begin()));
+  }
+  m_nPoolUsed = 0;
+}
+
+void TrkrHitSetv2::identify(std::ostream& os) const
+{
+  const unsigned int layer = TrkrDefs::getLayer(m_hitSetKey);
+  const unsigned int trkrid = TrkrDefs::getTrkrId(m_hitSetKey);
+  os
+      << "TrkrHitSetv2: "
+      << "       hitsetkey " << getHitSetKey()
+      << " TrkrId " << trkrid
+      << " layer " << layer
+      << " nhits: " << m_hits.size()
+      << " pool size: " << m_hitPool.size()
+      << std::endl;
+
+  for (const auto& entry : m_hits)
+  {
+    std::cout << " hitkey " << entry.first << std::endl;
+    (entry.second)->identify(os);
+  }
+}
+
+TrkrHitv2* TrkrHitSetv2::newPooledHit()
+{
+  if (m_nPoolUsed == m_hitPool.size())
+  {
+    m_hitPool.emplace_back();
+  }
+  TrkrHitv2* hit = &m_hitPool[m_nPoolUsed++];
+  hit->setAdc(0);
+  return hit;
+}
+
+TrkrHitSetv2::Map::iterator TrkrHitSetv2::insertHit(Map::const_iterator hint, const TrkrDefs::hitkey key, TrkrHit* hit)
+{
+  if (m_nodePool.empty())
+  {
+    return m_hits.emplace_hint(hint, key, hit);
+  }
+  Map::node_type node = std::move(m_nodePool.back());
+  m_nodePool.pop_back();
+  node.key() = key;
+  node.mapped() = hit;
+  return m_hits.insert(hint, std::move(node));
+}
+
+TrkrHitSetv2::ConstIterator
+TrkrHitSetv2::addHitSpecificKey(const TrkrDefs::hitkey key, TrkrHit* hit)
+{
+  const auto it = m_hits.lower_bound(key);
+  if (it != m_hits.end() && !(key < it->first))
+  {
+    std::cout << "TrkrHitSetv2::AddHitSpecificKey: duplicate key: " << key << " exiting now" << std::endl;
+    exit(1);
+  }
+  ++m_nAdoptedHits;
+  return insertHit(it, key, hit);
+}
+
+TrkrHit* TrkrHitSetv2::findOrAddHit(const TrkrDefs::hitkey key)
+{
+  auto it = m_hits.lower_bound(key);
+  if (it == m_hits.end() || key < it->first)
+  {
+    it = insertHit(it, key, newPooledHit());
+  }
+  return it->second;
+}
+
+void TrkrHitSetv2::appendHit(const TrkrDefs::hitkey key, const unsigned int adc)
+{
+  TrkrHitv2* hit = newPooledHit();
+  hit->setAdc(adc);
+  insertHit(m_hits.end(), key, hit);
+}
+
+void TrkrHitSetv2::removeHit(TrkrDefs::hitkey key)
+{
+  const auto it = m_hits.find(key);
+  if (it == m_hits.end())
+  {
+    identify();
+    std::cout << "TrkrHitSetv2::removeHit: deleting a nonexist key: " << key << " exiting now" << std::endl;
+    exit(1);
+  }
+  // pooled hits stay in the pool until the next Reset()
+  if (!dynamic_cast<PooledHit*>(it->second))
+  {
+    delete it->second;
+    --m_nAdoptedHits;
+  }
+  m_nodePool.push_back(m_hits.extract(it));
+}
+
+TrkrHit*
+TrkrHitSetv2::getHit(const TrkrDefs::hitkey key) const
+{
+  const auto it = m_hits.find(key);
+  if (it != m_hits.end())
+  {
+    return it->second;
+  }
+  return nullptr;
+}
+
+TrkrHitSetv2::ConstRange
+TrkrHitSetv2::getHits() const
+{
+  return std::make_pair(m_hits.cbegin(), m_hits.cend());
+}
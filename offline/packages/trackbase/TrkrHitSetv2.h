@@ -0,0 +1,110 @@
+#ifndef TRACKBASE_TRKRHITSETV2_H
+#define TRACKBASE_TRKRHITSETV2_H
+
+/**
+ * @file trackbase/TrkrHitSetv2.h
+ * @brief TrkrHitSet with pooled hit storage
+ */
+#include "TrkrDefs.h"
+#include "TrkrHitSet.h"
+#include "TrkrHitv2.h"
+
+#include <cstddef>
+#include <deque>
+#include <iostream>
+#include <utility>  // for pair
+#include <vector>
+
+// forward declaration
+class TrkrHit;
+
+/**
+ * Hits created by findOrAddHit() come from a pool owned by the hitset which
+ * is kept across Reset(), so after the first events no hit is allocated anymore.
+ * Hits passed to addHitSpecificKey() are adopted and deleted in Reset().
+ * Only the adc of the hits is kept.
+ *
+ * The TrkrHitSet interface hands out std::map iterators, so the hits are kept in a
+ * key -> TrkrHit* map rather than in flat arrays. The map nodes are extracted and
+ * recycled as well, so once the pools are warm a hitset does not allocate per hit.
+ *
+ * The hits are not written out by this class, it is meant to be used inside
+ * TrkrHitSetContainerv3 which stores the hits of all its hitsets as flat arrays
+ */
+class TrkrHitSetv2 final : public TrkrHitSet
+{
+ public:
+  TrkrHitSetv2() = default;
+
+  ~TrkrHitSetv2() override
+  {
+    TrkrHitSetv2::Reset();
+  }
+
+  void identify(std::ostream& os = std::cout) const override;
+
+  //! For ROOT TClonesArray end of event Operation
+  void Clear(Option_t* /*option*/ = "") override { Reset(); }
+
+  //! clears the hits but keeps the hit pool
+  void Reset() override;
+
+  void setHitSetKey(const TrkrDefs::hitsetkey key) override
+  {
+    m_hitSetKey = key;
+  }
+
+  TrkrDefs::hitsetkey getHitSetKey() const override
+  {
+    return m_hitSetKey;
+  }
+
+  ConstIterator addHitSpecificKey(const TrkrDefs::hitkey, TrkrHit*) override;
+
+  TrkrHit* findOrAddHit(const TrkrDefs::hitkey) override;
+
+  //! append a pooled hit, keys must be added in ascending order (used when unpacking from flat storage)
+  void appendHit(const TrkrDefs::hitkey, const unsigned int adc);
+
+  void removeHit(TrkrDefs::hitkey) override;
+
+  TrkrHit* getHit(const TrkrDefs::hitkey) const override;
+
+  ConstRange getHits() const override;
+
+  unsigned int size() const override
+  {
+    return m_hits.size();
+  }
+
+ private:
+  //! marks hits owned by the pool
+  class PooledHit final : public TrkrHitv2
+  {
+  };
+
+  TrkrHitv2* newPooledHit();
+
+  //! insert in the hit map, reusing a recycled node if any
+  Map::iterator insertHit(Map::const_iterator hint, const TrkrDefs::hitkey, TrkrHit*);
+
+  /// unique key for this object
+  TrkrDefs::hitsetkey m_hitSetKey = TrkrDefs::HITSETKEYMAX;
+
+  /// hits sorted by key, pointing into the pool or to adopted hits
+  Map m_hits;  //!
+
+  /// hit objects reused across events, a deque keeps their addresses stable
+  std::deque<PooledHit> m_hitPool;  //!
+  size_t m_nPoolUsed = 0;  //!
+
+  /// map nodes extracted from m_hits, reused by insertHit
+  std::vector<Map::node_type> m_nodePool;  //!
+
+  /// number of hits handed over by addHitSpecificKey()
+  size_t m_nAdoptedHits = 0;  //!
+
+  ClassDefOverride(TrkrHitSetv2, 1);
+};
+
+#endif  // TRACKBASE_TRKRHITSETV2_H
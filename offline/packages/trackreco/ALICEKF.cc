@@ -15,8 +15,6 @@
 #include <TMatrixT.h>
 #include <TMatrixTUtils.h>
 
-#include <omp.h>
-
 //#define _DEBUG_
 
 #if defined(_DEBUG_)
@@ -78,8 +76,8 @@ double ALICEKF::get_Bz(double x, double y, double z) const
     const std::array<double,4> p = {x * cm, y * cm, z * cm, 0. * cm};
     double bfield[3];
 
-    // check thread number. Use uncached field accessor for all but thread 0.
-    if( omp_get_thread_num() == 0 )
+    // check thread. Use uncached field accessor for all but the one which owns this filter.
+    if( std::this_thread::get_id() == _owner_thread )
     {
       _B->GetFieldValue(&p[0], bfield);
     } else {
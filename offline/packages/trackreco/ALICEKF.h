@@ -17,6 +17,7 @@
 #include <Eigen/Dense>
 
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -69,6 +70,9 @@ class ALICEKF
   //! magnetic field map
   PHField* _B = nullptr;
 
+  //! thread which created the filter. Only this one may use the cached field accessor
+  std::thread::id _owner_thread = std::this_thread::get_id();
+
   //! constant magnetic field
   /**
    * it is used for fast momentum calculation, or when positions are outside the field map boundaries along z
@@ -63,7 +63,7 @@ int AzimuthalSeeder::process_event(PHCompositeNode * /*unused*/)
   {
     for (const auto &layer : {0, 1, 2})
     {
-      for (const auto &hitsetkey : m_clusterContainer->getHitSetKeys(det, layer))
+      for (const auto &hitsetkey : m_clusterContainer->getHitSetKeyView(det, layer))
       {
         auto range = m_clusterContainer->getClusters(hitsetkey);
         for (auto citer = range.first; citer != range.second; ++citer)
@@ -939,7 +939,7 @@ std::vector<TrkrDefs::cluskey> PHActsSiliconSeeding::findMatches(
       {
         approximatephi = approximate_phi2;
       }
-      for (const auto& hitsetkey : m_clusterMap->getHitSetKeys(det, layer))
+      for (const auto& hitsetkey : m_clusterMap->getHitSetKeyView(det, layer))
       {
         auto surf = m_tGeometry->maps().getSiliconSurface(hitsetkey);
         auto surfcenter = surf->center(m_tGeometry->geometry().geoContext);
@@ -1220,7 +1220,7 @@ std::vector<std::vector<TrkrDefs::cluskey>> PHActsSiliconSeeding::iterateLayers(
     {
       approximatephi = approximate_phi2;
     }
-    for (const auto& hitsetkey : m_clusterMap->getHitSetKeys(TrkrDefs::TrkrId::inttId, layer))
+    for (const auto& hitsetkey : m_clusterMap->getHitSetKeyView(TrkrDefs::TrkrId::inttId, layer))
     {
       auto surf = m_tGeometry->maps().getSiliconSurface(hitsetkey);
       auto surfcenter = surf->center(m_tGeometry->geometry().geoContext);
@@ -1452,7 +1452,7 @@ std::vector<const SpacePoint*> PHActsSiliconSeeding::getSiliconSpacePoints(const
   }
   for (const auto& det : dets)
   {
-    for (const auto& hitsetkey : m_clusterMap->getHitSetKeys(det))
+    for (const auto& hitsetkey : m_clusterMap->getHitSetKeyView(det))
     {
       if (det == TrkrDefs::TrkrId::mvtxId)
       {
@@ -16,6 +16,8 @@
 #include <trackbase/ActsSourceLink.h>
 #include <trackbase/ActsTrackFittingAlgorithm.h>
 
+#include <trackbase_historic/SvtxTrack_v4.h>
+
 #include <tpc/TpcGlobalPositionWrapper.h>
 
 #include <Acts/Definitions/Algebra.hpp>
@@ -30,6 +32,7 @@
 #include <TH1.h>
 #include <TH2.h>
 #include <memory>
+#include <optional>
 #include <string>
 
 class alignmentTransformationContainer;
@@ -72,6 +75,10 @@ class PHActsTrkFitter : public SubsysReco
   /// Do some internal time benchmarking analysis
   void doTimeAnalysis(bool timeAnalysis) { m_timeAnalysis = timeAnalysis; }
 
+  /// number of threads used to fit the seeds. 1 (default) fits the seeds sequentially,
+  /// 0 uses all workers of the pool set with Fun4AllServer::NumWorkerThreads
+  void set_num_threads(int value) { m_num_threads = value; }
+
   /// Run the direct navigator to fit only tracks with silicon+MM hits
   void fitSiliconMMs(bool fitSiliconMMs)
   {
@@ -177,14 +184,31 @@ class PHActsTrkFitter : public SubsysReco
   /// Create new nodes
   int createNodes(PHCompositeNode* topNode);
 
+  /// fitted track of a single seed, stored in the track maps in seed order
+  struct SeedFitOutput
+  {
+    std::optional<SvtxTrack_v4> track;
+    /// true if the track goes to the silicon+MM track map
+    bool directed = false;
+    int nBadFits = 0;
+    bool missingTpcSeed = false;
+  };
+
   void loopTracks(Acts::Logging::Level logLevel);
 
+  /// fit a single seed. Only reads the module state, unless running sequentially
+  void fitSeed(TrackSeed* track, SeedFitOutput& output);
+
+  /// store the fitted track of a seed in the track map
+  void storeSeedFit(SeedFitOutput& output);
+
   /// Convert the acts track fit result to an svtx track
   void updateSvtxTrack(
       const std::vector<Acts::TrackIndexType>& tips,
       const Trajectory::IndexedParameters& paramsMap,
       const ActsTrackFittingAlgorithm::TrackContainer& tracks,
-      SvtxTrack* track);
+      SvtxTrack* track,
+      const Acts::GeometryContext& geoContext);
 
   /// Helper function to call either the regular navigation or direct
   /// navigation, depending on m_fitSiliconMMs
@@ -208,10 +232,11 @@ class PHActsTrkFitter : public SubsysReco
   bool getTrackFitResult(const FitResult& fitOutput, TrackSeed* seed,
                          SvtxTrack* track,
                          const ActsTrackFittingAlgorithm::TrackContainer& tracks,
-                         const ActsTrackFittingAlgorithm::MeasurementContainer& measurements);
+                         const ActsTrackFittingAlgorithm::MeasurementContainer& measurements,
+                         const Acts::GeometryContext& geoContext);
 
   Acts::BoundSquareMatrix setDefaultCovariance() const;
-  void printTrackSeed(const ActsTrackFittingAlgorithm::TrackParameters& seed) const;
+  void printTrackSeed(const ActsTrackFittingAlgorithm::TrackParameters& seed, const Acts::GeometryContext& geoContext) const;
 
   /// Event counter
   int m_event = 0;
@@ -226,7 +251,6 @@ class PHActsTrkFitter : public SubsysReco
   alignmentTransformationContainer* m_alignmentTransformationMap = nullptr;  // added for testing purposes
   alignmentTransformationContainer* m_alignmentTransformationMapTransient = nullptr;
   std::set<Acts::GeometryIdentifier> m_transient_id_set;
-  Acts::GeometryContext m_transient_geocontext = Acts::GeometryContext::dangerouslyDefaultConstruct();
   SvtxTrackMap* m_trackMap = nullptr;
   SvtxTrackMap* m_directedTrackMap = nullptr;
   TrkrClusterContainer* m_clusterContainer = nullptr;
@@ -316,6 +340,14 @@ class PHActsTrkFitter : public SubsysReco
 
   PHG4TpcGeomContainer* _tpccellgeo = nullptr;
 
+  /// number of threads used to fit the seeds
+  /**
+   * 1 fits the seeds sequentially. The fit is also sequential when running verbose,
+   * with the outlier finder, the evaluator, commissioning or time analysis,
+   * or without the cluster mover.
+   */
+  int m_num_threads = 1;
+
   /// Variables for doing event time execution analysis
   bool m_timeAnalysis = false;
   TFile* m_timeFile = nullptr;
@@ -11,6 +11,8 @@
 
 // sPHENIX includes
 #include <fun4all/Fun4AllReturnCodes.h>
+#include <fun4all/Fun4AllServer.h>
+#include <fun4all/Fun4AllTaskScheduler.h>
 
 #include <phool/PHTimer.h>  // for PHTimer
 #include <phool/getClass.h>
@@ -166,6 +168,21 @@ namespace
     return 2 * atan2(sqrt(dx * dx + dy * dy + dz * dz), sqrt(sx * sx + sy * sy + sz * sz));
   }
 
+  /// links found around the clusters of a single TPC row, merged into bilinks row by row
+  struct RowLinks
+  {
+    /// (cluster, cluster in the row below) links passing the triplet cut
+    std::unordered_set<PHCASeeding::keyLink> downlinks;
+
+    /// (cluster in the row above, cluster) links passing the triplet cut, in search order
+    PHCASeeding::keyLinks uplinks;
+
+    double cluster_find_time = 0;
+    double rtree_query_time = 0;
+    double transform_time = 0;
+    double compute_best_angle_time = 0;
+  };
+
 }  // namespace
 
 // using namespace ROOT::Minuit2;
@@ -248,7 +265,7 @@ std::pair<PHCASeeding::PositionMap, PHCASeeding::keyListPerLayer> PHCASeeding::F
   PositionMap cachedPositions;
   cachedPositions.reserve(_cluster_map->size());  // avoid resizing mid-execution
 
-  for (const auto& hitsetkey : _cluster_map->getHitSetKeys(TrkrDefs::TrkrId::tpcId))
+  for (const auto& hitsetkey : _cluster_map->getHitSetKeyView(TrkrDefs::TrkrId::tpcId))
   {
     auto range = _cluster_map->getClusters(hitsetkey);
     for (auto clusIter = range.first; clusIter != range.second; ++clusIter)
@@ -314,9 +331,15 @@ std::vector<PHCASeeding::coordKey> PHCASeeding::FillTree(bgi::rtree<PHCASeeding:
       continue;
     }
     coords.push_back({{static_cast<float>(clus_phi), static_cast<float>(clus_z)}, ckey});
-    t_fill->restart();
+    if (Verbosity() > 3)
+    {
+      t_fill->restart();
+    }
     _rtree.insert(std::make_pair(point(clus_phi, globalpos_d.z()), ckey));
-    t_fill->stop();
+    if (Verbosity() > 3)
+    {
+      t_fill->stop();
+    }
   }
   if (Verbosity() > 5)
   {
@@ -414,57 +437,49 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
   double compute_best_angle_time = 0;
   double set_insert_time = 0;
 
-  // there are three coord_array (only the current layer is used at a time,
-  // but it is filled the same time as the _rtrees, which are used two at
-  // a time -- the prior padplane row and the next padplain row
-  std::array<std::vector<coordKey>, 3> coord_arr;
-  std::array<std::unordered_set<keyLink>, 2> previous_downlinks_arr;
-  std::array<std::unordered_set<TrkrDefs::cluskey>, 2> bottom_of_bilink_arr;
-
   // iterate from outer to inner layers
   const int inner_index = _start_layer - _FIRST_LAYER_TPC + 1;
   const int outer_index = _end_layer - _FIRST_LAYER_TPC - 2;
 
-  // fill the current and prior row coord and ttrees for the first iteration
-  int _index_above = (outer_index + 1) % 3;
-  int _index_current = (outer_index) % 3;
-  coord_arr[_index_above] = FillTree(_rtrees[_index_above], ckeys[outer_index + 1], globalPositions, outer_index + 1);
-  coord_arr[_index_current] = FillTree(_rtrees[_index_current], ckeys[outer_index], globalPositions, outer_index);
-
-  for (int layer_index = outer_index; layer_index >= inner_index; --layer_index)
+  // layers are processed in parallel, unless tuples or verbose printouts are filled, which must happen in layer order
+#if defined(_PHCASEEDING_CLUSTERLOG_TUPOUT_)
+  const unsigned int num_threads = 1;
+#else
+  const unsigned int num_threads = (Verbosity() > 0) ? 1 : m_num_threads;
+#endif
+  auto* scheduler = Fun4AllServer::instance()->TaskScheduler();
+
+  // fill the coords and rtrees of all the rows used in a triplet, from outer to inner rows
+  // each row has its own rtree, filled in cluster order as before so that queries return the same clusters in the same order
+  std::array<std::vector<coordKey>, _NLAYERS_TPC> coord_arr;
+  const int n_trees = std::max(outer_index - inner_index + 3, 0);
+  scheduler->parallel_for(
+    Name(), n_trees, [&](std::size_t itree)
   {
-    // these lines of code will rotates through all three _rtree's in the array,
-    // where the old lower becomes the new middle, the old middle the new upper,
-    // and the old upper drops out and that _rtree is filled with the new lower
+    const int layer_index = outer_index + 1 - static_cast<int>(itree);
+    coord_arr[layer_index] = FillTree(_rtrees[layer_index], ckeys[layer_index], globalPositions, layer_index);
+  }, num_threads);
+
+  // For all the clusters in each row, find nearest neighbors in the
+  // above and below rows and make links. Rows are independent at this stage
+  const int n_rows = std::max(outer_index - inner_index + 1, 0);
+  std::vector<RowLinks> row_links(_NLAYERS_TPC);
+  scheduler->parallel_for(
+    Name(), n_rows, [&](std::size_t irow)
+  {
+    const int layer_index = outer_index - static_cast<int>(irow);
     const unsigned int LAYER = layer_index + _FIRST_LAYER_TPC;
-    int index_above = (layer_index + 1) % 3;
-    int index_current = (layer_index) % 3;
-    int index_below = (layer_index - 1) % 3;
-
-    coord_arr[index_below] = FillTree(_rtrees[index_below], ckeys[layer_index - 1], globalPositions, layer_index - 1);
-
-    // NO DUPLICATES FOUND IN COORD_ARR
-
-    auto& _rtree_above = _rtrees[index_above];
-    const std::vector<coordKey>& coord = coord_arr[index_current];
-    auto& _rtree_below = _rtrees[index_below];
-
-    auto& curr_downlinks = previous_downlinks_arr[layer_index % 2];
-    auto& last_downlinks = previous_downlinks_arr[(layer_index + 1) % 2];
 
-    auto& curr_bottom_of_bilink = bottom_of_bilink_arr[layer_index % 2];
-    auto& last_bottom_of_bilink = bottom_of_bilink_arr[(layer_index + 1) % 2];
+    const auto& _rtree_above = _rtrees[layer_index + 1];
+    const std::vector<coordKey>& coord = coord_arr[layer_index];
+    const auto& _rtree_below = _rtrees[layer_index - 1];
 
-    curr_downlinks.clear();
-    curr_bottom_of_bilink.clear();
+    auto& links = row_links[layer_index];
+    auto& curr_downlinks = links.downlinks;
 
-    // For all the clusters in coord, find nearest neighbors in the
-    // above and below layers and make links
-    // Any link to an above node which matches the same clusters
-    // on the previous iteration (to a "below node") becomes a "bilink"
-    // Check if this bilink links to a prior bilink or not
+    PHTimer timer("t_links");
+    timer.restart();
 
-    std::vector<keyLink> aboveLinks;
     for (const auto& StartCluster : coord)
     {
       double StartPhi = StartCluster.first[0];
@@ -472,9 +487,9 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
       double StartX = globalpos(0);
       double StartY = globalpos(1);
       double StartZ = globalpos(2);
-      t_seed->stop();
-      cluster_find_time += t_seed->elapsed();
-      t_seed->restart();
+      timer.stop();
+      links.cluster_find_time += timer.elapsed();
+      timer.restart();
       LogDebug(" starting cluster:" << std::endl);
       LogDebug(" z: " << StartZ << std::endl);
       LogDebug(" phi: " << StartPhi << std::endl);
@@ -489,7 +504,7 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
                 StartZ + dZ_per_layer[LAYER],
                 ClustersBelow);
 
-      FillTupWinLink(_rtree_below, StartCluster, globalPositions);
+      FillTupWinLink(_rtrees[layer_index - 1], StartCluster, globalPositions);
 
       QueryTree(_rtree_above,
                 StartPhi - dphi_per_layer[LAYER + 1],
@@ -498,9 +513,9 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
                 StartZ + dZ_per_layer[LAYER + 1],
                 ClustersAbove);
 
-      t_seed->stop();
-      rtree_query_time += t_seed->elapsed();
-      t_seed->restart();
+      timer.stop();
+      links.rtree_query_time += timer.elapsed();
+      timer.restart();
       LogDebug(" entries in below layer: " << ClustersBelow.size() << std::endl);
       LogDebug(" entries in above layer: " << ClustersAbove.size() << std::endl);
       std::vector<std::array<double, 3>> delta_below;
@@ -526,9 +541,9 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
           return std::array<double,3>{abovepos(0)-StartX,
           abovepos(1)-StartY,
           abovepos(2)-StartZ}; });
-      t_seed->stop();
-      transform_time += t_seed->elapsed();
-      t_seed->restart();
+      timer.stop();
+      links.transform_time += timer.elapsed();
+      timer.restart();
 
       // find the three clusters closest to a straight line
       // (by maximizing the cos of the angle between the (delta_z_,delta_phi) vectors)
@@ -569,41 +584,68 @@ std::pair<PHCASeeding::keyLinks, PHCASeeding::keyLinkPerLayer> PHCASeeding::Crea
       // There was some old commented-out code here for allowing layers to be skipped. This
       // may be useful in the future. This chunk of code has been moved towards the
       // end fo the file under the title: "---OLD CODE 0: SKIP_LAYERS---"
-      t_seed->stop();
-      compute_best_angle_time += t_seed->elapsed();
-      t_seed->restart();
+      timer.stop();
+      links.compute_best_angle_time += timer.elapsed();
+      timer.restart();
 
+      // the up-links are checked against the down-links of the row above once all rows are done
       for (auto cluster : bestAboveClusters)
       {
-        keyLink uplink = std::make_pair(cluster, StartCluster.second);
+        links.uplinks.emplace_back(cluster, StartCluster.second);
+      }
+    }  // end loop over start clusters
+  }, num_threads);
+
+  // Any link to an above node which matches the same clusters
+  // on the previous iteration (to a "below node") becomes a "bilink"
+  // Check if this bilink links to a prior bilink or not
+  PHTimer merge_timer("t_merge_links");
+  merge_timer.restart();
+
+  const std::unordered_set<keyLink> no_downlinks;
+  std::unordered_set<TrkrDefs::cluskey> curr_bottom_of_bilink;
+  std::unordered_set<TrkrDefs::cluskey> last_bottom_of_bilink;
+  for (int layer_index = outer_index; layer_index >= inner_index; --layer_index)
+  {
+    const auto& last_downlinks = (layer_index < outer_index) ? row_links[layer_index + 1].downlinks : no_downlinks;
+    curr_bottom_of_bilink.clear();
 
-        if (last_downlinks.find(uplink) != last_downlinks.end())
+    for (const auto& uplink : row_links[layer_index].uplinks)
+    {
+      if (last_downlinks.find(uplink) != last_downlinks.end())
+      {
+        // this is a bilink
+        const auto& key_top = uplink.first;
+        const auto& key_bot = uplink.second;
+        curr_bottom_of_bilink.insert(key_bot);
+        fill_tuple(_tupclus_bilinks, 0, key_top, globalPositions.at(key_top));
+        fill_tuple(_tupclus_bilinks, 1, key_bot, globalPositions.at(key_bot));
+
+        if (last_bottom_of_bilink.find(key_top) == last_bottom_of_bilink.end())
         {
-          // this is a bilink
-          const auto& key_top = uplink.first;
-          const auto& key_bot = uplink.second;
-          curr_bottom_of_bilink.insert(key_bot);
-          fill_tuple(_tupclus_bilinks, 0, key_top, globalPositions.at(key_top));
-          fill_tuple(_tupclus_bilinks, 1, key_bot, globalPositions.at(key_bot));
-
-          if (last_bottom_of_bilink.find(key_top) == last_bottom_of_bilink.end())
-          {
-            startLinks.push_back(std::make_pair(key_top, key_bot));
-          }
-          else
-          {
-            bodyLinks[layer_index + 1].push_back(std::make_pair(key_top, key_bot));
-          }
+          startLinks.push_back(std::make_pair(key_top, key_bot));
+        }
+        else
+        {
+          bodyLinks[layer_index + 1].push_back(std::make_pair(key_top, key_bot));
         }
-      }  // end loop over all up-links
-    }    // end loop over start clusters
+      }
+    }  // end loop over all up-links
 
-    t_seed->stop();
-    set_insert_time += t_seed->elapsed();
-    t_seed->restart();
+    std::swap(curr_bottom_of_bilink, last_bottom_of_bilink);
     LogDebug(" max collinearity: " << maxCosPlaneAngle << std::endl);
   }  // end loop over layers (to make links)
 
+  merge_timer.stop();
+  set_insert_time = merge_timer.elapsed();
+  for (const auto& links : row_links)
+  {
+    cluster_find_time += links.cluster_find_time;
+    rtree_query_time += links.rtree_query_time;
+    transform_time += links.transform_time;
+    compute_best_angle_time += links.compute_best_angle_time;
+  }
+
   t_seed->stop();
   if (Verbosity() > 0)
   {
@@ -969,6 +1011,12 @@ int PHCASeeding::Setup(PHCompositeNode* topNode)  // This is called by ::InitRun
     return ret;
   }
 
+  // number of shared worker threads used to build the links
+  if (Verbosity() > 0)
+  {
+    std::cout << "PHCASeeding::Setup - m_num_threads: " << m_num_threads << std::endl;
+  }
+
   // timing
   t_fill = std::make_unique<PHTimer>("t_fill");
   t_fill->stop();
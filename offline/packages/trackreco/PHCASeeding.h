@@ -156,6 +156,9 @@ class PHCASeeding : public PHTrackSeeding
   void setNitrogenFraction(double frac) { N2_frac = frac; };
   void setIsobutaneFraction(double frac) { isobutane_frac = frac; };
 
+  // number of threads
+  void set_num_threads(int value) { m_num_threads = value; }
+
  protected:
   int Setup(PHCompositeNode* topNode) override;
   int Process(PHCompositeNode* topNode) override;
@@ -272,8 +275,14 @@ class PHCASeeding : public PHTrackSeeding
   std::unique_ptr<PHTimer> t_fill;
   std::unique_ptr<PHTimer> t_makebilinks;
   std::unique_ptr<PHTimer> t_makeseeds;
-  /* std::array<bgi::rtree<pointKey, bgi::quadratic<16>>, _NLAYERS_TPC> _rtrees; */
-  std::array<bgi::rtree<pointKey, bgi::quadratic<16>>, 3> _rtrees;  // need three layers at a time
+  std::array<bgi::rtree<pointKey, bgi::quadratic<16>>, _NLAYERS_TPC> _rtrees;  // one per layer, so that layers can be processed in parallel
+
+  /// number of threads used to build the links between rows
+  /**
+   * 1 (default) builds the links sequentially, 0 uses all workers of the pool.
+   * The pool size itself is set with Fun4AllServer::NumWorkerThreads
+   */
+  int m_num_threads = 1;
 
   double Ne_frac = 0.00;
   double Ar_frac = 0.75;
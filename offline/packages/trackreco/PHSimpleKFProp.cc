@@ -35,6 +35,8 @@
 #include <trackbase_historic/TrackSeedHelper.h>
 
 #include <fun4all/Fun4AllReturnCodes.h>
+#include <fun4all/Fun4AllServer.h>
+#include <fun4all/Fun4AllTaskScheduler.h>
 
 #include <phool/PHTimer.h>
 #include <phool/getClass.h>
@@ -47,13 +49,12 @@
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
-#include <omp.h>
-
 #include <bit>
 #include <cmath>
 #include <filesystem>
 #include <iostream>
 #include <syncstream>
+#include <thread>
 #include <vector>
 
 // anonymous namespace for local functions
@@ -103,9 +104,8 @@ int PHSimpleKFProp::InitRun(PHCompositeNode* topNode)
   if( field_config->get_field_config() == PHFieldConfig::kFieldUniform )
   { fitter->setConstBField(field_config->get_field_mag_z()); }
 
-  // assign number of threads
+  // number of shared worker threads used for propagation
   std::cout << "PHSimpleKFProp::InitRun - m_num_threads: " << m_num_threads << std::endl;
-  if( m_num_threads >= 1 ) { omp_set_num_threads( m_num_threads ); }
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
@@ -195,175 +195,161 @@ int PHSimpleKFProp::process_event(PHCompositeNode* topNode)
   std::vector<std::vector<TrkrDefs::cluskey>> new_chains;
   std::vector<TrackSeed_v2> unused_tracks;
 
+  // per seed results, merged in seed order once all seeds are processed
+  std::vector<std::vector<TrkrDefs::cluskey>> seed_chains(_track_map->size());
+  std::vector<char> is_unused(_track_map->size(), 0);
+
   timer.restart();
-  #pragma omp parallel
+  Fun4AllServer::instance()->TaskScheduler()->parallel_for(
+    Name(), _track_map->size(), [&](std::size_t track_it)
   {
     if (Verbosity())
     {
       std::osyncstream(std::cout)
         << "PHSimpleKFProp -"
-        << " num_threads: " << omp_get_num_threads()
-        << " this thread: " << omp_get_thread_num()
-        << std::endl;
+        << " thread: " << std::this_thread::get_id()
+        << " processing seed " << track_it << std::endl;
     }
 
     PHTimer timer_mp("KFPropTimer_parallel");
 
-    std::vector<std::vector<TrkrDefs::cluskey>> local_chains;
-    std::vector<TrackSeed_v2> local_unused;
+    // if not a TPC track, ignore
+    auto *track = _track_map->get(track_it);
+    const bool is_tpc = std::any_of(
+      track->begin_cluster_keys(),
+      track->end_cluster_keys(),
+      [](const TrkrDefs::cluskey& key)
+    { return TrkrDefs::getTrkrId(key) == TrkrDefs::tpcId; });
 
-    #pragma omp for schedule(static)
-    for (size_t track_it = 0; track_it != _track_map->size(); ++track_it)
+    if (is_tpc)
     {
-      if (Verbosity())
-      {
-        std::osyncstream(std::cout)
-          << "PHSimpleKFProp -"
-          << " num_threads: " << omp_get_num_threads()
-          << " this thread: " << omp_get_thread_num()
-          << " processing seed " << track_it << std::endl;
-      }
 
-      // if not a TPC track, ignore
-      auto *track = _track_map->get(track_it);
-      const bool is_tpc = std::any_of(
-        track->begin_cluster_keys(),
-        track->end_cluster_keys(),
-        [](const TrkrDefs::cluskey& key)
-      { return TrkrDefs::getTrkrId(key) == TrkrDefs::tpcId; });
-
-      if (is_tpc)
-      {
-
-        // copy list of seed cluster keys
-        std::vector<std::vector<TrkrDefs::cluskey>> keylist_A(1);
-        std::copy(track->begin_cluster_keys(), track->end_cluster_keys(), std::back_inserter(keylist_A[0]));
-
-        // copy seed clusters position into local map
-        std::map<TrkrDefs::cluskey, Acts::Vector3> trackClusPositions;
-        std::transform(track->begin_cluster_keys(), track->end_cluster_keys(), std::inserter(trackClusPositions, trackClusPositions.end()),
-          [&globalPositions](const auto& key)
-        { return std::make_pair(key, globalPositions.at(key)); });
+      // copy list of seed cluster keys
+      std::vector<std::vector<TrkrDefs::cluskey>> keylist_A(1);
+      std::copy(track->begin_cluster_keys(), track->end_cluster_keys(), std::back_inserter(keylist_A[0]));
 
-        /// Can't circle fit a seed with less than 3 clusters, skip it
-        if (keylist_A[0].size() < 3)
-        {
-          continue;
-        }
+      // copy seed clusters position into local map
+      std::map<TrkrDefs::cluskey, Acts::Vector3> trackClusPositions;
+      std::transform(track->begin_cluster_keys(), track->end_cluster_keys(), std::inserter(trackClusPositions, trackClusPositions.end()),
+        [&globalPositions](const auto& key)
+      { return std::make_pair(key, globalPositions.at(key)); });
 
-        /// This will by definition return a single pair with each vector
-        /// in the pair length 1 corresponding to the seed info
-        std::vector<float> trackChi2;
+      /// Can't circle fit a seed with less than 3 clusters, skip it
+      if (keylist_A[0].size() < 3)
+      {
+        return;
+      }
 
-        timer_mp.restart();
-        auto seedpair = fitter->ALICEKalmanFilter(keylist_A, false, trackClusPositions, trackChi2);
+      /// This will by definition return a single pair with each vector
+      /// in the pair length 1 corresponding to the seed info
+      std::vector<float> trackChi2;
 
-        if (Verbosity() > 3)
-        {
-          std::cout << "PHSimpleKFProp::process_event - single track ALICEKF time " << timer_mp.elapsed() << " ms" << std::endl;
-        }
+      timer_mp.restart();
+      auto seedpair = fitter->ALICEKalmanFilter(keylist_A, false, trackClusPositions, trackChi2);
 
-        timer_mp.restart();
+      if (Verbosity() > 3)
+      {
+        std::cout << "PHSimpleKFProp::process_event - single track ALICEKF time " << timer_mp.elapsed() << " ms" << std::endl;
+      }
 
-        /// circle fit back to update track parameters
-        TrackSeedHelper::circleFitByTaubin(track, trackClusPositions, 7, 55);
-        TrackSeedHelper::lineFit(track, trackClusPositions, 7, 55);
-        track->set_phi(TrackSeedHelper::get_phi(track, trackClusPositions));
-        if (Verbosity() > 3)
-        {
-          std::cout << "PHSimpleKFProp::process_event - single track circle fit time " << timer_mp.elapsed() << " ms" << std::endl;
-        }
+      timer_mp.restart();
 
-        if (seedpair.first.empty()|| seedpair.second.empty())
-        {
-          continue;
-        }
+      /// circle fit back to update track parameters
+      TrackSeedHelper::circleFitByTaubin(track, trackClusPositions, 7, 55);
+      TrackSeedHelper::lineFit(track, trackClusPositions, 7, 55);
+      track->set_phi(TrackSeedHelper::get_phi(track, trackClusPositions));
+      if (Verbosity() > 3)
+      {
+        std::cout << "PHSimpleKFProp::process_event - single track circle fit time " << timer_mp.elapsed() << " ms" << std::endl;
+      }
 
-        if (Verbosity())
-        {
-          std::cout << "is tpc track" << std::endl;
-        }
+      if (seedpair.first.empty()|| seedpair.second.empty())
+      {
+        return;
+      }
 
-        timer_mp.restart();
+      if (Verbosity())
+      {
+        std::cout << "is tpc track" << std::endl;
+      }
 
-        if (Verbosity())
-        {
-          std::cout << "propagate first round" << std::endl;
-        }
+      timer_mp.restart();
 
-        auto preseed = PropagateTrack(track, PropagationDirection::Inward, seedpair.second.at(0), globalPositions);
-        if (Verbosity())
-        {
-          std::cout << "preseed size " << preseed.size() << std::endl;
-        }
+      if (Verbosity())
+      {
+        std::cout << "propagate first round" << std::endl;
+      }
 
-        std::vector<std::vector<TrkrDefs::cluskey>> kl = {preseed};
-        if (Verbosity())
-        {
-          std::cout << "kl size " << kl.size() << std::endl;
-        }
-        std::vector<float> pretrackChi2;
+      auto preseed = PropagateTrack(track, PropagationDirection::Inward, seedpair.second.at(0), globalPositions);
+      if (Verbosity())
+      {
+        std::cout << "preseed size " << preseed.size() << std::endl;
+      }
 
-        auto prepair = fitter->ALICEKalmanFilter(kl, false, globalPositions, pretrackChi2);
-        if (prepair.first.empty() || prepair.second.empty())
-        {
-          continue;
-        }
+      std::vector<std::vector<TrkrDefs::cluskey>> kl = {preseed};
+      if (Verbosity())
+      {
+        std::cout << "kl size " << kl.size() << std::endl;
+      }
+      std::vector<float> pretrackChi2;
 
-        std::reverse(kl.at(0).begin(), kl.at(0).end());
+      auto prepair = fitter->ALICEKalmanFilter(kl, false, globalPositions, pretrackChi2);
+      if (prepair.first.empty() || prepair.second.empty())
+      {
+        return;
+      }
 
-        auto pretrack = prepair.first.at(0);
+      std::reverse(kl.at(0).begin(), kl.at(0).end());
 
-        // copy seed clusters position into local map
-        std::map<TrkrDefs::cluskey, Acts::Vector3> pretrackClusPositions;
-        std::transform(pretrack.begin_cluster_keys(), pretrack.end_cluster_keys(), std::inserter(pretrackClusPositions, pretrackClusPositions.end()),
-          [&globalPositions](const auto& key)
-          { return std::make_pair(key, globalPositions.at(key)); });
+      auto pretrack = prepair.first.at(0);
 
-        // fit seed
-        TrackSeedHelper::circleFitByTaubin(&pretrack,pretrackClusPositions, 7, 55);
-        TrackSeedHelper::lineFit(&pretrack, pretrackClusPositions, 7, 55);
-        pretrack.set_phi(TrackSeedHelper::get_phi(&pretrack, pretrackClusPositions));
+      // copy seed clusters position into local map
+      std::map<TrkrDefs::cluskey, Acts::Vector3> pretrackClusPositions;
+      std::transform(pretrack.begin_cluster_keys(), pretrack.end_cluster_keys(), std::inserter(pretrackClusPositions, pretrackClusPositions.end()),
+        [&globalPositions](const auto& key)
+        { return std::make_pair(key, globalPositions.at(key)); });
 
-        prepair.second.at(0).SetDzDs(-prepair.second.at(0).GetDzDs());
-        const auto finalchain = PropagateTrack(&pretrack, kl.at(0), PropagationDirection::Outward, prepair.second.at(0), globalPositions);
+      // fit seed
+      TrackSeedHelper::circleFitByTaubin(&pretrack,pretrackClusPositions, 7, 55);
+      TrackSeedHelper::lineFit(&pretrack, pretrackClusPositions, 7, 55);
+      pretrack.set_phi(TrackSeedHelper::get_phi(&pretrack, pretrackClusPositions));
 
-        if (finalchain.size() > kl.at(0).size())
-        {
-          local_chains.push_back(finalchain);
-        }
-        else
-        {
-          local_chains.push_back(std::move(kl.at(0)));
-        }
+      prepair.second.at(0).SetDzDs(-prepair.second.at(0).GetDzDs());
+      const auto finalchain = PropagateTrack(&pretrack, kl.at(0), PropagationDirection::Outward, prepair.second.at(0), globalPositions);
 
-        if (Verbosity() > 3)
-        {
-          std::cout << "PHSimpleKFProp::process_event - propagate track time " << timer_mp.elapsed() << " ms" << std::endl;
-        }
+      if (finalchain.size() > kl.at(0).size())
+      {
+        seed_chains[track_it] = finalchain;
       }
       else
       {
-        if (Verbosity())
-        {
-          std::cout << "is NOT tpc track" << std::endl;
-        }
-        local_unused.emplace_back(*track);
+        seed_chains[track_it] = std::move(kl.at(0));
       }
-    }
-
-    // sort list and remove duplicates
-    std::sort(local_chains.begin(),local_chains.end());
-    local_chains.erase(std::unique(local_chains.begin(),local_chains.end()),local_chains.end());
 
-    // Critical sections to merge thread-local results
-    #pragma omp critical
+      if (Verbosity() > 3)
+      {
+        std::cout << "PHSimpleKFProp::process_event - propagate track time " << timer_mp.elapsed() << " ms" << std::endl;
+      }
+    }
+    else
     {
-      new_chains.reserve(new_chains.size()+local_chains.size());
-      new_chains.insert(new_chains.end(), std::make_move_iterator(local_chains.begin()), std::make_move_iterator(local_chains.end()));
+      if (Verbosity())
+      {
+        std::cout << "is NOT tpc track" << std::endl;
+      }
+      is_unused[track_it] = 1;
+    }
+  }, m_num_threads);
 
-      unused_tracks.reserve(unused_tracks.size()+local_unused.size());
-      unused_tracks.insert(unused_tracks.end(), std::make_move_iterator(local_unused.begin()), std::make_move_iterator(local_unused.end()));
+  for (size_t track_it = 0; track_it != seed_chains.size(); ++track_it)
+  {
+    if (!seed_chains[track_it].empty())
+    {
+      new_chains.push_back(std::move(seed_chains[track_it]));
+    }
+    if (is_unused[track_it])
+    {
+      unused_tracks.emplace_back(*_track_map->get(track_it));
     }
   }
   if (Verbosity())
@@ -448,7 +434,7 @@ PositionMap PHSimpleKFProp::PrepareKDTrees()
     return globalPositions;
   }
 
-  for (const auto& hitsetkey : _cluster_map->getHitSetKeys(TrkrDefs::TrkrId::tpcId))
+  for (const auto& hitsetkey : _cluster_map->getHitSetKeyView(TrkrDefs::TrkrId::tpcId))
   {
     auto range = _cluster_map->getClusters(hitsetkey);
     for (TrkrClusterContainer::ConstIterator it = range.first; it != range.second; ++it)
@@ -1351,31 +1337,26 @@ void PHSimpleKFProp::rejectAndPublishSeeds(std::vector<TrackSeed_v2>& seeds, con
   for (unsigned int itrack = 0; itrack < seeds.size(); ++itrack)
   { rejector.cut_from_clusters(itrack); }
 
-  #pragma omp parallel
+  Fun4AllServer::instance()->TaskScheduler()->parallel_for(
+    Name(), seeds.size(), [&](std::size_t itrack)
   {
+    // cut tracks with too-few clusters (or that don;t span a sector boundary, if desired)
+    if (rejector.is_rejected(itrack))
+    { return; }
 
-    #pragma omp for schedule(static)
-    for (unsigned int itrack = 0; itrack < seeds.size(); ++itrack)
-    {
-      // cut tracks with too-few clusters (or that don;t span a sector boundary, if desired)
-      if (rejector.is_rejected(itrack))
-      { continue; }
-
-      auto& seed = seeds[itrack];
-      /// The ALICEKF gives a better charge determination at high pT
-      const int q = seed.get_charge();
-
-      PositionMap local;
-      std::transform(seed.begin_cluster_keys(), seed.end_cluster_keys(), std::inserter(local, local.end()),
-        [&positions](const auto& key)
-        { return std::make_pair(key, positions.at(key)); });
-      TrackSeedHelper::circleFitByTaubin(&seed,local, 7, 55);
-      TrackSeedHelper::lineFit(&seed,local, 7, 55);
-      seed.set_phi(TrackSeedHelper::get_phi(&seed,local));
-      seed.set_qOverR(std::abs(seed.get_qOverR()) * q);
-    }
-
-  }
+    auto& seed = seeds[itrack];
+    /// The ALICEKF gives a better charge determination at high pT
+    const int q = seed.get_charge();
+
+    PositionMap local;
+    std::transform(seed.begin_cluster_keys(), seed.end_cluster_keys(), std::inserter(local, local.end()),
+      [&positions](const auto& key)
+      { return std::make_pair(key, positions.at(key)); });
+    TrackSeedHelper::circleFitByTaubin(&seed,local, 7, 55);
+    TrackSeedHelper::lineFit(&seed,local, 7, 55);
+    seed.set_phi(TrackSeedHelper::get_phi(&seed,local));
+    seed.set_qOverR(std::abs(seed.get_qOverR()) * q);
+  }, m_num_threads);
 
   if (Verbosity())
   { std::cout << "PHSimpleKFProp::rejectAndPublishSeeds - circle fit: " << timer.elapsed() << " ms" << std::endl; }
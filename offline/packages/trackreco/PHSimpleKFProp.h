@@ -242,10 +242,9 @@ class PHSimpleKFProp : public SubsysReco
 
   //! number of threads
   /**
-   * default is 0. This corresponds to allocating as many threads as available on the host
-   * on CONDOR, by default, this results in only one thread allocated
-   * being allocated unless several cores are allocated to the job
-   * via request_cpus directive in the jdf
+   * maximum number of threads of the shared Fun4AllServer worker pool working on the seeds.
+   * default is 0, which uses all workers of the pool. The pool size itself is set with
+   * Fun4AllServer::NumWorkerThreads
    */
   int m_num_threads = 0;
 
@@ -38,6 +38,7 @@
 
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <fun4all/Fun4AllServer.h>
+#include <fun4all/Fun4AllTaskScheduler.h>
 #include <fun4all/SubsysReco.h>  // for SubsysReco
 
 #include <phool/PHCompositeNode.h>
@@ -62,11 +63,15 @@
 #include <array>
 #include <cassert>
 #include <cmath>    // for sqrt, abs, NAN
+#include <cstdint>
 #include <cstdlib>  // for exit
 #include <format>
 #include <iostream>
+#include <limits>
 #include <map>      // for _Rb_tree_cons...
+#include <random>
 #include <utility>  // for pair
+#include <vector>
 
 namespace
 {
@@ -75,6 +80,65 @@ namespace
   {
     return x * x;
   }
+
+  // number of g4hits drifted together in the parallel mode
+  constexpr unsigned int drift_block_size = 5000;
+
+  //! counter based random numbers: the n-th number of a stream only depends on the stream key and n
+  class DriftRandomStream
+  {
+   public:
+    using result_type = uint64_t;
+
+    DriftRandomStream(const uint64_t seed, const uint64_t event, const uint64_t g4hitkey)
+      : m_key(mix(mix(seed ^ mix(event)) ^ g4hitkey))
+    {
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() { return mix(m_key + (++m_counter) * 0x9e3779b97f4a7c15ULL); }
+
+    //! uniform in [0,1)
+    double uniform() { return static_cast<double>(operator()() >> 11U) * 0x1.0p-53; }
+
+    void fill_uniform(std::vector<double> &values)
+    {
+      for (auto &value : values)
+      {
+        value = uniform();
+      }
+    }
+
+    //! unit gaussians, Box-Muller in pairs
+    void fill_gaussian(std::vector<double> &values)
+    {
+      for (size_t i = 0; i + 1 < values.size(); i += 2)
+      {
+        const double r = std::sqrt(-2. * std::log(1. - uniform()));
+        const double phi = 2. * M_PI * uniform();
+        values[i] = r * std::cos(phi);
+        values[i + 1] = r * std::sin(phi);
+      }
+      if (values.size() % 2)
+      {
+        values.back() = std::sqrt(-2. * std::log(1. - uniform())) * std::cos(2. * M_PI * uniform());
+      }
+    }
+
+   private:
+    //! splitmix64 finalizer
+    static uint64_t mix(uint64_t z)
+    {
+      z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27U)) * 0x94d049bb133111ebULL;
+      return z ^ (z >> 31U);
+    }
+
+    uint64_t m_key{0};
+    uint64_t m_counter{0};
+  };
 }  // namespace
 
 PHG4TpcElectronDrift::PHG4TpcElectronDrift(const std::string &name)
@@ -445,6 +509,7 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
   //  double ecollectedhits = 0.0;
   //  int ncollectedhits = 0;
   double ihit = 0;
+  const bool parallel_drift = m_parallel_drift && !do_ElectronDriftQAHistos && Verbosity() == 0;
   unsigned int dump_interval = 5000;  // dump temp_hitsetcontainer to the node tree after this many g4hits
   unsigned int dump_counter = 0;
 
@@ -459,6 +524,27 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
     count_g4hits++;
     dump_counter++;
 
+    // drift the electrons of the next block of g4hits in parallel
+    if (parallel_drift && (count_g4hits - 1) % drift_block_size == 0)
+    {
+      std::vector<PHG4HitContainer::ConstIterator> block;
+      block.reserve(drift_block_size);
+      for (auto block_iter = hiter; block_iter != hit_begin_end.second && block.size() < drift_block_size; ++block_iter)
+      {
+        block.push_back(block_iter);
+      }
+      if (m_drifted.size() < block.size())
+      {
+        m_drifted.resize(block.size());
+      }
+
+      const double drift_velocity = layergeom->get_drift_velocity_sim();
+      Fun4AllServer::instance()->TaskScheduler()->parallel_for(
+          Name(), block.size(), [&](std::size_t iblock)
+          { drift_electrons(block[iblock]->second, block[iblock]->first, drift_velocity, m_drifted[iblock]); },
+          m_drift_concurrency);
+    }
+
     const double t0 = std::fmax(hiter->second->get_t(0), hiter->second->get_t(1));
     if (t0 > max_time)
     {
@@ -523,7 +609,8 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
     // drifted electrons, then copy to the node tree later
 
     double eion = hiter->second->get_eion();
-    unsigned int n_electrons = gsl_ran_poisson(RandomGenerator.get(), eion * electrons_per_gev);
+    const DriftedElectrons *drifted = parallel_drift ? &m_drifted[(count_g4hits - 1) % drift_block_size] : nullptr;
+    unsigned int n_electrons = drifted ? drifted->n_electrons : gsl_ran_poisson(RandomGenerator.get(), eion * electrons_per_gev);
     //    count_electrons += n_electrons;
 
     if (Verbosity() > 100)
@@ -555,168 +642,177 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
     }
 
     int notReachingReadout = 0;
-    //    int notInAcceptance = 0;
-    for (unsigned int i = 0; i < n_electrons; i++)
+    if (drifted)
     {
-      // We choose the electron starting position at random from a flat
-      // distribution along the path length the parameter t is the fraction of
-      // the distance along the path betwen entry and exit points, it has
-      // values between 0 and 1
-      const double f = gsl_ran_flat(RandomGenerator.get(), 0.0, 1.0);
-
-      const double x_start_glob = hiter->second->get_x(0) + f * (hiter->second->get_x(1) - hiter->second->get_x(0));
-      const double y_start_glob = hiter->second->get_y(0) + f * (hiter->second->get_y(1) - hiter->second->get_y(0));
-      const double z_start_glob = hiter->second->get_z(0) + f * (hiter->second->get_z(1) - hiter->second->get_z(0));
-      const double t_start = hiter->second->get_t(0) + f * (hiter->second->get_t(1) - hiter->second->get_t(0));
-
-      Acts::Vector3 start_glob(x_start_glob, y_start_glob, z_start_glob);
-      Acts::Vector3 start = m_tGeometry->transformTpcWorldToEnvelope(start_glob); // we drift in tpc envelope coords, where E is in the z direction
-
-      const double x_start = start.x();
-      const double y_start = start.y();
-      const double z_start = start.z();
-      /*
-      std::cout << " xg " << x_start_glob << " x " << x_start
-		<<" yg " << y_start_glob << " y " << y_start
-		<<" zg " << z_start_glob << " z " << z_start << std::endl;
-      */
-      unsigned int side = 0;
-      if (z_start > 0)
-      {
-        side = 1;
-      }
-
-      const double r_sigma = diffusion_trans * sqrt(tpc_length / 2. - std::abs(z_start));
-      const double rantrans =
-          gsl_ran_gaussian(RandomGenerator.get(), r_sigma) +
-          gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_trans);
-
-      const double t_path = (tpc_length / 2. - std::abs(z_start)) / layergeom->get_drift_velocity_sim();
-      const double t_sigma = diffusion_long * sqrt(tpc_length / 2. - std::abs(z_start)) / layergeom->get_drift_velocity_sim();
-      const double rantime =
-          gsl_ran_gaussian(RandomGenerator.get(), t_sigma) +
-	gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_long) / layergeom->get_drift_velocity_sim();
-      double t_final = t_start + t_path + rantime;
-
-      if (t_final < min_time || t_final > max_time)
-      {
-        continue;
-      }
-
-      double z_final;
-      if (z_start < 0)
-      {
-        z_final = -tpc_length / 2. + t_final * layergeom->get_drift_velocity_sim();
-      }
-      else
+      padplane->MapToPadPlane(truth_clusterer, single_hitsetcontainer.get(),
+                              temp_hitsetcontainer.get(), hittruthassoc, drifted->x, drifted->y, drifted->t,
+                              drifted->side, hiter, ntpad, nthit);
+    }
+    else
+    {
+      //    int notInAcceptance = 0;
+      for (unsigned int i = 0; i < n_electrons; i++)
       {
-        z_final = tpc_length / 2. - t_final * layergeom->get_drift_velocity_sim();
-      }
-
-      const double radstart = std::sqrt(square(x_start) + square(y_start));
-      const double phistart = std::atan2(y_start, x_start);
-      const double ranphi = gsl_ran_flat(RandomGenerator.get(), -M_PI, M_PI);
-
-      double x_final = x_start + rantrans * std::cos(ranphi);  // Initialize these to be only diffused first, will be overwritten if doing SC distortion
-      double y_final = y_start + rantrans * std::sin(ranphi);
+        // We choose the electron starting position at random from a flat
+        // distribution along the path length the parameter t is the fraction of
+        // the distance along the path betwen entry and exit points, it has
+        // values between 0 and 1
+        const double f = gsl_ran_flat(RandomGenerator.get(), 0.0, 1.0);
+
+        const double x_start_glob = hiter->second->get_x(0) + f * (hiter->second->get_x(1) - hiter->second->get_x(0));
+        const double y_start_glob = hiter->second->get_y(0) + f * (hiter->second->get_y(1) - hiter->second->get_y(0));
+        const double z_start_glob = hiter->second->get_z(0) + f * (hiter->second->get_z(1) - hiter->second->get_z(0));
+        const double t_start = hiter->second->get_t(0) + f * (hiter->second->get_t(1) - hiter->second->get_t(0));
+
+        Acts::Vector3 start_glob(x_start_glob, y_start_glob, z_start_glob);
+        Acts::Vector3 start = m_tGeometry->transformTpcWorldToEnvelope(start_glob); // we drift in tpc envelope coords, where E is in the z direction
+
+        const double x_start = start.x();
+        const double y_start = start.y();
+        const double z_start = start.z();
+        /*
+        std::cout << " xg " << x_start_glob << " x " << x_start
+  		<<" yg " << y_start_glob << " y " << y_start
+  		<<" zg " << z_start_glob << " z " << z_start << std::endl;
+        */
+        unsigned int side = 0;
+        if (z_start > 0)
+        {
+          side = 1;
+        }
 
-      double rad_final = sqrt(square(x_final) + square(y_final));
-      double phi_final = atan2(y_final, x_final);
+        const double r_sigma = diffusion_trans * sqrt(tpc_length / 2. - std::abs(z_start));
+        const double rantrans =
+            gsl_ran_gaussian(RandomGenerator.get(), r_sigma) +
+            gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_trans);
 
-      if (do_ElectronDriftQAHistos)
-      {
-        z_startmap->Fill(z_start, radstart);                   // map of starting location in Z vs. R
-        deltaphinodist->Fill(phistart, rantrans / rad_final);  // delta phi no distortion, just diffusion+smear
-        deltarnodist->Fill(radstart, rantrans);                // delta r no distortion, just diffusion+smear
-      }
+        const double t_path = (tpc_length / 2. - std::abs(z_start)) / layergeom->get_drift_velocity_sim();
+        const double t_sigma = diffusion_long * sqrt(tpc_length / 2. - std::abs(z_start)) / layergeom->get_drift_velocity_sim();
+        const double rantime =
+            gsl_ran_gaussian(RandomGenerator.get(), t_sigma) +
+  	gsl_ran_gaussian(RandomGenerator.get(), added_smear_sigma_long) / layergeom->get_drift_velocity_sim();
+        double t_final = t_start + t_path + rantime;
 
-      if (m_distortionMap)
-      {
-        // zhangcanyu
-        const double reaches = m_distortionMap->get_reaches_readout(radstart, phistart, z_start);
-        if (reaches < thresholdforreachesreadout)
+        if (t_final < min_time || t_final > max_time)
         {
-          notReachingReadout++;
           continue;
         }
 
-        const double r_distortion = m_distortionMap->get_r_distortion(radstart, phistart, z_start);
-        const double phi_distortion = m_distortionMap->get_rphi_distortion(radstart, phistart, z_start) / radstart;
-        const double z_distortion = m_distortionMap->get_z_distortion(radstart, phistart, z_start);
-
-        rad_final += r_distortion;
-        phi_final += phi_distortion;
-        z_final += z_distortion;
+        double z_final;
         if (z_start < 0)
         {
-          t_final = (z_final + tpc_length / 2.0) / layergeom->get_drift_velocity_sim();
+          z_final = -tpc_length / 2. + t_final * layergeom->get_drift_velocity_sim();
         }
         else
         {
-          t_final = (tpc_length / 2.0 - z_final) / layergeom->get_drift_velocity_sim();
+          z_final = tpc_length / 2. - t_final * layergeom->get_drift_velocity_sim();
         }
 
-        x_final = rad_final * std::cos(phi_final);
-        y_final = rad_final * std::sin(phi_final);
+        const double radstart = std::sqrt(square(x_start) + square(y_start));
+        const double phistart = std::atan2(y_start, x_start);
+        const double ranphi = gsl_ran_flat(RandomGenerator.get(), -M_PI, M_PI);
 
-        //	if(i < 1)
-        //{std::cout << " electron " << i << " r_distortion " << r_distortion << " phi_distortion " << phi_distortion << " rad_final " << rad_final << " phi_final " << phi_final << " r*dphi distortion " << rad_final * phi_distortion << " z_distortion " << z_distortion << std::endl;}
+        double x_final = x_start + rantrans * std::cos(ranphi);  // Initialize these to be only diffused first, will be overwritten if doing SC distortion
+        double y_final = y_start + rantrans * std::sin(ranphi);
+
+        double rad_final = sqrt(square(x_final) + square(y_final));
+        double phi_final = atan2(y_final, x_final);
 
         if (do_ElectronDriftQAHistos)
         {
-          const double phi_final_nodiff = phistart + phi_distortion;
-          const double rad_final_nodiff = radstart + r_distortion;
-          deltarnodiff->Fill(radstart, rad_final_nodiff - radstart);    // delta r no diffusion, just distortion
-          deltaphinodiff->Fill(phistart, phi_final_nodiff - phistart);  // delta phi no diffusion, just distortion
-          deltaphivsRnodiff->Fill(radstart, phi_final_nodiff - phistart);
-          deltaRphinodiff->Fill(radstart, rad_final_nodiff * phi_final_nodiff - radstart * phistart);
-
-          // Fill Diagnostic plots, written into ElectronDriftQA.root
-          hitmapstart->Fill(x_start, y_start);  // G4Hit starting positions
-          hitmapend->Fill(x_final, y_final);    // INcludes diffusion and distortion
-          hitmapstart_z->Fill(z_start, radstart);
-          hitmapend_z->Fill(z_final, rad_final);
-          deltar->Fill(radstart, rad_final - radstart);    // total delta r
-          deltaphi->Fill(phistart, phi_final - phistart);  // total delta phi
-          deltaz->Fill(z_start, z_distortion);             // map of distortion in Z (time)
+          z_startmap->Fill(z_start, radstart);                   // map of starting location in Z vs. R
+          deltaphinodist->Fill(phistart, rantrans / rad_final);  // delta phi no distortion, just diffusion+smear
+          deltarnodist->Fill(radstart, rantrans);                // delta r no distortion, just diffusion+smear
         }
-      }
 
-      // remove electrons outside of our acceptance. Careful though, electrons from just inside 30 cm can contribute in the 1st active layer readout, so leave a little margin
-      if (rad_final < min_active_radius - 2.0 || rad_final > max_active_radius + 1.0)
-      {
-        //        notInAcceptance++;
-        continue;
-      }
+        if (m_distortionMap)
+        {
+          // zhangcanyu
+          const double reaches = m_distortionMap->get_reaches_readout(radstart, phistart, z_start);
+          if (reaches < thresholdforreachesreadout)
+          {
+            notReachingReadout++;
+            continue;
+          }
 
-      if (Verbosity() > 1000)
-      //      if(i < 1)
-      {
-        std::cout << "electron " << i << " g4hitid " << hiter->first << " f " << f << std::endl;
-        std::cout << "radstart " << radstart << " x_start: " << x_start
-                  << ", y_start: " << y_start
-                  << ",z_start: " << z_start
-                  << " t_start " << t_start
-                  << " t_path " << t_path
-                  << " t_sigma " << t_sigma
-                  << " rantime " << rantime
-                  << std::endl;
-
-        std::cout << "       rad_final " << rad_final << " x_final " << x_final
-                  << " y_final " << y_final
-                  << " z_final " << z_final << " t_final " << t_final
-                  << " zdiff " << z_final - z_start << std::endl;
-      }
+          const double r_distortion = m_distortionMap->get_r_distortion(radstart, phistart, z_start);
+          const double phi_distortion = m_distortionMap->get_rphi_distortion(radstart, phistart, z_start) / radstart;
+          const double z_distortion = m_distortionMap->get_z_distortion(radstart, phistart, z_start);
 
-      if (Verbosity() > 0)
-      {
-        assert(nt);
-        nt->Fill(ihit, t_start, t_final, t_sigma, rad_final, z_start, z_final);
-      }
-      padplane->MapToPadPlane(truth_clusterer, single_hitsetcontainer.get(),
-                              temp_hitsetcontainer.get(), hittruthassoc, x_final, y_final, t_final,
-                              side, hiter, ntpad, nthit);
-    }  // end loop over electrons for this g4hit
+          rad_final += r_distortion;
+          phi_final += phi_distortion;
+          z_final += z_distortion;
+          if (z_start < 0)
+          {
+            t_final = (z_final + tpc_length / 2.0) / layergeom->get_drift_velocity_sim();
+          }
+          else
+          {
+            t_final = (tpc_length / 2.0 - z_final) / layergeom->get_drift_velocity_sim();
+          }
+
+          x_final = rad_final * std::cos(phi_final);
+          y_final = rad_final * std::sin(phi_final);
+
+          //	if(i < 1)
+          //{std::cout << " electron " << i << " r_distortion " << r_distortion << " phi_distortion " << phi_distortion << " rad_final " << rad_final << " phi_final " << phi_final << " r*dphi distortion " << rad_final * phi_distortion << " z_distortion " << z_distortion << std::endl;}
+
+          if (do_ElectronDriftQAHistos)
+          {
+            const double phi_final_nodiff = phistart + phi_distortion;
+            const double rad_final_nodiff = radstart + r_distortion;
+            deltarnodiff->Fill(radstart, rad_final_nodiff - radstart);    // delta r no diffusion, just distortion
+            deltaphinodiff->Fill(phistart, phi_final_nodiff - phistart);  // delta phi no diffusion, just distortion
+            deltaphivsRnodiff->Fill(radstart, phi_final_nodiff - phistart);
+            deltaRphinodiff->Fill(radstart, rad_final_nodiff * phi_final_nodiff - radstart * phistart);
+
+            // Fill Diagnostic plots, written into ElectronDriftQA.root
+            hitmapstart->Fill(x_start, y_start);  // G4Hit starting positions
+            hitmapend->Fill(x_final, y_final);    // INcludes diffusion and distortion
+            hitmapstart_z->Fill(z_start, radstart);
+            hitmapend_z->Fill(z_final, rad_final);
+            deltar->Fill(radstart, rad_final - radstart);    // total delta r
+            deltaphi->Fill(phistart, phi_final - phistart);  // total delta phi
+            deltaz->Fill(z_start, z_distortion);             // map of distortion in Z (time)
+          }
+        }
+
+        // remove electrons outside of our acceptance. Careful though, electrons from just inside 30 cm can contribute in the 1st active layer readout, so leave a little margin
+        if (rad_final < min_active_radius - 2.0 || rad_final > max_active_radius + 1.0)
+        {
+          //        notInAcceptance++;
+          continue;
+        }
+
+        if (Verbosity() > 1000)
+        //      if(i < 1)
+        {
+          std::cout << "electron " << i << " g4hitid " << hiter->first << " f " << f << std::endl;
+          std::cout << "radstart " << radstart << " x_start: " << x_start
+                    << ", y_start: " << y_start
+                    << ",z_start: " << z_start
+                    << " t_start " << t_start
+                    << " t_path " << t_path
+                    << " t_sigma " << t_sigma
+                    << " rantime " << rantime
+                    << std::endl;
+
+          std::cout << "       rad_final " << rad_final << " x_final " << x_final
+                    << " y_final " << y_final
+                    << " z_final " << z_final << " t_final " << t_final
+                    << " zdiff " << z_final - z_start << std::endl;
+        }
+
+        if (Verbosity() > 0)
+        {
+          assert(nt);
+          nt->Fill(ihit, t_start, t_final, t_sigma, rad_final, z_start, z_final);
+        }
+        padplane->MapToPadPlane(truth_clusterer, single_hitsetcontainer.get(),
+                                temp_hitsetcontainer.get(), hittruthassoc, x_final, y_final, t_final,
+                                side, hiter, ntpad, nthit);
+      }  // end loop over electrons for this g4hit
+    }
 
     if (do_ElectronDriftQAHistos)
     {
@@ -947,6 +1043,113 @@ int PHG4TpcElectronDrift::End(PHCompositeNode * /*topNode*/)
 void PHG4TpcElectronDrift::set_seed(const unsigned int seed)
 {
   gsl_rng_set(RandomGenerator.get(), seed);
+  m_drift_seed = seed;
+}
+
+void PHG4TpcElectronDrift::DriftedElectrons::clear()
+{
+  n_electrons = 0;
+  x.clear();
+  y.clear();
+  t.clear();
+  side.clear();
+}
+
+void PHG4TpcElectronDrift::drift_electrons(const PHG4Hit *g4hit, const uint64_t g4hitkey, const double drift_velocity, DriftedElectrons &electrons) const
+{
+  electrons.clear();
+
+  const double t0 = std::fmax(g4hit->get_t(0), g4hit->get_t(1));
+  const double mean_electrons = g4hit->get_eion() * electrons_per_gev;
+  if (t0 > max_time || !(mean_electrons > 0))
+  {
+    return;
+  }
+
+  DriftRandomStream rng(m_drift_seed, event_num, g4hitkey);
+  std::poisson_distribution<unsigned int> poisson(mean_electrons);
+  const unsigned int n_electrons = poisson(rng);
+  electrons.n_electrons = n_electrons;
+  if (n_electrons == 0)
+  {
+    return;
+  }
+
+  // all random numbers needed for this g4hit are generated up front
+  // two flat (position along the path, diffusion direction) and four gaussian per electron
+  thread_local std::vector<double> flat;
+  thread_local std::vector<double> gauss;
+  flat.resize(2 * n_electrons);
+  gauss.resize(4 * n_electrons);
+  rng.fill_uniform(flat);
+  rng.fill_gaussian(gauss);
+
+  // the world to envelope transformation is affine, so the start position
+  // can be interpolated between the transformed entry and exit points
+  const Acts::Vector3 start_entry = m_tGeometry->transformTpcWorldToEnvelope(Acts::Vector3(g4hit->get_x(0), g4hit->get_y(0), g4hit->get_z(0)));
+  const Acts::Vector3 start_exit = m_tGeometry->transformTpcWorldToEnvelope(Acts::Vector3(g4hit->get_x(1), g4hit->get_y(1), g4hit->get_z(1)));
+  const Acts::Vector3 start_path = start_exit - start_entry;
+  const double t_entry = g4hit->get_t(0);
+  const double t_length = g4hit->get_t(1) - t_entry;
+
+  electrons.x.reserve(n_electrons);
+  electrons.y.reserve(n_electrons);
+  electrons.t.reserve(n_electrons);
+  electrons.side.reserve(n_electrons);
+
+  for (unsigned int i = 0; i < n_electrons; ++i)
+  {
+    const double f = flat[2 * i];
+    const double x_start = start_entry.x() + f * start_path.x();
+    const double y_start = start_entry.y() + f * start_path.y();
+    const double z_start = start_entry.z() + f * start_path.z();
+    const double t_start = t_entry + f * t_length;
+
+    const double drift_length = tpc_length / 2. - std::abs(z_start);
+    const double rantrans = gauss[4 * i] * diffusion_trans * std::sqrt(drift_length) + gauss[4 * i + 1] * added_smear_sigma_trans;
+    const double rantime = (gauss[4 * i + 2] * diffusion_long * std::sqrt(drift_length) + gauss[4 * i + 3] * added_smear_sigma_long) / drift_velocity;
+    double t_final = t_start + drift_length / drift_velocity + rantime;
+    if (t_final < min_time || t_final > max_time)
+    {
+      continue;
+    }
+
+    double z_final = z_start < 0 ? -tpc_length / 2. + t_final * drift_velocity : tpc_length / 2. - t_final * drift_velocity;
+
+    const double ranphi = -M_PI + 2. * M_PI * flat[2 * i + 1];
+    double x_final = x_start + rantrans * std::cos(ranphi);
+    double y_final = y_start + rantrans * std::sin(ranphi);
+    double rad_final = std::sqrt(square(x_final) + square(y_final));
+
+    if (m_distortionMap)
+    {
+      const double radstart = std::sqrt(square(x_start) + square(y_start));
+      const double phistart = std::atan2(y_start, x_start);
+      if (m_distortionMap->get_reaches_readout(radstart, phistart, z_start) < thresholdforreachesreadout)
+      {
+        continue;
+      }
+
+      const double phi_final = std::atan2(y_final, x_final) + m_distortionMap->get_rphi_distortion(radstart, phistart, z_start) / radstart;
+      rad_final += m_distortionMap->get_r_distortion(radstart, phistart, z_start);
+      z_final += m_distortionMap->get_z_distortion(radstart, phistart, z_start);
+      t_final = z_start < 0 ? (z_final + tpc_length / 2.0) / drift_velocity : (tpc_length / 2.0 - z_final) / drift_velocity;
+
+      x_final = rad_final * std::cos(phi_final);
+      y_final = rad_final * std::sin(phi_final);
+    }
+
+    // same acceptance margin as in the sequential drift
+    if (rad_final < min_active_radius - 2.0 || rad_final > max_active_radius + 1.0)
+    {
+      continue;
+    }
+
+    electrons.x.push_back(x_final);
+    electrons.y.push_back(y_final);
+    electrons.t.push_back(t_final);
+    electrons.side.push_back(z_start > 0 ? 1 : 0);
+  }
 }
 
 void PHG4TpcElectronDrift::SetDefaultParameters()
@@ -17,11 +17,14 @@
 
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
+class PHG4Hit;
 class PHG4TpcPadPlane;
 class PHG4TpcDistortion;
 class PHCompositeNode;
@@ -84,9 +87,37 @@ class PHG4TpcElectronDrift : public SubsysReco, public PHParameterInterface
   void set_zero_bfield_flag(bool flag) { zero_bfield = flag; };
   void set_zero_bfield_diffusion_factor(double f) { zero_bfield_diffusion_factor = f; };
   void use_PDG_gas_params() { m_use_PDG_gas_params = true; }
+
+  //! drift the electrons of several g4hits in parallel
+  /*!
+   * each g4hit gets its own counter based random stream, derived from the seed,
+   * the event number and the g4hit key, so that the result does not depend on the
+   * number of threads. The random sequence differs from the default sequential mode.
+   * The electrons of each g4hit are then mapped to the pad plane in one batch, in g4hit order.
+   * QA histograms and Verbosity() > 0 force the sequential mode.
+   */
+  void set_parallel_drift(bool b) { m_parallel_drift = b; }
+
+  //! maximum number of threads used for the parallel drift, 0 means no limit
+  void set_drift_concurrency(unsigned int n) { m_drift_concurrency = n; }
   ClusHitsVerbosev1 *mClusHitsVerbose{nullptr};
 
  private:
+  //! surviving electrons of one g4hit at the readout plane, in structure of arrays layout
+  struct DriftedElectrons
+  {
+    unsigned int n_electrons{0};
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> t;
+    std::vector<unsigned int> side;
+
+    void clear();
+  };
+
+  //! generate and drift the electrons of a g4hit, using the random stream of this g4hit
+  void drift_electrons(const PHG4Hit *g4hit, const uint64_t g4hitkey, const double drift_velocity, DriftedElectrons &electrons) const;
+
   TrkrHitSetContainer *hitsetcontainer{nullptr};
   TrkrHitTruthAssoc *hittruthassoc{nullptr};
   TrkrTruthTrackContainer *truthtracks{nullptr};
@@ -143,6 +174,14 @@ class PHG4TpcElectronDrift : public SubsysReco, public PHParameterInterface
   bool do_getReachReadout{false};
   bool zero_bfield{false};
   bool m_use_PDG_gas_params{false};
+  bool m_parallel_drift{false};
+  unsigned int m_drift_concurrency{0};
+
+  //! seed of the per g4hit random streams used by the parallel drift
+  uint64_t m_drift_seed{0};
+
+  //! drifted electrons of the current block of g4hits, reused across events
+  std::vector<DriftedElectrons> m_drifted;
 
   std::unique_ptr<TrkrHitSetContainer> temp_hitsetcontainer;
   std::unique_ptr<TrkrHitSetContainer> single_hitsetcontainer;
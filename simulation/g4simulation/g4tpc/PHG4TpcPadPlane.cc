@@ -9,6 +9,7 @@
 #include <phool/PHNode.h>  // for PHNode
 #include <phool/PHNodeIterator.h>
 
+#include <cassert>
 #include <string>
 
 PHG4TpcPadPlane::PHG4TpcPadPlane(const std::string &name)
@@ -47,3 +48,12 @@ int PHG4TpcPadPlane::InitRun(PHCompositeNode *topNode)
   UpdateInternalParameters();
   return Fun4AllReturnCodes::EVENT_OK;
 }
+
+void PHG4TpcPadPlane::MapToPadPlane(TpcClusterBuilder &builder, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer, TrkrHitTruthAssoc *hittruthassoc, std::span<const double> x_gem, std::span<const double> y_gem, std::span<const double> t_gem, std::span<const unsigned int> side, PHG4HitContainer::ConstIterator hiter, TNtuple *ntpad, TNtuple *nthit)
+{
+  assert(y_gem.size() == x_gem.size() && t_gem.size() == x_gem.size() && side.size() == x_gem.size());
+  for (size_t i = 0; i < x_gem.size(); ++i)
+  {
+    MapToPadPlane(builder, single_hitsetcontainer, hitsetcontainer, hittruthassoc, x_gem[i], y_gem[i], t_gem[i], side[i], hiter, ntpad, nthit);
+  }
+}
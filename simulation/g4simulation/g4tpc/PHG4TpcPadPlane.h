@@ -9,6 +9,7 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <span>
 #include <string>  // for string
 
 class TrkrHitSetContainer;
@@ -33,6 +34,8 @@ class PHG4TpcPadPlane : public SubsysReco, public PHParameterInterface
   virtual void UpdateInternalParameters() { return; }
   //  virtual void MapToPadPlane(PHG4CellContainer * /*g4cells*/, const double /*x_gem*/, const double /*y_gem*/, const double /*t_gem*/, const unsigned int /*side*/, PHG4HitContainer::ConstIterator /*hiter*/, TNtuple * /*ntpad*/, TNtuple * /*nthit*/) {}
   virtual void MapToPadPlane(TpcClusterBuilder & /*builder*/, TrkrHitSetContainer * /*single_hitsetcontainer*/, TrkrHitSetContainer * /*hitsetcontainer*/, TrkrHitTruthAssoc * /*hittruthassoc*/, const double /*x_gem*/, const double /*y_gem*/, const double /*t_gem*/, const unsigned int /*side*/, PHG4HitContainer::ConstIterator /*hiter*/, TNtuple * /*ntpad*/, TNtuple * /*nthit*/) = 0;  // { return {}; }
+  //! map several electrons of the same g4hit, the default calls the single electron method for each of them
+  virtual void MapToPadPlane(TpcClusterBuilder &builder, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer, TrkrHitTruthAssoc *hittruthassoc, std::span<const double> x_gem, std::span<const double> y_gem, std::span<const double> t_gem, std::span<const unsigned int> side, PHG4HitContainer::ConstIterator hiter, TNtuple *ntpad, TNtuple *nthit);
   void Detector(const std::string &name) { detector = name; }
 
  protected:
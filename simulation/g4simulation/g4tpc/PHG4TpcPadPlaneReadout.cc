@@ -37,12 +37,17 @@
 #include <gsl/gsl_randist.h>
 #include <gsl/gsl_rng.h>  // for gsl_rng_alloc
 
+#include <algorithm>
+#include <climits>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>  // for getenv
 #include <format>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <map>      // for _Rb_tree_cons...
+#include <tuple>
 #include <utility>  // for pair
 
 class PHCompositeNode;
@@ -296,30 +301,9 @@ double PHG4TpcPadPlaneReadout::getSingleEGEMAmplification(TF1 *f)
   return nelec;
 }
 
-void PHG4TpcPadPlaneReadout::MapToPadPlane(
-    TpcClusterBuilder &tpc_truth_clusterer,
-    TrkrHitSetContainer *single_hitsetcontainer,
-    TrkrHitSetContainer *hitsetcontainer,
-    TrkrHitTruthAssoc * /*hittruthassoc*/,
-    const double x_gem, const double y_gem, const double t_gem, const unsigned int side,
-    PHG4HitContainer::ConstIterator hiter, TNtuple * /*ntpad*/, TNtuple * /*nthit*/)
+//_________________________________________________________
+unsigned int PHG4TpcPadPlaneReadout::find_readout_layer(double &rad_gem, PHG4HitContainer::ConstIterator hiter)
 {
-  // One electron per call of this method
-  // The x_gem and y_gem values have already been randomized within the transverse drift diffusion width
-  // The t_gem value already reflects the drift time of the primary electron from the production point, and is randomized within the longitudinal diffusion witdth
-
-  double phi = atan2(y_gem, x_gem);
-  if (phi > +M_PI)
-  {
-    phi -= 2 * M_PI;
-  }
-  if (phi < -M_PI)
-  {
-    phi += 2 * M_PI;
-  }
-
-  double rad_gem = get_r(x_gem, y_gem);
-
   // Moving electrons from dead area to a closest pad
   for (int iregion = 0; iregion < 3; ++iregion)
   {
@@ -375,33 +359,12 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
     }
   }
 
-  if (layernum == 0)
-  {
-    return;
-  }
-
-  // store phi bins and tbins upfront to avoid repetitive checks on the phi methods
-  const auto phibins = LayerGeom->get_phibins();
-  /* pass_data.nphibins = phibins; */
-
-  const auto tbins = LayerGeom->get_zbins();
-
-  sector_min_Phi = LayerGeom->get_sector_min_phi();
-  sector_max_Phi = LayerGeom->get_sector_max_phi();
-  phi_bin_width = LayerGeom->get_phistep();
-
-  phi = check_phi(side, phi, rad_gem);
-
-  // Create the distribution function of charge on the pad plane around the electron position
-
-  // The resolution due to pad readout includes the charge spread during GEM multiplication.
-  // this now defaults to 400 microns during construction from Tom (see 8/11 email).
-  // Use the setSigmaT(const double) method to update...
-  // We use a double gaussian to represent the smearing due to the SAMPA chip shaping time - default values of fShapingLead and fShapingTail are for 80 ns SAMPA
-
-  // amplify the single electron in the gem stack
-  //===============================
+  return layernum;
+}
 
+//_________________________________________________________
+double PHG4TpcPadPlaneReadout::gem_gain(const unsigned int side, const double rad_gem, const double phi)
+{
   double nelec = getSingleEGEMAmplification();
   // Applying weight with respect to the rad_gem and phi after electrons are redistributed
   double phi_gain = phi;
@@ -482,6 +445,62 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
     }
   }
 
+  return nelec;
+}
+
+void PHG4TpcPadPlaneReadout::MapToPadPlane(
+    TpcClusterBuilder &tpc_truth_clusterer,
+    TrkrHitSetContainer *single_hitsetcontainer,
+    TrkrHitSetContainer *hitsetcontainer,
+    TrkrHitTruthAssoc * /*hittruthassoc*/,
+    const double x_gem, const double y_gem, const double t_gem, const unsigned int side,
+    PHG4HitContainer::ConstIterator hiter, TNtuple * /*ntpad*/, TNtuple * /*nthit*/)
+{
+  // One electron per call of this method
+  // The x_gem and y_gem values have already been randomized within the transverse drift diffusion width
+  // The t_gem value already reflects the drift time of the primary electron from the production point, and is randomized within the longitudinal diffusion witdth
+
+  double phi = atan2(y_gem, x_gem);
+  if (phi > +M_PI)
+  {
+    phi -= 2 * M_PI;
+  }
+  if (phi < -M_PI)
+  {
+    phi += 2 * M_PI;
+  }
+
+  double rad_gem = get_r(x_gem, y_gem);
+  const unsigned int layernum = find_readout_layer(rad_gem, hiter);
+  if (layernum == 0)
+  {
+    return;
+  }
+
+  // store phi bins and tbins upfront to avoid repetitive checks on the phi methods
+  const auto phibins = LayerGeom->get_phibins();
+  /* pass_data.nphibins = phibins; */
+
+  const auto tbins = LayerGeom->get_zbins();
+
+  sector_min_Phi = LayerGeom->get_sector_min_phi();
+  sector_max_Phi = LayerGeom->get_sector_max_phi();
+  phi_bin_width = LayerGeom->get_phistep();
+
+  phi = check_phi(side, phi, rad_gem);
+
+  // Create the distribution function of charge on the pad plane around the electron position
+
+  // The resolution due to pad readout includes the charge spread during GEM multiplication.
+  // this now defaults to 400 microns during construction from Tom (see 8/11 email).
+  // Use the setSigmaT(const double) method to update...
+  // We use a double gaussian to represent the smearing due to the SAMPA chip shaping time - default values of fShapingLead and fShapingTail are for 80 ns SAMPA
+
+  // amplify the single electron in the gem stack
+  //===============================
+
+  const double nelec = gem_gain(side, rad_gem, phi);
+
   // std::cout<<"PHG4TpcPadPlaneReadout::MapToPadPlane gain_weight = "<<gain_weight<<std::endl;
   /* pass_data.neff_electrons = nelec; */
 
@@ -716,6 +735,209 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
   m_NHits++;
   /* return pass_data; */
 }
+
+void PHG4TpcPadPlaneReadout::MapToPadPlane(
+    TpcClusterBuilder &tpc_truth_clusterer,
+    TrkrHitSetContainer *single_hitsetcontainer,
+    TrkrHitSetContainer *hitsetcontainer,
+    TrkrHitTruthAssoc *hittruthassoc,
+    std::span<const double> x_gem, std::span<const double> y_gem, std::span<const double> t_gem, std::span<const unsigned int> side,
+    PHG4HitContainer::ConstIterator hiter, TNtuple *ntpad, TNtuple *nthit)
+{
+  // electron by electron printouts are only available from the single electron method
+  if (Verbosity() > 1)
+  {
+    PHG4TpcPadPlane::MapToPadPlane(tpc_truth_clusterer, single_hitsetcontainer, hitsetcontainer, hittruthassoc, x_gem, y_gem, t_gem, side, hiter, ntpad, nthit);
+    return;
+  }
+
+  // Same response as the single electron method, electrons are processed in order so that the
+  // gain fluctuations use the same random numbers. Instead of updating the hitsets for every
+  // pad and time bin, the ADC counts are collected in a scratch buffer and every hit is
+  // updated once per batch.
+  m_batch_hitsets.clear();
+  m_batch_contributions.clear();
+
+  std::vector<int> pad_phibin;
+  std::vector<double> pad_phibin_share;
+  std::vector<int> adc_tbin;
+  std::vector<double> adc_tbin_share;
+
+  // sector boundaries only change with the layer
+  const PHG4TpcGeom *sector_geom = nullptr;
+
+  for (size_t ielectron = 0; ielectron < x_gem.size(); ++ielectron)
+  {
+    double phi = atan2(y_gem[ielectron], x_gem[ielectron]);
+    if (phi > +M_PI)
+    {
+      phi -= 2 * M_PI;
+    }
+    if (phi < -M_PI)
+    {
+      phi += 2 * M_PI;
+    }
+
+    double rad_gem = get_r(x_gem[ielectron], y_gem[ielectron]);
+    const unsigned int layernum = find_readout_layer(rad_gem, hiter);
+    if (layernum == 0)
+    {
+      continue;
+    }
+
+    const auto phibins = LayerGeom->get_phibins();
+    const auto tbins = LayerGeom->get_zbins();
+    if (LayerGeom != sector_geom)
+    {
+      sector_min_Phi = LayerGeom->get_sector_min_phi();
+      sector_max_Phi = LayerGeom->get_sector_max_phi();
+      phi_bin_width = LayerGeom->get_phistep();
+      sector_geom = LayerGeom;
+    }
+
+    const unsigned int electron_side = side[ielectron];
+    phi = check_phi(electron_side, phi, rad_gem);
+
+    const double nelec = gem_gain(electron_side, rad_gem, phi);
+
+    pad_phibin.clear();
+    pad_phibin_share.clear();
+    populate_zigzag_phibins(electron_side, layernum, phi, sigmaT, pad_phibin, pad_phibin_share);
+
+    double norm1 = 0.0;
+    for (const double pad_share : pad_phibin_share)
+    {
+      norm1 += pad_share;
+    }
+    for (double &pad_share : pad_phibin_share)
+    {
+      pad_share /= norm1;
+    }
+
+    adc_tbin.clear();
+    adc_tbin_share.clear();
+    sampaTimeDistribution(t_gem[ielectron], adc_tbin, adc_tbin_share);
+
+    double tnorm = 0.0;
+    for (const double bin_share : adc_tbin_share)
+    {
+      tnorm += bin_share;
+    }
+    for (double &bin_share : adc_tbin_share)
+    {
+      bin_share /= tnorm;
+    }
+
+    const unsigned int pads_per_sector = phibins / 12;
+    for (unsigned int ipad = 0; ipad < pad_phibin.size(); ++ipad)
+    {
+      const int pad_num = pad_phibin[ipad];
+      const double pad_share = pad_phibin_share[ipad];
+
+      for (unsigned int it = 0; it < adc_tbin.size(); ++it)
+      {
+        const int tbin_num = adc_tbin[it];
+
+        // Divide electrons from avalanche between bins
+        const float neffelectrons = nelec * (pad_share) * (adc_tbin_share[it]);
+        if (neffelectrons < neffelectrons_threshold)
+        {
+          continue;  // skip signals that will be below the noise suppression threshold
+        }
+
+        if (tbin_num >= tbins)
+        {
+          std::cout << " Error making key: adc_tbin " << tbin_num << " ntbins " << tbins << std::endl;
+        }
+        if (pad_num >= phibins)
+        {
+          std::cout << " Error making key: pad_phibin " << pad_num << " nphibins " << phibins << std::endl;
+        }
+
+        const unsigned int sector = pad_num / pads_per_sector;
+        const TrkrDefs::hitsetkey hitsetkey = TpcDefs::genHitSetKey(layernum, sector, electron_side);
+
+        // hitsets are created even if the channel is masked, as in the single electron method
+        m_batch_hitsets.push_back(hitsetkey);
+
+        if (m_maskDeadChannels)
+        {
+          const TrkrDefs::hitkey maskkey = TpcDefs::genHitKey((unsigned int) pad_num, 0);
+          if (m_deadChannelMap.contains(hitsetkey) &&
+              std::find(m_deadChannelMap[hitsetkey].begin(), m_deadChannelMap[hitsetkey].end(), maskkey) != m_deadChannelMap[hitsetkey].end())
+          {
+            continue;
+          }
+        }
+        if (m_maskHotChannels)
+        {
+          const TrkrDefs::hitkey maskkey = TpcDefs::genHitKey((unsigned int) pad_num, 0);
+          if (m_hotChannelMap.contains(hitsetkey) &&
+              std::find(m_hotChannelMap[hitsetkey].begin(), m_hotChannelMap[hitsetkey].end(), maskkey) != m_hotChannelMap[hitsetkey].end())
+          {
+            continue;
+          }
+        }
+
+        const TrkrDefs::hitkey hitkey = TpcDefs::genHitKey((unsigned int) pad_num, (unsigned int) tbin_num);
+        tpc_truth_clusterer.addhitset(hitsetkey, hitkey, neffelectrons);
+
+        // TrkrHitv2::addEnergy truncates every single deposit to full ADC counts,
+        // accumulate the truncated counts so that the sum is the same
+        const double ein = neffelectrons * TrkrDefs::EdepScaleFactor;
+        const unsigned int adc = ein >= USHRT_MAX ? USHRT_MAX : static_cast<unsigned int>(ein);
+        m_batch_contributions.push_back({hitsetkey, hitkey, adc});
+      }  // end of loop over adc T bins
+    }  // end of loop over zigzag pads
+
+    m_NHits++;
+  }  // end of loop over electrons
+
+  // create the hitsets
+  std::sort(m_batch_hitsets.begin(), m_batch_hitsets.end());
+  m_batch_hitsets.erase(std::unique(m_batch_hitsets.begin(), m_batch_hitsets.end()), m_batch_hitsets.end());
+  for (const auto &hitsetkey : m_batch_hitsets)
+  {
+    hitsetcontainer->findOrAddHitSet(hitsetkey);
+    single_hitsetcontainer->findOrAddHitSet(hitsetkey);
+  }
+
+  // add the summed ADC counts of every hit
+  std::sort(m_batch_contributions.begin(), m_batch_contributions.end(),
+            [](const BatchContribution &lhs, const BatchContribution &rhs)
+            { return std::tie(lhs.hitsetkey, lhs.hitkey) < std::tie(rhs.hitsetkey, rhs.hitkey); });
+
+  TrkrHitSetContainer::Iterator hitsetit;
+  TrkrHitSetContainer::Iterator single_hitsetit;
+  for (auto contribution = m_batch_contributions.begin(); contribution != m_batch_contributions.end();)
+  {
+    if (contribution == m_batch_contributions.begin() || std::prev(contribution)->hitsetkey != contribution->hitsetkey)
+    {
+      hitsetit = hitsetcontainer->findOrAddHitSet(contribution->hitsetkey);
+      single_hitsetit = single_hitsetcontainer->findOrAddHitSet(contribution->hitsetkey);
+    }
+
+    uint64_t adc = 0;
+    auto next = contribution;
+    for (; next != m_batch_contributions.end() && next->hitsetkey == contribution->hitsetkey && next->hitkey == contribution->hitkey; ++next)
+    {
+      adc += next->adc;
+    }
+
+    for (const auto &hitset : {hitsetit, single_hitsetit})
+    {
+      TrkrHit *hit = hitset->second->getHit(contribution->hitkey);
+      if (!hit)
+      {
+        hit = new TrkrHitv2();
+        hitset->second->addHitSpecificKey(contribution->hitkey, hit);
+      }
+      hit->setAdc(std::min<uint64_t>(hit->getAdc() + adc, USHRT_MAX));
+    }
+
+    contribution = next;
+  }
+}
 double PHG4TpcPadPlaneReadout::check_phi(const unsigned int side, const double phi, const double radius)
 {
   double new_phi = phi;
@@ -11,6 +11,8 @@
 #include <array>
 #include <climits>
 #include <cmath>
+#include <cstdint>
+#include <span>
 #include <string>  // for string
 #include <vector>
 #include <map>
@@ -48,6 +50,9 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
 
   void MapToPadPlane(TpcClusterBuilder &tpc_truth_clusterer, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer, TrkrHitTruthAssoc * /*hittruthassoc*/, const double x_gem, const double y_gem, const double t_gem, const unsigned int side, PHG4HitContainer::ConstIterator hiter, TNtuple * /*ntpad*/, TNtuple * /*nthit*/) override;
 
+  //! batched version, the hitsets are updated once per call instead of once per electron
+  void MapToPadPlane(TpcClusterBuilder &tpc_truth_clusterer, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer, TrkrHitTruthAssoc *hittruthassoc, std::span<const double> x_gem, std::span<const double> y_gem, std::span<const double> t_gem, std::span<const unsigned int> side, PHG4HitContainer::ConstIterator hiter, TNtuple *ntpad, TNtuple *nthit) override;
+
   void SetDefaultParameters() override;
   void UpdateInternalParameters() override;
  
@@ -75,6 +80,12 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
   
   double check_phi(const unsigned int side, const double phi, const double radius);
 
+  //! move electrons out of the dead areas and find the readout layer, sets LayerGeom. Returns 0 if outside all layers
+  unsigned int find_readout_layer(double &rad_gem, PHG4HitContainer::ConstIterator hiter);
+
+  //! number of electrons after GEM amplification of a single electron
+  double gem_gain(const unsigned int side, const double rad_gem, const double phi);
+
   void makeChannelMask(hitMaskTpc& aMask, const std::string& dbName, const std::string& totalChannelsToMask);
 
   PHG4TpcGeomContainer *GeomContainer = nullptr;
@@ -137,6 +148,16 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
 
   TF1 *flangau[2][3][12] {{{nullptr}}};
 
+  //! ADC counts of one pad and time bin, collected by the batched MapToPadPlane
+  struct BatchContribution
+  {
+    TrkrDefs::hitsetkey hitsetkey{0};
+    TrkrDefs::hitkey hitkey{0};
+    unsigned int adc{0};
+  };
+  std::vector<BatchContribution> m_batch_contributions;
+  std::vector<TrkrDefs::hitsetkey> m_batch_hitsets;
+
   hitMaskTpc m_deadChannelMap;
   hitMaskTpc m_hotChannelMap; 
 